@@ -0,0 +1,38 @@
+#pragma once
+#include "pch.h"
+
+struct AABB {
+public:
+	glm::vec3 min = glm::vec3(0.0f, 0.0f, 0.0f);
+	glm::vec3 max = glm::vec3(0.0f, 0.0f, 0.0f);
+
+	/// <summary>
+	/// Returns whether or not this box overlaps the other box, touching boxes count as overlapping
+	/// </summary>
+	/// <param name="other">The box to check against</param>
+	/// <returns>True if the boxes overlap</returns>
+	bool Overlaps(const AABB& other) const {
+		return min.x <= other.max.x && max.x >= other.min.x &&
+			min.y <= other.max.y && max.y >= other.min.y &&
+			min.z <= other.max.z && max.z >= other.min.z;
+	}
+
+	/// <summary>
+	/// Shortens a section of a ray to the part of it inside this box
+	/// </summary>
+	/// <param name="origin">The start of the ray</param>
+	/// <param name="inverseDirection">One divided by each component of the ray's direction</param>
+	/// <param name="start">The distance along the ray the section starts at, moved up to where the ray enters the box</param>
+	/// <param name="end">The distance along the ray the section ends at, moved back to where the ray leaves the box</param>
+	/// <returns>True if any of the section is inside the box</returns>
+	bool ClipRay(glm::vec3 origin, glm::vec3 inverseDirection, float& start, float& end) const {
+		for (int i = 0; i < 3; i++) {
+			float t1 = (min[i] - origin[i]) * inverseDirection[i];
+			float t2 = (max[i] - origin[i]) * inverseDirection[i];
+			start = std::max(start, std::min(t1, t2));
+			end = std::min(end, std::max(t1, t2));
+		}
+
+		return start <= end;
+	}
+};
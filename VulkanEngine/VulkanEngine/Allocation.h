@@ -0,0 +1,16 @@
+#pragma once
+#include "pch.h"
+
+class MemoryBlock;
+
+struct Allocation {
+public:
+	VkDeviceMemory memory = VK_NULL_HANDLE;
+	VkDeviceSize offset = 0;
+	VkDeviceSize size = 0;
+	void* mappedData = nullptr;
+
+	//Used by the memory allocator to return the range to the block it came from
+	MemoryBlock* block = nullptr;
+	uint32_t poolKey = 0;
+};
@@ -0,0 +1,55 @@
+#include "pch.h"
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <new>
+
+//Counted by the replacement operator new below, the standard library forwards nothrow allocations to it but over-aligned allocations are not counted
+static std::atomic<uint64_t> allocationCount{ 0 };
+
+uint64_t AllocationCounter::GetCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+#pragma region Operators
+
+void* operator new(size_t size)
+{
+	allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+	//Zero byte allocations must still return a unique pointer
+	void* memory = std::malloc(size > 0 ? size : 1);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete(void* memory, size_t size) noexcept
+{
+	std::free(memory);
+}
+
+void operator delete[](void* memory, size_t size) noexcept
+{
+	std::free(memory);
+}
+
+#pragma endregion
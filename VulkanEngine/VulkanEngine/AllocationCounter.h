@@ -0,0 +1,12 @@
+#pragma once
+#include "pch.h"
+
+class AllocationCounter
+{
+public:
+	/// <summary>
+	/// Returns the number of times operator new has been called since the program started, subtract two counts to find the allocations in between
+	/// </summary>
+	/// <returns>The allocation count</returns>
+	static uint64_t GetCount();
+};
@@ -0,0 +1,86 @@
+#pragma once
+#include "pch.h"
+
+#include <cstring>
+#include <type_traits>
+
+struct BinaryStream {
+public:
+	//Raw bytes of every value written so far, in the order they were written
+	std::vector<char> data;
+
+	//Where the next value will be read from
+	size_t readPosition = 0;
+
+	/// <summary>
+	/// Appends the bytes of a value to the stream
+	/// </summary>
+	/// <param name="value">The value to write, copied byte for byte</param>
+	template<typename T>
+	void Write(const T& value) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written to a binary stream");
+
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		data.insert(data.end(), bytes, bytes + sizeof(T));
+	}
+
+	/// <summary>
+	/// Appends the length of a vector followed by the bytes of its elements
+	/// </summary>
+	/// <param name="values">The values to write</param>
+	template<typename T>
+	void WriteVector(const std::vector<T>& values) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written to a binary stream");
+
+		Write(static_cast<uint32_t>(values.size()));
+		const char* bytes = reinterpret_cast<const char*>(values.data());
+		data.insert(data.end(), bytes, bytes + values.size() * sizeof(T));
+	}
+
+	/// <summary>
+	/// Reads the next value from the stream
+	/// </summary>
+	/// <returns>The value read</returns>
+	template<typename T>
+	T Read() {
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read from a binary stream");
+
+		CheckRemaining(sizeof(T));
+
+		T value;
+		std::memcpy(&value, data.data() + readPosition, sizeof(T));
+		readPosition += sizeof(T);
+		return value;
+	}
+
+	/// <summary>
+	/// Reads a vector written by WriteVector
+	/// </summary>
+	/// <param name="values">Resized and filled with the values read</param>
+	template<typename T>
+	void ReadVector(std::vector<T>& values) {
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be read from a binary stream");
+
+		uint32_t count = Read<uint32_t>();
+		CheckRemaining(static_cast<size_t>(count) * sizeof(T));
+
+		values.resize(count);
+		std::memcpy(values.data(), data.data() + readPosition, count * sizeof(T));
+		readPosition += count * sizeof(T);
+	}
+
+	/// <summary>
+	/// Returns whether every value in the stream has been read
+	/// </summary>
+	/// <returns>True if there is nothing left to read</returns>
+	bool AtEnd() const {
+		return readPosition >= data.size();
+	}
+
+private:
+	void CheckRemaining(size_t size) const {
+		if (readPosition + size > data.size()) {
+			throw std::runtime_error("Unexpected end of binary stream!");
+		}
+	}
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include "pch.h"
+
+struct BodyArrays {
+public:
+	//Pointers to the physics world's state arrays, all indexed by a body's dense index
+	float* positionX = nullptr;
+	float* positionY = nullptr;
+	float* positionZ = nullptr;
+	float* velocityX = nullptr;
+	float* velocityY = nullptr;
+	float* velocityZ = nullptr;
+	float* accelerationX = nullptr;
+	float* accelerationY = nullptr;
+	float* accelerationZ = nullptr;
+	const float* simulated = nullptr;
+	const float* gravityScale = nullptr;
+	const float* boundingRadius = nullptr;
+};
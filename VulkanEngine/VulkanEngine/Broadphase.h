@@ -0,0 +1,50 @@
+#pragma once
+
+#include "pch.h"
+#include "AABB.h"
+#include "CollisionFilter.h"
+#include "CollisionPair.h"
+
+class Broadphase
+{
+public:
+	virtual ~Broadphase() = default;
+
+#pragma region Pair Finding
+
+	/// <summary>
+	/// Finds every pair of proxies whose bounds overlap and whose collision filters accept each other
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="filters">The collision filter of each proxy, checked before the bounds since it is cheaper</param>
+	/// <param name="pairs">Filled with the candidate pairs, in no particular order</param>
+	virtual void FindPairs(const std::vector<AABB>& bounds, const std::vector<CollisionFilter>& filters, std::vector<CollisionPair>& pairs) = 0;
+
+#pragma endregion
+
+#pragma region Queries
+
+	/// <summary>
+	/// Finds every proxy whose bounds overlap a box, using whatever the latest FindPairs call built.
+	/// Does not change the broadphase so many queries can run at once
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy, the same ones passed to the latest FindPairs call</param>
+	/// <param name="query">The box to look in</param>
+	/// <param name="proxies">Filled with the overlapping proxies, each listed once in no particular order</param>
+	virtual void QueryBounds(const std::vector<AABB>& bounds, const AABB& query, std::vector<uint32_t>& proxies) const = 0;
+
+	/// <summary>
+	/// Visits every proxy whose bounds a ray or swept sphere passes through, using whatever the latest FindPairs call built.
+	/// Does not change the broadphase so many queries can run at once
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy, the same ones passed to the latest FindPairs call</param>
+	/// <param name="origin">The start of the ray</param>
+	/// <param name="direction">The normalized direction of the ray</param>
+	/// <param name="maxDistance">How far the ray reaches</param>
+	/// <param name="radius">The radius of the swept sphere, zero for a thin ray</param>
+	/// <param name="visit">Called once for each proxy the ray passes through, returns how far the ray should reach from then on
+	/// so a caller that only wants the closest hits can cut the ray short once it has them</param>
+	virtual void QueryRay(const std::vector<AABB>& bounds, glm::vec3 origin, glm::vec3 direction, float maxDistance, float radius, const std::function<float(uint32_t)>& visit) const = 0;
+
+#pragma endregion
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+enum BroadphaseTypes {
+	AllPairs,
+	Sweep,
+	Grid,
+	BroadphaseTypeCount
+};
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "pch.h"
+#include "BruteForceBroadphase.h"
+
+#pragma region Pair Finding
+
+void BruteForceBroadphase::FindPairs(const std::vector<AABB>& bounds, const std::vector<CollisionFilter>& filters, std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+
+	uint32_t count = static_cast<uint32_t>(bounds.size());
+	for (uint32_t i = 0; i < count; i++) {
+		for (uint32_t j = i + 1; j < count; j++) {
+			if (filters[i].CanCollide(filters[j]) && bounds[i].Overlaps(bounds[j])) {
+				pairs.push_back({ i, j });
+			}
+		}
+	}
+}
+
+#pragma endregion
+
+#pragma region Queries
+
+void BruteForceBroadphase::QueryBounds(const std::vector<AABB>& bounds, const AABB& query, std::vector<uint32_t>& proxies) const
+{
+	proxies.clear();
+
+	uint32_t count = static_cast<uint32_t>(bounds.size());
+	for (uint32_t i = 0; i < count; i++) {
+		if (bounds[i].Overlaps(query)) {
+			proxies.push_back(i);
+		}
+	}
+}
+
+void BruteForceBroadphase::QueryRay(const std::vector<AABB>& bounds, glm::vec3 origin, glm::vec3 direction, float maxDistance, float radius, const std::function<float(uint32_t)>& visit) const
+{
+	glm::vec3 inverseDirection = 1.0f / direction;
+	uint32_t count = static_cast<uint32_t>(bounds.size());
+	for (uint32_t i = 0; i < count; i++) {
+		//A swept sphere touches the bounds wherever its center line passes through the bounds grown by its radius
+		AABB grown = { bounds[i].min - radius, bounds[i].max + radius };
+		float start = 0.0f;
+		float end = maxDistance;
+
+		if (grown.ClipRay(origin, inverseDirection, start, end)) {
+			maxDistance = std::min(maxDistance, visit(i));
+		}
+	}
+}
+
+#pragma endregion
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "pch.h"
+#include "Broadphase.h"
+
+class BruteForceBroadphase : public Broadphase
+{
+public:
+#pragma region Pair Finding
+
+	/// <summary>
+	/// Tests every proxy against every other proxy, kept as a reference for the faster broadphases
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="filters">The collision filter of each proxy</param>
+	/// <param name="pairs">Filled with the candidate pairs</param>
+	void FindPairs(const std::vector<AABB>& bounds, const std::vector<CollisionFilter>& filters, std::vector<CollisionPair>& pairs) override;
+
+#pragma endregion
+
+#pragma region Queries
+
+	/// <summary>
+	/// Tests the box against every proxy
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="query">The box to look in</param>
+	/// <param name="proxies">Filled with the overlapping proxies</param>
+	void QueryBounds(const std::vector<AABB>& bounds, const AABB& query, std::vector<uint32_t>& proxies) const override;
+
+	/// <summary>
+	/// Tests the ray against every proxy
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="origin">The start of the ray</param>
+	/// <param name="direction">The normalized direction of the ray</param>
+	/// <param name="maxDistance">How far the ray reaches</param>
+	/// <param name="radius">The radius of the swept sphere, zero for a thin ray</param>
+	/// <param name="visit">Called for each proxy the ray passes through, returns how far the ray should reach from then on</param>
+	void QueryRay(const std::vector<AABB>& bounds, glm::vec3 origin, glm::vec3 direction, float maxDistance, float radius, const std::function<float(uint32_t)>& visit) const override;
+
+#pragma endregion
+};
@@ -2,29 +2,29 @@
 #include "Buffer.h"
 
 #include "VulkanManager.h"
-#include "CommandBuffer.h"
+#include "UploadManager.h"
+#include "MemoryAllocator.h"
 
 #define logicalDevice VulkanManager::GetInstance()->GetLogicalDevice()
 
 #pragma region Constructor
 
-Buffer::Buffer(VkBuffer buffer, VkDeviceMemory bufferMemory)
+Buffer::Buffer(VkBuffer buffer)
 {
 	this->buffer = buffer;
-	this->bufferMemory = bufferMemory;
 }
 
 void Buffer::Cleanup()
 {
 	vkDestroyBuffer(logicalDevice, buffer, nullptr);
-	vkFreeMemory(logicalDevice, bufferMemory, nullptr);
+	MemoryAllocator::GetInstance()->Free(allocation);
 }
 
 #pragma endregion
 
 #pragma region Accessors
 
-VkBuffer Buffer::GetBuffer()
+VkBuffer Buffer::GetBuffer() const
 {
 	return buffer;
 }
@@ -36,12 +36,17 @@ void Buffer::SetBuffer(VkBuffer value)
 
 VkDeviceMemory Buffer::GetBufferMemory()
 {
-	return bufferMemory;
+	return allocation.memory;
 }
 
-void Buffer::SetBufferMemory(VkDeviceMemory value)
+Allocation Buffer::GetAllocation()
 {
-	bufferMemory = value;
+	return allocation;
+}
+
+void* Buffer::GetMappedData()
+{
+	return allocation.mappedData;
 }
 
 #pragma endregion
@@ -66,25 +71,19 @@ void Buffer::CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryP
 	VkMemoryRequirements memoryRequirements;
 	vkGetBufferMemoryRequirements(logicalDevice, buffer.buffer, &memoryRequirements);
 
-	//Setup Vertex Buffer memory allocate info
-	VkMemoryAllocateInfo allocateInfo = {};
-	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocateInfo.allocationSize = memoryRequirements.size;
-	allocateInfo.memoryTypeIndex = VulkanManager::GetInstance()->FindMemoryType(memoryRequirements.memoryTypeBits, properties);
-
-	//Allocate memory
-	if (vkAllocateMemory(logicalDevice, &allocateInfo, nullptr, &buffer.bufferMemory) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to allocate Buffer memory!");
-	}
+	//Sub-allocate memory from a shared block
+	buffer.allocation = MemoryAllocator::GetInstance()->Allocate(memoryRequirements, properties, true);
 
 	//Bind buffer memory
-	vkBindBufferMemory(logicalDevice, buffer.buffer, buffer.bufferMemory, 0);
+	if (vkBindBufferMemory(logicalDevice, buffer.buffer, buffer.allocation.memory, buffer.allocation.offset) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to bind Buffer memory!");
+	}
 }
 
 void Buffer::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
 {
-	//Begin the command buffer
-	VkCommandBuffer commandBuffer = CommandBuffer::BeginSingleTimeCommand();
+	//Record into the current upload batch instead of submitting and waiting on the queue
+	VkCommandBuffer commandBuffer = UploadManager::GetInstance()->GetCommandBuffer();
 
 	//Copy the buffer
 	VkBufferCopy copyRegion = {};
@@ -92,9 +91,6 @@ void Buffer::CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize siz
 	copyRegion.dstOffset = 0;
 	copyRegion.size = size;
 	vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-
-	//End the command buffer
-	CommandBuffer::EndSingleTimeCommand(commandBuffer);
 }
 
 #pragma endregion
\ No newline at end of file
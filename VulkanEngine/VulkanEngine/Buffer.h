@@ -1,19 +1,20 @@
 #pragma once
 
 #include "pch.h"
+#include "Allocation.h"
 
 class Buffer
 {
 private:
 	VkBuffer buffer;
-	VkDeviceMemory bufferMemory;
+	Allocation allocation;
 public:
 #pragma region Constructor
 
-	Buffer(VkBuffer buffer = VK_NULL_HANDLE, VkDeviceMemory bufferMemory = VK_NULL_HANDLE);
+	Buffer(VkBuffer buffer = VK_NULL_HANDLE);
 
 	/// <summary>
-	/// Destroys the buffer and frees buffer memory
+	/// Destroys the buffer and returns its memory to the memory allocator
 	/// </summary>
 	void Cleanup();
 
@@ -25,7 +26,7 @@ public:
 	/// Returns the VkBuffer associated with this buffer
 	/// </summary>
 	/// <returns>The VkBuffer associated with this buffer</returns>
-	VkBuffer GetBuffer();
+	VkBuffer GetBuffer() const;
 
 	/// <summary>
 	/// Sets the VkBuffer
@@ -34,16 +35,22 @@ public:
 	void SetBuffer(VkBuffer value);
 
 	/// <summary>
-	/// Returns the device memory associated with this buffer
+	/// Returns the device memory block that this buffer is bound to, shared with other resources
 	/// </summary>
 	/// <returns>The VkDeviceMemory associated with this buffer</returns>
 	VkDeviceMemory GetBufferMemory();
 
 	/// <summary>
-	/// Sets the VkDeviceMemory
+	/// Returns the range of device memory sub-allocated for this buffer
 	/// </summary>
-	/// <param name="value">The value to set the VkDeviceMemory to</param>
-	void SetBufferMemory(VkDeviceMemory value);
+	/// <returns>The buffer's allocation</returns>
+	Allocation GetAllocation();
+
+	/// <summary>
+	/// Returns a pointer to the buffer's memory, the memory block stays mapped so there is no need to unmap it
+	/// </summary>
+	/// <returns>The mapped pointer or nullptr if the buffer is not host visible</returns>
+	void* GetMappedData();
 
 #pragma endregion
 
@@ -56,11 +63,10 @@ public:
 	/// <param name="usage">The intended VK_BUFFER_USAGE of this buffer</param>
 	/// <param name="properties">The required memory properties for the created buffer</param>
 	/// <param name="buffer">The buffer to create</param>
-	/// <param name="bufferMemory">The device memory associated with the buffer</param>
 	static void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, Buffer& buffer);
 
 	/// <summary>
-	/// Copies data from the source buffer to the destination buffer
+	/// Records a copy from the source buffer to the destination buffer into the current upload batch
 	/// </summary>
 	/// <param name="srcBuffer">The buffer to copy data from</param>
 	/// <param name="dstBuffer">The buffer to transfer the data to</param>
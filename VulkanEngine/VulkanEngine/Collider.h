@@ -0,0 +1,27 @@
+#pragma once
+#include "pch.h"
+
+#include "ColliderTypes.h"
+
+struct Collider {
+public:
+	ColliderTypes type = ColliderTypes::SphereCollider;
+
+	//Center of the shape relative to the body, in the body's local space
+	glm::vec3 offset = glm::vec3(0.0f, 0.0f, 0.0f);
+
+	//Used by spheres and capsules, scaled by the largest component of the body's scale
+	float radius = 0.5f;
+
+	//Used by AABBs and OBBs, scaled by the body's scale
+	glm::vec3 halfExtents = glm::vec3(0.5f, 0.5f, 0.5f);
+
+	//Half the length of a capsule's center line along its local Y axis, not including the rounded ends
+	float halfHeight = 0.5f;
+
+	//How strongly the surface resists sliding, combined with the other collider's by their geometric mean
+	float friction = 0.5f;
+
+	//How much of the closing speed is kept after a bounce, the larger of the two colliders' values is used
+	float restitution = 0.5f;
+};
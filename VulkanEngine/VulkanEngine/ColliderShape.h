@@ -0,0 +1,18 @@
+#pragma once
+#include "pch.h"
+
+#include "ColliderTypes.h"
+
+struct ColliderShape {
+public:
+	//A collider placed in world space, AABBs and OBBs are both stored as boxes with their own axes
+	ColliderTypes type = ColliderTypes::SphereCollider;
+	glm::vec3 center = glm::vec3(0.0f, 0.0f, 0.0f);
+	glm::vec3 axes[3] = { glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f) };
+	glm::vec3 halfExtents = glm::vec3(0.0f, 0.0f, 0.0f);
+	float radius = 0.0f;
+
+	//End points of a capsule's center line
+	glm::vec3 segmentStart = glm::vec3(0.0f, 0.0f, 0.0f);
+	glm::vec3 segmentEnd = glm::vec3(0.0f, 0.0f, 0.0f);
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+enum ColliderTypes {
+	SphereCollider,
+	AABBCollider,
+	OBBCollider,
+	CapsuleCollider,
+	ColliderTypeCount
+};
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+#include "pch.h"
+
+struct CollisionFilter {
+public:
+	//Bit of the collision layer the body belongs to
+	uint32_t category = 1;
+
+	//Bits of every collision layer the body is tested against
+	uint32_t mask = UINT32_MAX;
+
+	/// <summary>
+	/// Returns whether two bodies should be tested for collisions, both have to accept the other's layer
+	/// </summary>
+	/// <param name="other">The filter of the other body</param>
+	/// <returns>True if the bodies can collide</returns>
+	bool CanCollide(const CollisionFilter& other) const {
+		return (category & other.mask) != 0 && (other.category & mask) != 0;
+	}
+};
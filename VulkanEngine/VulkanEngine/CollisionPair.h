@@ -0,0 +1,17 @@
+#pragma once
+#include "pch.h"
+
+struct CollisionPair {
+public:
+	//Indices of the two proxies whose bounds overlap, a is always less than b
+	uint32_t a = 0;
+	uint32_t b = 0;
+
+	bool operator<(const CollisionPair& other) const {
+		return a < other.a || (a == other.a && b < other.b);
+	}
+
+	bool operator==(const CollisionPair& other) const {
+		return a == other.a && b == other.b;
+	}
+};
@@ -1,42 +0,0 @@
-#include "pch.h"
-#include "CommandBuffer.h"
-
-#include "VulkanManager.h"
-#include "SwapChain.h"
-
-VkCommandBuffer CommandBuffer::BeginSingleTimeCommand()
-{
-	VkCommandBufferAllocateInfo allocateInfo = {};
-	allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-	allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-	allocateInfo.commandPool = SwapChain::GetInstance()->GetCommandPool();
-	allocateInfo.commandBufferCount = 1;
-
-	VkCommandBuffer commandBuffer;
-	vkAllocateCommandBuffers(VulkanManager::GetInstance()->GetLogicalDevice(), &allocateInfo, &commandBuffer);
-
-	VkCommandBufferBeginInfo beginInfo = {};
-	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-	vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-	return commandBuffer;
-}
-
-void CommandBuffer::EndSingleTimeCommand(VkCommandBuffer commandBuffer)
-{
-	vkEndCommandBuffer(commandBuffer);
-
-	VkSubmitInfo submitInfo = {};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &commandBuffer;
-
-	if (vkQueueSubmit(VulkanManager::GetInstance()->GetGraphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to submit single time command buffer");
-	}
-	vkQueueWaitIdle(VulkanManager::GetInstance()->GetGraphicsQueue());
-
-	vkFreeCommandBuffers(VulkanManager::GetInstance()->GetLogicalDevice(), SwapChain::GetInstance()->GetCommandPool(), 1, &commandBuffer);
-}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include "pch.h"
+
+//Position, orientation and scale of an instance in 32 bytes, the vertex shader rebuilds the model matrix from them.
+//The orientation is quantized to 16 bits per component which is well below a pixel of error at any sensible scale
+struct CompactTransformData {
+	//Position in xyz and the x scale in w
+	glm::vec4 positionScaleX;
+
+	//Orientation quaternion in xyzw order, read by the shader as normalized values between -1 and 1
+	int16_t orientation[4];
+
+	glm::vec2 scaleYZ;
+
+	static VkVertexInputBindingDescription GetBindingDescription(int offset = 0) {
+		VkVertexInputBindingDescription bindingDescription = {};
+		bindingDescription.binding = offset;
+		bindingDescription.stride = sizeof(CompactTransformData);
+		bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+
+		return bindingDescription;
+	}
+
+	static std::vector<VkVertexInputAttributeDescription> GetAttributeDescriptions(int offset = 0, int binding = 0) {
+		//Setup attributes
+		std::vector<VkVertexInputAttributeDescription> attributeDescriptions = std::vector<VkVertexInputAttributeDescription>(3);
+		attributeDescriptions[0].binding = binding;
+		attributeDescriptions[0].location = offset;
+		attributeDescriptions[0].format = VK_FORMAT_R32G32B32A32_SFLOAT;
+		attributeDescriptions[0].offset = offsetof(CompactTransformData, positionScaleX);
+
+		attributeDescriptions[1].binding = binding;
+		attributeDescriptions[1].location = offset + 1;
+		attributeDescriptions[1].format = VK_FORMAT_R16G16B16A16_SNORM;
+		attributeDescriptions[1].offset = offsetof(CompactTransformData, orientation);
+
+		attributeDescriptions[2].binding = binding;
+		attributeDescriptions[2].location = offset + 2;
+		attributeDescriptions[2].format = VK_FORMAT_R32G32_SFLOAT;
+		attributeDescriptions[2].offset = offsetof(CompactTransformData, scaleYZ);
+
+		return attributeDescriptions;
+	}
+
+	static CompactTransformData Load(glm::vec3 position, glm::quat orientation, glm::vec3 scale) {
+		CompactTransformData data = {};
+
+		data.positionScaleX = glm::vec4(position, scale.x);
+		data.orientation[0] = static_cast<int16_t>(std::round(glm::clamp(orientation.x, -1.0f, 1.0f) * 32767.0f));
+		data.orientation[1] = static_cast<int16_t>(std::round(glm::clamp(orientation.y, -1.0f, 1.0f) * 32767.0f));
+		data.orientation[2] = static_cast<int16_t>(std::round(glm::clamp(orientation.z, -1.0f, 1.0f) * 32767.0f));
+		data.orientation[3] = static_cast<int16_t>(std::round(glm::clamp(orientation.w, -1.0f, 1.0f) * 32767.0f));
+		data.scaleYZ = glm::vec2(scale.y, scale.z);
+
+		return data;
+	}
+
+	static CompactTransformData LoadMat4(glm::mat4 value) {
+		//Split the matrix back into position, orientation and scale, any shear from non uniformly scaled parents is lost
+		glm::vec3 scale = glm::vec3(glm::length(glm::vec3(value[0])), glm::length(glm::vec3(value[1])), glm::length(glm::vec3(value[2])));
+		glm::mat3 rotation = glm::mat3(
+			scale.x > 0.0f ? glm::vec3(value[0]) / scale.x : glm::vec3(1.0f, 0.0f, 0.0f),
+			scale.y > 0.0f ? glm::vec3(value[1]) / scale.y : glm::vec3(0.0f, 1.0f, 0.0f),
+			scale.z > 0.0f ? glm::vec3(value[2]) / scale.z : glm::vec3(0.0f, 0.0f, 1.0f));
+
+		return Load(glm::vec3(value[3]), glm::quat_cast(rotation), scale);
+	}
+};
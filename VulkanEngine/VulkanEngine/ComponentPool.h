@@ -0,0 +1,138 @@
+#pragma once
+#include "pch.h"
+
+#include "Entity.h"
+
+template<typename T>
+class ComponentPool
+{
+private:
+	//Position of each entity's component in the dense arrays indexed by entity index, UINT32_MAX for entities without one
+	std::vector<uint32_t> denseIndices;
+
+	//Components packed with no gaps so systems can walk them in order, entities[i] owns components[i]
+	std::vector<Entity> entities;
+	std::vector<T> components;
+
+public:
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the number of entities with this component
+	/// </summary>
+	/// <returns>The component count</returns>
+	uint32_t GetSize()
+	{
+		return static_cast<uint32_t>(components.size());
+	}
+
+	/// <summary>
+	/// Returns the entities with this component, in the same order as GetComponents
+	/// </summary>
+	/// <returns>The packed entities</returns>
+	const std::vector<Entity>& GetEntities()
+	{
+		return entities;
+	}
+
+	/// <summary>
+	/// Returns every component, the order changes whenever a component is removed
+	/// </summary>
+	/// <returns>The packed components</returns>
+	std::vector<T>& GetComponents()
+	{
+		return components;
+	}
+
+	/// <summary>
+	/// Returns whether an entity has this component
+	/// </summary>
+	/// <param name="entity">The entity to check</param>
+	/// <returns>True if the entity has the component</returns>
+	bool Has(Entity entity)
+	{
+		if (entity.index >= denseIndices.size()) {
+			return false;
+		}
+
+		uint32_t index = denseIndices[entity.index];
+		return index != UINT32_MAX && entities[index] == entity;
+	}
+
+	/// <summary>
+	/// Returns an entity's component, the reference is invalidated when components are added or removed
+	/// </summary>
+	/// <param name="entity">The entity the component belongs to</param>
+	/// <returns>The component</returns>
+	T& Get(Entity entity)
+	{
+		if (!Has(entity)) {
+			throw std::runtime_error("Failed to get component, the entity doesn't have one!");
+		}
+
+		return components[denseIndices[entity.index]];
+	}
+
+#pragma endregion
+
+#pragma region Components
+
+	/// <summary>
+	/// Gives an entity this component, replacing the one it already has
+	/// </summary>
+	/// <param name="entity">The entity to add the component to</param>
+	/// <param name="component">The component to add</param>
+	/// <returns>The stored component</returns>
+	T& Add(Entity entity, const T& component)
+	{
+		if (Has(entity)) {
+			T& existing = components[denseIndices[entity.index]];
+			existing = component;
+			return existing;
+		}
+
+		if (entity.index >= denseIndices.size()) {
+			denseIndices.resize(static_cast<size_t>(entity.index) + 1, UINT32_MAX);
+		}
+
+		denseIndices[entity.index] = static_cast<uint32_t>(components.size());
+		entities.push_back(entity);
+		components.push_back(component);
+
+		return components.back();
+	}
+
+	/// <summary>
+	/// Removes an entity's component by moving the last component into its place
+	/// </summary>
+	/// <param name="entity">The entity to remove the component from</param>
+	void Remove(Entity entity)
+	{
+		if (!Has(entity)) {
+			return;
+		}
+
+		uint32_t index = denseIndices[entity.index];
+		uint32_t last = static_cast<uint32_t>(components.size() - 1);
+
+		entities[index] = entities[last];
+		components[index] = std::move(components[last]);
+		denseIndices[entities[index].index] = index;
+
+		entities.pop_back();
+		components.pop_back();
+		denseIndices[entity.index] = UINT32_MAX;
+	}
+
+	/// <summary>
+	/// Removes every component
+	/// </summary>
+	void Clear()
+	{
+		denseIndices.clear();
+		entities.clear();
+		components.clear();
+	}
+
+#pragma endregion
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include "pch.h"
+
+struct ContactConstraint {
+public:
+	//Dense indices of the two bodies, only valid for the step the constraint was built in
+	uint32_t a = 0;
+	uint32_t b = 0;
+
+	//Handle slots of both bodies packed together, stays the same across steps so impulses can be carried over
+	uint64_t key = 0;
+
+	//Points from a towards b, the two tangents span the plane friction acts in
+	glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::vec3 tangents[2];
+
+	float inverseMassA = 0.0f;
+	float inverseMassB = 0.0f;
+
+	//Impulse needed to change the relative velocity by one unit
+	float effectiveMass = 0.0f;
+
+	float friction = 0.0f;
+
+	//Separating speed the normal impulse aims for, from restitution or pushing overlapping bodies apart
+	float targetSpeed = 0.0f;
+
+	//Total impulse applied so far, clamped as a whole rather than per iteration
+	float normalImpulse = 0.0f;
+	float tangentImpulses[2] = {};
+
+	bool operator<(const ContactConstraint& other) const {
+		return key < other.key;
+	}
+};
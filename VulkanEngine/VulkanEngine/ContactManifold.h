@@ -0,0 +1,60 @@
+#pragma once
+#include "pch.h"
+
+struct ContactManifold {
+public:
+	static const uint32_t MAX_POINTS = 4;
+
+	//Dense indices of the two bodies in contact
+	uint32_t a = 0;
+	uint32_t b = 0;
+
+	//Points from a towards b, moving b along it by the depth separates the bodies
+	glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+
+	//Fixed size so manifolds can be stored in a reused buffer without allocating
+	uint32_t pointCount = 0;
+	glm::vec3 points[MAX_POINTS];
+	float depths[MAX_POINTS] = {};
+
+	/// <summary>
+	/// Adds a contact point, replacing the shallowest point once the manifold is full
+	/// </summary>
+	/// <param name="point">The world space position of the contact</param>
+	/// <param name="depth">How far the bodies overlap at the point</param>
+	void AddPoint(glm::vec3 point, float depth) {
+		uint32_t slot = pointCount;
+
+		if (pointCount == MAX_POINTS) {
+			slot = 0;
+			for (uint32_t i = 1; i < MAX_POINTS; i++) {
+				if (depths[i] < depths[slot]) {
+					slot = i;
+				}
+			}
+
+			if (depths[slot] >= depth) {
+				return;
+			}
+		}
+		else {
+			pointCount++;
+		}
+
+		points[slot] = point;
+		depths[slot] = depth;
+	}
+
+	/// <summary>
+	/// Returns the depth of the deepest contact point
+	/// </summary>
+	/// <returns>The largest depth in the manifold</returns>
+	float GetMaxDepth() const {
+		float maxDepth = 0.0f;
+		for (uint32_t i = 0; i < pointCount; i++) {
+			maxDepth = std::max(maxDepth, depths[i]);
+		}
+
+		return maxDepth;
+	}
+};
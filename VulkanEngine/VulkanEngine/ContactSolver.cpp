@@ -0,0 +1,188 @@
+#include "pch.h"
+#include "ContactSolver.h"
+
+#include "PhysicsWorld.h"
+
+//Fraction of the overlap that is pushed out each step, pushing all of it at once makes stacks jitter
+static const float BAUMGARTE = 0.2f;
+
+//Overlap that is allowed to remain so resting contacts stay touching instead of separating and colliding again
+static const float PENETRATION_SLOP = 0.01f;
+
+//Collisions slower than this don't bounce so resting bodies settle
+static const float RESTING_SPEED = 0.5f;
+
+/// <summary>
+/// Builds two tangents perpendicular to the normal, always the same for the same normal so carried over friction impulses still line up
+/// </summary>
+static void ComputeTangents(glm::vec3 normal, glm::vec3& tangent1, glm::vec3& tangent2)
+{
+	//Cross with whichever axis is furthest from the normal to stay well conditioned
+	if (std::abs(normal.x) >= 0.57735f) {
+		tangent1 = glm::normalize(glm::vec3(normal.y, -normal.x, 0.0f));
+	}
+	else {
+		tangent1 = glm::normalize(glm::vec3(0.0f, normal.z, -normal.y));
+	}
+
+	tangent2 = glm::cross(normal, tangent1);
+}
+
+#pragma region Accessors
+
+uint32_t ContactSolver::GetIterations()
+{
+	return iterations;
+}
+
+void ContactSolver::SetIterations(uint32_t value)
+{
+	iterations = value;
+}
+
+bool ContactSolver::GetWarmStarting()
+{
+	return warmStarting;
+}
+
+void ContactSolver::SetWarmStarting(bool value)
+{
+	warmStarting = value;
+}
+
+#pragma endregion
+
+#pragma region Solving
+
+void ContactSolver::Prepare(PhysicsWorld& world, const ContactManifold* manifolds, const uint8_t* results, uint32_t count, float deltaTime)
+{
+	constraints.clear();
+
+	for (uint32_t i = 0; i < count; i++) {
+		if (!results[i]) {
+			continue;
+		}
+
+		const ContactManifold& manifold = manifolds[i];
+		uint32_t a = manifold.a;
+		uint32_t b = manifold.b;
+
+		//Triggers report overlaps but never push anything
+		if (world.layers[a] == PhysicsLayers::Trigger || world.layers[b] == PhysicsLayers::Trigger) {
+			continue;
+		}
+
+		//Bodies that are not simulated, including sleeping bodies, have no inverse mass and are treated as immovable
+		ContactConstraint constraint;
+		constraint.a = a;
+		constraint.b = b;
+		constraint.inverseMassA = world.simulated[a] / world.mass[a];
+		constraint.inverseMassB = world.simulated[b] / world.mass[b];
+
+		float totalInverseMass = constraint.inverseMassA + constraint.inverseMassB;
+		if (totalInverseMass <= 0.0f) {
+			continue;
+		}
+
+		constraint.key = (static_cast<uint64_t>(world.handleSlots[a]) << 32) | world.handleSlots[b];
+		constraint.normal = manifold.normal;
+		ComputeTangents(constraint.normal, constraint.tangents[0], constraint.tangents[1]);
+		constraint.effectiveMass = 1.0f / totalInverseMass;
+		constraint.friction = std::sqrt(world.colliders[a].friction * world.colliders[b].friction);
+
+		//Bounce fast collisions and push overlapping bodies apart over a few steps, whichever needs the bodies to separate faster
+		float normalSpeed = glm::dot(GetRelativeVelocity(world, constraint), constraint.normal);
+		float restitution = std::max(world.colliders[a].restitution, world.colliders[b].restitution);
+		float bounceSpeed = -normalSpeed > RESTING_SPEED ? -restitution * normalSpeed : 0.0f;
+		float pushSpeed = BAUMGARTE * std::max(manifold.GetMaxDepth() - PENETRATION_SLOP, 0.0f) / deltaTime;
+		constraint.targetSpeed = std::max(bounceSpeed, pushSpeed);
+
+		constraints.push_back(constraint);
+	}
+
+	//Start from last step's impulses, resting contacts need almost the same impulse every step so few iterations are needed.
+	//Applied once every constraint is built so the bounce speeds above are measured before any impulses change the velocities
+	if (!warmStarting) {
+		return;
+	}
+
+	for (size_t i = 0; i < constraints.size(); i++) {
+		ContactConstraint& constraint = constraints[i];
+
+		std::vector<ContactConstraint>::iterator previous = std::lower_bound(previousConstraints.begin(), previousConstraints.end(), constraint);
+		if (previous != previousConstraints.end() && previous->key == constraint.key) {
+			constraint.normalImpulse = previous->normalImpulse;
+			constraint.tangentImpulses[0] = previous->tangentImpulses[0];
+			constraint.tangentImpulses[1] = previous->tangentImpulses[1];
+
+			ApplyImpulse(world, constraint,
+				constraint.normal * constraint.normalImpulse +
+				constraint.tangents[0] * constraint.tangentImpulses[0] +
+				constraint.tangents[1] * constraint.tangentImpulses[1]);
+		}
+	}
+}
+
+void ContactSolver::Solve(PhysicsWorld& world)
+{
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		for (size_t i = 0; i < constraints.size(); i++) {
+			ContactConstraint& constraint = constraints[i];
+
+			//Friction first, limited by the normal impulse so it can never pull bodies along faster than they are pressed together
+			float maxFriction = constraint.friction * constraint.normalImpulse;
+			for (uint32_t j = 0; j < 2; j++) {
+				float tangentSpeed = glm::dot(GetRelativeVelocity(world, constraint), constraint.tangents[j]);
+				float previousImpulse = constraint.tangentImpulses[j];
+				constraint.tangentImpulses[j] = glm::clamp(previousImpulse - tangentSpeed * constraint.effectiveMass, -maxFriction, maxFriction);
+				ApplyImpulse(world, constraint, constraint.tangents[j] * (constraint.tangentImpulses[j] - previousImpulse));
+			}
+
+			//Contacts can only push, so the total normal impulse is kept positive while single iterations may pull some back
+			float normalSpeed = glm::dot(GetRelativeVelocity(world, constraint), constraint.normal);
+			float previousImpulse = constraint.normalImpulse;
+			constraint.normalImpulse = std::max(previousImpulse + (constraint.targetSpeed - normalSpeed) * constraint.effectiveMass, 0.0f);
+			ApplyImpulse(world, constraint, constraint.normal * (constraint.normalImpulse - previousImpulse));
+		}
+	}
+}
+
+void ContactSolver::StoreImpulses()
+{
+	std::swap(constraints, previousConstraints);
+	std::sort(previousConstraints.begin(), previousConstraints.end());
+}
+
+void ContactSolver::ApplyImpulse(PhysicsWorld& world, const ContactConstraint& constraint, glm::vec3 impulse)
+{
+	world.velocityX[constraint.a] -= impulse.x * constraint.inverseMassA;
+	world.velocityY[constraint.a] -= impulse.y * constraint.inverseMassA;
+	world.velocityZ[constraint.a] -= impulse.z * constraint.inverseMassA;
+	world.velocityX[constraint.b] += impulse.x * constraint.inverseMassB;
+	world.velocityY[constraint.b] += impulse.y * constraint.inverseMassB;
+	world.velocityZ[constraint.b] += impulse.z * constraint.inverseMassB;
+}
+
+glm::vec3 ContactSolver::GetRelativeVelocity(PhysicsWorld& world, const ContactConstraint& constraint)
+{
+	return glm::vec3(
+		world.velocityX[constraint.b] - world.velocityX[constraint.a],
+		world.velocityY[constraint.b] - world.velocityY[constraint.a],
+		world.velocityZ[constraint.b] - world.velocityZ[constraint.a]);
+}
+
+#pragma endregion
+
+#pragma region Snapshots
+
+void ContactSolver::SaveImpulses(BinaryStream& stream)
+{
+	stream.WriteVector(previousConstraints);
+}
+
+void ContactSolver::LoadImpulses(BinaryStream& stream)
+{
+	stream.ReadVector(previousConstraints);
+}
+
+#pragma endregion
@@ -0,0 +1,107 @@
+#pragma once
+#include "pch.h"
+
+#include "ContactConstraint.h"
+#include "ContactManifold.h"
+#include "BinaryStream.h"
+
+class PhysicsWorld;
+
+class ContactSolver
+{
+private:
+	//Contacts being solved this step and the previous step's contacts sorted by key, where warm starting looks up each contact's last impulse.
+	//The two are swapped at the end of every step
+	std::vector<ContactConstraint> constraints;
+	std::vector<ContactConstraint> previousConstraints;
+
+	uint32_t iterations = 8;
+	bool warmStarting = true;
+
+	/// <summary>
+	/// Applies an impulse along a direction to both bodies of a constraint
+	/// </summary>
+	/// <param name="world">The world the bodies belong to</param>
+	/// <param name="constraint">The constraint between the bodies</param>
+	/// <param name="impulse">The impulse to apply, pushes b along the direction and a against it</param>
+	static void ApplyImpulse(PhysicsWorld& world, const ContactConstraint& constraint, glm::vec3 impulse);
+
+	/// <summary>
+	/// Returns the velocity of b relative to a
+	/// </summary>
+	/// <param name="world">The world the bodies belong to</param>
+	/// <param name="constraint">The constraint between the bodies</param>
+	/// <returns>The relative velocity</returns>
+	static glm::vec3 GetRelativeVelocity(PhysicsWorld& world, const ContactConstraint& constraint);
+
+public:
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the number of times every contact is solved each step
+	/// </summary>
+	/// <returns>The number of velocity iterations</returns>
+	uint32_t GetIterations();
+
+	/// <summary>
+	/// Sets the number of times every contact is solved each step, more iterations make tall stacks stiffer
+	/// </summary>
+	/// <param name="value">The number of velocity iterations</param>
+	void SetIterations(uint32_t value);
+
+	/// <summary>
+	/// Returns whether contacts start from the impulses found for them on the previous step
+	/// </summary>
+	/// <returns>True if warm starting is enabled</returns>
+	bool GetWarmStarting();
+
+	/// <summary>
+	/// Sets whether contacts start from the impulses found for them on the previous step
+	/// </summary>
+	/// <param name="value">Whether to warm start</param>
+	void SetWarmStarting(bool value);
+
+#pragma endregion
+
+#pragma region Solving
+
+	/// <summary>
+	/// Builds a constraint for every colliding pair and applies the impulses carried over from the previous step.
+	/// The caller must hold the world's mutex
+	/// </summary>
+	/// <param name="world">The world the bodies belong to</param>
+	/// <param name="manifolds">The contact of each candidate pair</param>
+	/// <param name="results">Whether each candidate pair is colliding and should be solved</param>
+	/// <param name="count">The number of candidate pairs</param>
+	/// <param name="deltaTime">The length of the step</param>
+	void Prepare(PhysicsWorld& world, const ContactManifold* manifolds, const uint8_t* results, uint32_t count, float deltaTime);
+
+	/// <summary>
+	/// Repeatedly applies friction and normal impulses to every constraint until the bodies stop moving into each other
+	/// </summary>
+	/// <param name="world">The world the bodies belong to</param>
+	void Solve(PhysicsWorld& world);
+
+	/// <summary>
+	/// Keeps the accumulated impulses so the next step can be warm started from them
+	/// </summary>
+	void StoreImpulses();
+
+#pragma endregion
+
+#pragma region Snapshots
+
+	/// <summary>
+	/// Writes the impulses kept for warm starting the next step, a snapshot without them would not continue the simulation exactly
+	/// </summary>
+	/// <param name="stream">The stream to write to</param>
+	void SaveImpulses(BinaryStream& stream);
+
+	/// <summary>
+	/// Replaces the impulses kept for warm starting the next step with ones written by SaveImpulses
+	/// </summary>
+	/// <param name="stream">The stream to read from</param>
+	void LoadImpulses(BinaryStream& stream);
+
+#pragma endregion
+};
@@ -14,6 +14,10 @@ namespace Controls {
 		LeftClick,
 		RightClick,
 		ToggleDebug,
+		SpawnPyramid,
+		RaycastBenchmark,
+		InstanceBenchmark,
+		ProjectileBenchmark,
 		ControlCount
 	};
 
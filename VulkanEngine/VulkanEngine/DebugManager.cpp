@@ -4,6 +4,7 @@
 #include "EntityManager.h"
 #include "InputManager.h"
 #include "VulkanManager.h"
+#include "SwapChain.h"
 
 #pragma region Proxy Functions
 
@@ -66,8 +67,7 @@ void DebugManager::Init()
 
 	for (int i = 0; i < debugMeshes.size(); i++) {
 		debugShapes.insert(std::pair<std::shared_ptr<Mesh>, std::vector<std::shared_ptr<DebugShape>>>(debugMeshes[i], std::vector<std::shared_ptr<DebugShape>>()));
-		instanceBuffers.insert(std::pair<std::shared_ptr<Mesh>, std::shared_ptr<Buffer>>(debugMeshes[i], nullptr));
-		instanceBufferDirty.insert(std::pair<std::shared_ptr<Mesh>, bool>(debugMeshes[i], true));
+		instanceBuffers.insert(std::pair<std::shared_ptr<Mesh>, std::shared_ptr<InstanceBuffer>>(debugMeshes[i], nullptr));
 	}
 #endif
 }
@@ -75,7 +75,7 @@ void DebugManager::Init()
 void DebugManager::Cleanup()
 {
 #ifdef DEBUG
-	for (std::pair<std::shared_ptr<Mesh>, std::shared_ptr<Buffer>> pair : instanceBuffers) {
+	for (const std::pair<const std::shared_ptr<Mesh>, std::shared_ptr<InstanceBuffer>>& pair : instanceBuffers) {
 		if (pair.second != nullptr) {
 			pair.second->Cleanup();
 		}
@@ -85,7 +85,7 @@ void DebugManager::Cleanup()
 
 	if (enableValidationLayers) {
 		// The ifdef was not working so I moved code here.  Validation error fixed
-		for (std::pair<std::shared_ptr<Mesh>, std::shared_ptr<Buffer>> pair : instanceBuffers) {
+		for (const std::pair<const std::shared_ptr<Mesh>, std::shared_ptr<InstanceBuffer>>& pair : instanceBuffers) {
 			if (pair.second != nullptr) {
 				pair.second->Cleanup();
 			}
@@ -104,16 +104,18 @@ bool DebugManager::GetEnableValidationLayers()
 	return enableValidationLayers;
 }
 
-std::vector<const char*> DebugManager::GetValidationLayers()
+const std::vector<const char*>& DebugManager::GetValidationLayers()
 {
+	static const std::vector<const char*> NO_LAYERS;
+
 	if (enableValidationLayers) {
 		return validationLayers;
 	}
 
-	return {};
+	return NO_LAYERS;
 }
 
-std::map<std::shared_ptr<Mesh>, std::shared_ptr<Buffer>> DebugManager::GetInstanceBuffers()
+const std::map<std::shared_ptr<Mesh>, std::shared_ptr<InstanceBuffer>>& DebugManager::GetInstanceBuffers()
 {
 	return instanceBuffers;
 }
@@ -127,60 +129,31 @@ bool DebugManager::GetDrawHandles()
 
 #pragma region DebugShapes
 
-void DebugManager::CreateInstanceBuffer(std::shared_ptr<Mesh> mesh)
+void DebugManager::CreateInstanceBuffer(const std::shared_ptr<Mesh>& mesh)
 {
 	if (enableValidationLayers)
 	{
-		//Create buffer
-		VkDeviceSize bufferSize = sizeof(glm::vec3);
-		instanceBuffers[mesh] = std::make_shared<Buffer>(VkBuffer(), VkDeviceMemory());
-		Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, *instanceBuffers[mesh]);
+		//Create one persistently mapped buffer per frame in flight
+		instanceBuffers[mesh] = std::make_shared<InstanceBuffer>(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+		instanceBuffers[mesh]->Init(sizeof(glm::vec3));
 
 		//Data will be added to the buffer in UpdateInstanceBuffer method once we have data to add
 	}
 }
 
-void DebugManager::UpdateInstanceBuffer(std::shared_ptr<Mesh> mesh)
+void DebugManager::UpdateInstanceBuffer(const std::shared_ptr<Mesh>& mesh)
 {
 	if (enableValidationLayers)
 	{
-		//If a new object has been spawned or deleted the instance buffer must be re-created to the correct size
-		if (instanceBufferDirty[mesh]) {
-			vkQueueWaitIdle(VulkanManager::GetInstance()->GetGraphicsQueue());
-			instanceBuffers[mesh]->Cleanup();
-			instanceBuffers[mesh] = std::make_shared<Buffer>(VkBuffer(), VkDeviceMemory());
-		}
+		//Write the color data straight into the mapped memory of the current frame, each color goes wherever the mesh moved its instance to
+		std::vector<std::shared_ptr<DebugShape>>& shapes = debugShapes[mesh];
+		glm::vec3* data = static_cast<glm::vec3*>(instanceBuffers[mesh]->Map(SwapChain::GetInstance()->GetCurrentFrame(), sizeof(glm::vec3) * mesh->GetActiveInstanceCount()));
 
-		//Get Color data
-		std::vector<glm::vec3> bufferData;
-
-		for (size_t i = 0; i < debugShapes[mesh].size(); i++) {
-			if (debugShapes[mesh][i] != nullptr) {
-				bufferData.push_back(debugShapes[mesh][i]->color);
+		for (size_t i = 0; i < shapes.size(); i++) {
+			if (shapes[i] != nullptr) {
+				data[mesh->GetInstanceIndex(shapes[i]->meshID)] = shapes[i]->color;
 			}
 		}
-
-		//Ensure that buffer size is not 0
-		VkDeviceSize bufferSize;
-		if (bufferData.size() > 0) {
-			bufferSize = sizeof(glm::vec3) * bufferData.size();
-		}
-		else {
-			bufferData.push_back(glm::vec3(0, 0, 0));
-			bufferSize = sizeof(glm::vec3);
-		}
-
-		//Create the buffer if necessary
-		if (instanceBufferDirty[mesh]) {
-			Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, *instanceBuffers[mesh]);
-		}
-		//Copy Data
-		void* data;
-		vkMapMemory(VulkanManager::GetInstance()->GetLogicalDevice(), instanceBuffers[mesh]->GetBufferMemory(), 0, bufferSize, 0, &data);
-		memcpy(data, bufferData.data(), bufferSize);
-		vkUnmapMemory(VulkanManager::GetInstance()->GetLogicalDevice(), instanceBuffers[mesh]->GetBufferMemory());
-
-		instanceBufferDirty[mesh] = false;
 	}
 }
 
@@ -188,12 +161,14 @@ void DebugManager::DrawWireSphere(glm::vec3 position, glm::vec3 color, float rad
 {
 	if (enableValidationLayers)
 	{
-		std::shared_ptr<Mesh> mesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::WireSphere];
+		const std::shared_ptr<Mesh>& mesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::WireSphere];
 
 		std::shared_ptr<DebugShape> shape = std::make_shared<DebugShape>();
 		shape->transform = std::make_shared<Transform>(position, glm::quat(glm::vec3(0.0f, 0.0f, 0.0f)), glm::vec3(radius / 0.5f, radius / 0.5f, radius / 0.5f));
 		shape->color = color;
 		shape->duration = duration;
+
+		std::lock_guard<std::mutex> lock(shapeMutex);
 		shape->meshID = mesh->AddInstance(shape->transform);
 
 		AddShape(mesh, shape);
@@ -208,12 +183,14 @@ void DebugManager::DrawWireCube(glm::vec3 position, glm::vec3 color, glm::vec3 s
 {
 	if (enableValidationLayers)
 	{
-		std::shared_ptr<Mesh> mesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::WireCube];
+		const std::shared_ptr<Mesh>& mesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::WireCube];
 
 		std::shared_ptr<DebugShape> shape = std::make_shared<DebugShape>();
 		shape->transform = std::make_shared<Transform>(position, glm::quat(glm::vec3(0.0f, 0.0f, 0.0f)), size);
 		shape->color = color;
 		shape->duration = duration;
+
+		std::lock_guard<std::mutex> lock(shapeMutex);
 		shape->meshID = mesh->AddInstance(shape->transform);
 
 		AddShape(mesh, shape);
@@ -228,7 +205,7 @@ void DebugManager::DrawLine(glm::vec3 position1, glm::vec3 position2, glm::vec3
 {
 	if (enableValidationLayers)
 	{
-		std::shared_ptr<Mesh> mesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::Line];
+		const std::shared_ptr<Mesh>& mesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::Line];
 
 		std::shared_ptr<DebugShape> shape = std::make_shared<DebugShape>();
 		float length = glm::distance(position1, position2);
@@ -247,6 +224,8 @@ void DebugManager::DrawLine(glm::vec3 position1, glm::vec3 position2, glm::vec3
 		shape->transform = std::make_shared<Transform>(position1, orientation, glm::vec3(1.0f, 1.0f, 1.0f) * length);
 		shape->color = color;
 		shape->duration = duration;
+
+		std::lock_guard<std::mutex> lock(shapeMutex);
 		shape->meshID = mesh->AddInstance(shape->transform);
 
 		AddShape(mesh, shape);
@@ -257,22 +236,19 @@ void DebugManager::DrawLine(glm::vec3 position1, glm::vec3 position2, glm::vec3
 	}
 }
 
-void DebugManager::RemoveShape(std::shared_ptr<Mesh> mesh, int index)
+void DebugManager::RemoveShape(const std::shared_ptr<Mesh>& mesh, int index)
 {
 	if (enableValidationLayers)
 	{
-		instanceBufferDirty[mesh] = true;
 		mesh->RemoveInstance(debugShapes[mesh][index]->meshID);
 		debugShapes[mesh][index] = nullptr;
 	}
 }
 
-void DebugManager::AddShape(std::shared_ptr<Mesh> mesh, std::shared_ptr<DebugShape> shape)
+void DebugManager::AddShape(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<DebugShape>& shape)
 {
 	if (enableValidationLayers)
 	{
-		instanceBufferDirty[mesh] = true;
-
 		for (size_t i = 0; i < debugShapes[mesh].size(); i++) {
 			if (debugShapes[mesh][i] == nullptr) {
 				debugShapes[mesh][i] = shape;
@@ -296,7 +272,7 @@ void DebugManager::Update()
 			drawHandles = !drawHandles;
 		}
 
-		for (std::pair<std::shared_ptr<Mesh>, std::vector<std::shared_ptr<DebugShape>>> pair : debugShapes) {
+		for (std::pair<const std::shared_ptr<Mesh>, std::vector<std::shared_ptr<DebugShape>>>& pair : debugShapes) {
 			for (int i = 0; i < pair.second.size(); i++) {
 				if (pair.second[i] == nullptr) {
 					continue;
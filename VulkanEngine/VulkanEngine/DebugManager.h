@@ -2,7 +2,9 @@
 #include "pch.h"
 
 #include "Mesh.h"
-#include "Buffer.h"
+#include "InstanceBuffer.h"
+
+#include <mutex>
 
 class DebugManager
 {
@@ -17,9 +19,11 @@ private:
 	};
 
 	std::map<std::shared_ptr<Mesh>, std::vector<std::shared_ptr<DebugShape>>> debugShapes;
-	std::map<std::shared_ptr<Mesh>, std::shared_ptr<Buffer>> instanceBuffers;
-	std::map<std::shared_ptr<Mesh>, bool> instanceBufferDirty;
+	std::map<std::shared_ptr<Mesh>, std::shared_ptr<InstanceBuffer>> instanceBuffers;
 	bool drawHandles = false;
+
+	//Shapes can be drawn from job system threads
+	std::mutex shapeMutex;
 	
 #ifdef NDEBUG
 	const bool enableValidationLayers = false;
@@ -64,13 +68,13 @@ public:
 	/// Returns the currently enabled validation layers
 	/// </summary>
 	/// <returns>The currently enabled validation layers</returns>
-	std::vector<const char*> GetValidationLayers();
+	const std::vector<const char*>& GetValidationLayers();
 
 	/// <summary>
 	/// Returns the instance buffer map used by the debug shapes
 	/// </summary>
 	/// <returns>The instance buffer map</returns>
-	std::map<std::shared_ptr<Mesh>, std::shared_ptr<Buffer>> GetInstanceBuffers();
+	const std::map<std::shared_ptr<Mesh>, std::shared_ptr<InstanceBuffer>>& GetInstanceBuffers();
 
 	/// <summary>
 	/// Returns whether or not to draw handles
@@ -86,13 +90,13 @@ public:
 	/// Creates the instance buffer for the specified mesh
 	/// </summary>
 	/// <param name="mesh">The mesh to make an instance buffer for</param>
-	void CreateInstanceBuffer(std::shared_ptr<Mesh> mesh);
+	void CreateInstanceBuffer(const std::shared_ptr<Mesh>& mesh);
 
 	/// <summary>
-	/// Update the instance buffer of the mesh
+	/// Writes the debug shape colors of the mesh into the instance buffer of the current frame in flight
 	/// </summary>
 	/// <param name="mesh">The mesh to update the instance buffer</param>
-	void UpdateInstanceBuffer(std::shared_ptr<Mesh> mesh);
+	void UpdateInstanceBuffer(const std::shared_ptr<Mesh>& mesh);
 
 	/// <summary>
 	/// Draws a wireframe sphere at the specified location
@@ -126,14 +130,14 @@ public:
 	/// </summary>
 	/// <param name="mesh">The mesh used by the shape</param>
 	/// <param name="index">The index of the shape to remove</param>
-	void RemoveShape(std::shared_ptr<Mesh> mesh, int index);
+	void RemoveShape(const std::shared_ptr<Mesh>& mesh, int index);
 
 	/// <summary>
 	/// Adds a debug shape the the list for the specified mesh
 	/// </summary>
 	/// <param name="mesh">The mesh to add the shape to</param>
 	/// <param name="shape">The shape to add</param>
-	void AddShape(std::shared_ptr<Mesh> mesh, std::shared_ptr<DebugShape> shape);
+	void AddShape(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<DebugShape>& shape);
 
 #pragma endregion
 
@@ -0,0 +1,13 @@
+#pragma once
+#include "pch.h"
+
+struct DrawCommands {
+public:
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+
+	//Handles and counts the commands were recorded with, the commands are re-recorded when these change
+	std::vector<uint64_t> signature;
+
+	//How long the commands took to record in milliseconds
+	float recordTime = 0.0f;
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include "pch.h"
+
+struct DrawStats {
+public:
+	//Time spent recording the frame's command buffers in milliseconds
+	float recordTime = 0.0f;
+
+	//Time the reused secondary command buffers took the last time they were recorded
+	float savedTime = 0.0f;
+
+	uint32_t recordedCount = 0;
+	uint32_t reusedCount = 0;
+
+	//Number of chunks the materials were split into for recording
+	uint32_t threadCount = 0;
+};
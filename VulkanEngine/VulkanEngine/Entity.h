@@ -0,0 +1,19 @@
+#pragma once
+#include "pch.h"
+
+struct Entity {
+public:
+	//Slot in the entity registry, reused once the entity is destroyed
+	uint32_t index = UINT32_MAX;
+
+	//Must match the slot's generation, entities that were destroyed stop matching when their slot is reused
+	uint32_t generation = 0;
+
+	bool operator==(const Entity& other) const {
+		return index == other.index && generation == other.generation;
+	}
+
+	bool operator!=(const Entity& other) const {
+		return !(*this == other);
+	}
+};
@@ -5,6 +5,8 @@
 #include "VulkanManager.h"
 #include "SwapChain.h"
 #include "Image.h"
+#include "JobSystem.h"
+#include "SceneGraph.h"
 #pragma region Singleton
 
 EntityManager* EntityManager::instance = nullptr;
@@ -22,16 +24,40 @@ EntityManager* EntityManager::GetInstance()
 
 #pragma region Accessors
 
-std::vector<std::shared_ptr<Material>> EntityManager::GetMaterials()
+const std::vector<std::shared_ptr<Material>>& EntityManager::GetMaterials()
 {
     return materials;
 }
 
-std::vector<std::shared_ptr<Mesh>> EntityManager::GetMeshes()
+const std::vector<std::shared_ptr<Mesh>>& EntityManager::GetMeshes()
 {
     return meshes;
 }
 
+DrawStats EntityManager::GetDrawStats()
+{
+    return drawStats;
+}
+
+VkDeviceSize EntityManager::GetUploadedInstanceBytes()
+{
+    return uploadedInstanceBytes;
+}
+
+InstanceFormats EntityManager::GetInstanceFormat()
+{
+    return instanceFormat;
+}
+
+void EntityManager::SetInstanceFormat(InstanceFormats value)
+{
+    if (materials.size() > 0) {
+        throw std::runtime_error("Instance format can't be changed after the entity manager is initialized!");
+    }
+
+    instanceFormat = value;
+}
+
 #pragma endregion
 
 #pragma region Initialization
@@ -65,6 +91,7 @@ void EntityManager::LoadMeshes()
 
     meshes[MeshTypes::Plane] = std::make_shared<Mesh>(materials[0]);
     meshes[MeshTypes::Plane]->GeneratePlane();
+    meshes[MeshTypes::Plane]->SetStaticInstances(true);
 
     meshes[MeshTypes::Cube] = std::make_shared<Mesh>(materials[1]);
     meshes[MeshTypes::Cube]->GenerateCube();
@@ -74,6 +101,7 @@ void EntityManager::LoadMeshes()
     
     meshes[MeshTypes::Model] = std::make_shared<Mesh>(materials[1]);
     meshes[MeshTypes::Model]->LoadModel("models/room.obj");
+    meshes[MeshTypes::Model]->SetStaticInstances(true);
 
     meshes[MeshTypes::Skybox] = std::make_shared<Mesh>(materials[2]);
     meshes[MeshTypes::Skybox]->GenerateCube();
@@ -86,6 +114,11 @@ void EntityManager::LoadMeshes()
 
     meshes[MeshTypes::Line] = std::make_shared<Mesh>(materials[3]);
     meshes[MeshTypes::Line]->GenerateLine(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f));
+
+    //Every material's vertex shader was built for the same instance format
+    for (std::shared_ptr<Mesh> mesh : meshes) {
+        mesh->SetInstanceFormat(instanceFormat);
+    }
 }
 
 void EntityManager::LoadMaterials()
@@ -93,15 +126,34 @@ void EntityManager::LoadMaterials()
     
     std::vector<std::vector<VkVertexInputAttributeDescription>> attributeDescriptions;
     attributeDescriptions.push_back(Vertex::GetAttributeDescriptions(0, 0));
-    attributeDescriptions.push_back(TransformData::GetAttributeDescriptions(attributeDescriptions[0].size(), 1));
 
     std::vector<VkVertexInputBindingDescription> bindingDescriptions;
     bindingDescriptions.push_back(Vertex::GetBindingDescription(0));
-    bindingDescriptions.push_back(TransformData::GetBindingDescription(bindingDescriptions.size()));
 
-    materials.push_back(std::make_shared<Material>("shaders/vert.spv", "shaders/frag.spv", false, attributeDescriptions, bindingDescriptions, "textures/frog.jpg"));
-    materials.push_back(std::make_shared<Material>("shaders/vert.spv", "shaders/frag.spv", false, attributeDescriptions, bindingDescriptions, "textures/room.png"));
-    materials.push_back(std::make_shared<Material>("shaders/SkyVert.spv", "shaders/SkyFrag.spv", false, attributeDescriptions, bindingDescriptions, "textures/Skybox/", 'S'));
+    //Each instance format has its own build of the vertex shaders, see compile.bat
+    std::string variant;
+    switch (instanceFormat) {
+        case MatrixInstanceFormat:
+            attributeDescriptions.push_back(TransformData::GetAttributeDescriptions(attributeDescriptions[0].size(), 1));
+            bindingDescriptions.push_back(TransformData::GetBindingDescription(bindingDescriptions.size()));
+            break;
+        case AffineInstanceFormat:
+            attributeDescriptions.push_back(AffineTransformData::GetAttributeDescriptions(attributeDescriptions[0].size(), 1));
+            bindingDescriptions.push_back(AffineTransformData::GetBindingDescription(bindingDescriptions.size()));
+            variant = "Affine";
+            break;
+        case CompactInstanceFormat:
+            attributeDescriptions.push_back(CompactTransformData::GetAttributeDescriptions(attributeDescriptions[0].size(), 1));
+            bindingDescriptions.push_back(CompactTransformData::GetBindingDescription(bindingDescriptions.size()));
+            variant = "Compact";
+            break;
+        default:
+            throw std::runtime_error("Unknown instance format!");
+    }
+
+    materials.push_back(std::make_shared<Material>("shaders/vert" + variant + ".spv", "shaders/frag.spv", false, attributeDescriptions, bindingDescriptions, "textures/frog.jpg"));
+    materials.push_back(std::make_shared<Material>("shaders/vert" + variant + ".spv", "shaders/frag.spv", false, attributeDescriptions, bindingDescriptions, "textures/room.png"));
+    materials.push_back(std::make_shared<Material>("shaders/SkyVert" + variant + ".spv", "shaders/SkyFrag.spv", false, attributeDescriptions, bindingDescriptions, "textures/Skybox/", 'S'));
 
     //TODO: Find a better way of doing this that will work for multiple types of inputs
     std::vector<VkVertexInputAttributeDescription> attributeDescription(1);
@@ -116,7 +168,7 @@ void EntityManager::LoadMaterials()
     bindingDescription.stride = sizeof(glm::vec3);
     bindingDescription.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
     bindingDescriptions.push_back(bindingDescription);
-    materials.push_back(std::make_shared<Material>("shaders/DebugVert.spv", "shaders/DebugFrag.spv", true, attributeDescriptions, bindingDescriptions, "textures/room.png"));
+    materials.push_back(std::make_shared<Material>("shaders/DebugVert" + variant + ".spv", "shaders/DebugFrag.spv", true, attributeDescriptions, bindingDescriptions, "textures/room.png"));
 }
 
 #pragma endregion
@@ -125,22 +177,97 @@ void EntityManager::LoadMaterials()
 
 void EntityManager::Update()
 {
-    for (std::shared_ptr<Mesh> mesh : meshes) {
-        if (mesh->GetActiveInstanceCount() > 0)
-            mesh->UpdateInstanceBuffer();
+    //World matrices of attached transforms have to be ready before the meshes pack them
+    SceneGraph::GetInstance()->Update();
+
+    //Every mesh packs into its own instance buffer so meshes can be packed in parallel
+    JobSystem::GetInstance()->ParallelFor(static_cast<uint32_t>(meshes.size()), [this](uint32_t i) {
+        if (meshes[i]->GetActiveInstanceCount() > 0 && !meshes[i]->GetStaticInstances())
+            meshes[i]->UpdateInstanceBuffer();
+    });
+
+    //Static meshes upload through the upload manager, which can only be used from one thread
+    uploadedInstanceBytes = 0;
+    for (size_t i = 0; i < meshes.size(); i++) {
+        if (meshes[i]->GetActiveInstanceCount() > 0) {
+            if (meshes[i]->GetStaticInstances()) {
+                meshes[i]->UpdateInstanceBuffer();
+            }
+
+            uploadedInstanceBytes += meshes[i]->GetUploadedBytes();
+        }
     }
 }
 
 void EntityManager::Draw(uint32_t imageIndex, VkCommandBuffer* commandBuffer)
 {
-    if (vkResetCommandBuffer(*commandBuffer, VK_COMMAND_BUFFER_RESET_RELEASE_RESOURCES_BIT) != VK_SUCCESS) {
+    std::chrono::steady_clock::time_point recordStart = std::chrono::steady_clock::now();
+    uint32_t currentFrame = SwapChain::GetInstance()->GetCurrentFrame();
+
+    if (drawCommands.empty()) {
+        AllocateDrawCommands();
+    }
+
+    //Snapshot the debug color buffers so the recording threads don't touch the debug manager
+    debugInstanceBuffers.clear();
+    for (const std::pair<const std::shared_ptr<Mesh>, std::shared_ptr<InstanceBuffer>>& debugBuffer : DebugManager::GetInstance()->GetInstanceBuffers()) {
+        if (debugBuffer.second != nullptr) {
+            debugInstanceBuffers.push_back(debugBuffer);
+        }
+    }
+
+    //Each chunk owns a command pool so materials are split between chunks the same way they were allocated,
+    //re-recording only the materials whose meshes, instance counts or buffers changed since they were last recorded
+    chunkStats.assign(recordChunkCount, DrawStats());
+    chunkSignatures.resize(recordChunkCount);
+    JobSystem::GetInstance()->ParallelFor(recordChunkCount, [this, imageIndex, currentFrame](uint32_t chunk) {
+        std::vector<uint64_t>& signature = chunkSignatures[chunk];
+
+        for (size_t i = chunk; i < materials.size(); i += recordChunkCount) {
+            DrawCommands& commands = drawCommands[currentFrame][imageIndex][i];
+            GetDrawSignature(materials[i], imageIndex, currentFrame, signature);
+
+            if (signature.empty()) {
+                commands.signature.clear();
+            }
+            else if (signature != commands.signature) {
+                std::chrono::steady_clock::time_point materialStart = std::chrono::steady_clock::now();
+                RecordMaterial(materials[i], imageIndex, currentFrame, commands.commandBuffer);
+                commands.recordTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - materialStart).count();
+                commands.signature = signature;
+                chunkStats[chunk].recordedCount++;
+            }
+            else {
+                chunkStats[chunk].savedTime += commands.recordTime;
+                chunkStats[chunk].reusedCount++;
+            }
+        }
+    });
+
+    //Stitch the secondary command buffers together in material order regardless of which thread recorded them
+    drawStats = DrawStats();
+    drawStats.threadCount = recordChunkCount;
+    for (const DrawStats& stats : chunkStats) {
+        drawStats.recordedCount += stats.recordedCount;
+        drawStats.reusedCount += stats.reusedCount;
+        drawStats.savedTime += stats.savedTime;
+    }
+
+    secondaryCommandBuffers.clear();
+    for (size_t i = 0; i < materials.size(); i++) {
+        if (!drawCommands[currentFrame][imageIndex][i].signature.empty()) {
+            secondaryCommandBuffers.push_back(drawCommands[currentFrame][imageIndex][i].commandBuffer);
+        }
+    }
+
+    if (vkResetCommandBuffer(*commandBuffer, 0) != VK_SUCCESS) {
         throw std::runtime_error("Failed to reset command buffer!");
     }
 
     //Setup command
     VkCommandBufferBeginInfo beginInfo = {};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = 0;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
     beginInfo.pInheritanceInfo = nullptr;
 
     if (vkBeginCommandBuffer(*commandBuffer, &beginInfo) != VK_SUCCESS) {
@@ -162,45 +289,122 @@ void EntityManager::Draw(uint32_t imageIndex, VkCommandBuffer* commandBuffer)
     renderPassBeginInfo.clearValueCount = static_cast<uint32_t>(clearColors.size());
     renderPassBeginInfo.pClearValues = clearColors.data();
 
-    //Setup commands
-    vkCmdBeginRenderPass(*commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    //The render pass contents come entirely from the per material secondary command buffers
+    vkCmdBeginRenderPass(*commandBuffer, &renderPassBeginInfo, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
 
-    //Begin Per Material Commands
-    for (std::shared_ptr<Material> material : materials) {
-        vkCmdBindPipeline(*commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, material->GetPipeline());//Per material
-
-        vkCmdBindDescriptorSets(*commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, material->GetPipelineLayout(), 0, 1, &material->GetDescriptorSets()[imageIndex], 0, nullptr);//Per Material
-
-        //Begin Per Mesh Commands
-        for (std::shared_ptr<Mesh> mesh : entities[material]) {
-            if (mesh->GetActiveInstanceCount() > 0) {
-                //TODO: Make sure this changes based on the attributes used by the current material
-                VkBuffer vertexBuffers[] = { mesh->GetVertexBuffer()->GetBuffer() };
-                VkDeviceSize offsets[] = { 0 };
-                vkCmdBindVertexBuffers(*commandBuffer, 0, 1, vertexBuffers, offsets);//Per mesh
-
-                VkBuffer instanceBuffers[] = { mesh->GetInstanceBuffer()->GetBuffer() };
-                vkCmdBindVertexBuffers(*commandBuffer, 1, 1, instanceBuffers, offsets);//Per mesh
-
-                //Add the color instance buffer only for the debug shapes
-                VkBuffer colorBuffer[1];
-                if (DebugManager::GetInstance()->GetInstanceBuffers().count(mesh) != 0) {
-                     colorBuffer[0] = DebugManager::GetInstance()->GetInstanceBuffers()[mesh]->GetBuffer();
-                    vkCmdBindVertexBuffers(*commandBuffer, 2, 1, colorBuffer, offsets);
-                }
+    if (!secondaryCommandBuffers.empty()) {
+        vkCmdExecuteCommands(*commandBuffer, static_cast<uint32_t>(secondaryCommandBuffers.size()), secondaryCommandBuffers.data());
+    }
 
-                VkBuffer indexBuffers[] = { mesh->GetIndexBuffer()->GetBuffer() };
-                vkCmdBindIndexBuffer(*commandBuffer, mesh->GetIndexBuffer()->GetBuffer(), 0, VK_INDEX_TYPE_UINT16);//Per mesh
+    vkCmdEndRenderPass(*commandBuffer);
 
-                vkCmdDrawIndexed(*commandBuffer, static_cast<uint32_t>(mesh->GetIndices().size()), mesh->GetActiveInstanceCount(), 0, 0, 0);//Per mesh
+    if (vkEndCommandBuffer(*commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to end Command Buffer!");
+    }
+
+    drawStats.recordTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - recordStart).count();
+}
+
+void EntityManager::GetDrawSignature(const std::shared_ptr<Material>& material, uint32_t imageIndex, uint32_t frame, std::vector<uint64_t>& signature)
+{
+    signature.clear();
+
+    for (const std::shared_ptr<Mesh>& mesh : entities.at(material)) {
+        if (mesh->GetActiveInstanceCount() > 0) {
+            //Instance buffers grow by being re-created, a new buffer can reuse the old handle so the generation is tracked too
+            uint64_t colorBuffer = 0;
+            uint64_t colorGeneration = 0;
+            InstanceBuffer* colorInstanceBuffer = GetDebugColorBuffer(mesh);
+            if (colorInstanceBuffer != nullptr) {
+                colorBuffer = (uint64_t)colorInstanceBuffer->GetBuffer(frame);
+                colorGeneration = colorInstanceBuffer->GetGeneration();
             }
+
+            signature.push_back((uint64_t)mesh->GetVertexBuffer()->GetBuffer());
+            signature.push_back((uint64_t)mesh->GetIndexBuffer()->GetBuffer());
+            signature.push_back((uint64_t)mesh->GetInstanceBuffer()->GetBuffer(frame));
+            signature.push_back(mesh->GetInstanceBuffer()->GetGeneration());
+            signature.push_back(colorBuffer);
+            signature.push_back(colorGeneration);
+            signature.push_back(mesh->GetIndices().size());
+            signature.push_back(mesh->GetActiveInstanceCount());
         }
     }
 
-    vkCmdEndRenderPass(*commandBuffer);
+    //Nothing to draw so the material doesn't need to be bound either
+    if (signature.empty()) {
+        return;
+    }
 
-    if (vkEndCommandBuffer(*commandBuffer) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to end Command Buffer!");
+    //Swap chain resources that are re-created when the window is resized
+    signature.push_back((uint64_t)material->GetPipeline());
+    signature.push_back((uint64_t)material->GetDescriptorSets()[imageIndex]);
+    signature.push_back((uint64_t)SwapChain::GetInstance()->GetRenderPass());
+    signature.push_back((uint64_t)SwapChain::GetInstance()->GetFrameBuffers()[imageIndex]);
+}
+
+InstanceBuffer* EntityManager::GetDebugColorBuffer(const std::shared_ptr<Mesh>& mesh)
+{
+    //Only the few debug meshes have color buffers so a linear search beats hashing
+    for (size_t i = 0; i < debugInstanceBuffers.size(); i++) {
+        if (debugInstanceBuffers[i].first == mesh) {
+            return debugInstanceBuffers[i].second.get();
+        }
+    }
+
+    return nullptr;
+}
+
+void EntityManager::RecordMaterial(const std::shared_ptr<Material>& material, uint32_t imageIndex, uint32_t frame, VkCommandBuffer commandBuffer)
+{
+    //Secondary command buffers continue the primary buffer's render pass
+    VkCommandBufferInheritanceInfo inheritanceInfo = {};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = SwapChain::GetInstance()->GetRenderPass();
+    inheritanceInfo.subpass = 0;
+    inheritanceInfo.framebuffer = SwapChain::GetInstance()->GetFrameBuffers()[imageIndex];
+
+    VkCommandBufferBeginInfo beginInfo = {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to begin recording secondary Command Buffer!");
+    }
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, material->GetPipeline());//Per material
+
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, material->GetPipelineLayout(), 0, 1, &material->GetDescriptorSets()[imageIndex], 0, nullptr);//Per Material
+
+    //Begin Per Mesh Commands
+    for (const std::shared_ptr<Mesh>& mesh : entities.at(material)) {
+        if (mesh->GetActiveInstanceCount() > 0) {
+            //TODO: Make sure this changes based on the attributes used by the current material
+            VkBuffer vertexBuffers[] = { mesh->GetVertexBuffer()->GetBuffer() };
+            VkDeviceSize offsets[] = { 0 };
+            vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);//Per mesh
+
+            //Bind the instance buffers that are written for this frame in flight
+            VkBuffer instanceBuffers[] = { mesh->GetInstanceBuffer()->GetBuffer(frame) };
+            vkCmdBindVertexBuffers(commandBuffer, 1, 1, instanceBuffers, offsets);//Per mesh
+
+            //Add the color instance buffer only for the debug shapes
+            VkBuffer colorBuffer[1];
+            InstanceBuffer* debugBuffer = GetDebugColorBuffer(mesh);
+            if (debugBuffer != nullptr) {
+                colorBuffer[0] = debugBuffer->GetBuffer(frame);
+                vkCmdBindVertexBuffers(commandBuffer, 2, 1, colorBuffer, offsets);
+            }
+
+            vkCmdBindIndexBuffer(commandBuffer, mesh->GetIndexBuffer()->GetBuffer(), 0, VK_INDEX_TYPE_UINT16);//Per mesh
+
+            vkCmdDrawIndexed(commandBuffer, static_cast<uint32_t>(mesh->GetIndices().size()), mesh->GetActiveInstanceCount(), 0, 0, 0);//Per mesh
+        }
+    }
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to end secondary Command Buffer!");
     }
 }
 
@@ -245,5 +449,63 @@ void EntityManager::CleanupMeshes()
     }
 }
 
+void EntityManager::AllocateDrawCommands()
+{
+    VkDevice logicalDevice = VulkanManager::GetInstance()->GetLogicalDevice();
+    uint32_t imageCount = static_cast<uint32_t>(SwapChain::GetInstance()->GetFrameBuffers().size());
+    recordChunkCount = std::max(std::min(JobSystem::GetInstance()->GetThreadCount(), static_cast<uint32_t>(materials.size())), 1u);
+
+    //Command pools can only be used by one thread at a time so every recording chunk gets its own pool for each frame in flight
+    QueueFamilyIndices queueFamilyIndices = VulkanManager::GetInstance()->FindQueueFamilies(VulkanManager::GetInstance()->GetPhysicalDevice());
+
+    VkCommandPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+
+    recordCommandPools.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    for (std::vector<VkCommandPool>& framePools : recordCommandPools) {
+        framePools.resize(recordChunkCount);
+        for (VkCommandPool& pool : framePools) {
+            if (vkCreateCommandPool(logicalDevice, &poolInfo, nullptr, &pool) != VK_SUCCESS) {
+                throw std::runtime_error("Failed to create recording Command Pool!");
+            }
+        }
+    }
+
+    VkCommandBufferAllocateInfo allocateInfo = {};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    allocateInfo.commandBufferCount = 1;
+
+    //A secondary buffer is only ever used by one frame in flight so it can be re-recorded as soon as that frame's fence is waited on
+    drawCommands.resize(SwapChain::MAX_FRAMES_IN_FLIGHT);
+    for (uint32_t frame = 0; frame < drawCommands.size(); frame++) {
+        drawCommands[frame].resize(imageCount);
+        for (uint32_t image = 0; image < imageCount; image++) {
+            drawCommands[frame][image].resize(materials.size());
+            for (size_t i = 0; i < materials.size(); i++) {
+                //Allocate from the pool of the chunk that will record this material
+                allocateInfo.commandPool = recordCommandPools[frame][i % recordChunkCount];
+                if (vkAllocateCommandBuffers(logicalDevice, &allocateInfo, &drawCommands[frame][image][i].commandBuffer) != VK_SUCCESS) {
+                    throw std::runtime_error("Failed to allocate secondary Command Buffer!");
+                }
+            }
+        }
+    }
+}
+
+void EntityManager::FreeDrawCommands()
+{
+    //Destroying the pools frees every secondary command buffer allocated from them
+    for (std::vector<VkCommandPool>& framePools : recordCommandPools) {
+        for (VkCommandPool pool : framePools) {
+            vkDestroyCommandPool(VulkanManager::GetInstance()->GetLogicalDevice(), pool, nullptr);
+        }
+    }
+
+    recordCommandPools.clear();
+    drawCommands.clear();
+}
 
 #pragma endregion
\ No newline at end of file
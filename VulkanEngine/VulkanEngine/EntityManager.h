@@ -4,6 +4,8 @@
 #include "Material.h"
 #include "Mesh.h"
 #include "Buffer.h"
+#include "DrawCommands.h"
+#include "DrawStats.h"
 
 class EntityManager
 {
@@ -15,6 +17,61 @@ private:
 	std::vector<std::shared_ptr<Material>> materials;
 	std::vector<std::shared_ptr<Mesh>> meshes;
 
+	//Cached secondary command buffers indexed by frame in flight, swap chain image and material
+	std::vector<std::vector<std::vector<DrawCommands>>> drawCommands;
+	DrawStats drawStats;
+
+	//Bytes of instance data written to instance buffers during the latest update
+	VkDeviceSize uploadedInstanceBytes = 0;
+
+	//Layout every mesh sends its instances in, picks which build of the vertex shaders the materials load
+	InstanceFormats instanceFormat = MatrixInstanceFormat;
+
+	//One command pool per frame in flight and recording chunk, chunk c records every material where index % recordChunkCount == c
+	std::vector<std::vector<VkCommandPool>> recordCommandPools;
+	uint32_t recordChunkCount = 1;
+
+	//Copy of the debug manager's color buffers taken before recording so worker threads only read from it,
+	//kept as a vector so refilling it every frame reuses its storage instead of rebuilding map nodes
+	std::vector<std::pair<std::shared_ptr<Mesh>, std::shared_ptr<InstanceBuffer>>> debugInstanceBuffers;
+
+	//Draw signature being built by each recording chunk and the stats each chunk gathered, one entry per chunk
+	std::vector<std::vector<uint64_t>> chunkSignatures;
+	std::vector<DrawStats> chunkStats;
+
+	//Secondary command buffers of the current frame in material order, executed together by the primary command buffer
+	std::vector<VkCommandBuffer> secondaryCommandBuffers;
+
+	/// <summary>
+	/// Creates the recording command pools and allocates a secondary command buffer for every frame in flight, swap chain image and material
+	/// </summary>
+	void AllocateDrawCommands();
+
+	/// <summary>
+	/// Builds the list of handles and counts that the material's draw commands depend on
+	/// </summary>
+	/// <param name="material">The material to build the signature for</param>
+	/// <param name="imageIndex">The swap chain image being drawn to</param>
+	/// <param name="frame">The frame in flight being drawn</param>
+	/// <param name="signature">Receives the signature, left empty if the material has nothing to draw</param>
+	void GetDrawSignature(const std::shared_ptr<Material>& material, uint32_t imageIndex, uint32_t frame, std::vector<uint64_t>& signature);
+
+	/// <summary>
+	/// Finds the debug color buffer snapshotted for a mesh
+	/// </summary>
+	/// <param name="mesh">The mesh to find the color buffer of</param>
+	/// <returns>The color buffer, nullptr if the mesh doesn't have one</returns>
+	InstanceBuffer* GetDebugColorBuffer(const std::shared_ptr<Mesh>& mesh);
+
+	/// <summary>
+	/// Records the draw commands for all meshes using a material into a secondary command buffer
+	/// </summary>
+	/// <param name="material">The material to record</param>
+	/// <param name="imageIndex">The swap chain image being drawn to</param>
+	/// <param name="frame">The frame in flight being drawn</param>
+	/// <param name="commandBuffer">The secondary command buffer to record into</param>
+	void RecordMaterial(const std::shared_ptr<Material>& material, uint32_t imageIndex, uint32_t frame, VkCommandBuffer commandBuffer);
+
 public:
 #pragma region Singleton
 
@@ -32,13 +89,38 @@ public:
 	/// Returns a list of all of the materials in use
 	/// </summary>
 	/// <returns>std::vector<std::shared_ptr<Material>> of the materials that are in use</returns>
-	std::vector<std::shared_ptr<Material>> GetMaterials();
+	const std::vector<std::shared_ptr<Material>>& GetMaterials();
 
 	/// <summary>
 	/// Returns a list of all of the meshes in use
 	/// </summary>
 	/// <returns>std::vector<std::shared_ptr<Mesh>> of the meshes that are in use</returns>
-	std::vector<std::shared_ptr<Mesh>> GetMeshes();
+	const std::vector<std::shared_ptr<Mesh>>& GetMeshes();
+
+	/// <summary>
+	/// Returns how long the last frame's command buffers took to record and how much recording was skipped
+	/// </summary>
+	/// <returns>The draw statistics for the last frame</returns>
+	DrawStats GetDrawStats();
+
+	/// <summary>
+	/// Returns how much instance data was written to the instance buffers during the latest update, only changed instances are written
+	/// </summary>
+	/// <returns>The uploaded byte count</returns>
+	VkDeviceSize GetUploadedInstanceBytes();
+
+	/// <summary>
+	/// Returns the layout the meshes send their instances to the vertex shaders in
+	/// </summary>
+	/// <returns>The instance format</returns>
+	InstanceFormats GetInstanceFormat();
+
+	/// <summary>
+	/// Sets the layout the meshes send their instances to the vertex shaders in, the smaller formats use less bandwidth.
+	/// Must be set before the entity manager is initialized
+	/// </summary>
+	/// <param name="value">The instance format</param>
+	void SetInstanceFormat(InstanceFormats value);
 
 #pragma endregion
 
@@ -69,7 +151,8 @@ public:
 	void Update();
 
 	/// <summary>
-	/// Re-records the command buffer to draw all meshes
+	/// Records the primary command buffer to execute each material's secondary command buffer,
+	/// secondary command buffers are recorded in parallel and only when the handles or counts they use have changed
 	/// </summary>
 	/// <param name="commandBuffer">The command buffer that will be recorded</param>
 	void Draw(uint32_t imageIndex, VkCommandBuffer* commandBuffer);
@@ -103,5 +186,10 @@ public:
 	/// </summary>
 	void CleanupMeshes();
 
+	/// <summary>
+	/// Destroys the recording command pools and cached secondary command buffers, they are re-created on the next draw
+	/// </summary>
+	void FreeDrawCommands();
+
 #pragma endregion
 };
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "pch.h"
+#include "EntityRegistry.h"
+
+#include "DebugManager.h"
+#include "PhysicsManager.h"
+
+#pragma region Singleton
+
+EntityRegistry* EntityRegistry::instance = nullptr;
+
+EntityRegistry* EntityRegistry::GetInstance()
+{
+	if (instance == nullptr) {
+		instance = new EntityRegistry();
+	}
+
+	return instance;
+}
+
+#pragma endregion
+
+#pragma region Entities
+
+Entity EntityRegistry::Create()
+{
+	//Reuse a freed slot if there is one, its generation was bumped when it was freed
+	Entity entity;
+	if (freeIndices.size() > 0) {
+		entity.index = freeIndices.back();
+		freeIndices.pop_back();
+	}
+	else {
+		entity.index = static_cast<uint32_t>(generations.size());
+		generations.push_back(0);
+	}
+
+	entity.generation = generations[entity.index];
+	return entity;
+}
+
+void EntityRegistry::Destroy(Entity entity)
+{
+	if (!IsAlive(entity)) {
+		return;
+	}
+
+	Remove<TransformComponent>(entity);
+	Remove<PhysicsComponent>(entity);
+	Remove<MeshComponent>(entity);
+	Remove<Light>(entity);
+
+	generations[entity.index]++;
+	freeIndices.push_back(entity.index);
+}
+
+bool EntityRegistry::IsAlive(Entity entity)
+{
+	return entity.index < generations.size() && generations[entity.index] == entity.generation;
+}
+
+uint32_t EntityRegistry::GetEntityCount()
+{
+	return static_cast<uint32_t>(generations.size() - freeIndices.size());
+}
+
+void EntityRegistry::Release(MeshComponent& component)
+{
+	if (component.mesh != nullptr && component.instanceId >= 0) {
+		component.mesh->RemoveInstance(component.instanceId);
+		component.instanceId = -1;
+	}
+}
+
+#pragma endregion
+
+#pragma region Systems
+
+void EntityRegistry::Update()
+{
+	//Bodies that aren't simulated can be moved by hand, show the handles for them
+	if (!DebugManager::GetInstance()->GetDrawHandles()) {
+		return;
+	}
+
+	FindInactiveEntities(inactiveEntities);
+
+	for (size_t i = 0; i < inactiveEntities.size(); i++) {
+		if (transforms.Has(inactiveEntities[i])) {
+			transforms.Get(inactiveEntities[i]).transform->DrawHandles();
+		}
+	}
+}
+
+void EntityRegistry::FindInactiveEntities(std::vector<Entity>& output)
+{
+	output.clear();
+
+	std::vector<PhysicsComponent>& bodies = physicsBodies.GetComponents();
+	uint32_t count = physicsBodies.GetSize();
+
+	bodyHandles.resize(count);
+	bodiesAlive.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		bodyHandles[i] = bodies[i].handle;
+	}
+
+	PhysicsManager::GetInstance()->GetWorld()->GetAlive(bodyHandles.data(), count, bodiesAlive.data());
+
+	const std::vector<Entity>& entities = physicsBodies.GetEntities();
+	for (uint32_t i = 0; i < count; i++) {
+		if (!bodiesAlive[i]) {
+			output.push_back(entities[i]);
+		}
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,229 @@
+#pragma once
+#include "pch.h"
+
+#include "Entity.h"
+#include "ComponentPool.h"
+#include "TransformComponent.h"
+#include "PhysicsComponent.h"
+#include "MeshComponent.h"
+
+class EntityRegistry
+{
+private:
+	static EntityRegistry* instance;
+
+	//Generation of every entity slot and the slots that are free to reuse
+	std::vector<uint32_t> generations;
+	std::vector<uint32_t> freeIndices;
+
+	ComponentPool<TransformComponent> transforms;
+	ComponentPool<PhysicsComponent> physicsBodies;
+	ComponentPool<MeshComponent> meshInstances;
+	ComponentPool<Light> lights;
+
+	//Handles of every physics component and whether each body is alive, filled so the world can answer in a single locked batch
+	std::vector<PhysicsHandle> bodyHandles;
+	std::vector<uint8_t> bodiesAlive;
+
+	//Entities whose bodies are not alive, found each frame to draw their handles
+	std::vector<Entity> inactiveEntities;
+
+	/// <summary>
+	/// Removes the mesh instance drawn for a mesh component that is being removed
+	/// </summary>
+	/// <param name="component">The component being removed</param>
+	void Release(MeshComponent& component);
+
+	/// <summary>
+	/// Components that don't own anything outside of the registry need no cleanup
+	/// </summary>
+	/// <param name="component">The component being removed</param>
+	template<typename T>
+	void Release(T& component)
+	{
+	}
+
+public:
+#pragma region Singleton
+
+	/// <summary>
+	/// Returns the singleton instance of the entity registry
+	/// </summary>
+	/// <returns>The singleton instance</returns>
+	static EntityRegistry* GetInstance();
+
+#pragma endregion
+
+#pragma region Entities
+
+	/// <summary>
+	/// Creates an entity with no components
+	/// </summary>
+	/// <returns>The new entity</returns>
+	Entity Create();
+
+	/// <summary>
+	/// Removes every component of an entity and frees its slot, does nothing if the entity was already destroyed
+	/// </summary>
+	/// <param name="entity">The entity to destroy</param>
+	void Destroy(Entity entity);
+
+	/// <summary>
+	/// Returns whether an entity has been created and not destroyed yet
+	/// </summary>
+	/// <param name="entity">The entity to check</param>
+	/// <returns>True if the entity is alive</returns>
+	bool IsAlive(Entity entity);
+
+	/// <summary>
+	/// Returns the number of entities that are alive
+	/// </summary>
+	/// <returns>The entity count</returns>
+	uint32_t GetEntityCount();
+
+#pragma endregion
+
+#pragma region Components
+
+	/// <summary>
+	/// Returns the pool storing every component of a type
+	/// </summary>
+	/// <returns>The component pool</returns>
+	template<typename T>
+	ComponentPool<T>& GetPool();
+
+	/// <summary>
+	/// Gives an entity a component, replacing the one it already has
+	/// </summary>
+	/// <param name="entity">The entity to add the component to</param>
+	/// <param name="component">The component to add</param>
+	/// <returns>The stored component, invalidated when components of the same type are added or removed</returns>
+	template<typename T>
+	T& Add(Entity entity, const T& component)
+	{
+		if (!IsAlive(entity)) {
+			throw std::runtime_error("Failed to add component, the entity was destroyed!");
+		}
+
+		ComponentPool<T>& pool = GetPool<T>();
+		if (pool.Has(entity)) {
+			Release(pool.Get(entity));
+		}
+
+		return pool.Add(entity, component);
+	}
+
+	/// <summary>
+	/// Removes a component from an entity, does nothing if the entity doesn't have one
+	/// </summary>
+	/// <param name="entity">The entity to remove the component from</param>
+	template<typename T>
+	void Remove(Entity entity)
+	{
+		ComponentPool<T>& pool = GetPool<T>();
+		if (pool.Has(entity)) {
+			Release(pool.Get(entity));
+			pool.Remove(entity);
+		}
+	}
+
+	/// <summary>
+	/// Returns whether an entity has a component
+	/// </summary>
+	/// <param name="entity">The entity to check</param>
+	/// <returns>True if the entity has the component</returns>
+	template<typename T>
+	bool Has(Entity entity)
+	{
+		return GetPool<T>().Has(entity);
+	}
+
+	/// <summary>
+	/// Returns an entity's component
+	/// </summary>
+	/// <param name="entity">The entity the component belongs to</param>
+	/// <returns>The component, invalidated when components of the same type are added or removed</returns>
+	template<typename T>
+	T& Get(Entity entity)
+	{
+		return GetPool<T>().Get(entity);
+	}
+
+	/// <summary>
+	/// Calls a function for every entity that has all of the listed components.
+	/// A single component is walked straight through its pool, otherwise the smallest pool is walked and the rest are looked up.
+	/// Components of the listed types may not be added or removed until it returns
+	/// </summary>
+	/// <param name="function">Called with the entity followed by a reference to each component</param>
+	template<typename First, typename... Rest, typename Function>
+	void Each(Function function)
+	{
+		ComponentPool<First>& first = GetPool<First>();
+
+		if constexpr (sizeof...(Rest) == 0) {
+			const std::vector<Entity>& entities = first.GetEntities();
+			std::vector<First>& components = first.GetComponents();
+
+			for (size_t i = 0; i < components.size(); i++) {
+				function(entities[i], components[i]);
+			}
+		}
+		else {
+			const std::vector<Entity>* smallest = &first.GetEntities();
+			((smallest = GetPool<Rest>().GetSize() < smallest->size() ? &GetPool<Rest>().GetEntities() : smallest), ...);
+
+			for (size_t i = 0; i < smallest->size(); i++) {
+				Entity entity = (*smallest)[i];
+
+				if (first.Has(entity) && (GetPool<Rest>().Has(entity) && ...)) {
+					function(entity, first.Get(entity), GetPool<Rest>().Get(entity)...);
+				}
+			}
+		}
+	}
+
+#pragma endregion
+
+#pragma region Systems
+
+	/// <summary>
+	/// Runs the systems that need to run once per frame
+	/// </summary>
+	void Update();
+
+	/// <summary>
+	/// Finds every entity whose physics body isn't being simulated, the physics world is locked once for all of them
+	/// </summary>
+	/// <param name="output">Receives the inactive entities</param>
+	void FindInactiveEntities(std::vector<Entity>& output);
+
+#pragma endregion
+};
+
+#pragma region Component Pools
+
+template<>
+inline ComponentPool<TransformComponent>& EntityRegistry::GetPool<TransformComponent>()
+{
+	return transforms;
+}
+
+template<>
+inline ComponentPool<PhysicsComponent>& EntityRegistry::GetPool<PhysicsComponent>()
+{
+	return physicsBodies;
+}
+
+template<>
+inline ComponentPool<MeshComponent>& EntityRegistry::GetPool<MeshComponent>()
+{
+	return meshInstances;
+}
+
+template<>
+inline ComponentPool<Light>& EntityRegistry::GetPool<Light>()
+{
+	return lights;
+}
+
+#pragma endregion
@@ -21,4 +21,18 @@ std::vector<char> FileManager::ReadFile(const std::string& filePath)
 	//Close the file and return
 	file.close();
 	return buffer;
+}
+
+void FileManager::WriteFile(const std::string& filePath, const std::vector<char>& data)
+{
+	std::ofstream file(filePath, std::ios::trunc | std::ios::binary);
+
+	if (!file.is_open()) {
+		std::cout << "File Manager Line " << __LINE__ << ": " << std::endl;
+		throw std::runtime_error("Failed to open file!");
+	}
+
+	//Write the contents and close the file
+	file.write(data.data(), data.size());
+	file.close();
 }
\ No newline at end of file
@@ -5,4 +5,5 @@ class FileManager
 {
 public:
 	static std::vector<char> ReadFile(const std::string& filePath);
+	static void WriteFile(const std::string& filePath, const std::vector<char>& data);
 };
\ No newline at end of file
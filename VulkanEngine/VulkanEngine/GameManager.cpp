@@ -1,13 +1,24 @@
 #include "pch.h"
 #include "GameManager.h"
 
+#include "AllocationCounter.h"
 #include "DebugManager.h"
 #include "EntityManager.h"
 #include "InputManager.h"
 #include "Camera.h"
+#include "PhysicsManager.h"
+#include "StringTable.h"
+#include "UploadManager.h"
+#include "VulkanManager.h"
 
 #define MshMngr MeshManager::GetInstance()
 
+//Hashed at compile time so looking the object up costs a single hash map lookup
+static constexpr StringId JUMP_OBJECT_NAME = StringId("Sphere01");
+
+//Returned by the group queries when nothing matches
+static const std::vector<GameObject*> NO_OBJECTS;
+
 #pragma region Singleton
 
 GameManager* GameManager::instance = nullptr;
@@ -25,21 +36,116 @@ GameManager* GameManager::GetInstance()
 
 #pragma region Accessors
 
-std::vector<std::shared_ptr<Light>> GameManager::GetLights()
+std::shared_ptr<GameObject> GameManager::GetObjectByName(StringId name)
+{
+    std::unordered_map<StringId, std::vector<GameObject*>>::iterator objects = objectsByName.find(name);
+    if (objects != objectsByName.end() && !objects->second.empty()) {
+        return objects->second[0]->shared_from_this();
+    }
+
+    std::cout << "Could not find object with name: " << StringTable::GetInstance()->GetString(name) << std::endl;
+    return nullptr;
+}
+
+const std::vector<GameObject*>& GameManager::GetObjectsByName(StringId name)
 {
-    return lights;
+    std::unordered_map<StringId, std::vector<GameObject*>>::iterator objects = objectsByName.find(name);
+    return objects != objectsByName.end() ? objects->second : NO_OBJECTS;
+}
+
+const std::vector<GameObject*>& GameManager::GetObjectsWithTag(StringId tag)
+{
+    std::unordered_map<StringId, std::vector<GameObject*>>::iterator objects = objectsByTag.find(tag);
+    return objects != objectsByTag.end() ? objects->second : NO_OBJECTS;
+}
+
+uint32_t GameManager::GetInstanceChurnCount()
+{
+    return instanceChurnCount;
+}
+
+float GameManager::GetInstanceChurnTime()
+{
+    return instanceChurnTime;
+}
+
+uint32_t GameManager::GetInstanceChurnFrames()
+{
+    return instanceChurnFrames;
+}
+
+uint32_t GameManager::GetInstanceChurnIdles()
+{
+    return instanceChurnIdles;
+}
+
+uint32_t GameManager::GetInstanceChurnStalls()
+{
+    return instanceChurnStalls;
+}
+
+void GameManager::SetInstanceBenchmark(bool value)
+{
+    if (instanceBenchmark && !value) {
+        StopInstanceBenchmark();
+    }
+
+    instanceBenchmark = value;
 }
 
-std::shared_ptr<GameObject> GameManager::GetObjectByName(std::string name)
+uint32_t GameManager::GetProjectileCount()
 {
-    for (int i = 0; i < gameObjects.size(); i++) {
-        if (gameObjects[i]->GetName().compare(name) == 0) {
-            return gameObjects[i];
+    return projectileCount;
+}
+
+uint32_t GameManager::GetProjectileAllocations()
+{
+    return projectileAllocations;
+}
+
+#pragma endregion
+
+#pragma region Index
+
+void GameManager::AddToIndex(GameObject* object)
+{
+    if (object->name != StringId()) {
+        objectsByName[object->name].push_back(object);
+    }
+
+    if (object->tag != StringId()) {
+        std::vector<GameObject*>& group = objectsByTag[object->tag];
+        object->tagIndex = static_cast<uint32_t>(group.size());
+        group.push_back(object);
+    }
+}
+
+void GameManager::RemoveFromIndex(GameObject* object)
+{
+    //Empty entries are kept so pooled objects can be spawned again without allocating.
+    //Names keep their spawn order so GetObjectByName keeps returning the first spawned object, few objects share a name
+    if (object->name != StringId()) {
+        std::unordered_map<StringId, std::vector<GameObject*>>::iterator objects = objectsByName.find(object->name);
+        if (objects != objectsByName.end()) {
+            std::vector<GameObject*>::iterator entry = std::find(objects->second.begin(), objects->second.end(), object);
+            if (entry != objects->second.end()) {
+                objects->second.erase(entry);
+            }
         }
     }
 
-    std::cout << "Could not find object with name: " << name << std::endl;
-    return nullptr;
+    //Tags can group many objects, move the last one into the hole instead of searching
+    if (object->tag != StringId() && object->tagIndex != UINT32_MAX) {
+        std::unordered_map<StringId, std::vector<GameObject*>>::iterator objects = objectsByTag.find(object->tag);
+        if (objects != objectsByTag.end()) {
+            std::vector<GameObject*>& group = objects->second;
+            group[object->tagIndex] = group.back();
+            group[object->tagIndex]->tagIndex = object->tagIndex;
+            group.pop_back();
+        }
+    }
+
+    object->tagIndex = UINT32_MAX;
 }
 
 #pragma endregion
@@ -49,8 +155,10 @@ std::shared_ptr<GameObject> GameManager::GetObjectByName(std::string name)
 void GameManager::Init()
 {
     //Setup Lights
-    lights.push_back(std::make_shared<Light>(glm::vec3(1.5f, 1.1f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), 5.0f));
-    lights.push_back(std::make_shared<Light>(glm::vec3(0.0f, 2.0f, -1.5f), glm::vec3(1.0f, 0.988f, 0.769f), 3.0f, 4.0f));
+    EntityRegistry* registry = EntityRegistry::GetInstance();
+    movingLight = registry->Create();
+    registry->Add(movingLight, Light(glm::vec3(1.5f, 1.1f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f), 5.0f));
+    registry->Add(registry->Create(), Light(glm::vec3(0.0f, 2.0f, -1.5f), glm::vec3(1.0f, 0.988f, 0.769f), 3.0f, 4.0f));
 
     //gameObjects.push_back(std::make_shared<GameObject>(EntityManager::GetInstance()->GetMeshes()[MeshTypes::Model]));
     gameObjects.push_back(std::make_shared<GameObject>(EntityManager::GetInstance()->GetMeshes()[MeshTypes::Plane]));
@@ -65,6 +173,12 @@ void GameManager::Init()
     gameObjects[0]->GetTransform()->SetScale(glm::vec3(5.0f, 1.0f, 5.0f));
     gameObjects[0]->SetPhysicsObject(std::make_shared<PhysicsObject>(gameObjects[0]->GetTransform(), PhysicsLayers::Static, 1.0f, false, true));
     gameObjects[0]->SetName("Floor");
+
+    //The plane has no thickness, give it a box underneath so objects can't pass through it
+    Collider floorCollider;
+    floorCollider.type = ColliderTypes::AABBCollider;
+    floorCollider.offset = glm::vec3(0.0f, -0.5f, 0.0f);
+    gameObjects[0]->GetPhysicsObject()->SetCollider(floorCollider);
     
     //Setup Cube
     gameObjects[1]->SetTransform(std::make_shared<Transform>(glm::vec3()));
@@ -73,6 +187,10 @@ void GameManager::Init()
     gameObjects[1]->SetPhysicsObject(std::make_shared<PhysicsObject>(gameObjects[1]->GetTransform(), PhysicsLayers::Dynamic, 1.0f, true, true));
     gameObjects[1]->SetName("DynamicCube");
 
+    Collider cubeCollider;
+    cubeCollider.type = ColliderTypes::OBBCollider;
+    gameObjects[1]->GetPhysicsObject()->SetCollider(cubeCollider);
+
     //Setup Sphere
     gameObjects[2]->SetTransform(std::make_shared<Transform>(glm::vec3(1.0f, 2.5f, 0.0f)));
     gameObjects[2]->SetPhysicsObject(std::make_shared<PhysicsObject>(gameObjects[2]->GetTransform(), PhysicsLayers::Dynamic, 1.0f, true, true));
@@ -154,15 +272,53 @@ void GameManager::Update()
 
     //Update Lights
     float scaledTime = Time::GetTotalTime() / 2.5f;
-    lights[0]->position = glm::vec3(0.0f, 1.1f, 0.0f) + glm::vec3(cos(scaledTime), 0.0f, sin(scaledTime)) * 1.5f;
+    EntityRegistry::GetInstance()->Get<Light>(movingLight).position = glm::vec3(0.0f, 1.1f, 0.0f) + glm::vec3(cos(scaledTime), 0.0f, sin(scaledTime)) * 1.5f;
     
+    //Send out the trigger and collision events from the latest physics update before objects update
+    PhysicsManager::GetInstance()->DispatchEvents();
+
     //Update Game Objects
     for (size_t i = 0; i < gameObjects.size(); i++) {
         gameObjects[i]->Update();
     }
 
+    EntityRegistry::GetInstance()->Update();
+
+    if (InputManager::GetInstance()->GetKeyPressed(Controls::SpawnPyramid)) {
+        SpawnPyramid(glm::vec3(0.0f, 0.0f, -8.0f - 4.0f * pyramidCount), 20);
+        pyramidCount++;
+    }
+
+    if (InputManager::GetInstance()->GetKeyPressed(Controls::RaycastBenchmark)) {
+        raycastBenchmark = !raycastBenchmark;
+    }
+
+    if (raycastBenchmark) {
+        RunRaycastBenchmark();
+    }
+
+    if (InputManager::GetInstance()->GetKeyPressed(Controls::InstanceBenchmark)) {
+        SetInstanceBenchmark(!instanceBenchmark);
+    }
+
+    if (instanceBenchmark) {
+        RunInstanceBenchmark();
+    }
+
+    if (InputManager::GetInstance()->GetKeyPressed(Controls::ProjectileBenchmark)) {
+        projectileBenchmark = !projectileBenchmark;
+
+        if (!projectileBenchmark) {
+            StopProjectileBenchmark();
+        }
+    }
+
+    if (projectileBenchmark) {
+        RunProjectileBenchmark();
+    }
+
     if (InputManager::GetInstance()->GetKeyPressed(Controls::Jump)) {
-        gameObjects[2]->GetPhysicsObject()->ApplyForce(glm::vec3(0.0f, 5000.0f, 0.0f));
+        GetObjectByName(JUMP_OBJECT_NAME)->GetPhysicsObject()->ApplyForce(glm::vec3(0.0f, 5000.0f, 0.0f));
 
         //Spawn Object Sample Code:
         /*
@@ -177,4 +333,198 @@ void GameManager::Update()
     }
 }
 
+void GameManager::SpawnPyramid(glm::vec3 position, uint32_t baseWidth)
+{
+    //Leave a small gap between neighbouring boxes so each one only rests on the boxes below it
+    const float spacing = 1.05f;
+
+    std::shared_ptr<GameObject> floor = std::make_shared<GameObject>(EntityManager::GetInstance()->GetMeshes()[MeshTypes::Cube]);
+    gameObjects.push_back(floor);
+
+    floor->SetTransform(std::make_shared<Transform>(position - glm::vec3(0.0f, 0.5f, 0.0f)));
+    floor->GetTransform()->SetScale(glm::vec3(baseWidth * spacing + 2.0f, 1.0f, 3.0f));
+    floor->SetPhysicsObject(std::make_shared<PhysicsObject>(floor->GetTransform(), PhysicsLayers::Static, 1.0f, false, true));
+    floor->SetName("PyramidFloor");
+
+    Collider floorCollider;
+    floorCollider.type = ColliderTypes::AABBCollider;
+    floor->GetPhysicsObject()->SetCollider(floorCollider);
+    floor->Spawn();
+
+    Collider boxCollider;
+    boxCollider.type = ColliderTypes::OBBCollider;
+
+    //The boxes have no behaviour of their own so they are plain entities rather than game objects
+    EntityRegistry* registry = EntityRegistry::GetInstance();
+    std::shared_ptr<Mesh> boxMesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::Cube];
+
+    for (uint32_t row = 0; row < baseWidth; row++) {
+        uint32_t rowWidth = baseWidth - row;
+
+        for (uint32_t column = 0; column < rowWidth; column++) {
+            glm::vec3 offset = glm::vec3((column - (rowWidth - 1) * 0.5f) * spacing, 0.5f + row, 0.0f);
+            std::shared_ptr<Transform> transform = std::make_shared<Transform>(position + offset);
+            std::shared_ptr<PhysicsObject> physicsObject = std::make_shared<PhysicsObject>(transform, PhysicsLayers::Dynamic, 1.0f, true, true);
+            physicsObject->SetCollider(boxCollider);
+
+            MeshComponent meshComponent;
+            meshComponent.mesh = boxMesh;
+            meshComponent.instanceId = boxMesh->AddInstance(transform);
+
+            Entity box = registry->Create();
+            registry->Add(box, TransformComponent{ transform });
+            registry->Add(box, PhysicsComponent{ physicsObject, physicsObject->GetHandle() });
+            registry->Add(box, meshComponent);
+        }
+    }
+}
+
+void GameManager::RunRaycastBenchmark()
+{
+    const uint32_t gridWidth = 100;
+    const float area = 50.0f;
+
+    if (benchmarkRays.empty()) {
+        benchmarkRays.resize(gridWidth * gridWidth);
+
+        for (uint32_t x = 0; x < gridWidth; x++) {
+            for (uint32_t z = 0; z < gridWidth; z++) {
+                RayQuery& ray = benchmarkRays[x * gridWidth + z];
+                ray.origin = glm::vec3((x / (gridWidth - 1.0f) - 0.5f) * area, 1.0f, (z / (gridWidth - 1.0f) - 0.5f) * area);
+
+                //Aim through the middle of the scene at the opposite point, only the first thing in the way matters
+                glm::vec3 target = glm::vec3(-ray.origin.x, ray.origin.y, -ray.origin.z);
+                ray.direction = target - ray.origin;
+                ray.maxDistance = glm::length(ray.direction);
+                ray.maxHits = 1;
+            }
+        }
+    }
+
+    PhysicsManager::GetInstance()->Raycast(benchmarkRays, benchmarkHits);
+}
+
+void GameManager::RunInstanceBenchmark()
+{
+    const uint32_t liveCount = 10000;
+    const float churnRate = 100000.0f;
+
+    std::shared_ptr<Mesh> mesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::Cube];
+
+    //Every instance shares one transform under the floor, only adding and removing them is being measured
+    if (benchmarkTransform == nullptr) {
+        benchmarkTransform = std::make_shared<Transform>(glm::vec3(0.0f, -50.0f, 0.0f));
+    }
+
+    std::chrono::steady_clock::time_point churnStart = std::chrono::steady_clock::now();
+
+    //Remove instances from random places so removals don't always hit the end of the mesh's instances
+    uint32_t churnCount = std::min(static_cast<uint32_t>(churnRate * Time::GetDeltaTime()), static_cast<uint32_t>(benchmarkInstances.size()));
+    for (uint32_t i = 0; i < churnCount; i++) {
+        size_t index = std::rand() % benchmarkInstances.size();
+        mesh->RemoveInstance(benchmarkInstances[index]);
+        benchmarkInstances[index] = benchmarkInstances.back();
+        benchmarkInstances.pop_back();
+    }
+
+    while (benchmarkInstances.size() < liveCount) {
+        benchmarkInstances.push_back(mesh->AddInstance(benchmarkTransform));
+    }
+
+    instanceChurnTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - churnStart).count();
+    instanceChurnCount = churnCount;
+
+    //Anything that idled or stalled since the last churn frame happened while drawing the churned instances, the first frame only records where the counts start
+    uint32_t idleCount = VulkanManager::GetInstance()->GetIdleCount();
+    uint32_t stallCount = UploadManager::GetInstance()->GetStallCount();
+    if (instanceChurnFrames > 0) {
+        instanceChurnIdles += idleCount - lastIdleCount;
+        instanceChurnStalls += stallCount - lastStallCount;
+    }
+    lastIdleCount = idleCount;
+    lastStallCount = stallCount;
+    instanceChurnFrames++;
+}
+
+void GameManager::StopInstanceBenchmark()
+{
+    std::shared_ptr<Mesh> mesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::Cube];
+
+    for (size_t i = 0; i < benchmarkInstances.size(); i++) {
+        mesh->RemoveInstance(benchmarkInstances[i]);
+    }
+
+    benchmarkInstances.clear();
+    instanceChurnCount = 0;
+    instanceChurnTime = 0.0f;
+    instanceChurnFrames = 0;
+    instanceChurnIdles = 0;
+    instanceChurnStalls = 0;
+}
+
+void GameManager::RunProjectileBenchmark()
+{
+    const float fireRate = 10000.0f;
+    const float lifetime = 1.0f;
+
+    //A second of projectiles with room to spare for long frames
+    const uint32_t capacity = 12000;
+
+    if (projectilePool == nullptr) {
+        ObjectPrefab prefab;
+        prefab.mesh = EntityManager::GetInstance()->GetMeshes()[MeshTypes::Sphere];
+        prefab.tag = "Projectile";
+        prefab.scale = glm::vec3(0.1f, 0.1f, 0.1f);
+
+        projectilePool = std::make_shared<ObjectPool<GameObject>>(prefab, capacity);
+        projectiles.resize(capacity);
+        projectileSpawnTimes.resize(capacity);
+    }
+
+    uint64_t allocationStart = AllocationCounter::GetCount();
+    float time = Time::GetTotalTime();
+
+    while (projectileCount > 0 && time - projectileSpawnTimes[firstProjectile] >= lifetime) {
+        projectilePool->Despawn(projectiles[firstProjectile]);
+        projectiles[firstProjectile] = nullptr;
+        firstProjectile = (firstProjectile + 1) % capacity;
+        projectileCount--;
+    }
+
+    //Fire from a line behind the scene, spread out so the projectiles rarely hit each other
+    projectilesOwed += fireRate * Time::GetDeltaTime();
+    while (projectilesOwed >= 1.0f) {
+        glm::vec3 position = glm::vec3((std::rand() / static_cast<float>(RAND_MAX) - 0.5f) * 50.0f, 1.0f, 30.0f);
+        glm::vec3 velocity = glm::vec3(0.0f, 5.0f + std::rand() / static_cast<float>(RAND_MAX) * 5.0f, -10.0f);
+
+        std::shared_ptr<GameObject> projectile = projectilePool->Spawn(position, velocity);
+        if (projectile == nullptr) {
+            projectilesOwed = 0.0f;
+            break;
+        }
+
+        uint32_t last = (firstProjectile + projectileCount) % capacity;
+        projectiles[last] = projectile;
+        projectileSpawnTimes[last] = time;
+        projectileCount++;
+        projectilesOwed -= 1.0f;
+    }
+
+    projectileAllocations = static_cast<uint32_t>(AllocationCounter::GetCount() - allocationStart);
+}
+
+void GameManager::StopProjectileBenchmark()
+{
+    for (uint32_t i = 0; i < projectileCount; i++) {
+        uint32_t index = (firstProjectile + i) % static_cast<uint32_t>(projectiles.size());
+        projectilePool->Despawn(projectiles[index]);
+        projectiles[index] = nullptr;
+    }
+
+    firstProjectile = 0;
+    projectileCount = 0;
+    projectilesOwed = 0.0f;
+    projectileAllocations = 0;
+}
+
 #pragma endregion
\ No newline at end of file
@@ -1,18 +1,111 @@
 #pragma once
 #include "pch.h"
 
+#include <unordered_map>
+
 #include "GameObject.h"
+#include "ObjectPool.h"
+#include "RayQuery.h"
+#include "RaycastHit.h"
+#include "StringId.h"
 
 class GameManager
 {
 private:
 	static GameManager* instance;
 
+	friend class GameObject;
+
+	//Spawned objects by name in the order they were spawned and by tag in no particular order.
+	//Declared before the object list so they outlive it, objects remove themselves as they are destroyed
+	std::unordered_map<StringId, std::vector<GameObject*>> objectsByName;
+	std::unordered_map<StringId, std::vector<GameObject*>> objectsByTag;
+
+	/// <summary>
+	/// Adds a spawned object to the name and tag index, objects without a name or tag are left out of that part of the index
+	/// </summary>
+	/// <param name="object">The object to add</param>
+	void AddToIndex(GameObject* object);
+
+	/// <summary>
+	/// Removes an object from the name and tag index
+	/// </summary>
+	/// <param name="object">The object to remove</param>
+	void RemoveFromIndex(GameObject* object);
+
+	//Objects with behaviour of their own, everything else in the scene is a plain entity in the entity registry
 	std::vector<std::shared_ptr<GameObject>> gameObjects;
-	std::vector<std::shared_ptr<Light>> lights;
+
+	//Light that circles the scene
+	Entity movingLight;
 
 	float cameraSpeed = 2.5f;
 	bool lockCamera = true;
+
+	//Number of box pyramids spawned so far, each one is placed behind the last
+	uint32_t pyramidCount = 0;
+
+	/// <summary>
+	/// Spawns a stack of boxes on its own floor away from the rest of the scene, used to measure the contact solver
+	/// </summary>
+	/// <param name="position">The center of the pyramid's floor</param>
+	/// <param name="baseWidth">The number of boxes in the bottom row</param>
+	void SpawnPyramid(glm::vec3 position, uint32_t baseWidth);
+
+	//While enabled a grid of line of sight rays is cast across the scene every frame to measure query throughput
+	bool raycastBenchmark = false;
+	std::vector<RayQuery> benchmarkRays;
+	std::vector<std::vector<RaycastHit>> benchmarkHits;
+
+	/// <summary>
+	/// Casts one line of sight ray from every point of a grid at eye height to the point opposite it across the scene
+	/// </summary>
+	void RunRaycastBenchmark();
+
+	//While enabled cube instances are added and removed at a steady rate every frame to measure instance churn
+	bool instanceBenchmark = false;
+	std::vector<int> benchmarkInstances;
+	std::shared_ptr<Transform> benchmarkTransform;
+	uint32_t instanceChurnCount = 0;
+	float instanceChurnTime = 0.0f;
+
+	//Device idles and upload stalls between churn frames, these should stay at zero however many instances are churned
+	uint32_t instanceChurnFrames = 0;
+	uint32_t instanceChurnIdles = 0;
+	uint32_t instanceChurnStalls = 0;
+	uint32_t lastIdleCount = 0;
+	uint32_t lastStallCount = 0;
+
+	/// <summary>
+	/// Removes and adds back enough cube instances to churn 100k instances per second, keeping 10k alive below the scene
+	/// </summary>
+	void RunInstanceBenchmark();
+
+	/// <summary>
+	/// Removes every instance the instance benchmark added
+	/// </summary>
+	void StopInstanceBenchmark();
+
+	//While enabled projectiles are fired from a pool at a steady rate every frame to measure spawn churn.
+	//Live projectiles are kept in a ring in the order they were fired, which is also the order they expire in
+	bool projectileBenchmark = false;
+	std::shared_ptr<ObjectPool<GameObject>> projectilePool;
+	std::vector<std::shared_ptr<GameObject>> projectiles;
+	std::vector<float> projectileSpawnTimes;
+	uint32_t firstProjectile = 0;
+	uint32_t projectileCount = 0;
+	float projectilesOwed = 0.0f;
+	uint32_t projectileAllocations = 0;
+
+	/// <summary>
+	/// Fires 10k pooled projectiles per second from behind the scene and despawns each one a second after it was fired
+	/// </summary>
+	void RunProjectileBenchmark();
+
+	/// <summary>
+	/// Despawns every projectile, the pool is kept for the next run
+	/// </summary>
+	void StopProjectileBenchmark();
 public:
 #pragma region Singleton
 
@@ -22,14 +115,74 @@ public:
 
 #pragma region Accessors
 
-	std::vector<std::shared_ptr<Light>> GetLights();
+	/// <summary>
+	/// Finds a spawned gameobject with the specified name
+	/// </summary>
+	/// <param name="name">The name of the object to find, hashed at compile time when it is a constexpr literal</param>
+	/// <returns>The first object spawned with that name or null if there is no object found with the specified name</returns>
+	std::shared_ptr<GameObject> GetObjectByName(StringId name);
+
+	/// <summary>
+	/// Returns every spawned gameobject with the specified name
+	/// </summary>
+	/// <param name="name">The name of the objects to find</param>
+	/// <returns>The objects in the order they were spawned, kept up to date as objects with the name are spawned and despawned</returns>
+	const std::vector<GameObject*>& GetObjectsByName(StringId name);
+
+	/// <summary>
+	/// Returns every spawned gameobject with the specified tag
+	/// </summary>
+	/// <param name="tag">The tag of the objects to find</param>
+	/// <returns>The objects in no particular order, kept up to date as objects with the tag are spawned and despawned</returns>
+	const std::vector<GameObject*>& GetObjectsWithTag(StringId tag);
+
+	/// <summary>
+	/// Returns the number of instances the instance benchmark removed and added back during the last frame
+	/// </summary>
+	/// <returns>The instance churn count</returns>
+	uint32_t GetInstanceChurnCount();
+
+	/// <summary>
+	/// Returns how long removing and adding the instance benchmark's instances took during the last frame
+	/// </summary>
+	/// <returns>The instance churn time in milliseconds</returns>
+	float GetInstanceChurnTime();
+
+	/// <summary>
+	/// Returns the number of frames the instance benchmark has been running for
+	/// </summary>
+	/// <returns>The churn frame count</returns>
+	uint32_t GetInstanceChurnFrames();
+
+	/// <summary>
+	/// Returns the number of times the device was idled while the instance benchmark was running
+	/// </summary>
+	/// <returns>The idle count</returns>
+	uint32_t GetInstanceChurnIdles();
+
+	/// <summary>
+	/// Returns the number of times the CPU blocked on an upload batch while the instance benchmark was running
+	/// </summary>
+	/// <returns>The stall count</returns>
+	uint32_t GetInstanceChurnStalls();
+
+	/// <summary>
+	/// Starts or stops the instance benchmark, the same as pressing its key
+	/// </summary>
+	/// <param name="value">Whether or not the benchmark should run</param>
+	void SetInstanceBenchmark(bool value);
+
+	/// <summary>
+	/// Returns the number of projectiles the projectile benchmark currently has spawned
+	/// </summary>
+	/// <returns>The live projectile count</returns>
+	uint32_t GetProjectileCount();
 
 	/// <summary>
-	/// Finds a gameobject with the specified name
+	/// Returns the number of heap allocations made while spawning and despawning projectiles during the last frame
 	/// </summary>
-	/// <param name="name">The name of the object to find</param>
-	/// <returns>The first object created with that name or null if there is no object found with the specified name</returns>
-	std::shared_ptr<GameObject> GetObjectByName(std::string name);
+	/// <returns>The allocation count</returns>
+	uint32_t GetProjectileAllocations();
 
 #pragma endregion
 
@@ -1,68 +1,188 @@
 #include "pch.h"
 #include "GameObject.h"
 
-#include "DebugManager.h"
 #include "EntityManager.h"
-#include "PhysicsManager.h"
+#include "GameManager.h"
+#include "SceneGraph.h"
+#include "StringTable.h"
 
 #pragma region Constructor
 
-GameObject::GameObject(std::shared_ptr<Mesh> mesh, std::shared_ptr<Transform> transform, std::shared_ptr<PhysicsObject> physicsObject)
+GameObject::GameObject(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Transform>& transform, const std::shared_ptr<PhysicsObject>& physicsObject)
 {
-	this->mesh = mesh;
-	this->transform = transform;
-	this->physicsObject = physicsObject;
+	entity = EntityRegistry::GetInstance()->Create();
+	active = false;
+
+	if (mesh != nullptr) {
+		MeshComponent meshComponent;
+		meshComponent.mesh = mesh;
+		EntityRegistry::GetInstance()->Add(entity, meshComponent);
+	}
+
+	if (transform != nullptr) {
+		EntityRegistry::GetInstance()->Add(entity, TransformComponent{ transform });
+	}
 
 	if (physicsObject != nullptr) {
-		PhysicsManager::GetInstance()->AddPhysicsObject(physicsObject);
+		EntityRegistry::GetInstance()->Add(entity, PhysicsComponent{ physicsObject, physicsObject->GetHandle() });
 	}
 
-	instanceId = -1;
-	active = false;
+	ListenForPhysicsEvents();
+}
+
+GameObject::~GameObject()
+{
+	if (active) {
+		GameManager::GetInstance()->RemoveFromIndex(this);
+	}
+
+	std::shared_ptr<PhysicsObject> physicsObject = GetPhysicsObject();
+	if (physicsObject != nullptr) {
+		physicsObject->SetEventCallback(nullptr);
+	}
+
+	EntityRegistry::GetInstance()->Destroy(entity);
 }
 
 #pragma endregion
 
 #pragma region Accessors
 
+Entity GameObject::GetEntity()
+{
+	return entity;
+}
+
 std::shared_ptr<Transform> GameObject::GetTransform()
 {
-	return transform;
+	if (!EntityRegistry::GetInstance()->Has<TransformComponent>(entity)) {
+		return nullptr;
+	}
+
+	return EntityRegistry::GetInstance()->Get<TransformComponent>(entity).transform;
 }
 
-void GameObject::SetTransform(std::shared_ptr<Transform> value)
+void GameObject::SetTransform(const std::shared_ptr<Transform>& value)
 {
-	transform = value;
+	if (value == nullptr) {
+		EntityRegistry::GetInstance()->Remove<TransformComponent>(entity);
+	}
+	else {
+		EntityRegistry::GetInstance()->Add(entity, TransformComponent{ value });
+	}
 
+	std::shared_ptr<PhysicsObject> physicsObject = GetPhysicsObject();
 	if (physicsObject != nullptr) {
 		physicsObject->SetTransform(value);
 	}
 }
 
+void GameObject::SetParent(const std::shared_ptr<GameObject>& value)
+{
+	if (GetTransform() == nullptr) {
+		SetTransform(std::make_shared<Transform>());
+	}
+
+	if (value != nullptr && value->GetTransform() == nullptr) {
+		value->SetTransform(std::make_shared<Transform>());
+	}
+
+	SceneGraph::GetInstance()->SetParent(GetTransform(), value != nullptr ? value->GetTransform() : nullptr);
+}
+
+glm::mat4 GameObject::GetWorldMatrix()
+{
+	std::shared_ptr<Transform> transform = GetTransform();
+	if (transform == nullptr) {
+		return glm::mat4(1.0f);
+	}
+
+	return transform->GetWorldMatrix();
+}
+
 std::shared_ptr<PhysicsObject> GameObject::GetPhysicsObject()
 {
-	return physicsObject;
+	if (!EntityRegistry::GetInstance()->Has<PhysicsComponent>(entity)) {
+		return nullptr;
+	}
+
+	return EntityRegistry::GetInstance()->Get<PhysicsComponent>(entity).physicsObject;
 }
 
-void GameObject::SetPhysicsObject(std::shared_ptr<PhysicsObject> value)
+void GameObject::SetPhysicsObject(const std::shared_ptr<PhysicsObject>& value)
 {
-	physicsObject = value;
-	PhysicsManager::GetInstance()->AddPhysicsObject(physicsObject);
+	std::shared_ptr<PhysicsObject> physicsObject = GetPhysicsObject();
+	if (physicsObject != nullptr && physicsObject != value) {
+		physicsObject->SetEventCallback(nullptr);
+	}
+
+	if (value == nullptr) {
+		EntityRegistry::GetInstance()->Remove<PhysicsComponent>(entity);
+	}
+	else {
+		EntityRegistry::GetInstance()->Add(entity, PhysicsComponent{ value, value->GetHandle() });
+	}
+
+	ListenForPhysicsEvents();
 }
 
 std::shared_ptr<Mesh> GameObject::GetMesh()
 {
-	return mesh;
+	if (!EntityRegistry::GetInstance()->Has<MeshComponent>(entity)) {
+		return nullptr;
+	}
+
+	return EntityRegistry::GetInstance()->Get<MeshComponent>(entity).mesh;
 }
 
-std::string GameObject::GetName()
+const std::string& GameObject::GetName()
+{
+	return StringTable::GetInstance()->GetString(name);
+}
+
+StringId GameObject::GetNameId()
 {
 	return name;
 }
 
-void GameObject::SetName(std::string value)
+void GameObject::SetName(const std::string& value)
+{
+	StringId id = StringTable::GetInstance()->Intern(value);
+	if (id == name) {
+		return;
+	}
+
+	//Spawned objects are indexed by name, move this one to the new name's entry
+	if (active) {
+		GameManager::GetInstance()->RemoveFromIndex(this);
+		name = id;
+		GameManager::GetInstance()->AddToIndex(this);
+	}
+	else {
+		name = id;
+	}
+}
+
+StringId GameObject::GetTag()
+{
+	return tag;
+}
+
+void GameObject::SetTag(const std::string& value)
 {
-	name = value;
+	StringId id = StringTable::GetInstance()->Intern(value);
+	if (id == tag) {
+		return;
+	}
+
+	if (active) {
+		GameManager::GetInstance()->RemoveFromIndex(this);
+		tag = id;
+		GameManager::GetInstance()->AddToIndex(this);
+	}
+	else {
+		tag = id;
+	}
 }
 
 bool GameObject::GetActive()
@@ -76,27 +196,35 @@ bool GameObject::GetActive()
 
 void GameObject::Spawn()
 {
+	std::shared_ptr<Transform> transform = GetTransform();
 	if (transform == nullptr) {
 		transform = std::make_shared<Transform>();
+		SetTransform(transform);
 	}
 
+	std::shared_ptr<PhysicsObject> physicsObject = GetPhysicsObject();
 	if (physicsObject == nullptr) {
 		physicsObject = std::make_shared<PhysicsObject>(transform);
-		PhysicsManager::GetInstance()->AddPhysicsObject(physicsObject);
+		SetPhysicsObject(physicsObject);
 	}
-	
-	// glm::lerp(glm::vec3(), glm::vec3(), 4.0f);
-	instanceId = mesh->AddInstance(transform);
+
+	MeshComponent& meshComponent = EntityRegistry::GetInstance()->Get<MeshComponent>(entity);
+	meshComponent.instanceId = meshComponent.mesh->AddInstance(transform);
 	physicsObject->SetAlive(true);
 	active = true;
+
+	GameManager::GetInstance()->AddToIndex(this);
 }
 
 void GameObject::Despawn()
 {
-	mesh->RemoveInstance(instanceId);
-	instanceId = -1;
-	physicsObject->SetAlive(false);
+	MeshComponent& meshComponent = EntityRegistry::GetInstance()->Get<MeshComponent>(entity);
+	meshComponent.mesh->RemoveInstance(meshComponent.instanceId);
+	meshComponent.instanceId = -1;
+	GetPhysicsObject()->SetAlive(false);
 	active = false;
+
+	GameManager::GetInstance()->RemoveFromIndex(this);
 }
 
 #pragma endregion
@@ -105,9 +233,61 @@ void GameObject::Despawn()
 
 void GameObject::Update()
 {
-	if (!physicsObject->GetAlive() && DebugManager::GetInstance()->GetDrawHandles()) {
-		transform->DrawHandles();
+}
+
+#pragma endregion
+
+#pragma region Physics Events
+
+void GameObject::ListenForPhysicsEvents()
+{
+	std::shared_ptr<PhysicsObject> physicsObject = GetPhysicsObject();
+	if (physicsObject != nullptr) {
+		physicsObject->SetEventCallback([this](const PhysicsEvent& event) { HandlePhysicsEvent(event); });
 	}
 }
 
+void GameObject::HandlePhysicsEvent(const PhysicsEvent& event)
+{
+	switch (event.type) {
+	case PhysicsEventTypes::TriggerEnter:
+		OnTriggerEnter(event);
+		break;
+	case PhysicsEventTypes::TriggerStay:
+		OnTriggerStay(event);
+		break;
+	case PhysicsEventTypes::TriggerExit:
+		OnTriggerExit(event);
+		break;
+	case PhysicsEventTypes::CollisionEnter:
+		OnCollisionEnter(event);
+		break;
+	case PhysicsEventTypes::CollisionExit:
+		OnCollisionExit(event);
+		break;
+	default:
+		break;
+	}
+}
+
+void GameObject::OnTriggerEnter(const PhysicsEvent& event)
+{
+}
+
+void GameObject::OnTriggerStay(const PhysicsEvent& event)
+{
+}
+
+void GameObject::OnTriggerExit(const PhysicsEvent& event)
+{
+}
+
+void GameObject::OnCollisionEnter(const PhysicsEvent& event)
+{
+}
+
+void GameObject::OnCollisionExit(const PhysicsEvent& event)
+{
+}
+
 #pragma endregion
\ No newline at end of file
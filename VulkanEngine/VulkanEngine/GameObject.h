@@ -4,29 +4,62 @@
 #include "Transform.h"
 #include "Mesh.h"
 #include "PhysicsObject.h"
+#include "EntityRegistry.h"
+#include "StringId.h"
 
-class GameObject
+class GameObject : public std::enable_shared_from_this<GameObject>
 {
 private:
-	std::shared_ptr<Transform> transform;
-	std::shared_ptr<PhysicsObject> physicsObject;
+	friend class GameManager;
 
-	std::shared_ptr<Mesh> mesh;
-	int instanceId;
+	//The transform, physics object and mesh instance are stored as components of this entity
+	Entity entity;
 
-	std::string name;
+	//Interned so spawned objects can be indexed by them in game manager
+	StringId name;
+	StringId tag;
+
+	//Position in game manager's list of spawned objects with the same tag, lets the object be removed without searching
+	uint32_t tagIndex = UINT32_MAX;
 
 	bool active;
 
+	/// <summary>
+	/// Routes the physics object's trigger and collision events to this object's event methods
+	/// </summary>
+	void ListenForPhysicsEvents();
+
+	/// <summary>
+	/// Calls the event method matching the event's type
+	/// </summary>
+	/// <param name="event">The event to handle</param>
+	void HandlePhysicsEvent(const PhysicsEvent& event);
+
 public:
 #pragma region Constructor
 
-	GameObject(std::shared_ptr<Mesh> mesh, std::shared_ptr<Transform> transform = nullptr, std::shared_ptr<PhysicsObject> physicsObject = nullptr);
+	GameObject(const std::shared_ptr<Mesh>& mesh, const std::shared_ptr<Transform>& transform = nullptr, const std::shared_ptr<PhysicsObject>& physicsObject = nullptr);
+
+	/// <summary>
+	/// Copying would leave two objects sharing and destroying the same entity
+	/// </summary>
+	GameObject(const GameObject&) = delete;
+
+	/// <summary>
+	/// Stops the physics object from sending events to this object in case it is still in use elsewhere, destroys the entity and removes the object from game manager's index
+	/// </summary>
+	virtual ~GameObject();
 
 #pragma endregion
 
 #pragma region Accessors
 
+	/// <summary>
+	/// Returns the entity holding this object's components
+	/// </summary>
+	/// <returns>The game object's entity</returns>
+	Entity GetEntity();
+
 	/// <summary>
 	/// Returns the transform that is being used by this game object
 	/// </summary>
@@ -37,7 +70,20 @@ public:
 	/// Sets the game object's transform to the specified value
 	/// </summary>
 	/// <param name="value">The transform to set to</param>
-	void SetTransform(std::shared_ptr<Transform> value);
+	void SetTransform(const std::shared_ptr<Transform>& value);
+
+	/// <summary>
+	/// Attaches this object's transform to another object's so it follows it around, its transform becomes relative to the parent's.
+	/// Attached objects should not be simulated by physics
+	/// </summary>
+	/// <param name="value">The object to attach to, nullptr to detach</param>
+	void SetParent(const std::shared_ptr<GameObject>& value);
+
+	/// <summary>
+	/// Returns the matrix placing this object in the world, including every parent's transform as of the latest scene graph update
+	/// </summary>
+	/// <returns>The world matrix</returns>
+	glm::mat4 GetWorldMatrix();
 
 	/// <summary>
 	/// Returns the physics object that is being used by this game object
@@ -49,7 +95,7 @@ public:
 	/// Sets the game object's physics object
 	/// </summary>
 	/// <param name="value">The physics object to set to</param>
-	void SetPhysicsObject(std::shared_ptr<PhysicsObject> value);
+	void SetPhysicsObject(const std::shared_ptr<PhysicsObject>& value);
 
 	/// <summary>
 	/// Returns the mesh that is being used by this game object
@@ -61,13 +107,31 @@ public:
 	/// Returns the name of this gameobject
 	/// </summary>
 	/// <returns>The gameobject's name</returns>
-	std::string GetName();
+	const std::string& GetName();
+
+	/// <summary>
+	/// Returns the interned ID of this gameobject's name
+	/// </summary>
+	/// <returns>The gameobject's name ID</returns>
+	StringId GetNameId();
 
 	/// <summary>
 	/// Sets the name of this gameobject used to display the object and access it in game manager
 	/// </summary>
 	/// <param name="value">The string to set the name to</param>
-	void SetName(std::string value);
+	void SetName(const std::string& value);
+
+	/// <summary>
+	/// Returns the interned ID of the tag grouping this gameobject with others
+	/// </summary>
+	/// <returns>The gameobject's tag ID</returns>
+	StringId GetTag();
+
+	/// <summary>
+	/// Sets the tag used to find this gameobject along with every other spawned object with the same tag in game manager
+	/// </summary>
+	/// <param name="value">The string to set the tag to</param>
+	void SetTag(const std::string& value);
 
 	/// <summary>
 	/// Returns whether this object is active (visible and interactable)
@@ -80,12 +144,13 @@ public:
 #pragma region Spawning
 
 	/// <summary>
-	/// Sets the object to active and spawns it into the entity manager
+	/// Sets the object to active, spawns it into the entity manager and adds it to game manager's name and tag index.
+	/// The object must be owned by a shared pointer
 	/// </summary>
 	virtual void Spawn();
 
 	/// <summary>
-	/// Sets the object as inactive and despawns it with the entity manager
+	/// Sets the object as inactive, despawns it with the entity manager and removes it from game manager's name and tag index
 	/// </summary>
 	virtual void Despawn();
 
@@ -94,9 +159,43 @@ public:
 #pragma region Update
 
 	/// <summary>
-	/// Updates this objects variables once per frame
+	/// Updates this objects variables once per frame, shared behaviour such as drawing handles is done by the entity registry's systems
 	/// </summary>
 	virtual void Update();
 
+#pragma endregion
+
+#pragma region Physics Events
+
+	/// <summary>
+	/// Called after the physics update in which this object started overlapping a trigger, or something started overlapping this trigger
+	/// </summary>
+	/// <param name="event">The event, other is the body that was touched</param>
+	virtual void OnTriggerEnter(const PhysicsEvent& event);
+
+	/// <summary>
+	/// Called after every physics step in which this object and a trigger are still overlapping
+	/// </summary>
+	/// <param name="event">The event, other is the body that is being touched</param>
+	virtual void OnTriggerStay(const PhysicsEvent& event);
+
+	/// <summary>
+	/// Called after the physics update in which this object and a trigger stopped overlapping
+	/// </summary>
+	/// <param name="event">The event, other is the body that was touched</param>
+	virtual void OnTriggerExit(const PhysicsEvent& event);
+
+	/// <summary>
+	/// Called after the physics update in which this object started touching another solid body
+	/// </summary>
+	/// <param name="event">The event, other is the body that was touched</param>
+	virtual void OnCollisionEnter(const PhysicsEvent& event);
+
+	/// <summary>
+	/// Called after the physics update in which this object stopped touching another solid body
+	/// </summary>
+	/// <param name="event">The event, other is the body that was touched</param>
+	virtual void OnCollisionExit(const PhysicsEvent& event);
+
 #pragma endregion
 };
\ No newline at end of file
@@ -1,4 +1,4 @@
-#include "pch.h"
+﻿#include "pch.h"
 #include "SwapChain.h"
 
 #include "VulkanManager.h"
@@ -8,6 +8,14 @@
 #include "Camera.h"
 #include "TextureImages.h"
 #include "GuiManager.h"
+#include "InstanceBuffer.h"
+#include "MemoryAllocator.h"
+#include "UploadManager.h"
+#include "JobSystem.h"
+#include "PhysicsManager.h"
+#include "PhysicsKernels.h"
+#include "SceneGraph.h"
+#include "AllocationCounter.h"
 
 #define logicalDevice VulkanManager::GetInstance()->GetLogicalDevice()
 #define physicalDevice VulkanManager::GetInstance()->GetPhysicalDevice()
@@ -125,9 +133,9 @@ void GuiManager::InitImGui()
 	CreateFrameBuffers();
 	CreateCommandPool();
 	CreateCommandBuffers();
-	VkCommandBuffer cb = CommandBuffer::BeginSingleTimeCommand();
-	ImGui_ImplVulkan_CreateFontsTexture(cb);
-	CommandBuffer::EndSingleTimeCommand(cb);
+	//ImGui keeps its font staging buffer alive until shutdown so the upload doesn't need to be waited on
+	ImGui_ImplVulkan_CreateFontsTexture(UploadManager::GetInstance()->GetCommandBuffer());
+	UploadManager::GetInstance()->Submit();
 }
 void GuiManager::Draw(uint32_t imageIndex)
 {
@@ -187,23 +195,113 @@ void GuiManager::DrawGUI()
 	static ImVec4 v4Color = ImColor(255, 0, 0);
 	ImGuiWindowFlags window_flags = ImGuiWindowFlags_NoResize | ImGuiWindowFlags_NoCollapse | ImGuiWindowFlags_NoTitleBar;
 	ImGui::SetNextWindowPos(ImVec2(1, 1), 0);
-	ImGui::SetNextWindowSize(ImVec2(340, 140), 0);
+	ImGui::SetNextWindowSize(ImVec2(340, 600), 0);
 	// tring sAbout = m_pSystem->GetAppName() + " - About";
 	ImGui::Begin("About", (bool*)0, window_flags);
 	{
 		ImGui::Text("Programmer: \n");
 		ImGui::TextColored(v4Color, "Vulkan Team");
+		//Every allocation since the last time the window was drawn, which is once per frame
+		static uint64_t lastAllocationCount = 0;
+		uint64_t allocationCount = AllocationCounter::GetCount();
+		uint32_t frameAllocations = static_cast<uint32_t>(allocationCount - lastAllocationCount);
+		lastAllocationCount = allocationCount;
+		//Device idles and upload stalls since the last frame, neither should happen while the scene is running
+		static uint32_t lastIdleCount = 0;
+		static uint32_t lastStallCount = 0;
+		uint32_t idleCount = VulkanManager::GetInstance()->GetIdleCount();
+		uint32_t stallCount = UploadManager::GetInstance()->GetStallCount();
+		uint32_t frameIdles = idleCount - lastIdleCount;
+		uint32_t frameStalls = stallCount - lastStallCount;
+		lastIdleCount = idleCount;
+		lastStallCount = stallCount;
 		ImGui::Text("FrameRate: %.2f [FPS] -> %.3f [ms/frame]\n",
 			ImGui::GetIO().Framerate, 1000.0f / ImGui::GetIO().Framerate);
+		DrawStats drawStats = EntityManager::GetInstance()->GetDrawStats();
+		ImGui::Text("Draw Recording: %.3f ms, ~%.3f ms saved\n", drawStats.recordTime, drawStats.savedTime);
+		ImGui::Text(" %u secondary buffers re-recorded, %u reused, %u threads\n", drawStats.recordedCount, drawStats.reusedCount, drawStats.threadCount);
+		ImGui::Text("Job System: %u threads, %u jobs stolen\n", JobSystem::GetInstance()->GetThreadCount(), JobSystem::GetInstance()->GetStealCount());
+		ImGui::Text("Instance Buffer Reallocations: %u\n", InstanceBuffer::GetReallocationCount());
+		MemoryStats memoryStats = MemoryAllocator::GetInstance()->GetStats();
+		ImGui::Text("Device Memory: %u blocks, %u allocations\n", memoryStats.blockCount, memoryStats.allocationCount);
+		ImGui::Text(" %.2f / %.2f MB in use, %.0f%% fragmented\n",
+			memoryStats.bytesInUse / (1024.0f * 1024.0f), memoryStats.bytesReserved / (1024.0f * 1024.0f), memoryStats.fragmentation * 100.0f);
+		ImGui::Text("Instance Uploads: %.1f KB this frame, %u bytes each\n",
+			EntityManager::GetInstance()->GetUploadedInstanceBytes() / 1024.0f, Mesh::GetInstanceStride(EntityManager::GetInstance()->GetInstanceFormat()));
+		ImGui::Text("Instances: %u removed and added in %.3f ms\n",
+			GameManager::GetInstance()->GetInstanceChurnCount(), GameManager::GetInstance()->GetInstanceChurnTime());
+		ImGui::Text(" %u device idles over %u churn frames\n",
+			GameManager::GetInstance()->GetInstanceChurnIdles(), GameManager::GetInstance()->GetInstanceChurnFrames());
+		ImGui::Text("Projectiles: %u live, %u allocations spawning, %u this frame\n", GameManager::GetInstance()->GetProjectileCount(),
+			GameManager::GetInstance()->GetProjectileAllocations(), frameAllocations);
+		ImGui::Text("Scene Graph: %u nodes, %u updated in %.3f ms\n", SceneGraph::GetInstance()->GetNodeCount(),
+			SceneGraph::GetInstance()->GetUpdatedNodeCount(), SceneGraph::GetInstance()->GetUpdateTime());
+		ImGui::Text("Upload Batches: %u submitted, %u pending\n",
+			UploadManager::GetInstance()->GetSubmitCount(), UploadManager::GetInstance()->GetPendingBatchCount());
+		ImGui::Text("Queue Idles: %u this frame, %u upload stalls\n", frameIdles, frameStalls);
+		ImGui::Text("Physics: %u bodies integrated in %.3f ms\n",
+			PhysicsManager::GetInstance()->GetBodyCount(), PhysicsManager::GetInstance()->GetIntegrationTime());
+		ImGui::Text(" %u steps at %.0f Hz\n", PhysicsManager::GetInstance()->GetStepCount(), 1.0f / PhysicsManager::GetInstance()->GetFixedTimeStep());
+		ImGui::SameLine();
+		bool physicsThreaded = PhysicsManager::GetInstance()->GetThreaded();
+		if (ImGui::Checkbox("Own Thread", &physicsThreaded)) {
+			PhysicsManager::GetInstance()->SetThreaded(physicsThreaded);
+		}
+		ImGui::Text("Broadphase: %u candidate pairs in %.3f ms\n",
+			PhysicsManager::GetInstance()->GetCandidatePairCount(), PhysicsManager::GetInstance()->GetBroadphaseTime());
+		int broadphaseType = PhysicsManager::GetInstance()->GetBroadphaseType();
+		ImGui::RadioButton("All Pairs", &broadphaseType, BroadphaseTypes::AllPairs);
+		ImGui::SameLine();
+		ImGui::RadioButton("Sweep and Prune", &broadphaseType, BroadphaseTypes::Sweep);
+		ImGui::SameLine();
+		ImGui::RadioButton("Grid", &broadphaseType, BroadphaseTypes::Grid);
+		PhysicsManager::GetInstance()->SetBroadphaseType(static_cast<BroadphaseTypes>(broadphaseType));
+		float narrowphaseTime = PhysicsManager::GetInstance()->GetNarrowphaseTime();
+		ImGui::Text("Narrowphase: %u contacts, %.2f million pairs/s\n", PhysicsManager::GetInstance()->GetContactCount(),
+			narrowphaseTime > 0.0f ? PhysicsManager::GetInstance()->GetCandidatePairCount() / (narrowphaseTime * 1000.0f) : 0.0f);
+		ImGui::Text("Solver: %.3f ms, %u/%u bodies asleep\n", PhysicsManager::GetInstance()->GetSolverTime(),
+			PhysicsManager::GetInstance()->GetSleepingBodyCount(), PhysicsManager::GetInstance()->GetBodyCount());
+		float raycastTime = PhysicsManager::GetInstance()->GetRaycastTime();
+		ImGui::Text("Raycasts: %u in %.3f ms, %.2f million rays/s\n", PhysicsManager::GetInstance()->GetRaycastCount(), raycastTime,
+			raycastTime > 0.0f ? PhysicsManager::GetInstance()->GetRaycastCount() / (raycastTime * 1000.0f) : 0.0f);
+		ImGui::SameLine();
+		bool sleepingEnabled = PhysicsManager::GetInstance()->GetSleepingEnabled();
+		if (ImGui::Checkbox("Sleep", &sleepingEnabled)) {
+			PhysicsManager::GetInstance()->SetSleepingEnabled(sleepingEnabled);
+		}
+		int simdLevel = PhysicsKernels::GetLevel();
+		ImGui::RadioButton("Scalar", &simdLevel, SimdLevels::Scalar);
+		if (PhysicsKernels::GetSupportedLevel() >= SimdLevels::SSE) {
+			ImGui::SameLine();
+			ImGui::RadioButton("SSE", &simdLevel, SimdLevels::SSE);
+		}
+		if (PhysicsKernels::GetSupportedLevel() >= SimdLevels::AVX2) {
+			ImGui::SameLine();
+			ImGui::RadioButton("AVX2", &simdLevel, SimdLevels::AVX2);
+		}
+		PhysicsKernels::SetLevel(static_cast<SimdLevels>(simdLevel));
+		bool physicsRecording = PhysicsManager::GetInstance()->GetRecording();
+		if (ImGui::Checkbox("Record Physics", &physicsRecording)) {
+			//Saved next to the executable, replay it with --replay PhysicsRecording.bin
+			if (physicsRecording) {
+				PhysicsManager::GetInstance()->StartRecording();
+			}
+			else {
+				PhysicsManager::GetInstance()->StopRecording("PhysicsRecording.bin");
+			}
+		}
 		ImGui::Separator();
 		ImGui::Text("Controls:\n");
 		ImGui::Text(" WASDQE: Movement\n");
 		ImGui::Text(" Right Click: Rotation toggle\n");
 		ImGui::Text(" F9: Toggle Debug Handles\n");
+		ImGui::Text(" F10: Spawn Box Pyramid\n");
+		ImGui::Text(" F11: Toggle Raycast Benchmark\n");
+		ImGui::Text(" F12: Toggle Instance Benchmark\n");
 	}
 	ImGui::End();
 }
-std::vector<VkFramebuffer> GuiManager::GetFrameBuffers(void)
+const std::vector<VkFramebuffer>& GuiManager::GetFrameBuffers(void)
 {
 	return guiFrameBuffers;
 }
@@ -233,7 +331,7 @@ void GuiManager::Cleanup()
 	}
 	vkFreeCommandBuffers(logicalDevice, imGuiCommandPool, static_cast<uint32_t>(imGuiCommandBuffers.size()), imGuiCommandBuffers.data());
 }
-std::vector<VkCommandBuffer> GuiManager::GetCommandBuffers()
+const std::vector<VkCommandBuffer>& GuiManager::GetCommandBuffers()
 {
 	return imGuiCommandBuffers;
 }
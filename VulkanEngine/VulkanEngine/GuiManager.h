@@ -26,7 +26,7 @@ public:
 	void Draw(uint32_t imageIndex);
 	void DrawGUI();
 
-	std::vector<VkFramebuffer> GetFrameBuffers(void);
+	const std::vector<VkFramebuffer>& GetFrameBuffers(void);
 	void FullCleanup();
 	void Cleanup();
 
@@ -34,7 +34,7 @@ public:
 	/// Returns the list of command buffers used by the swap chain
 	/// </summary>
 	/// <returns>The list of command buffers</returns>
-	std::vector<VkCommandBuffer> GetCommandBuffers();
+	const std::vector<VkCommandBuffer>& GetCommandBuffers();
 
 	/// <summary>
 	/// Returns the command pool being used by the application
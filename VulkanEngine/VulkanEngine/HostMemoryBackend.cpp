@@ -0,0 +1,102 @@
+#include "pch.h"
+#include "HostMemoryBackend.h"
+
+#pragma region Constructor
+
+HostMemoryBackend::HostMemoryBackend()
+{
+	memoryTypes[0] = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+	memoryTypes[1] = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+#pragma endregion
+
+#pragma region Memory Types
+
+uint32_t HostMemoryBackend::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
+{
+	for (uint32_t i = 0; i < MEMORY_TYPE_COUNT; i++) {
+		if ((typeFilter & (1 << i)) && (memoryTypes[i] & properties) == properties) {
+			return i;
+		}
+	}
+
+	throw std::runtime_error("Failed to find suitable memory type!");
+}
+
+bool HostMemoryBackend::IsHostVisible(uint32_t memoryTypeIndex)
+{
+	return (memoryTypes[memoryTypeIndex] & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+#pragma endregion
+
+#pragma region Memory Management
+
+VkDeviceMemory HostMemoryBackend::AllocateMemory(uint32_t memoryTypeIndex, VkDeviceSize size)
+{
+	if (memoryTypeIndex >= MEMORY_TYPE_COUNT) {
+		throw std::runtime_error("Failed to allocate device memory block, the memory type doesn't exist!");
+	}
+
+	VkDeviceMemory memory = reinterpret_cast<VkDeviceMemory>(static_cast<uintptr_t>(nextHandle++));
+	blocks[memory] = IsHostVisible(memoryTypeIndex) ? std::unique_ptr<char[]>(new char[static_cast<size_t>(size)]) : nullptr;
+	allocateCount++;
+
+	return memory;
+}
+
+void HostMemoryBackend::FreeMemory(VkDeviceMemory memory)
+{
+	if (blocks.find(memory) == blocks.end()) {
+		throw std::runtime_error("Failed to free device memory block, it was never allocated!");
+	}
+
+	if (mappedBlocks.find(memory) != mappedBlocks.end()) {
+		throw std::runtime_error("Failed to free device memory block, it is still mapped!");
+	}
+
+	blocks.erase(memory);
+}
+
+void* HostMemoryBackend::MapMemory(VkDeviceMemory memory, VkDeviceSize size)
+{
+	std::map<VkDeviceMemory, std::unique_ptr<char[]>>::iterator block = blocks.find(memory);
+	if (block == blocks.end() || block->second == nullptr) {
+		throw std::runtime_error("Failed to map device memory block, it isn't host visible!");
+	}
+
+	if (!mappedBlocks.insert(memory).second) {
+		throw std::runtime_error("Failed to map device memory block, it is already mapped!");
+	}
+
+	return block->second.get();
+}
+
+void HostMemoryBackend::UnmapMemory(VkDeviceMemory memory)
+{
+	if (mappedBlocks.erase(memory) == 0) {
+		throw std::runtime_error("Failed to unmap device memory block, it isn't mapped!");
+	}
+}
+
+#pragma endregion
+
+#pragma region Accessors
+
+uint32_t HostMemoryBackend::GetBlockCount()
+{
+	return static_cast<uint32_t>(blocks.size());
+}
+
+uint32_t HostMemoryBackend::GetMappedBlockCount()
+{
+	return static_cast<uint32_t>(mappedBlocks.size());
+}
+
+uint32_t HostMemoryBackend::GetAllocateCount()
+{
+	return allocateCount;
+}
+
+#pragma endregion
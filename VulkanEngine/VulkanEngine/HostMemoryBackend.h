@@ -0,0 +1,99 @@
+#pragma once
+
+#include "pch.h"
+#include "MemoryBackend.h"
+
+class HostMemoryBackend : public MemoryBackend
+{
+private:
+	//Memory type 0 is device local and memory type 1 is host visible and coherent
+	static constexpr uint32_t MEMORY_TYPE_COUNT = 2;
+	VkMemoryPropertyFlags memoryTypes[MEMORY_TYPE_COUNT];
+
+	//Host visible blocks are backed by real memory so writes through the mapped pointers can be checked,
+	//device local blocks only get a handle
+	std::map<VkDeviceMemory, std::unique_ptr<char[]>> blocks;
+	std::set<VkDeviceMemory> mappedBlocks;
+	uint64_t nextHandle = 1;
+	uint32_t allocateCount = 0;
+
+public:
+#pragma region Constructor
+
+	HostMemoryBackend();
+
+#pragma endregion
+
+#pragma region Memory Types
+
+	/// <summary>
+	/// Finds the first of the two memory types that matches the type filter and has the requested properties
+	/// </summary>
+	/// <param name="typeFilter">Bit mask of the acceptable memory types</param>
+	/// <param name="properties">The required memory properties</param>
+	/// <returns>The index of the memory type to use</returns>
+	uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) override;
+
+	/// <summary>
+	/// Returns whether memory of the specified type can be mapped by the host
+	/// </summary>
+	/// <param name="memoryTypeIndex">The memory type to check</param>
+	/// <returns>True if the memory type is host visible</returns>
+	bool IsHostVisible(uint32_t memoryTypeIndex) override;
+
+#pragma endregion
+
+#pragma region Memory Management
+
+	/// <summary>
+	/// Hands out a new block, backed by host memory if the type is host visible
+	/// </summary>
+	/// <param name="memoryTypeIndex">The memory type to allocate from</param>
+	/// <param name="size">The size of the block in bytes</param>
+	/// <returns>The handle of the block</returns>
+	VkDeviceMemory AllocateMemory(uint32_t memoryTypeIndex, VkDeviceSize size) override;
+
+	/// <summary>
+	/// Frees a block, throws if it was never allocated or is still mapped
+	/// </summary>
+	/// <param name="memory">The memory to free</param>
+	void FreeMemory(VkDeviceMemory memory) override;
+
+	/// <summary>
+	/// Returns the host memory behind a block, throws if it is device local or already mapped
+	/// </summary>
+	/// <param name="memory">The memory to map</param>
+	/// <param name="size">The size of the memory block</param>
+	/// <returns>Pointer to the start of the block's host memory</returns>
+	void* MapMemory(VkDeviceMemory memory, VkDeviceSize size) override;
+
+	/// <summary>
+	/// Unmaps a block, throws if it wasn't mapped
+	/// </summary>
+	/// <param name="memory">The memory to unmap</param>
+	void UnmapMemory(VkDeviceMemory memory) override;
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the number of blocks that have been allocated and not freed
+	/// </summary>
+	/// <returns>The live block count</returns>
+	uint32_t GetBlockCount();
+
+	/// <summary>
+	/// Returns the number of blocks that are currently mapped
+	/// </summary>
+	/// <returns>The mapped block count</returns>
+	uint32_t GetMappedBlockCount();
+
+	/// <summary>
+	/// Returns the number of blocks that have been allocated since the backend was created
+	/// </summary>
+	/// <returns>The allocation count</returns>
+	uint32_t GetAllocateCount();
+
+#pragma endregion
+};
@@ -2,6 +2,8 @@
 #include "Image.h"
 
 #include "VulkanManager.h"
+#include "MemoryAllocator.h"
+#include "UploadManager.h"
 
 #include "Buffer.h"
 #include "TextureImages.h"
@@ -11,7 +13,7 @@ void Image::Cleanup()
 {
 	vkDestroyImage(VulkanManager::GetInstance()->GetLogicalDevice(), image, nullptr);
 	vkDestroyImageView(VulkanManager::GetInstance()->GetLogicalDevice(), view, nullptr);
-	vkFreeMemory(VulkanManager::GetInstance()->GetLogicalDevice(), memory, nullptr);
+	MemoryAllocator::GetInstance()->Free(allocation);
 }
 
 #pragma endregion
@@ -33,9 +35,9 @@ VkImageView* Image::GetView()
 	return &view;
 }
 
-VkDeviceMemory* Image::GetMemory()
+Allocation* Image::GetAllocation()
 {
-	return &memory;
+	return &allocation;
 }
 
 #pragma endregion
@@ -69,16 +71,11 @@ void Image::CreateImage(uint32_t mipLevels, uint32_t width, uint32_t height, VkF
 	VkMemoryRequirements memoryRequirements;
 	vkGetImageMemoryRequirements(VulkanManager::GetInstance()->GetLogicalDevice(), *image.GetImage(), &memoryRequirements);
 
-	VkMemoryAllocateInfo allocateInfo = {};
-	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-	allocateInfo.allocationSize = memoryRequirements.size;
-	allocateInfo.memoryTypeIndex = VulkanManager::GetInstance()->FindMemoryType(memoryRequirements.memoryTypeBits, properties);
+	*image.GetAllocation() = MemoryAllocator::GetInstance()->Allocate(memoryRequirements, properties, tiling == VK_IMAGE_TILING_LINEAR);
 
-	if (vkAllocateMemory(VulkanManager::GetInstance()->GetLogicalDevice(), &allocateInfo, nullptr, image.GetMemory()) != VK_SUCCESS) {
-		throw std::runtime_error("Failed to allocate image memory!");
+	if (vkBindImageMemory(VulkanManager::GetInstance()->GetLogicalDevice(), *image.GetImage(), image.GetAllocation()->memory, image.GetAllocation()->offset) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to bind image memory!");
 	}
-
-	vkBindImageMemory(VulkanManager::GetInstance()->GetLogicalDevice(), *image.GetImage(), *image.GetMemory(), 0);
 }
 
 void Image::CreateImageView(Image* image, VkFormat format, VkImageAspectFlags aspectFlags, uint32_t mipLevels)
@@ -124,7 +121,8 @@ VkImageView Image::CreateImageView(VkImage image,  VkFormat format, VkImageAspec
 
 void Image::TransitionImageLayout(Image image, VkImageLayout oldLayout, VkImageLayout newLayout, uint32_t mipLevels, uint32_t layers)
 {
-	VkCommandBuffer commandBuffer = CommandBuffer::BeginSingleTimeCommand();
+	//Recorded into the current upload batch, the caller decides when the batch is submitted
+	VkCommandBuffer commandBuffer = UploadManager::GetInstance()->GetCommandBuffer();
 	
 	VkImageMemoryBarrier barrier = {};
 	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -161,16 +159,14 @@ void Image::TransitionImageLayout(Image image, VkImageLayout oldLayout, VkImageL
 	}
 
 	vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-
-	CommandBuffer::EndSingleTimeCommand(commandBuffer);
 }
 
-void Image::CopyBufferToImage(VkBuffer buffer, Image image, uint32_t imageWidth, uint32_t imageHeight, uint32_t layers, VkImageLayout layout)
+void Image::CopyBufferToImage(VkBuffer buffer, Image image, uint32_t imageWidth, uint32_t imageHeight, uint32_t layers, VkImageLayout layout, VkDeviceSize bufferOffset)
 {
-	VkCommandBuffer commandBuffer = CommandBuffer::BeginSingleTimeCommand();
+	VkCommandBuffer commandBuffer = UploadManager::GetInstance()->GetCommandBuffer();
 
 	VkBufferImageCopy region = {};
-	region.bufferOffset = 0;
+	region.bufferOffset = bufferOffset;
 	region.bufferImageHeight = 0;
 	region.bufferRowLength = 0;
 
@@ -187,8 +183,6 @@ void Image::CopyBufferToImage(VkBuffer buffer, Image image, uint32_t imageWidth,
 	};
 
 	vkCmdCopyBufferToImage(commandBuffer, buffer, *image.GetImage(), layout, 1, &region);
-
-	CommandBuffer::EndSingleTimeCommand(commandBuffer);
 }
 
 VkFormat Image::FindSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features)
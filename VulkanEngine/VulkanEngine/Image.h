@@ -1,13 +1,14 @@
 #pragma once
 
 #include "pch.h"
+#include "Allocation.h"
 
 class Image
 {
 private:
 	VkImage image;
 	VkImageView view;
-	VkDeviceMemory memory;
+	Allocation allocation;
 
 public:
 
@@ -41,10 +42,10 @@ public:
 	VkImageView* GetView();
 
 	/// <summary>
-	/// Returns the DeviceMemory associated with this image
+	/// Returns the range of device memory sub-allocated for this image
 	/// </summary>
-	/// <returns></returns>
-	VkDeviceMemory* GetMemory();
+	/// <returns>The image's allocation</returns>
+	Allocation* GetAllocation();
 
 #pragma endregion
 
@@ -94,7 +95,8 @@ public:
 	/// <param name="image">The image to copy the data to</param>
 	/// <param name="imageWidth">The width of the image</param>
 	/// <param name="imageHeight">The height of the image</param>
-	static void CopyBufferToImage(VkBuffer buffer, Image image, uint32_t imageWidth, uint32_t imageHeight, uint32_t layers = 1, VkImageLayout layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	/// <param name="bufferOffset">The offset in the buffer that the image data starts at</param>
+	static void CopyBufferToImage(VkBuffer buffer, Image image, uint32_t imageWidth, uint32_t imageHeight, uint32_t layers = 1, VkImageLayout layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VkDeviceSize bufferOffset = 0);
 
 	/// <summary>
 	/// Checks the physical device for format support
@@ -46,18 +46,22 @@ InputManager::InputManager()
     controls[Controls::LeftClick].SetKeyCode(VK_LBUTTON);
     controls[Controls::RightClick].SetKeyCode(VK_RBUTTON);
     controls[Controls::ToggleDebug].SetKeyCode(VK_F9);
+    controls[Controls::SpawnPyramid].SetKeyCode(VK_F10);
+    controls[Controls::RaycastBenchmark].SetKeyCode(VK_F11);
+    controls[Controls::InstanceBenchmark].SetKeyCode(VK_F12);
+    controls[Controls::ProjectileBenchmark].SetKeyCode(VK_F8);
 }
 
 #pragma endregion
 
 #pragma region Accessors
 
-std::vector<Input> InputManager::GetControls()
+const std::vector<Input>& InputManager::GetControls()
 {
     return controls;
 }
 
-std::vector<InputAxis> InputManager::GetAxes()
+const std::vector<InputAxis>& InputManager::GetAxes()
 {
     return axes;
 }
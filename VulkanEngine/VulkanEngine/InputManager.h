@@ -38,13 +38,13 @@ public:
 	/// Returns the list of controls
 	/// </summary>
 	/// <returns>The list of controls used by the input manager</returns>
-	std::vector<Input> GetControls();
+	const std::vector<Input>& GetControls();
 
 	/// <summary>
 	/// Returns the list of axes
 	/// </summary>
 	/// <returns>The list of axes used by the input manager</returns>
-	std::vector<InputAxis> GetAxes();
+	const std::vector<InputAxis>& GetAxes();
 
 	/// <summary>
 	/// Returns the position of the mouse in screen coordinates
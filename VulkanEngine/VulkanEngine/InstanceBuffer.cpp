@@ -0,0 +1,138 @@
+#include "pch.h"
+#include "InstanceBuffer.h"
+
+#include "SwapChain.h"
+#include "UploadManager.h"
+
+std::atomic<uint32_t> InstanceBuffer::reallocationCount{ 0 };
+
+#pragma region Constructor
+
+InstanceBuffer::InstanceBuffer(VkBufferUsageFlags usage, bool deviceLocal)
+{
+	this->usage = usage;
+	this->deviceLocal = deviceLocal;
+}
+
+void InstanceBuffer::Init(VkDeviceSize initialSize)
+{
+	uint32_t bufferCount = deviceLocal ? 1 : SwapChain::MAX_FRAMES_IN_FLIGHT;
+	buffers.resize(bufferCount);
+	capacities.resize(bufferCount, 0);
+
+	for (uint32_t i = 0; i < buffers.size(); i++) {
+		Reallocate(i, initialSize);
+	}
+}
+
+void InstanceBuffer::Cleanup()
+{
+	for (uint32_t i = 0; i < buffers.size(); i++) {
+		buffers[i].Cleanup();
+		capacities[i] = 0;
+	}
+}
+
+#pragma endregion
+
+#pragma region Accessors
+
+VkBuffer InstanceBuffer::GetBuffer(uint32_t frame)
+{
+	return buffers[frame % buffers.size()].GetBuffer();
+}
+
+VkDeviceSize InstanceBuffer::GetCapacity(uint32_t frame)
+{
+	return capacities[frame % capacities.size()];
+}
+
+uint32_t InstanceBuffer::GetReallocationCount()
+{
+	return reallocationCount;
+}
+
+uint32_t InstanceBuffer::GetGeneration()
+{
+	return generation;
+}
+
+bool InstanceBuffer::GetDeviceLocal()
+{
+	return deviceLocal;
+}
+
+uint32_t InstanceBuffer::GetBufferCount()
+{
+	return static_cast<uint32_t>(buffers.size());
+}
+
+#pragma endregion
+
+#pragma region Buffer Management
+
+void* InstanceBuffer::Map(uint32_t frame, VkDeviceSize size)
+{
+	if (deviceLocal) {
+		throw std::runtime_error("Device local instance buffers can't be mapped!");
+	}
+
+	Reserve(frame, size);
+	return buffers[frame].GetMappedData();
+}
+
+bool InstanceBuffer::Reserve(uint32_t frame, VkDeviceSize size)
+{
+	frame %= buffers.size();
+
+	if (size <= capacities[frame]) {
+		return false;
+	}
+
+	//Grow geometrically so that steady spawning only reallocates a logarithmic number of times
+	Reallocate(frame, std::max(size, capacities[frame] * 2));
+	reallocationCount++;
+	return true;
+}
+
+void InstanceBuffer::WriteRange(uint32_t frame, const void* data, VkDeviceSize offset, VkDeviceSize size)
+{
+	if (deviceLocal) {
+		UploadManager::GetInstance()->UploadToBuffer(data, size, buffers[0].GetBuffer(), offset);
+	}
+	else {
+		memcpy(static_cast<char*>(buffers[frame].GetMappedData()) + offset, data, static_cast<size_t>(size));
+	}
+}
+
+void InstanceBuffer::Write(uint32_t frame, const void* data, VkDeviceSize size)
+{
+	memcpy(Map(frame, size), data, static_cast<size_t>(size));
+}
+
+void InstanceBuffer::Reallocate(uint32_t frame, VkDeviceSize size)
+{
+	//The frame's fence has already been waited on so nothing on the GPU is still reading a mapped buffer,
+	//but every frame in flight reads a device local buffer so it is only destroyed once the upload batch after them completes
+	if (capacities[frame] > 0) {
+		if (deviceLocal) {
+			UploadManager::GetInstance()->DestroyAfterBatch(buffers[frame]);
+		}
+		else {
+			buffers[frame].Cleanup();
+		}
+	}
+
+	buffers[frame] = Buffer();
+	if (deviceLocal) {
+		Buffer::CreateBuffer(size, usage | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffers[frame]);
+	}
+	else {
+		//Host visible memory blocks stay mapped for their whole lifetime so the buffer can be written to directly
+		Buffer::CreateBuffer(size, usage, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, buffers[frame]);
+	}
+	capacities[frame] = size;
+	generation++;
+}
+
+#pragma endregion
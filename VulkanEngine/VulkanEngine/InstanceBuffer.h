@@ -0,0 +1,132 @@
+#pragma once
+
+#include "pch.h"
+#include "Buffer.h"
+
+#include <atomic>
+
+class InstanceBuffer
+{
+private:
+	VkBufferUsageFlags usage;
+
+	//Device local buffers are a single buffer shared by every frame in flight that is written through the upload manager,
+	//for instances that rarely change
+	bool deviceLocal;
+
+	//One persistently mapped buffer per frame in flight, or the one device local buffer
+	std::vector<Buffer> buffers;
+	std::vector<VkDeviceSize> capacities;
+
+	//Incremented whenever a buffer is re-created so cached commands that bound the old buffer can be detected
+	uint32_t generation = 0;
+
+	static std::atomic<uint32_t> reallocationCount;
+
+	/// <summary>
+	/// Destroys and re-creates the buffer for the specified frame with at least the requested capacity
+	/// </summary>
+	/// <param name="frame">The frame in flight whose buffer should be re-created</param>
+	/// <param name="size">The minimum capacity in bytes</param>
+	void Reallocate(uint32_t frame, VkDeviceSize size);
+
+public:
+#pragma region Constructor
+
+	InstanceBuffer(VkBufferUsageFlags usage = VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, bool deviceLocal = false);
+
+	/// <summary>
+	/// Creates and maps a buffer for every frame in flight, or the single buffer if device local
+	/// </summary>
+	/// <param name="initialSize">The starting capacity of each buffer in bytes</param>
+	void Init(VkDeviceSize initialSize);
+
+	/// <summary>
+	/// Unmaps and destroys all of the buffers
+	/// </summary>
+	void Cleanup();
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the VkBuffer used by the specified frame in flight
+	/// </summary>
+	/// <param name="frame">The frame in flight</param>
+	/// <returns>The VkBuffer to bind when drawing that frame</returns>
+	VkBuffer GetBuffer(uint32_t frame);
+
+	/// <summary>
+	/// Returns the current capacity of the buffer used by the specified frame in flight
+	/// </summary>
+	/// <param name="frame">The frame in flight</param>
+	/// <returns>The capacity in bytes</returns>
+	VkDeviceSize GetCapacity(uint32_t frame);
+
+	/// <summary>
+	/// Returns the number of times any instance buffer has had to grow since the application started
+	/// </summary>
+	/// <returns>The total reallocation count</returns>
+	static uint32_t GetReallocationCount();
+
+	/// <summary>
+	/// Returns a counter that changes every time one of the buffers is re-created
+	/// </summary>
+	/// <returns>The buffer generation</returns>
+	uint32_t GetGeneration();
+
+	/// <summary>
+	/// Returns whether this is a single device local buffer rather than one mapped buffer per frame in flight
+	/// </summary>
+	/// <returns>True if device local</returns>
+	bool GetDeviceLocal();
+
+	/// <summary>
+	/// Returns the number of separate buffers, a frame in flight uses buffer frame % count
+	/// </summary>
+	/// <returns>The number of buffers</returns>
+	uint32_t GetBufferCount();
+
+#pragma endregion
+
+#pragma region Buffer Management
+
+	/// <summary>
+	/// Returns a pointer to the mapped memory of the specified frame, growing the buffer if it cannot hold size bytes.
+	/// The frame's fence must have been waited on before calling this
+	/// </summary>
+	/// <param name="frame">The frame in flight to write to</param>
+	/// <param name="size">The number of bytes that will be written</param>
+	/// <returns>Pointer to the start of the frame's mapped memory</returns>
+	void* Map(uint32_t frame, VkDeviceSize size);
+
+	/// <summary>
+	/// Grows the buffer used by the specified frame if it cannot hold size bytes, losing its contents.
+	/// The frame's fence must have been waited on before calling this
+	/// </summary>
+	/// <param name="frame">The frame in flight that will be written to</param>
+	/// <param name="size">The number of bytes the buffer must hold</param>
+	/// <returns>True if the buffer was re-created and everything in it has to be written again</returns>
+	bool Reserve(uint32_t frame, VkDeviceSize size);
+
+	/// <summary>
+	/// Copies data into part of the buffer used by the specified frame, device local buffers record the copy with the upload manager.
+	/// The buffer must already be large enough
+	/// </summary>
+	/// <param name="frame">The frame in flight to write to</param>
+	/// <param name="data">The data to copy</param>
+	/// <param name="offset">The offset in the buffer to copy to in bytes</param>
+	/// <param name="size">The size of the data in bytes</param>
+	void WriteRange(uint32_t frame, const void* data, VkDeviceSize offset, VkDeviceSize size);
+
+	/// <summary>
+	/// Copies data into the buffer used by the specified frame
+	/// </summary>
+	/// <param name="frame">The frame in flight to write to</param>
+	/// <param name="data">The data to copy</param>
+	/// <param name="size">The size of the data in bytes</param>
+	void Write(uint32_t frame, const void* data, VkDeviceSize size);
+
+#pragma endregion
+};
@@ -0,0 +1,9 @@
+#pragma once
+
+//Layout of the data sent to the vertex shaders for every instance, each format has its own build of the vertex shaders
+enum InstanceFormats {
+	MatrixInstanceFormat,
+	AffineInstanceFormat,
+	CompactInstanceFormat,
+	InstanceFormatCount
+};
@@ -0,0 +1,346 @@
+#include "pch.h"
+#include "JobSystem.h"
+
+thread_local uint32_t JobSystem::queueIndex = 0;
+thread_local bool JobSystem::isolated = false;
+
+#pragma region Singleton
+
+JobSystem* JobSystem::instance = nullptr;
+
+JobSystem* JobSystem::GetInstance()
+{
+	if (instance == nullptr) {
+		instance = new JobSystem();
+	}
+
+	return instance;
+}
+
+#pragma endregion
+
+#pragma region Memory Management
+
+void JobSystem::Init(uint32_t threadCount)
+{
+	if (threadCount == 0) {
+		threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	running = true;
+
+	//The thread that waits on work helps out so one less worker is needed, the extra queue is kept for an isolated thread
+	for (uint32_t i = 0; i < threadCount + 1; i++) {
+		queues.push_back(std::make_unique<JobQueue>());
+	}
+
+	for (uint32_t i = 1; i < threadCount; i++) {
+		workers.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+	}
+}
+
+void JobSystem::Cleanup()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		running = false;
+	}
+	jobAvailable.notify_all();
+
+	for (std::thread& worker : workers) {
+		worker.join();
+	}
+
+	workers.clear();
+	queues.clear();
+}
+
+void JobSystem::WorkerLoop(uint32_t index)
+{
+	queueIndex = index;
+
+	while (true) {
+		std::function<void()> job;
+		if (Pop(job)) {
+			job();
+			continue;
+		}
+
+		//Sleep until something is queued, jobs left in the queues are finished before shutting down
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		jobAvailable.wait(lock, [this] { return queuedJobCount.load() > 0 || !running; });
+
+		if (!running && queuedJobCount.load() == 0) {
+			return;
+		}
+	}
+}
+
+void JobSystem::Push(std::function<void()> job)
+{
+	//Run inline if the job system hasn't been started
+	if (queues.empty()) {
+		job();
+		return;
+	}
+
+	{
+		JobQueue& queue = *queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		//Unwrap the ring into a bigger one when it is full
+		if (queue.count == queue.jobs.size()) {
+			std::vector<std::function<void()>> jobs(std::max(queue.jobs.size() * 2, static_cast<size_t>(16)));
+			for (size_t i = 0; i < queue.count; i++) {
+				jobs[i] = std::move(queue.jobs[(queue.first + i) % queue.jobs.size()]);
+			}
+
+			queue.jobs.swap(jobs);
+			queue.first = 0;
+		}
+
+		queue.jobs[(queue.first + queue.count) % queue.jobs.size()] = std::move(job);
+		queue.count++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		queuedJobCount.fetch_add(1);
+	}
+	jobAvailable.notify_one();
+}
+
+bool JobSystem::Pop(std::function<void()>& job, bool steal)
+{
+	if (queuedJobCount.load() == 0) {
+		return false;
+	}
+
+	//Newest job from our own queue first since its data is most likely still in cache
+	{
+		JobQueue& queue = *queues[queueIndex];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.count > 0) {
+			queue.count--;
+			job = std::move(queue.jobs[(queue.first + queue.count) % queue.jobs.size()]);
+			queuedJobCount.fetch_sub(1);
+			return true;
+		}
+	}
+
+	if (!steal) {
+		return false;
+	}
+
+	//Steal the oldest job from another thread, oldest jobs tend to be the largest pieces of work
+	for (size_t offset = 1; offset < queues.size(); offset++) {
+		JobQueue& victim = *queues[(queueIndex + offset) % queues.size()];
+
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (victim.count > 0) {
+			job = std::move(victim.jobs[victim.first]);
+			victim.first = (victim.first + 1) % victim.jobs.size();
+			victim.count--;
+			queuedJobCount.fetch_sub(1);
+			stealCount.fetch_add(1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+#pragma endregion
+
+#pragma region Accessors
+
+uint32_t JobSystem::GetThreadCount()
+{
+	return static_cast<uint32_t>(workers.size()) + 1;
+}
+
+uint32_t JobSystem::GetStealCount()
+{
+	return stealCount.load();
+}
+
+#pragma endregion
+
+#pragma region Isolation
+
+void JobSystem::BeginIsolation()
+{
+	//Jobs run inline on the calling thread until the job system is started, so there is nothing to isolate from
+	if (queues.empty() || isolated) {
+		return;
+	}
+
+	if (isolatedQueueTaken.exchange(true)) {
+		throw std::runtime_error("Failed to isolate thread, another thread is already isolated!");
+	}
+
+	queueIndex = static_cast<uint32_t>(queues.size() - 1);
+	isolated = true;
+}
+
+void JobSystem::EndIsolation()
+{
+	if (!isolated) {
+		return;
+	}
+
+	queueIndex = 0;
+	isolated = false;
+	isolatedQueueTaken = false;
+}
+
+#pragma endregion
+
+#pragma region Tasks
+
+std::shared_ptr<Task> JobSystem::CreateTask(std::function<void()> work)
+{
+	return std::make_shared<Task>(work);
+}
+
+void JobSystem::AddDependency(const std::shared_ptr<Task>& task, const std::shared_ptr<Task>& dependency)
+{
+	//Holding the lock means the dependency either finishes before we check or sees the continuation when it does
+	std::lock_guard<std::mutex> lock(dependency->continuationMutex);
+	if (dependency->finished.load()) {
+		return;
+	}
+
+	task->dependencyCount.fetch_add(1);
+	dependency->continuations.push_back(task);
+}
+
+void JobSystem::Schedule(const std::shared_ptr<Task>& task)
+{
+	//Drop the reference the task was created with
+	ReleaseDependency(task);
+}
+
+std::shared_ptr<Task> JobSystem::Then(const std::shared_ptr<Task>& task, std::function<void()> work)
+{
+	std::shared_ptr<Task> continuation = CreateTask(work);
+	AddDependency(continuation, task);
+	Schedule(continuation);
+
+	return continuation;
+}
+
+void JobSystem::Wait(const std::shared_ptr<Task>& task)
+{
+	while (!task->IsFinished()) {
+		std::function<void()> job;
+		if (Pop(job)) {
+			job();
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::ReleaseDependency(const std::shared_ptr<Task>& task)
+{
+	if (task->dependencyCount.fetch_sub(1) == 1) {
+		std::shared_ptr<Task> readyTask = task;
+		Push([this, readyTask]() { Execute(readyTask); });
+	}
+}
+
+void JobSystem::Execute(const std::shared_ptr<Task>& task)
+{
+	task->work();
+
+	std::vector<std::shared_ptr<Task>> continuations;
+	{
+		std::lock_guard<std::mutex> lock(task->continuationMutex);
+		task->finished.store(true);
+		continuations.swap(task->continuations);
+	}
+
+	for (const std::shared_ptr<Task>& continuation : continuations) {
+		ReleaseDependency(continuation);
+	}
+}
+
+#pragma endregion
+
+#pragma region Jobs
+
+JobSystem::LoopState* JobSystem::AcquireLoopState()
+{
+	std::lock_guard<std::mutex> lock(loopStateMutex);
+
+	for (const std::unique_ptr<LoopState>& state : loopStates) {
+		if (state->userCount.load() == 0) {
+			state->userCount.store(1);
+			return state.get();
+		}
+	}
+
+	loopStates.push_back(std::make_unique<LoopState>());
+	loopStates.back()->userCount.store(1);
+	return loopStates.back().get();
+}
+
+void JobSystem::RunRanges(LoopState* state)
+{
+	uint32_t start;
+	while ((start = state->nextIndex.fetch_add(state->grainSize)) < state->count) {
+		uint32_t end = std::min(start + state->grainSize, state->count);
+		for (uint32_t i = start; i < end; i++) {
+			state->invoke(state->job, i);
+		}
+		state->completedCount.fetch_add(end - start);
+	}
+}
+
+void JobSystem::RunParallel(uint32_t count, void (*invoke)(const void* job, uint32_t index), const void* job, uint32_t grainSize)
+{
+	if (count == 0) {
+		return;
+	}
+
+	grainSize = std::max(grainSize, 1u);
+	uint32_t rangeCount = (count + grainSize - 1) / grainSize;
+
+	LoopState* state = AcquireLoopState();
+	state->invoke = invoke;
+	state->job = job;
+	state->count = count;
+	state->grainSize = grainSize;
+	state->nextIndex.store(0);
+	state->completedCount.store(0);
+
+	//Queue one helper per thread that could help, idle threads steal them from this thread's queue.
+	//The helpers only capture two pointers so their std::functions don't allocate
+	uint32_t helperCount = std::min(rangeCount - 1, static_cast<uint32_t>(workers.size()));
+	state->userCount.fetch_add(helperCount);
+	for (uint32_t i = 0; i < helperCount; i++) {
+		Push([this, state]() {
+			RunRanges(state);
+			state->userCount.fetch_sub(1);
+		});
+	}
+
+	//Work on the loop from this thread as well, then run other jobs until the indices running elsewhere are done.
+	//An isolated thread only takes jobs it queued itself, anything else could need a lock it is holding
+	RunRanges(state);
+	while (state->completedCount.load() < count) {
+		std::function<void()> otherJob;
+		if (Pop(otherJob, !isolated)) {
+			otherJob();
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+
+	state->userCount.fetch_sub(1);
+}
+
+#pragma endregion
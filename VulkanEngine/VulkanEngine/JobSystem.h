@@ -0,0 +1,222 @@
+#pragma once
+#include "pch.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "Task.h"
+
+class JobSystem
+{
+private:
+	static JobSystem* instance;
+
+	//Each thread pushes and pops from the back of its own queue and steals from the front of the others.
+	//Jobs are kept in a ring that only grows so queueing doesn't allocate once the ring is big enough
+	struct JobQueue {
+		std::vector<std::function<void()>> jobs;
+		size_t first = 0;
+		size_t count = 0;
+		std::mutex mutex;
+	};
+
+	//Shared between every thread working on a parallel loop, helpers may only start after the loop has finished so a state
+	//is only reused once every thread that was handed it is done, the job is only called while the loop is still running
+	struct LoopState {
+		void (*invoke)(const void* job, uint32_t index) = nullptr;
+		const void* job = nullptr;
+		uint32_t count = 0;
+		uint32_t grainSize = 1;
+		std::atomic<uint32_t> nextIndex{ 0 };
+		std::atomic<uint32_t> completedCount{ 0 };
+		std::atomic<uint32_t> userCount{ 0 };
+	};
+
+	//Queue 0 is shared by every thread that isn't a worker, queue i + 1 belongs to worker i and the last queue belongs to the isolated thread
+	std::vector<std::unique_ptr<JobQueue>> queues;
+	std::vector<std::thread> workers;
+
+	std::mutex sleepMutex;
+	std::condition_variable jobAvailable;
+	std::atomic<uint32_t> queuedJobCount{ 0 };
+	std::atomic<uint32_t> stealCount{ 0 };
+	bool running = false;
+
+	//Every loop state ever created, a parallel loop claims one no other loop is using and only creates one if they are all in use
+	std::vector<std::unique_ptr<LoopState>> loopStates;
+	std::mutex loopStateMutex;
+
+	static thread_local uint32_t queueIndex;
+
+	//Set on the isolated thread, which only runs jobs it queued itself while it waits on a parallel loop
+	static thread_local bool isolated;
+	std::atomic<bool> isolatedQueueTaken{ false };
+
+	/// <summary>
+	/// Runs queued jobs on a worker thread until the job system is cleaned up
+	/// </summary>
+	/// <param name="index">The index of the worker's queue</param>
+	void WorkerLoop(uint32_t index);
+
+	/// <summary>
+	/// Adds a job to the calling thread's queue and wakes a sleeping worker
+	/// </summary>
+	/// <param name="job">The job to add</param>
+	void Push(std::function<void()> job);
+
+	/// <summary>
+	/// Takes a job from the calling thread's queue, or steals one from another thread if it is empty
+	/// </summary>
+	/// <param name="job">Set to the job that was found</param>
+	/// <param name="steal">Whether to look in the other threads' queues when the calling thread's queue is empty</param>
+	/// <returns>True if a job was found</returns>
+	bool Pop(std::function<void()>& job, bool steal = true);
+
+	/// <summary>
+	/// Drops the dependency a task was waiting on and queues it once it has none left
+	/// </summary>
+	/// <param name="task">The task to release</param>
+	void ReleaseDependency(const std::shared_ptr<Task>& task);
+
+	/// <summary>
+	/// Runs a task and releases the tasks that depend on it
+	/// </summary>
+	/// <param name="task">The task to run</param>
+	void Execute(const std::shared_ptr<Task>& task);
+
+	/// <summary>
+	/// Finds a loop state no thread is using anymore, or creates one if they are all in use
+	/// </summary>
+	/// <returns>The loop state, already counted as used by the calling thread</returns>
+	LoopState* AcquireLoopState();
+
+	/// <summary>
+	/// Claims and runs ranges of a parallel loop until every index has been claimed
+	/// </summary>
+	/// <param name="state">The loop to work on</param>
+	void RunRanges(LoopState* state);
+
+	/// <summary>
+	/// Runs a type erased job once for every index in [0, count), see ParallelFor
+	/// </summary>
+	/// <param name="count">The number of indices to run</param>
+	/// <param name="invoke">Calls the job with an index</param>
+	/// <param name="job">The job passed to invoke</param>
+	/// <param name="grainSize">The number of consecutive indices a thread claims at a time</param>
+	void RunParallel(uint32_t count, void (*invoke)(const void* job, uint32_t index), const void* job, uint32_t grainSize);
+
+public:
+#pragma region Singleton
+
+	/// <summary>
+	/// Returns the singleton instance of the job system
+	/// </summary>
+	/// <returns>The job system instance</returns>
+	static JobSystem* GetInstance();
+
+#pragma endregion
+
+#pragma region Memory Management
+
+	/// <summary>
+	/// Starts the worker threads
+	/// </summary>
+	/// <param name="threadCount">The total number of threads including the calling thread, 0 uses one per hardware thread</param>
+	void Init(uint32_t threadCount = 0);
+
+	/// <summary>
+	/// Finishes any queued jobs and joins the worker threads
+	/// </summary>
+	void Cleanup();
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the number of threads that jobs can run on, including the calling thread
+	/// </summary>
+	/// <returns>The thread count</returns>
+	uint32_t GetThreadCount();
+
+	/// <summary>
+	/// Returns the number of jobs that were run by a different thread than the one that queued them
+	/// </summary>
+	/// <returns>The total steal count</returns>
+	uint32_t GetStealCount();
+
+#pragma endregion
+
+#pragma region Isolation
+
+	/// <summary>
+	/// Gives the calling thread a queue of its own. While it waits on a parallel loop it only runs jobs from that queue rather than
+	/// stealing work queued by other threads, so a long running thread can hold a lock through its parallel loops without picking up
+	/// a job that needs the same lock. Only one thread can be isolated at a time
+	/// </summary>
+	void BeginIsolation();
+
+	/// <summary>
+	/// Returns the calling thread to the shared queue, its queue must be empty
+	/// </summary>
+	void EndIsolation();
+
+#pragma endregion
+
+#pragma region Tasks
+
+	/// <summary>
+	/// Creates a task that won't run until it is scheduled and all of its dependencies have finished
+	/// </summary>
+	/// <param name="work">The work the task will do</param>
+	/// <returns>The created task</returns>
+	std::shared_ptr<Task> CreateTask(std::function<void()> work);
+
+	/// <summary>
+	/// Makes a task wait for another task to finish before it runs, must be called before the task is scheduled
+	/// </summary>
+	/// <param name="task">The task that should wait</param>
+	/// <param name="dependency">The task to wait for</param>
+	void AddDependency(const std::shared_ptr<Task>& task, const std::shared_ptr<Task>& dependency);
+
+	/// <summary>
+	/// Allows a task to run as soon as its dependencies have finished
+	/// </summary>
+	/// <param name="task">The task to schedule</param>
+	void Schedule(const std::shared_ptr<Task>& task);
+
+	/// <summary>
+	/// Creates and schedules a task that runs once the specified task has finished
+	/// </summary>
+	/// <param name="task">The task to continue from</param>
+	/// <param name="work">The work to run afterwards</param>
+	/// <returns>The continuation task</returns>
+	std::shared_ptr<Task> Then(const std::shared_ptr<Task>& task, std::function<void()> work);
+
+	/// <summary>
+	/// Runs queued jobs on the calling thread until the task has finished
+	/// </summary>
+	/// <param name="task">The task to wait for</param>
+	void Wait(const std::shared_ptr<Task>& task);
+
+#pragma endregion
+
+#pragma region Jobs
+
+	/// <summary>
+	/// Runs the job once for every index in [0, count) spread across the worker threads and the calling thread,
+	/// returns once every index has finished
+	/// </summary>
+	/// <param name="count">The number of indices to run</param>
+	/// <param name="job">The job to run, called with the index to process. It is called in place rather than copied into a std::function so nothing is allocated however much it captures</param>
+	/// <param name="grainSize">The number of consecutive indices a thread claims at a time</param>
+	template<typename Function>
+	void ParallelFor(uint32_t count, const Function& job, uint32_t grainSize = 1)
+	{
+		RunParallel(count, [](const void* function, uint32_t index) { (*static_cast<const Function*>(function))(index); }, &job, grainSize);
+	}
+
+#pragma endregion
+};
@@ -421,7 +421,7 @@ VkPipeline Material::GetPipeline()
 	return pipeline;
 }
 
-std::vector<VkDescriptorSet> Material::GetDescriptorSets()
+const std::vector<VkDescriptorSet>& Material::GetDescriptorSets()
 {
 	return descriptorSets;
 }
@@ -87,7 +87,7 @@ public:
 	/// Returns the descriptor sets used by the material
 	/// </summary>
 	/// <returns>The list of the material's descriptor sets</returns>
-	std::vector<VkDescriptorSet> GetDescriptorSets();
+	const std::vector<VkDescriptorSet>& GetDescriptorSets();
 
 
 	TextureImages* GetTImage();
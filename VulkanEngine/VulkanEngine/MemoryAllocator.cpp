@@ -0,0 +1,177 @@
+#include "pch.h"
+#include "MemoryAllocator.h"
+
+#pragma region Singleton
+
+MemoryAllocator* MemoryAllocator::instance = nullptr;
+
+MemoryAllocator* MemoryAllocator::GetInstance()
+{
+	if (instance == nullptr) {
+		instance = new MemoryAllocator();
+	}
+
+	return instance;
+}
+
+#pragma endregion
+
+#pragma region Memory Management
+
+void MemoryAllocator::Init(std::shared_ptr<MemoryBackend> backend)
+{
+	this->backend = backend;
+}
+
+void MemoryAllocator::Cleanup()
+{
+	for (std::pair<const uint32_t, std::vector<std::shared_ptr<MemoryBlock>>>& pool : pools) {
+		for (const std::shared_ptr<MemoryBlock>& block : pool.second) {
+			ReleaseBlock(block);
+		}
+	}
+
+	pools.clear();
+	bytesInUse = 0;
+}
+
+std::shared_ptr<MemoryBlock> MemoryAllocator::CreateBlock(uint32_t poolKey, uint32_t memoryTypeIndex, VkDeviceSize minimumSize)
+{
+	//Oversized resources get a block of their own rounded up to the next power of two multiple
+	VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE;
+	while (blockSize < minimumSize) {
+		blockSize *= 2;
+	}
+
+	VkDeviceMemory memory = backend->AllocateMemory(memoryTypeIndex, blockSize);
+
+	//Host visible blocks stay mapped for their whole lifetime since a VkDeviceMemory can only be mapped once at a time
+	void* mappedData = nullptr;
+	if (backend->IsHostVisible(memoryTypeIndex)) {
+		mappedData = backend->MapMemory(memory, blockSize);
+	}
+
+	std::shared_ptr<MemoryBlock> block = std::make_shared<MemoryBlock>(memory, blockSize, mappedData, MIN_ALLOCATION_SIZE);
+	pools[poolKey].push_back(block);
+	return block;
+}
+
+void MemoryAllocator::ReleaseBlock(const std::shared_ptr<MemoryBlock>& block)
+{
+	if (block->GetMappedData() != nullptr) {
+		backend->UnmapMemory(block->GetMemory());
+	}
+
+	backend->FreeMemory(block->GetMemory());
+}
+
+#pragma endregion
+
+#pragma region Allocation
+
+Allocation MemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear)
+{
+	std::lock_guard<std::mutex> lock(allocatorMutex);
+
+	if (backend == nullptr) {
+		throw std::runtime_error("Memory allocator was used before it was initialized!");
+	}
+
+	uint32_t memoryTypeIndex = backend->FindMemoryType(requirements.memoryTypeBits, properties);
+	uint32_t poolKey = (memoryTypeIndex << 1) | (linear ? 0 : 1);
+
+	Allocation allocation = {};
+	allocation.size = requirements.size;
+	allocation.poolKey = poolKey;
+
+	//Try the existing blocks first
+	for (const std::shared_ptr<MemoryBlock>& block : pools[poolKey]) {
+		if (block->Allocate(requirements.size, requirements.alignment, allocation.offset)) {
+			allocation.block = block.get();
+			break;
+		}
+	}
+
+	//Otherwise create a new block that can fit the resource
+	if (allocation.block == nullptr) {
+		std::shared_ptr<MemoryBlock> block = CreateBlock(poolKey, memoryTypeIndex, std::max(requirements.size, requirements.alignment));
+
+		if (!block->Allocate(requirements.size, requirements.alignment, allocation.offset)) {
+			throw std::runtime_error("Failed to sub-allocate from a new memory block!");
+		}
+
+		allocation.block = block.get();
+	}
+
+	allocation.memory = allocation.block->GetMemory();
+	if (allocation.block->GetMappedData() != nullptr) {
+		allocation.mappedData = static_cast<char*>(allocation.block->GetMappedData()) + allocation.offset;
+	}
+
+	bytesInUse += allocation.size;
+	return allocation;
+}
+
+void MemoryAllocator::Free(Allocation& allocation)
+{
+	if (allocation.block == nullptr) {
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock(allocatorMutex);
+
+	std::vector<std::shared_ptr<MemoryBlock>>& pool = pools[allocation.poolKey];
+
+	for (size_t i = 0; i < pool.size(); i++) {
+		if (pool[i].get() != allocation.block) {
+			continue;
+		}
+
+		pool[i]->Free(allocation.offset);
+		bytesInUse -= allocation.size;
+
+		//Keep one block per pool around so that short lived staging buffers do not allocate a block every time
+		if (pool[i]->IsEmpty() && pool.size() > 1) {
+			ReleaseBlock(pool[i]);
+			pool.erase(pool.begin() + i);
+		}
+
+		allocation = {};
+		return;
+	}
+
+	throw std::runtime_error("Failed to free memory, the allocation's block no longer exists!");
+}
+
+#pragma endregion
+
+#pragma region Accessors
+
+MemoryStats MemoryAllocator::GetStats()
+{
+	std::lock_guard<std::mutex> lock(allocatorMutex);
+
+	MemoryStats stats = {};
+	VkDeviceSize largestFreeRange = 0;
+
+	for (std::pair<const uint32_t, std::vector<std::shared_ptr<MemoryBlock>>>& pool : pools) {
+		for (const std::shared_ptr<MemoryBlock>& block : pool.second) {
+			stats.blockCount++;
+			stats.allocationCount += block->GetAllocationCount();
+			stats.bytesReserved += block->GetSize();
+			stats.bytesAllocated += block->GetBytesAllocated();
+			largestFreeRange = std::max(largestFreeRange, block->GetLargestFreeRange());
+		}
+	}
+
+	stats.bytesInUse = bytesInUse;
+
+	VkDeviceSize freeBytes = stats.bytesReserved - stats.bytesAllocated;
+	if (freeBytes > 0) {
+		stats.fragmentation = 1.0f - static_cast<float>(largestFreeRange) / static_cast<float>(freeBytes);
+	}
+
+	return stats;
+}
+
+#pragma endregion
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "pch.h"
+#include "Allocation.h"
+#include "MemoryBackend.h"
+#include "MemoryBlock.h"
+#include "MemoryStats.h"
+
+#include <mutex>
+
+class MemoryAllocator
+{
+private:
+	static MemoryAllocator* instance;
+
+	static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64 * 1024 * 1024;
+	static constexpr VkDeviceSize MIN_ALLOCATION_SIZE = 256;
+
+	std::shared_ptr<MemoryBackend> backend;
+
+	//Blocks are kept in separate pools per memory type, linear and optimal resources never share a block so bufferImageGranularity can be ignored
+	std::map<uint32_t, std::vector<std::shared_ptr<MemoryBlock>>> pools;
+
+	//Resources can be created and destroyed from job system threads
+	std::mutex allocatorMutex;
+	VkDeviceSize bytesInUse = 0;
+
+	/// <summary>
+	/// Allocates a new block of device memory and adds it to the specified pool
+	/// </summary>
+	/// <param name="poolKey">The key of the pool to add the block to</param>
+	/// <param name="memoryTypeIndex">The memory type of the block</param>
+	/// <param name="minimumSize">The smallest size the block can be</param>
+	/// <returns>The block that was created</returns>
+	std::shared_ptr<MemoryBlock> CreateBlock(uint32_t poolKey, uint32_t memoryTypeIndex, VkDeviceSize minimumSize);
+
+	/// <summary>
+	/// Unmaps and frees the device memory of a block
+	/// </summary>
+	/// <param name="block">The block to release</param>
+	void ReleaseBlock(const std::shared_ptr<MemoryBlock>& block);
+
+public:
+#pragma region Singleton
+
+	/// <summary>
+	/// Returns the singleton instance of the memory allocator
+	/// </summary>
+	/// <returns>The memory allocator instance</returns>
+	static MemoryAllocator* GetInstance();
+
+#pragma endregion
+
+#pragma region Memory Management
+
+	/// <summary>
+	/// Sets the backend used to allocate device memory, must be called before any resources are created
+	/// </summary>
+	/// <param name="backend">The backend to allocate blocks from</param>
+	void Init(std::shared_ptr<MemoryBackend> backend);
+
+	/// <summary>
+	/// Frees every block of device memory, all resources must have been destroyed first
+	/// </summary>
+	void Cleanup();
+
+#pragma endregion
+
+#pragma region Allocation
+
+	/// <summary>
+	/// Sub-allocates a range of device memory that meets the requirements
+	/// </summary>
+	/// <param name="requirements">The memory requirements of the resource</param>
+	/// <param name="properties">The required memory properties</param>
+	/// <param name="linear">True for buffers and linear images, false for optimally tiled images</param>
+	/// <returns>The allocated range</returns>
+	Allocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, bool linear);
+
+	/// <summary>
+	/// Returns the range to the block it was allocated from and resets the allocation
+	/// </summary>
+	/// <param name="allocation">The allocation to free</param>
+	void Free(Allocation& allocation);
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns statistics on the blocks and allocations that currently exist
+	/// </summary>
+	/// <returns>The current memory statistics</returns>
+	MemoryStats GetStats();
+
+#pragma endregion
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "pch.h"
+
+class MemoryBackend
+{
+public:
+	virtual ~MemoryBackend() = default;
+
+#pragma region Memory Types
+
+	/// <summary>
+	/// Finds a memory type that matches the type filter and has the requested properties
+	/// </summary>
+	/// <param name="typeFilter">Bit mask of the acceptable memory types</param>
+	/// <param name="properties">The required memory properties</param>
+	/// <returns>The index of the memory type to use</returns>
+	virtual uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) = 0;
+
+	/// <summary>
+	/// Returns whether memory of the specified type can be mapped by the host
+	/// </summary>
+	/// <param name="memoryTypeIndex">The memory type to check</param>
+	/// <returns>True if the memory type is host visible</returns>
+	virtual bool IsHostVisible(uint32_t memoryTypeIndex) = 0;
+
+#pragma endregion
+
+#pragma region Memory Management
+
+	/// <summary>
+	/// Allocates a block of device memory
+	/// </summary>
+	/// <param name="memoryTypeIndex">The memory type to allocate from</param>
+	/// <param name="size">The size of the block in bytes</param>
+	/// <returns>The allocated device memory</returns>
+	virtual VkDeviceMemory AllocateMemory(uint32_t memoryTypeIndex, VkDeviceSize size) = 0;
+
+	/// <summary>
+	/// Frees a block of device memory
+	/// </summary>
+	/// <param name="memory">The memory to free</param>
+	virtual void FreeMemory(VkDeviceMemory memory) = 0;
+
+	/// <summary>
+	/// Maps an entire block of device memory into host address space
+	/// </summary>
+	/// <param name="memory">The memory to map</param>
+	/// <param name="size">The size of the memory block</param>
+	/// <returns>Pointer to the start of the mapped memory</returns>
+	virtual void* MapMemory(VkDeviceMemory memory, VkDeviceSize size) = 0;
+
+	/// <summary>
+	/// Unmaps a block of device memory that was mapped with MapMemory
+	/// </summary>
+	/// <param name="memory">The memory to unmap</param>
+	virtual void UnmapMemory(VkDeviceMemory memory) = 0;
+
+#pragma endregion
+};
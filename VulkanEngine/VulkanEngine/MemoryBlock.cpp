@@ -0,0 +1,143 @@
+#include "pch.h"
+#include "MemoryBlock.h"
+
+#pragma region Constructor
+
+MemoryBlock::MemoryBlock(VkDeviceMemory memory, VkDeviceSize size, void* mappedData, VkDeviceSize minAllocationSize)
+{
+	this->memory = memory;
+	this->size = size;
+	this->mappedData = mappedData;
+	this->minAllocationSize = minAllocationSize;
+
+	maxOrder = GetOrder(size);
+	if ((minAllocationSize << maxOrder) != size) {
+		throw std::runtime_error("Memory block size must be a power of two multiple of the minimum allocation size!");
+	}
+
+	//The whole block starts out as a single free range of the highest order
+	freeLists.resize(maxOrder + 1);
+	freeLists[maxOrder].insert(0);
+	bytesAllocated = 0;
+}
+
+#pragma endregion
+
+#pragma region Accessors
+
+VkDeviceMemory MemoryBlock::GetMemory()
+{
+	return memory;
+}
+
+VkDeviceSize MemoryBlock::GetSize()
+{
+	return size;
+}
+
+void* MemoryBlock::GetMappedData()
+{
+	return mappedData;
+}
+
+VkDeviceSize MemoryBlock::GetBytesAllocated()
+{
+	return bytesAllocated;
+}
+
+VkDeviceSize MemoryBlock::GetLargestFreeRange()
+{
+	for (int order = maxOrder; order >= 0; order--) {
+		if (!freeLists[order].empty()) {
+			return minAllocationSize << order;
+		}
+	}
+
+	return 0;
+}
+
+uint32_t MemoryBlock::GetAllocationCount()
+{
+	return static_cast<uint32_t>(allocatedOrders.size());
+}
+
+bool MemoryBlock::IsEmpty()
+{
+	return allocatedOrders.empty();
+}
+
+#pragma endregion
+
+#pragma region Allocation
+
+uint32_t MemoryBlock::GetOrder(VkDeviceSize bytes)
+{
+	uint32_t order = 0;
+	while ((minAllocationSize << order) < bytes) {
+		order++;
+	}
+
+	return order;
+}
+
+bool MemoryBlock::Allocate(VkDeviceSize requestedSize, VkDeviceSize alignment, VkDeviceSize& offset)
+{
+	//Ranges of order n always start at a multiple of their own size so rounding up to the alignment satisfies it
+	uint32_t order = GetOrder(std::max(requestedSize, alignment));
+	if (order > maxOrder) {
+		return false;
+	}
+
+	//Find the smallest free range that is large enough
+	uint32_t freeOrder = order;
+	while (freeOrder <= maxOrder && freeLists[freeOrder].empty()) {
+		freeOrder++;
+	}
+
+	if (freeOrder > maxOrder) {
+		return false;
+	}
+
+	offset = *freeLists[freeOrder].begin();
+	freeLists[freeOrder].erase(freeLists[freeOrder].begin());
+
+	//Split the range in half until it is the requested order, freeing the upper halves
+	while (freeOrder > order) {
+		freeOrder--;
+		freeLists[freeOrder].insert(offset + (minAllocationSize << freeOrder));
+	}
+
+	allocatedOrders[offset] = order;
+	bytesAllocated += minAllocationSize << order;
+	return true;
+}
+
+void MemoryBlock::Free(VkDeviceSize offset)
+{
+	std::map<VkDeviceSize, uint32_t>::iterator allocated = allocatedOrders.find(offset);
+	if (allocated == allocatedOrders.end()) {
+		throw std::runtime_error("Failed to free memory, offset was not allocated from this block!");
+	}
+
+	uint32_t order = allocated->second;
+	allocatedOrders.erase(allocated);
+	bytesAllocated -= minAllocationSize << order;
+
+	//Merge with the buddy range for as long as it is also free
+	while (order < maxOrder) {
+		VkDeviceSize buddy = offset ^ (minAllocationSize << order);
+		std::set<VkDeviceSize>::iterator freeBuddy = freeLists[order].find(buddy);
+
+		if (freeBuddy == freeLists[order].end()) {
+			break;
+		}
+
+		freeLists[order].erase(freeBuddy);
+		offset = std::min(offset, buddy);
+		order++;
+	}
+
+	freeLists[order].insert(offset);
+}
+
+#pragma endregion
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "pch.h"
+
+class MemoryBlock
+{
+private:
+	VkDeviceMemory memory;
+	VkDeviceSize size;
+	void* mappedData;
+
+	//Buddy allocator state, order n ranges are minAllocationSize << n bytes long
+	VkDeviceSize minAllocationSize;
+	uint32_t maxOrder;
+	std::vector<std::set<VkDeviceSize>> freeLists;
+	std::map<VkDeviceSize, uint32_t> allocatedOrders;
+	VkDeviceSize bytesAllocated;
+
+	/// <summary>
+	/// Returns the smallest order whose ranges can hold the specified number of bytes
+	/// </summary>
+	/// <param name="bytes">The number of bytes to fit</param>
+	/// <returns>The order of the range</returns>
+	uint32_t GetOrder(VkDeviceSize bytes);
+
+public:
+#pragma region Constructor
+
+	/// <summary>
+	/// Creates a block that sub-allocates ranges of the specified device memory
+	/// </summary>
+	/// <param name="memory">The device memory owned by this block</param>
+	/// <param name="size">The size of the memory, must be minAllocationSize multiplied by a power of two</param>
+	/// <param name="mappedData">Pointer to the mapped memory or nullptr if the memory is not host visible</param>
+	/// <param name="minAllocationSize">The smallest range that will be handed out, must be a power of two</param>
+	MemoryBlock(VkDeviceMemory memory, VkDeviceSize size, void* mappedData = nullptr, VkDeviceSize minAllocationSize = 256);
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the device memory owned by this block
+	/// </summary>
+	/// <returns>The VkDeviceMemory of the block</returns>
+	VkDeviceMemory GetMemory();
+
+	/// <summary>
+	/// Returns the total size of the block
+	/// </summary>
+	/// <returns>The size in bytes</returns>
+	VkDeviceSize GetSize();
+
+	/// <summary>
+	/// Returns the pointer to the start of the mapped memory
+	/// </summary>
+	/// <returns>The mapped pointer or nullptr if the block is not host visible</returns>
+	void* GetMappedData();
+
+	/// <summary>
+	/// Returns the number of bytes handed out including rounding to the range sizes
+	/// </summary>
+	/// <returns>The allocated bytes</returns>
+	VkDeviceSize GetBytesAllocated();
+
+	/// <summary>
+	/// Returns the size of the largest free range in the block
+	/// </summary>
+	/// <returns>The size in bytes, 0 if the block is full</returns>
+	VkDeviceSize GetLargestFreeRange();
+
+	/// <summary>
+	/// Returns the number of ranges currently handed out by this block
+	/// </summary>
+	/// <returns>The allocation count</returns>
+	uint32_t GetAllocationCount();
+
+	/// <summary>
+	/// Returns whether or not every range in this block is free
+	/// </summary>
+	/// <returns>True if nothing is allocated from this block</returns>
+	bool IsEmpty();
+
+#pragma endregion
+
+#pragma region Allocation
+
+	/// <summary>
+	/// Finds a free range that can hold the requested size with the requested alignment
+	/// </summary>
+	/// <param name="requestedSize">The size of the range in bytes</param>
+	/// <param name="alignment">The required alignment of the range, must be a power of two</param>
+	/// <param name="offset">Set to the offset of the range within the block</param>
+	/// <returns>True if a range was found, false if the block does not have enough space</returns>
+	bool Allocate(VkDeviceSize requestedSize, VkDeviceSize alignment, VkDeviceSize& offset);
+
+	/// <summary>
+	/// Returns the range at the specified offset to the free lists, merging it with its buddies
+	/// </summary>
+	/// <param name="offset">The offset that was returned by Allocate</param>
+	void Free(VkDeviceSize offset);
+
+#pragma endregion
+};
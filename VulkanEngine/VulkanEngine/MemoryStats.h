@@ -0,0 +1,14 @@
+#pragma once
+#include "pch.h"
+
+struct MemoryStats {
+public:
+	uint32_t blockCount = 0;
+	uint32_t allocationCount = 0;
+	VkDeviceSize bytesReserved = 0;
+	VkDeviceSize bytesAllocated = 0;
+	VkDeviceSize bytesInUse = 0;
+
+	//0 when all of the free memory is in one range, approaches 1 as the free memory is split into small ranges
+	float fragmentation = 0.0f;
+};
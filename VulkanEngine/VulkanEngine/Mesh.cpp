@@ -2,8 +2,10 @@
 #include "Mesh.h"
 
 #include "VulkanManager.h"
-#include "TransformData.h"
+#include "SwapChain.h"
 #include "Image.h"
+#include "UploadManager.h"
+#include "TransformKernels.h"
 //Tiny OBJ Loader
 #define TINYOBJLOADER_IMPLEMENTATION 
 #include <TinyObjLoader/tiny_obj_loader.h>
@@ -13,7 +15,7 @@
 
 #pragma region Constructor
 // WELCOME TO ATLAS!! <3 <3 
-Mesh::Mesh(std::shared_ptr<Material> material, std::vector<Vertex> vertices, std::vector<uint16_t> indices, std::shared_ptr<Buffer> vertexBuffer, uint32_t vertexBufferOffset, std::shared_ptr<Buffer> indexBuffer, uint32_t indexBufferOffset, std::vector<std::shared_ptr<Transform>> instances, std::shared_ptr<Buffer> instanceBuffer)
+Mesh::Mesh(std::shared_ptr<Material> material, std::vector<Vertex> vertices, std::vector<uint16_t> indices, std::shared_ptr<Buffer> vertexBuffer, uint32_t vertexBufferOffset, std::shared_ptr<Buffer> indexBuffer, uint32_t indexBufferOffset, std::vector<std::shared_ptr<Transform>> instances, std::shared_ptr<InstanceBuffer> instanceBuffer)
 {
 	this->material = material;
 	this->vertices = vertices;
@@ -22,10 +24,11 @@ Mesh::Mesh(std::shared_ptr<Material> material, std::vector<Vertex> vertices, std
 	this->vertexBufferOffset = vertexBufferOffset;
 	this->indexBuffer = indexBuffer;
 	this->indexBufferOffset = indexBufferOffset;
-	this->instances = instances;
 	this->instanceBuffer = instanceBuffer;
 
-	activeInstanceCount = static_cast<uint32_t>(instances.size());
+	for (size_t i = 0; i < instances.size(); i++) {
+		AddInstance(instances[i]);
+	}
 }
 
 #pragma endregion
@@ -41,62 +44,36 @@ void Mesh::Init()
 
 void Mesh::CreateInstanceBuffer()
 {
-	//Create buffer
-	VkDeviceSize bufferSize = sizeof(TransformData);
-	instanceBuffer = std::make_shared<Buffer>(VkBuffer(), VkDeviceMemory());
-	Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, *instanceBuffer);
+	//Create one persistently mapped buffer per frame in flight, or a single device local buffer for static instances
+	instanceBuffer = std::make_shared<InstanceBuffer>(VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, staticInstances);
+	instanceBuffer->Init(instanceStride * std::max(GetActiveInstanceCount(), 1u));
 
-	//Data will be added to the buffer in UpdateInstanceBuffer method once we have data to add
+	//Data will be added to the buffer in UpdateInstanceBuffer method once we have data to add, the new buffer holds none of it yet
+	MarkAllInstancesDirty();
 }
 
 void Mesh::CreateVertexBuffer()
 {
-	//Create the staging buffer
 	VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-	Buffer stagingBuffer;
-
-	Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer);
-
-	//Map vertex data to the buffer
-	void* data;
-	vkMapMemory(logicalDevice, stagingBuffer.GetBufferMemory(), 0, bufferSize, 0, &data);
-	memcpy(data, vertices.data(), bufferSize);
-	vkUnmapMemory(logicalDevice, stagingBuffer.GetBufferMemory());
 
 	//Create the vertex buffer
 	vertexBuffer = std::make_shared<Buffer>();
 	Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, *vertexBuffer);
 
-	//Copy buffer data
-	Buffer::CopyBuffer(stagingBuffer.GetBuffer(), vertexBuffer->GetBuffer(), bufferSize);
-
-	//Cleanup staging buffer
-	stagingBuffer.Cleanup();
+	//Stage the vertex data and record the copy, it is submitted together with the rest of the upload batch
+	UploadManager::GetInstance()->UploadToBuffer(vertices.data(), bufferSize, vertexBuffer->GetBuffer());
 }
 
 void Mesh::CreateIndexBuffer()
 {
-	//Create the staging buffer
 	VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-	Buffer stagingBuffer;
-
-	Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer);
-
-	//Map index data to the buffer
-	void* data;
-	vkMapMemory(logicalDevice, stagingBuffer.GetBufferMemory(), 0, bufferSize, 0, &data);
-	memcpy(data, indices.data(), bufferSize);
-	vkUnmapMemory(logicalDevice, stagingBuffer.GetBufferMemory());
 
 	//Create the index buffer
 	indexBuffer = std::make_shared<Buffer>();
 	Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, *indexBuffer);
 
-	//Copy buffer data
-	Buffer::CopyBuffer(stagingBuffer.GetBuffer(), indexBuffer->GetBuffer(), bufferSize);
-
-	//Cleanup staging buffer
-	stagingBuffer.Cleanup();
+	//Stage the index data and record the copy, it is submitted together with the rest of the upload batch
+	UploadManager::GetInstance()->UploadToBuffer(indices.data(), bufferSize, indexBuffer->GetBuffer());
 }
 
 void Mesh::Cleanup()
@@ -108,91 +85,78 @@ void Mesh::Cleanup()
 
 void Mesh::UpdateInstanceBuffer()
 {
-	//If a new object has been spawned or deleted the instance buffer must be re-created to the correct size
-	if (instanceBufferDirty) {
-		vkQueueWaitIdle(VulkanManager::GetInstance()->GetGraphicsQueue());
-		instanceBuffer->Cleanup();
-		instanceBuffer = std::make_shared<Buffer>(VkBuffer(), VkDeviceMemory());
+	uint32_t frame = SwapChain::GetInstance()->GetCurrentFrame();
+	uint8_t copyBit = 1 << (frame % instanceBuffer->GetBufferCount());
+	uint32_t count = static_cast<uint32_t>(instances.size());
+
+	//Only repack the transforms that changed, every copy of the buffer then needs the new data
+	changedInstances.clear();
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t version = instances[i]->GetVersion();
+		if (version != instanceVersions[i]) {
+			//Children already have their world matrix from the scene graph, only roots are built from position, orientation and scale
+			if (instances[i]->HasParent()) {
+				PackInstance(i);
+			}
+			else {
+				changedInstances.push_back(i);
+			}
+			instanceVersions[i] = version;
+			instanceDirtyCopies[i] = UINT8_MAX;
+		}
 	}
+	PackChangedInstances();
 
-	//Get Data as TransformData
-	std::vector<std::shared_ptr<Transform>> activeInstances = GetActiveInstances();
-	std::vector<TransformData> bufferData(activeInstanceCount);
-
-	for (size_t i = 0; i < activeInstanceCount; i++) {
-		bufferData[i] = TransformData::LoadMat4(activeInstances[i]->GetModelMatrix());
+	//A grown buffer starts out empty
+	if (instanceBuffer->Reserve(frame, static_cast<VkDeviceSize>(instanceStride) * count)) {
+		for (uint32_t i = 0; i < count; i++) {
+			instanceDirtyCopies[i] |= copyBit;
+		}
 	}
 
-	//Ensure that buffer size is not 0
-	VkDeviceSize bufferSize;
-	if (bufferData.size() > 0) {
-		bufferSize = sizeof(TransformData) * bufferData.size();
-	}
-	else {
-		bufferSize = sizeof(TransformData);
-		// return;
-	}
+	//Write each run of instances this frame's copy is missing in one go, static objects never get written again
+	uploadedBytes = 0;
+	uint32_t i = 0;
+	while (i < count) {
+		if (!(instanceDirtyCopies[i] & copyBit)) {
+			i++;
+			continue;
+		}
 
-	//Create the buffer if necessary
-	if (instanceBufferDirty) {
-		Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, *instanceBuffer);
-	}
-	//Copy Data
-	void* data;
-	vkMapMemory(logicalDevice, instanceBuffer->GetBufferMemory(), 0, bufferSize, 0, &data);
-	memcpy(data, bufferData.data(), bufferSize);
-	vkUnmapMemory(logicalDevice, instanceBuffer->GetBufferMemory());
+		uint32_t start = i;
+		while (i < count && (instanceDirtyCopies[i] & copyBit)) {
+			instanceDirtyCopies[i] &= ~copyBit;
+			i++;
+		}
 
-	instanceBufferDirty = false;
+		VkDeviceSize rangeOffset = static_cast<VkDeviceSize>(instanceStride) * start;
+		VkDeviceSize rangeSize = static_cast<VkDeviceSize>(instanceStride) * (i - start);
+		instanceBuffer->WriteRange(frame, &instanceData[rangeOffset], rangeOffset, rangeSize);
+		uploadedBytes += rangeSize;
+	}
 }
 
 void Mesh::UpdateVertexBuffer()
 {
-	//Create the staging buffer
 	VkDeviceSize bufferSize = sizeof(vertices[0]) * vertices.size();
-	Buffer stagingBuffer;
-
-	Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer);
-
-	//Map index data to the buffer
-	void* data;
-	vkMapMemory(logicalDevice, stagingBuffer.GetBufferMemory(), 0, bufferSize, 0, &data);
-	memcpy(data, vertices.data(), bufferSize);
-	vkUnmapMemory(logicalDevice, stagingBuffer.GetBufferMemory());
 
-	//Copy buffer data
-	Buffer::CopyBuffer(stagingBuffer.GetBuffer(), vertexBuffer->GetBuffer(), bufferSize);
-
-	//Cleanup staging buffer
-	stagingBuffer.Cleanup();
+	//Stage the vertex data and record the copy, it is submitted together with the rest of the upload batch
+	UploadManager::GetInstance()->UploadToBuffer(vertices.data(), bufferSize, vertexBuffer->GetBuffer());
 }
 
 void Mesh::UpdateIndexBuffer()
 {
-	//Create the staging buffer
 	VkDeviceSize bufferSize = sizeof(indices[0]) * indices.size();
-	Buffer stagingBuffer;
-
-	Buffer::CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer);
-
-	//Map index data to the buffer
-	void* data;
-	vkMapMemory(logicalDevice, stagingBuffer.GetBufferMemory(), 0, bufferSize, 0, &data);
-	memcpy(data, indices.data(), bufferSize);
-	vkUnmapMemory(logicalDevice, stagingBuffer.GetBufferMemory());
 
-	//Copy buffer data
-	Buffer::CopyBuffer(stagingBuffer.GetBuffer(), indexBuffer->GetBuffer(), bufferSize);
-
-	//Cleanup staging buffer
-	stagingBuffer.Cleanup();
+	//Stage the index data and record the copy, it is submitted together with the rest of the upload batch
+	UploadManager::GetInstance()->UploadToBuffer(indices.data(), bufferSize, indexBuffer->GetBuffer());
 }
 
 #pragma endregion
 
 #pragma region Accessors
 
-std::vector<Vertex> Mesh::GetVertices()
+const std::vector<Vertex>& Mesh::GetVertices()
 {
 	return vertices;
 }
@@ -218,7 +182,7 @@ void Mesh::SetVertexBuffer(std::shared_ptr<Buffer> value, uint32_t offset)
 	vertexBufferOffset = offset;
 }
 
-std::vector<uint16_t> Mesh::GetIndices()
+const std::vector<uint16_t>& Mesh::GetIndices()
 {
 	return indices;
 }
@@ -246,32 +210,88 @@ void Mesh::SetIndexBuffer(std::shared_ptr<Buffer> value, uint32_t offset)
 
 uint32_t Mesh::GetActiveInstanceCount()
 {
-	return activeInstanceCount;
+	return static_cast<uint32_t>(instances.size());
 }
 
-std::vector<std::shared_ptr<Transform>> Mesh::GetActiveInstances()
+const std::vector<std::shared_ptr<Transform>>& Mesh::GetActiveInstances()
 {
-	std::vector<std::shared_ptr<Transform>> activeInstances;
-	activeInstanceCount = 0;
+	return instances;
+}
 
-	for (size_t i = 0; i < instances.size(); i++) {
-		if (instances[i] != nullptr) {
-			activeInstances.push_back(instances[i]);
-			activeInstanceCount++;
-		}
+uint32_t Mesh::GetInstanceIndex(int instanceId)
+{
+	if (instanceId < 0 || instanceId >= instanceSlots.size() || instanceSlots[instanceId] == UINT32_MAX) {
+		throw std::runtime_error("Failed to find instance, ID was empty!");
 	}
 
-	return activeInstances;
+	return instanceSlots[instanceId];
 }
 
-std::shared_ptr<Buffer> Mesh::GetInstanceBuffer()
+std::shared_ptr<InstanceBuffer> Mesh::GetInstanceBuffer()
 {
 	return instanceBuffer;
 }
 
-void Mesh::SetInstanceBuffer(std::shared_ptr<Buffer> value)
+void Mesh::SetInstanceBuffer(std::shared_ptr<InstanceBuffer> value)
 {
 	instanceBuffer = value;
+	MarkAllInstancesDirty();
+}
+
+bool Mesh::GetStaticInstances()
+{
+	return staticInstances;
+}
+
+void Mesh::SetStaticInstances(bool value)
+{
+	if (instanceBuffer != nullptr) {
+		throw std::runtime_error("Instances can't be made static after the instance buffer is created!");
+	}
+
+	staticInstances = value;
+}
+
+InstanceFormats Mesh::GetInstanceFormat()
+{
+	return instanceFormat;
+}
+
+void Mesh::SetInstanceFormat(InstanceFormats value)
+{
+	if (instanceBuffer != nullptr) {
+		throw std::runtime_error("Instance format can't be changed after the instance buffer is created!");
+	}
+
+	instanceFormat = value;
+	instanceStride = GetInstanceStride(value);
+
+	//Repack every instance in the new layout
+	instanceData.resize(static_cast<size_t>(instanceStride) * instances.size());
+	for (uint32_t i = 0; i < instances.size(); i++) {
+		PackInstance(i);
+	}
+
+	MarkAllInstancesDirty();
+}
+
+uint32_t Mesh::GetInstanceStride(InstanceFormats format)
+{
+	switch (format) {
+		case MatrixInstanceFormat:
+			return sizeof(TransformData);
+		case AffineInstanceFormat:
+			return sizeof(AffineTransformData);
+		case CompactInstanceFormat:
+			return sizeof(CompactTransformData);
+		default:
+			throw std::runtime_error("Unknown instance format!");
+	}
+}
+
+VkDeviceSize Mesh::GetUploadedBytes()
+{
+	return uploadedBytes;
 }
 
 std::shared_ptr<Material> Mesh::GetMaterial()
@@ -288,42 +308,172 @@ void Mesh::SetMaterial(std::shared_ptr<Material> value)
 
 #pragma region Instances
 
-int Mesh::AddInstance(std::shared_ptr<Transform> value)
+int Mesh::AddInstance(const std::shared_ptr<Transform>& value)
 {
-	activeInstanceCount++;
-	size_t freeIndex = -1;
-
-	for (size_t i = 0; i < instances.size(); i++) {
-		if (instances[i] == nullptr) {
-			freeIndex = i;
-			break;
-		}
+	//Reuse the ID of a removed instance if there is one
+	uint32_t instanceId;
+	if (freeInstanceIds.size() > 0) {
+		instanceId = freeInstanceIds.back();
+		freeInstanceIds.pop_back();
 	}
-
-	if (freeIndex == -1) {
-		instances.push_back(value);
-		return (instances.size() - 1);
+	else {
+		instanceId = static_cast<uint32_t>(instanceSlots.size());
+		instanceSlots.push_back(UINT32_MAX);
 	}
-	instances[freeIndex] = value;
-	instanceBufferDirty = true;
-	return freeIndex;
+
+	instanceSlots[instanceId] = static_cast<uint32_t>(instances.size());
+	instances.push_back(value);
+	instanceIds.push_back(instanceId);
+	instanceData.resize(instanceData.size() + instanceStride);
+	instanceVersions.push_back(value->GetVersion());
+	instanceDirtyCopies.push_back(UINT8_MAX);
+	PackInstance(instanceSlots[instanceId]);
+
+	return static_cast<int>(instanceId);
 }
 
 void Mesh::RemoveInstance(int instanceId)
 {
-	if (instanceId < 0 || instanceId >= instances.size()) {
+	if (instanceId < 0 || instanceId >= instanceSlots.size()) {
 		throw std::runtime_error("Failed to remove instance, ID out of bounds!");
 	}
 
-	if (instances[instanceId] == nullptr) {
+	uint32_t index = instanceSlots[instanceId];
+	if (index == UINT32_MAX) {
 		throw std::runtime_error("Failed to remove instance, ID was empty!");
 	}
 
-	activeInstanceCount--;
-	instances[instanceId] = nullptr;
-	// We technically don't need to set the instanceColor at this index to anything bc
-	// once a new instance is added to instances, the instanceColor will be overridden.
-	instanceBufferDirty = true;
+	//Move the last instance into the hole so the instances stay packed
+	uint32_t last = static_cast<uint32_t>(instances.size() - 1);
+	instances[index] = instances[last];
+	instanceIds[index] = instanceIds[last];
+	instanceSlots[instanceIds[index]] = index;
+	memcpy(&instanceData[static_cast<size_t>(instanceStride) * index], &instanceData[static_cast<size_t>(instanceStride) * last], instanceStride);
+	instanceVersions[index] = instanceVersions[last];
+	instanceDirtyCopies[index] = UINT8_MAX;
+
+	instances.pop_back();
+	instanceIds.pop_back();
+	instanceData.resize(instanceData.size() - instanceStride);
+	instanceVersions.pop_back();
+	instanceDirtyCopies.pop_back();
+	instanceSlots[instanceId] = UINT32_MAX;
+	freeInstanceIds.push_back(instanceId);
+}
+
+void Mesh::ReserveInstances(uint32_t count)
+{
+	instances.reserve(count);
+	instanceIds.reserve(count);
+	instanceData.reserve(static_cast<size_t>(instanceStride) * count);
+	instanceVersions.reserve(count);
+	instanceDirtyCopies.reserve(count);
+	instanceSlots.reserve(count);
+	freeInstanceIds.reserve(count);
+}
+
+void Mesh::MarkAllInstancesDirty()
+{
+	for (size_t i = 0; i < instanceDirtyCopies.size(); i++) {
+		instanceDirtyCopies[i] = UINT8_MAX;
+	}
+}
+
+void Mesh::PackInstance(uint32_t index)
+{
+	uint8_t* data = &instanceData[static_cast<size_t>(instanceStride) * index];
+	std::shared_ptr<Transform> transform = instances[index];
+
+	switch (instanceFormat) {
+		case MatrixInstanceFormat: {
+			TransformData matrix = TransformData::LoadMat4(transform->GetWorldMatrix());
+			memcpy(data, &matrix, sizeof(matrix));
+			break;
+		}
+		case AffineInstanceFormat: {
+			AffineTransformData affine = AffineTransformData::LoadMat4(transform->GetWorldMatrix());
+			memcpy(data, &affine, sizeof(affine));
+			break;
+		}
+		case CompactInstanceFormat: {
+			//The shader builds the matrix itself so the transform's matrix is never generated unless a parent is involved
+			CompactTransformData compact = transform->HasParent() ?
+				CompactTransformData::LoadMat4(transform->GetWorldMatrix()) :
+				CompactTransformData::Load(transform->GetPosition(), transform->GetOrientation(), transform->GetScale());
+			memcpy(data, &compact, sizeof(compact));
+			break;
+		}
+	}
+}
+
+void Mesh::PackChangedInstances()
+{
+	uint32_t count = static_cast<uint32_t>(changedInstances.size());
+	if (count == 0) {
+		return;
+	}
+
+	//The compact format has no matrix to build
+	if (instanceFormat == CompactInstanceFormat) {
+		for (uint32_t i = 0; i < count; i++) {
+			PackInstance(changedInstances[i]);
+		}
+		return;
+	}
+
+	//Gather the changed transforms one component per array
+	changedTransforms.resize(static_cast<size_t>(count) * 10);
+	float* components = changedTransforms.data();
+	TransformArrays transforms;
+	transforms.positionX = components;
+	transforms.positionY = components + count;
+	transforms.positionZ = components + count * 2;
+	transforms.orientationX = components + count * 3;
+	transforms.orientationY = components + count * 4;
+	transforms.orientationZ = components + count * 5;
+	transforms.orientationW = components + count * 6;
+	transforms.scaleX = components + count * 7;
+	transforms.scaleY = components + count * 8;
+	transforms.scaleZ = components + count * 9;
+
+	for (uint32_t i = 0; i < count; i++) {
+		std::shared_ptr<Transform> transform = instances[changedInstances[i]];
+		glm::vec3 position = transform->GetPosition();
+		glm::quat orientation = transform->GetOrientation();
+		glm::vec3 scale = transform->GetScale();
+
+		components[i] = position.x;
+		components[count + i] = position.y;
+		components[count * 2 + i] = position.z;
+		components[count * 3 + i] = orientation.x;
+		components[count * 4 + i] = orientation.y;
+		components[count * 5 + i] = orientation.z;
+		components[count * 6 + i] = orientation.w;
+		components[count * 7 + i] = scale.x;
+		components[count * 8 + i] = scale.y;
+		components[count * 9 + i] = scale.z;
+	}
+
+	//When every instance changed the kernels write straight into the instance data, otherwise the results are scattered into place
+	bool allChanged = count == instances.size();
+	uint8_t* output = instanceData.data();
+	if (!allChanged) {
+		changedData.resize(static_cast<size_t>(instanceStride) * count);
+		output = changedData.data();
+	}
+
+	if (instanceFormat == AffineInstanceFormat) {
+		TransformKernels::GenerateAffineMatricesParallel(transforms, count, reinterpret_cast<AffineTransformData*>(output));
+	}
+	else {
+		TransformKernels::GenerateModelMatricesParallel(transforms, count, reinterpret_cast<TransformData*>(output));
+	}
+
+	if (!allChanged) {
+		for (uint32_t i = 0; i < count; i++) {
+			memcpy(&instanceData[static_cast<size_t>(instanceStride) * changedInstances[i]], &changedData[static_cast<size_t>(instanceStride) * i], instanceStride);
+		}
+	}
 }
 
 #pragma endregion
@@ -5,6 +5,10 @@
 #include "Transform.h"
 #include "Material.h"
 #include "Buffer.h"
+#include "InstanceBuffer.h"
+#include "TransformData.h"
+#include "AffineTransformData.h"
+#include "CompactTransformData.h"
 #include "UniformBufferObject.h"
 
 class Mesh
@@ -20,16 +24,53 @@ private:
 	uint32_t indexBufferOffset;
 	std::shared_ptr<Buffer> indexBuffer;
 
-	//Instances
+	//Instances are packed with no gaps and removed by moving the last one into the hole, so adding and removing never searches.
+	//Instance IDs index instanceSlots, which holds where each instance currently is, instanceIds is the reverse
 	std::vector<std::shared_ptr<Transform>> instances;
-	uint32_t activeInstanceCount;
-	std::shared_ptr<Buffer> instanceBuffer;
+	std::vector<uint32_t> instanceIds;
+	std::vector<uint32_t> instanceSlots;
+	std::vector<uint32_t> freeInstanceIds;
+	std::shared_ptr<InstanceBuffer> instanceBuffer;
+
+	//Packed data of every instance in the same order as instances and the transform version it was built from, instanceStride bytes each
+	std::vector<uint8_t> instanceData;
+	std::vector<uint32_t> instanceVersions;
+	InstanceFormats instanceFormat = MatrixInstanceFormat;
+	uint32_t instanceStride = sizeof(TransformData);
+
+	//Instances whose transform changed since the latest update, with their components gathered one per array for the transform kernels
+	std::vector<uint32_t> changedInstances;
+	std::vector<float> changedTransforms;
+	std::vector<uint8_t> changedData;
+
+	//One bit per instance buffer copy that hasn't been sent the instance's latest matrix, only runs of set bits are uploaded
+	std::vector<uint8_t> instanceDirtyCopies;
+
+	//Static instances live in a single device local buffer, for meshes whose instances rarely move
+	bool staticInstances = false;
+
+	//Bytes written to the instance buffer by the latest UpdateInstanceBuffer
+	VkDeviceSize uploadedBytes = 0;
+
+	/// <summary>
+	/// Marks every instance as needing to be written to every copy of the instance buffer
+	/// </summary>
+	void MarkAllInstancesDirty();
+
+	/// <summary>
+	/// Writes the data of an instance's transform into instanceData in the mesh's instance format
+	/// </summary>
+	/// <param name="index">The index of the instance among the active instances</param>
+	void PackInstance(uint32_t index);
+
+	/// <summary>
+	/// Writes the data of every changed instance into instanceData, building the matrices in batches with the transform kernels
+	/// </summary>
+	void PackChangedInstances();
 
 	//Material
 	std::shared_ptr<Material> material;
 
-
-	bool instanceBufferDirty = true;
 public:
 
 #pragma region Constructor
@@ -40,7 +81,7 @@ public:
 		std::vector<uint16_t> indices = {},
 		std::shared_ptr<Buffer> vertexBuffer = nullptr, uint32_t vertexBufferOffset = 0, 
 		std::shared_ptr<Buffer> indexBuffer = nullptr, uint32_t indexBufferOffset = 0,
-		std::vector<std::shared_ptr<Transform>> instances = std::vector<std::shared_ptr<Transform>>(), std::shared_ptr<Buffer> instanceBuffer = nullptr);
+		std::vector<std::shared_ptr<Transform>> instances = std::vector<std::shared_ptr<Transform>>(), std::shared_ptr<InstanceBuffer> instanceBuffer = nullptr);
 
 #pragma endregion
 
@@ -72,7 +113,8 @@ public:
 	void Cleanup();
 
 	/// <summary>
-	/// Updates the mesh's instance buffer
+	/// Writes the model matrices of instances that changed since they were last written into the instance buffer of the current frame in flight.
+	/// Static meshes record their writes with the upload manager, so only one thread may update static meshes at a time
 	/// </summary>
 	void UpdateInstanceBuffer();
 
@@ -95,7 +137,7 @@ public:
 	/// Returns the list of vertices associated with this mesh
 	/// </summary>
 	/// <returns>List of vertices</returns>
-	std::vector<Vertex> GetVertices();
+	const std::vector<Vertex>& GetVertices();
 
 	/// <summary>
 	/// Sets the list of vertices associated with this mesh
@@ -126,7 +168,7 @@ public:
 	/// Returns the list of indices associated with this mesh
 	/// </summary>
 	/// <returns>List of indices</returns>
-	std::vector<uint16_t> GetIndices();
+	const std::vector<uint16_t>& GetIndices();
 
 	/// <summary>
 	/// Sets the list of indices associated with this mesh
@@ -160,21 +202,67 @@ public:
 	uint32_t GetActiveInstanceCount();
 
 	/// <summary>
-	/// Returns a std::vector of all of the active instances of this mesh
+	/// Returns every active instance of this mesh, packed in the order they are drawn
 	/// </summary>
-	std::vector<std::shared_ptr<Transform>> GetActiveInstances();
+	/// <returns>The active instances, only valid until an instance is added or removed</returns>
+	const std::vector<std::shared_ptr<Transform>>& GetActiveInstances();
+
+	/// <summary>
+	/// Returns where an instance currently is in the instance buffer, changes when other instances are removed
+	/// </summary>
+	/// <param name="instanceId">The ID returned when the instance was added</param>
+	/// <returns>The index of the instance among the active instances</returns>
+	uint32_t GetInstanceIndex(int instanceId);
 
 	/// <summary>
 	/// Returns the instance buffer used by this mesh
 	/// </summary>
 	/// <returns>The mesh's instance buffer</returns>
-	std::shared_ptr<Buffer> GetInstanceBuffer();
+	std::shared_ptr<InstanceBuffer> GetInstanceBuffer();
 
 	/// <summary>
 	/// Sets the instance buffer to the specified value
 	/// </summary>
 	/// <param name="value">The value to set the instance buffer to</param>
-	void SetInstanceBuffer(std::shared_ptr<Buffer> value);
+	void SetInstanceBuffer(std::shared_ptr<InstanceBuffer> value);
+
+	/// <summary>
+	/// Returns whether this mesh's instances are kept in device local memory
+	/// </summary>
+	/// <returns>True if the instances are static</returns>
+	bool GetStaticInstances();
+
+	/// <summary>
+	/// Sets whether this mesh's instances are kept in device local memory, faster to draw but slower to change.
+	/// Must be set before the instance buffer is created
+	/// </summary>
+	/// <param name="value">Whether the instances are static</param>
+	void SetStaticInstances(bool value);
+
+	/// <summary>
+	/// Returns the layout the instances are sent to the vertex shader in
+	/// </summary>
+	/// <returns>The instance format</returns>
+	InstanceFormats GetInstanceFormat();
+
+	/// <summary>
+	/// Sets the layout the instances are sent to the vertex shader in, must match the vertex shader used by the mesh's material
+	/// </summary>
+	/// <param name="value">The instance format</param>
+	void SetInstanceFormat(InstanceFormats value);
+
+	/// <summary>
+	/// Returns the number of bytes each instance takes up in an instance format
+	/// </summary>
+	/// <param name="format">The instance format</param>
+	/// <returns>The size of one instance</returns>
+	static uint32_t GetInstanceStride(InstanceFormats format);
+
+	/// <summary>
+	/// Returns the number of bytes written to the instance buffer by the latest update
+	/// </summary>
+	/// <returns>The uploaded byte count</returns>
+	VkDeviceSize GetUploadedBytes();
 
 	/// <summary>
 	/// Returns the material that is being used by this mesh
@@ -197,14 +285,20 @@ public:
 	/// </summary>
 	/// <param name="value">The transform to add</param>
 	/// <returns>The instance ID of the instance that was created</returns>
-	int AddInstance(std::shared_ptr<Transform> value);
+	int AddInstance(const std::shared_ptr<Transform>& value);
 
 	/// <summary>
-	/// Removes the specified instance from the instance list
+	/// Removes the specified instance from the instance list, the last instance is moved into its place
 	/// </summary>
-	/// <param name="instanceId">The index of the instance to remove</param>
+	/// <param name="instanceId">The ID returned when the instance was added</param>
 	void RemoveInstance(int instanceId);
 
+	/// <summary>
+	/// Makes room for a number of instances so adding instances up to that count doesn't allocate
+	/// </summary>
+	/// <param name="count">The total number of instances to make room for</param>
+	void ReserveInstances(uint32_t count);
+
 #pragma endregion
 
 #pragma region Mesh Generation
@@ -0,0 +1,12 @@
+#pragma once
+#include "pch.h"
+
+#include "Mesh.h"
+
+struct MeshComponent {
+public:
+	std::shared_ptr<Mesh> mesh;
+
+	//Instance drawn for the entity, -1 while the entity isn't spawned
+	int instanceId = -1;
+};
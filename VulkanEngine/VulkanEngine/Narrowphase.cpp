@@ -0,0 +1,760 @@
+#include "pch.h"
+#include "Narrowphase.h"
+
+#include "DebugManager.h"
+
+#include <cfloat>
+
+//Shorter lengths are treated as zero to avoid dividing by them
+static const float EPSILON = 0.000001f;
+
+//How far apart shapes can be and still count as touching, keeps resting contacts from flickering
+static const float CONTACT_TOLERANCE = 0.001f;
+
+//Edge axes have to overlap noticeably less than face axes to be chosen so boxes resting on each other keep a face normal
+static const float EDGE_AXIS_BIAS = 1.05f;
+
+//Number of times the capsule box test alternates between the two shapes, the closest points converge quickly for convex shapes
+static const uint32_t CAPSULE_BOX_ITERATIONS = 4;
+
+/// <summary>
+/// Returns the order shapes are passed to the shape tests in so each pair of types only needs one test
+/// </summary>
+static uint32_t GetTestOrder(ColliderTypes type)
+{
+	switch (type) {
+	case ColliderTypes::SphereCollider:
+		return 0;
+	case ColliderTypes::CapsuleCollider:
+		return 1;
+	default:
+		return 2;
+	}
+}
+
+#pragma region Shapes
+
+ColliderShape Narrowphase::ComputeShape(const Collider& collider, glm::vec3 position, glm::quat orientation, glm::vec3 scale)
+{
+	ColliderShape shape;
+	shape.type = collider.type;
+
+	//AABBs stay aligned to the world axes whichever way the body is facing
+	glm::mat3 rotation = collider.type == ColliderTypes::AABBCollider ? glm::mat3(1.0f) : glm::mat3_cast(orientation);
+	glm::vec3 absoluteScale = glm::abs(scale);
+
+	shape.center = position + rotation * (collider.offset * scale);
+	shape.axes[0] = rotation[0];
+	shape.axes[1] = rotation[1];
+	shape.axes[2] = rotation[2];
+
+	switch (collider.type) {
+	case ColliderTypes::SphereCollider:
+		shape.radius = collider.radius * std::max(absoluteScale.x, std::max(absoluteScale.y, absoluteScale.z));
+		break;
+	case ColliderTypes::AABBCollider:
+	case ColliderTypes::OBBCollider:
+		shape.halfExtents = collider.halfExtents * absoluteScale;
+		break;
+	case ColliderTypes::CapsuleCollider:
+		shape.radius = collider.radius * std::max(absoluteScale.x, absoluteScale.z);
+		shape.segmentStart = shape.center - shape.axes[1] * (collider.halfHeight * absoluteScale.y);
+		shape.segmentEnd = shape.center + shape.axes[1] * (collider.halfHeight * absoluteScale.y);
+		break;
+	default:
+		break;
+	}
+
+	return shape;
+}
+
+AABB Narrowphase::ComputeBounds(const ColliderShape& shape)
+{
+	AABB bounds;
+
+	switch (shape.type) {
+	case ColliderTypes::AABBCollider:
+	case ColliderTypes::OBBCollider: {
+		glm::vec3 extents = glm::abs(shape.axes[0]) * shape.halfExtents.x + glm::abs(shape.axes[1]) * shape.halfExtents.y + glm::abs(shape.axes[2]) * shape.halfExtents.z;
+		bounds.min = shape.center - extents;
+		bounds.max = shape.center + extents;
+		break;
+	}
+	case ColliderTypes::CapsuleCollider:
+		bounds.min = glm::min(shape.segmentStart, shape.segmentEnd) - glm::vec3(shape.radius);
+		bounds.max = glm::max(shape.segmentStart, shape.segmentEnd) + glm::vec3(shape.radius);
+		break;
+	default:
+		bounds.min = shape.center - glm::vec3(shape.radius);
+		bounds.max = shape.center + glm::vec3(shape.radius);
+		break;
+	}
+
+	return bounds;
+}
+
+float Narrowphase::ComputeBoundingRadius(const ColliderShape& shape)
+{
+	switch (shape.type) {
+	case ColliderTypes::AABBCollider:
+	case ColliderTypes::OBBCollider:
+		return glm::length(shape.halfExtents);
+	case ColliderTypes::CapsuleCollider:
+		return glm::length(shape.segmentEnd - shape.center) + shape.radius;
+	default:
+		return shape.radius;
+	}
+}
+
+void Narrowphase::DrawShape(const ColliderShape& shape, glm::vec3 color)
+{
+	DebugManager* debug = DebugManager::GetInstance();
+
+	switch (shape.type) {
+	case ColliderTypes::AABBCollider:
+	case ColliderTypes::OBBCollider: {
+		glm::vec3 vertices[8];
+		GetVertices(shape, vertices);
+
+		//Corners are numbered by which axes they are on the positive side of, each edge joins corners that differ by one axis
+		for (uint32_t i = 0; i < 8; i++) {
+			for (uint32_t axis = 1; axis < 8; axis <<= 1) {
+				if ((i & axis) == 0) {
+					debug->DrawLine(vertices[i], vertices[i | axis], color, 0.0f);
+				}
+			}
+		}
+		break;
+	}
+	case ColliderTypes::CapsuleCollider:
+		debug->DrawWireSphere(shape.segmentStart, color, shape.radius, 0.0f);
+		debug->DrawWireSphere(shape.segmentEnd, color, shape.radius, 0.0f);
+		debug->DrawLine(shape.segmentStart + shape.axes[0] * shape.radius, shape.segmentEnd + shape.axes[0] * shape.radius, color, 0.0f);
+		debug->DrawLine(shape.segmentStart - shape.axes[0] * shape.radius, shape.segmentEnd - shape.axes[0] * shape.radius, color, 0.0f);
+		debug->DrawLine(shape.segmentStart + shape.axes[2] * shape.radius, shape.segmentEnd + shape.axes[2] * shape.radius, color, 0.0f);
+		debug->DrawLine(shape.segmentStart - shape.axes[2] * shape.radius, shape.segmentEnd - shape.axes[2] * shape.radius, color, 0.0f);
+		break;
+	default:
+		debug->DrawWireSphere(shape.center, color, shape.radius, 0.0f);
+		break;
+	}
+}
+
+#pragma endregion
+
+#pragma region Collision Tests
+
+bool Narrowphase::Collide(const ColliderShape& shape1, const ColliderShape& shape2, ContactManifold& manifold)
+{
+	manifold.pointCount = 0;
+
+	//Swap the shapes into test order then flip the normal back so it still points from the first shape to the second
+	if (GetTestOrder(shape1.type) > GetTestOrder(shape2.type)) {
+		if (!Collide(shape2, shape1, manifold)) {
+			return false;
+		}
+
+		manifold.normal = -manifold.normal;
+		return true;
+	}
+
+	switch (shape1.type) {
+	case ColliderTypes::SphereCollider:
+		switch (shape2.type) {
+		case ColliderTypes::SphereCollider:
+			return SphereSphere(shape1.center, shape1.radius, shape2.center, shape2.radius, manifold);
+		case ColliderTypes::CapsuleCollider:
+			return SphereSphere(shape1.center, shape1.radius, ClosestPointOnSegment(shape1.center, shape2.segmentStart, shape2.segmentEnd), shape2.radius, manifold);
+		default:
+			return SphereBox(shape1.center, shape1.radius, shape2, manifold);
+		}
+	case ColliderTypes::CapsuleCollider:
+		if (shape2.type == ColliderTypes::CapsuleCollider) {
+			return CapsuleCapsule(shape1, shape2, manifold);
+		}
+
+		return CapsuleBox(shape1, shape2, manifold);
+	default:
+		return BoxBox(shape1, shape2, manifold);
+	}
+}
+
+bool Narrowphase::SphereSphere(glm::vec3 center1, float radius1, glm::vec3 center2, float radius2, ContactManifold& manifold)
+{
+	glm::vec3 direction = center2 - center1;
+	float distanceSquared = glm::dot(direction, direction);
+	float radius = radius1 + radius2;
+
+	if (distanceSquared >= radius * radius) {
+		return false;
+	}
+
+	//Spheres with the same center are pushed apart vertically
+	float distance = std::sqrt(distanceSquared);
+	manifold.normal = distance > EPSILON ? direction / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+
+	float depth = radius - distance;
+	manifold.pointCount = 0;
+	manifold.AddPoint(center1 + manifold.normal * (radius1 - depth * 0.5f), depth);
+
+	return true;
+}
+
+bool Narrowphase::SphereBox(glm::vec3 center, float radius, const ColliderShape& box, ContactManifold& manifold)
+{
+	glm::vec3 closest = ClosestPointOnBox(center, box);
+	glm::vec3 direction = closest - center;
+	float distanceSquared = glm::dot(direction, direction);
+
+	manifold.pointCount = 0;
+
+	if (distanceSquared > EPSILON * EPSILON) {
+		if (distanceSquared >= radius * radius) {
+			return false;
+		}
+
+		float distance = std::sqrt(distanceSquared);
+		manifold.normal = direction / distance;
+		manifold.AddPoint(closest, radius - distance);
+		return true;
+	}
+
+	//The center is inside the box, push the sphere out through the nearest face
+	glm::vec3 offset = center - box.center;
+	float minPenetration = FLT_MAX;
+
+	for (uint32_t i = 0; i < 3; i++) {
+		float projection = glm::dot(offset, box.axes[i]);
+		float penetration = box.halfExtents[i] - std::abs(projection);
+
+		if (penetration < minPenetration) {
+			minPenetration = penetration;
+			manifold.normal = projection >= 0.0f ? -box.axes[i] : box.axes[i];
+		}
+	}
+
+	manifold.AddPoint(center, minPenetration + radius);
+	return true;
+}
+
+bool Narrowphase::CapsuleCapsule(const ColliderShape& capsule1, const ColliderShape& capsule2, ContactManifold& manifold)
+{
+	glm::vec3 point1;
+	glm::vec3 point2;
+	ClosestPointsBetweenSegments(capsule1.segmentStart, capsule1.segmentEnd, capsule2.segmentStart, capsule2.segmentEnd, point1, point2);
+
+	return SphereSphere(point1, capsule1.radius, point2, capsule2.radius, manifold);
+}
+
+bool Narrowphase::CapsuleBox(const ColliderShape& capsule, const ColliderShape& box, ContactManifold& manifold)
+{
+	//Find the point on the center line closest to the box by alternately projecting onto each shape
+	glm::vec3 point = (capsule.segmentStart + capsule.segmentEnd) * 0.5f;
+	for (uint32_t i = 0; i < CAPSULE_BOX_ITERATIONS; i++) {
+		point = ClosestPointOnSegment(ClosestPointOnBox(point, box), capsule.segmentStart, capsule.segmentEnd);
+	}
+
+	if (!SphereBox(point, capsule.radius, box, manifold)) {
+		return false;
+	}
+
+	//A capsule lying on a box touches it along its length, add the ends as well so it can rest flat
+	glm::vec3 ends[2] = { capsule.segmentStart, capsule.segmentEnd };
+	for (uint32_t i = 0; i < 2; i++) {
+		ContactManifold endContact;
+
+		if (glm::distance(ends[i], point) > CONTACT_TOLERANCE && SphereBox(ends[i], capsule.radius, box, endContact) && glm::dot(endContact.normal, manifold.normal) > 0.99f) {
+			manifold.AddPoint(endContact.points[0], endContact.depths[0]);
+		}
+	}
+
+	return true;
+}
+
+bool Narrowphase::BoxBox(const ColliderShape& box1, const ColliderShape& box2, ContactManifold& manifold)
+{
+	glm::vec3 offset = box2.center - box1.center;
+	float minOverlap = FLT_MAX;
+	float bestScore = FLT_MAX;
+	uint32_t bestAxis = 0;
+	glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+
+	//Projects both boxes onto the axis, returns false if there is a gap between them.
+	//Axes 0-2 are the first box's faces, 3-5 the second box's faces and 6-14 the cross products of their edges
+	auto testAxis = [&](glm::vec3 axis, uint32_t axisId) {
+		float lengthSquared = glm::dot(axis, axis);
+
+		//Cross products of parallel edges have no direction and are already covered by the face axes
+		if (lengthSquared < EPSILON) {
+			return true;
+		}
+
+		axis /= std::sqrt(lengthSquared);
+
+		float radius1 = 0.0f;
+		float radius2 = 0.0f;
+		for (uint32_t i = 0; i < 3; i++) {
+			radius1 += box1.halfExtents[i] * std::abs(glm::dot(box1.axes[i], axis));
+			radius2 += box2.halfExtents[i] * std::abs(glm::dot(box2.axes[i], axis));
+		}
+
+		float distance = glm::dot(offset, axis);
+		float overlap = radius1 + radius2 - std::abs(distance);
+
+		if (overlap < 0.0f) {
+			return false;
+		}
+
+		float score = axisId >= 6 ? overlap * EDGE_AXIS_BIAS + CONTACT_TOLERANCE : overlap;
+		if (score < bestScore) {
+			bestScore = score;
+			bestAxis = axisId;
+			minOverlap = overlap;
+			normal = distance >= 0.0f ? axis : -axis;
+		}
+
+		return true;
+	};
+
+	for (uint32_t i = 0; i < 3; i++) {
+		if (!testAxis(box1.axes[i], i) || !testAxis(box2.axes[i], i + 3)) {
+			return false;
+		}
+	}
+
+	for (uint32_t i = 0; i < 3; i++) {
+		for (uint32_t j = 0; j < 3; j++) {
+			if (!testAxis(glm::cross(box1.axes[i], box2.axes[j]), 6 + i * 3 + j)) {
+				return false;
+			}
+		}
+	}
+
+	manifold.normal = normal;
+	manifold.pointCount = 0;
+
+	//Edges crossing each other touch at a single point, use the middle of the closest points between the two edges
+	if (bestAxis >= 6) {
+		glm::vec3 start1;
+		glm::vec3 end1;
+		glm::vec3 start2;
+		glm::vec3 end2;
+		GetSupportEdge(box1, normal, (bestAxis - 6) / 3, start1, end1);
+		GetSupportEdge(box2, -normal, (bestAxis - 6) % 3, start2, end2);
+
+		glm::vec3 point1;
+		glm::vec3 point2;
+		ClosestPointsBetweenSegments(start1, end1, start2, end2, point1, point2);
+		manifold.AddPoint((point1 + point2) * 0.5f, minOverlap);
+
+		return true;
+	}
+
+	//Otherwise one box's face is the reference and the most opposing face of the other box is clipped to it
+	bool secondIsReference = bestAxis >= 3;
+	const ColliderShape& reference = secondIsReference ? box2 : box1;
+	const ColliderShape& incident = secondIsReference ? box1 : box2;
+	glm::vec3 referenceNormal = secondIsReference ? -normal : normal;
+	uint32_t referenceAxis = bestAxis % 3;
+
+	uint32_t incidentAxis = 0;
+	float maxAlignment = -1.0f;
+	for (uint32_t i = 0; i < 3; i++) {
+		float alignment = std::abs(glm::dot(incident.axes[i], referenceNormal));
+		if (alignment > maxAlignment) {
+			maxAlignment = alignment;
+			incidentAxis = i;
+		}
+	}
+
+	//Corners of the incident face in winding order
+	uint32_t u = (incidentAxis + 1) % 3;
+	uint32_t v = (incidentAxis + 2) % 3;
+	float faceSide = glm::dot(incident.axes[incidentAxis], referenceNormal) > 0.0f ? -1.0f : 1.0f;
+	glm::vec3 faceCenter = incident.center + incident.axes[incidentAxis] * (incident.halfExtents[incidentAxis] * faceSide);
+	glm::vec3 faceU = incident.axes[u] * incident.halfExtents[u];
+	glm::vec3 faceV = incident.axes[v] * incident.halfExtents[v];
+
+	glm::vec3 polygon[8] = { faceCenter + faceU + faceV, faceCenter - faceU + faceV, faceCenter - faceU - faceV, faceCenter + faceU - faceV };
+	glm::vec3 clipped[8];
+	uint32_t count = 4;
+
+	//Clip against the 4 planes around the sides of the reference face
+	for (uint32_t i = 1; i < 3; i++) {
+		glm::vec3 sideAxis = reference.axes[(referenceAxis + i) % 3];
+		float center = glm::dot(reference.center, sideAxis);
+		float halfExtent = reference.halfExtents[(referenceAxis + i) % 3];
+
+		count = ClipPolygon(polygon, count, sideAxis, center + halfExtent, clipped);
+		count = ClipPolygon(clipped, count, -sideAxis, halfExtent - center, polygon);
+	}
+
+	//Keep the clipped points that are below the reference face, alternating through them so flat contacts keep points spread around the polygon
+	float referencePlane = glm::dot(reference.center, referenceNormal) + reference.halfExtents[referenceAxis];
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t index = i * 2 < count ? i * 2 : (i * 2 - count) | 1;
+		float depth = referencePlane - glm::dot(polygon[index], referenceNormal);
+
+		if (depth >= -CONTACT_TOLERANCE) {
+			manifold.AddPoint(polygon[index], glm::clamp(depth, 0.0f, minOverlap));
+		}
+	}
+
+	//Numerical edge cases can clip away every point, fall back to the deepest point of the incident box
+	if (manifold.pointCount == 0) {
+		manifold.AddPoint(SupportPoint(incident, -referenceNormal), minOverlap);
+	}
+
+	return true;
+}
+
+#pragma endregion
+
+#pragma region Ray Tests
+
+bool Narrowphase::Raycast(const ColliderShape& shape, glm::vec3 origin, glm::vec3 direction, float radius, float maxDistance, float& distance, glm::vec3& normal)
+{
+	//A swept sphere touches a shape where its center line hits the shape grown by the sphere's radius
+	switch (shape.type) {
+	case ColliderTypes::SphereCollider:
+		return RaySphere(origin, direction, shape.center, shape.radius + radius, maxDistance, distance, normal);
+	case ColliderTypes::CapsuleCollider:
+		return RayCapsule(origin, direction, shape.segmentStart, shape.segmentEnd, shape.radius + radius, maxDistance, distance, normal);
+	default:
+		if (radius > 0.0f) {
+			return RayRoundedBox(origin, direction, shape, radius, maxDistance, distance, normal);
+		}
+
+		return RayBox(origin, direction, shape, 0.0f, maxDistance, distance, normal);
+	}
+}
+
+bool Narrowphase::RaySphere(glm::vec3 origin, glm::vec3 direction, glm::vec3 center, float radius, float maxDistance, float& distance, glm::vec3& normal)
+{
+	glm::vec3 offset = origin - center;
+	float c = glm::dot(offset, offset) - radius * radius;
+
+	if (c <= 0.0f) {
+		distance = 0.0f;
+		normal = -direction;
+		return true;
+	}
+
+	//Outside the sphere and pointing away from it
+	float b = glm::dot(offset, direction);
+	if (b > 0.0f) {
+		return false;
+	}
+
+	float discriminant = b * b - c;
+	if (discriminant < 0.0f) {
+		return false;
+	}
+
+	float hitDistance = -b - std::sqrt(discriminant);
+	if (hitDistance > maxDistance) {
+		return false;
+	}
+
+	distance = hitDistance;
+	normal = (offset + direction * hitDistance) / radius;
+	return true;
+}
+
+bool Narrowphase::RayBox(glm::vec3 origin, glm::vec3 direction, const ColliderShape& box, float margin, float maxDistance, float& distance, glm::vec3& normal)
+{
+	glm::vec3 offset = origin - box.center;
+
+	//The ray is inside the box between the last time it enters a pair of faces and the first time it leaves one
+	float enter = -FLT_MAX;
+	float exit = FLT_MAX;
+	glm::vec3 enterNormal = -direction;
+
+	for (uint32_t i = 0; i < 3; i++) {
+		float extent = box.halfExtents[i] + margin;
+		float start = glm::dot(offset, box.axes[i]);
+		float speed = glm::dot(direction, box.axes[i]);
+
+		//Parallel to this pair of faces, the ray is either always between them or never
+		if (std::abs(speed) < EPSILON) {
+			if (std::abs(start) > extent) {
+				return false;
+			}
+
+			continue;
+		}
+
+		float faceEnter = (-std::copysign(extent, speed) - start) / speed;
+		float faceExit = (std::copysign(extent, speed) - start) / speed;
+
+		if (faceEnter > enter) {
+			enter = faceEnter;
+			enterNormal = speed > 0.0f ? -box.axes[i] : box.axes[i];
+		}
+
+		exit = std::min(exit, faceExit);
+	}
+
+	if (enter > exit || exit < 0.0f || enter > maxDistance) {
+		return false;
+	}
+
+	if (enter <= 0.0f) {
+		distance = 0.0f;
+		normal = -direction;
+		return true;
+	}
+
+	distance = enter;
+	normal = enterNormal;
+	return true;
+}
+
+bool Narrowphase::RayCapsule(glm::vec3 origin, glm::vec3 direction, glm::vec3 start, glm::vec3 end, float radius, float maxDistance, float& distance, glm::vec3& normal)
+{
+	glm::vec3 closest = ClosestPointOnSegment(origin, start, end);
+	if (glm::dot(origin - closest, origin - closest) <= radius * radius) {
+		distance = 0.0f;
+		normal = -direction;
+		return true;
+	}
+
+	bool hit = false;
+	float closestDistance = maxDistance;
+
+	//The side of the capsule, hit the infinite cylinder around the center line and keep the hit if it lands between the ends
+	glm::vec3 axis = end - start;
+	float axisLengthSquared = glm::dot(axis, axis);
+
+	if (axisLengthSquared > EPSILON) {
+		glm::vec3 offset = origin - start;
+		glm::vec3 perpendicularOffset = offset - axis * (glm::dot(offset, axis) / axisLengthSquared);
+		glm::vec3 perpendicularDirection = direction - axis * (glm::dot(direction, axis) / axisLengthSquared);
+
+		float a = glm::dot(perpendicularDirection, perpendicularDirection);
+		float b = glm::dot(perpendicularOffset, perpendicularDirection);
+		float c = glm::dot(perpendicularOffset, perpendicularOffset) - radius * radius;
+		float discriminant = b * b - a * c;
+
+		if (a > EPSILON && discriminant >= 0.0f) {
+			float sideDistance = (-b - std::sqrt(discriminant)) / a;
+			float along = glm::dot(offset + direction * sideDistance, axis) / axisLengthSquared;
+
+			if (sideDistance >= 0.0f && sideDistance <= closestDistance && along >= 0.0f && along <= 1.0f) {
+				closestDistance = sideDistance;
+				normal = (perpendicularOffset + perpendicularDirection * sideDistance) / radius;
+				hit = true;
+			}
+		}
+	}
+
+	//The rounded ends
+	float capDistance;
+	glm::vec3 capNormal;
+
+	if (RaySphere(origin, direction, start, radius, closestDistance, capDistance, capNormal)) {
+		closestDistance = capDistance;
+		normal = capNormal;
+		hit = true;
+	}
+
+	if (RaySphere(origin, direction, end, radius, closestDistance, capDistance, capNormal)) {
+		closestDistance = capDistance;
+		normal = capNormal;
+		hit = true;
+	}
+
+	distance = closestDistance;
+	return hit;
+}
+
+bool Narrowphase::RayRoundedBox(glm::vec3 origin, glm::vec3 direction, const ColliderShape& box, float radius, float maxDistance, float& distance, glm::vec3& normal)
+{
+	//The rounded box fits inside the box grown by the radius, missing that misses everything
+	float grownDistance;
+	glm::vec3 grownNormal;
+	if (!RayBox(origin, direction, box, radius, maxDistance, grownDistance, grownNormal)) {
+		return false;
+	}
+
+	//Hitting the grown box within the original box's extents on all but one axis means the hit is on a flat face
+	glm::vec3 offset = origin + direction * grownDistance - box.center;
+	uint32_t outsideCount = 0;
+	for (uint32_t i = 0; i < 3; i++) {
+		if (std::abs(glm::dot(offset, box.axes[i])) > box.halfExtents[i]) {
+			outsideCount++;
+		}
+	}
+
+	if (outsideCount <= 1) {
+		distance = grownDistance;
+		normal = grownNormal;
+		return true;
+	}
+
+	//Otherwise the ray reached the grown box near an edge or corner, where the rounded box is made of capsules around the box's edges
+	glm::vec3 vertices[8];
+	GetVertices(box, vertices);
+
+	bool hit = false;
+	float closestDistance = maxDistance;
+
+	for (uint32_t axis = 0; axis < 3; axis++) {
+		uint32_t bit = 1 << axis;
+
+		for (uint32_t i = 0; i < 8; i++) {
+			float edgeDistance;
+			glm::vec3 edgeNormal;
+
+			if (!(i & bit) && RayCapsule(origin, direction, vertices[i], vertices[i | bit], radius, closestDistance, edgeDistance, edgeNormal)) {
+				closestDistance = edgeDistance;
+				normal = edgeNormal;
+				hit = true;
+			}
+		}
+	}
+
+	distance = closestDistance;
+	return hit;
+}
+
+#pragma endregion
+
+#pragma region Helper Methods
+
+glm::vec3 Narrowphase::ClosestPointOnSegment(glm::vec3 point, glm::vec3 start, glm::vec3 end)
+{
+	glm::vec3 direction = end - start;
+	float lengthSquared = glm::dot(direction, direction);
+
+	if (lengthSquared < EPSILON) {
+		return start;
+	}
+
+	return start + direction * glm::clamp(glm::dot(point - start, direction) / lengthSquared, 0.0f, 1.0f);
+}
+
+void Narrowphase::ClosestPointsBetweenSegments(glm::vec3 start1, glm::vec3 end1, glm::vec3 start2, glm::vec3 end2, glm::vec3& point1, glm::vec3& point2)
+{
+	glm::vec3 direction1 = end1 - start1;
+	glm::vec3 direction2 = end2 - start2;
+	glm::vec3 offset = start1 - start2;
+
+	float length1 = glm::dot(direction1, direction1);
+	float length2 = glm::dot(direction2, direction2);
+	float f = glm::dot(direction2, offset);
+
+	//s and t are how far along each segment the closest points are, from 0 to 1
+	float s = 0.0f;
+	float t = 0.0f;
+
+	if (length1 < EPSILON && length2 < EPSILON) {
+		//Both segments are points
+	}
+	else if (length1 < EPSILON) {
+		t = glm::clamp(f / length2, 0.0f, 1.0f);
+	}
+	else {
+		float c = glm::dot(direction1, offset);
+
+		if (length2 < EPSILON) {
+			s = glm::clamp(-c / length1, 0.0f, 1.0f);
+		}
+		else {
+			float b = glm::dot(direction1, direction2);
+			float denominator = length1 * length2 - b * b;
+
+			//Parallel segments have no single closest pair, start from the beginning of the first one
+			if (denominator > EPSILON) {
+				s = glm::clamp((b * f - c * length2) / denominator, 0.0f, 1.0f);
+			}
+
+			t = (b * s + f) / length2;
+
+			//Clamp t to the second segment and recalculate s for the clamped point
+			if (t < 0.0f) {
+				t = 0.0f;
+				s = glm::clamp(-c / length1, 0.0f, 1.0f);
+			}
+			else if (t > 1.0f) {
+				t = 1.0f;
+				s = glm::clamp((b - c) / length1, 0.0f, 1.0f);
+			}
+		}
+	}
+
+	point1 = start1 + direction1 * s;
+	point2 = start2 + direction2 * t;
+}
+
+glm::vec3 Narrowphase::ClosestPointOnBox(glm::vec3 point, const ColliderShape& box)
+{
+	glm::vec3 offset = point - box.center;
+	glm::vec3 closest = box.center;
+
+	for (uint32_t i = 0; i < 3; i++) {
+		closest += box.axes[i] * glm::clamp(glm::dot(offset, box.axes[i]), -box.halfExtents[i], box.halfExtents[i]);
+	}
+
+	return closest;
+}
+
+glm::vec3 Narrowphase::SupportPoint(const ColliderShape& box, glm::vec3 direction)
+{
+	glm::vec3 support = box.center;
+
+	for (uint32_t i = 0; i < 3; i++) {
+		support += box.axes[i] * (glm::dot(direction, box.axes[i]) >= 0.0f ? box.halfExtents[i] : -box.halfExtents[i]);
+	}
+
+	return support;
+}
+
+void Narrowphase::GetSupportEdge(const ColliderShape& box, glm::vec3 direction, uint32_t axis, glm::vec3& start, glm::vec3& end)
+{
+	glm::vec3 center = box.center;
+
+	for (uint32_t i = 0; i < 3; i++) {
+		if (i != axis) {
+			center += box.axes[i] * (glm::dot(direction, box.axes[i]) >= 0.0f ? box.halfExtents[i] : -box.halfExtents[i]);
+		}
+	}
+
+	start = center - box.axes[axis] * box.halfExtents[axis];
+	end = center + box.axes[axis] * box.halfExtents[axis];
+}
+
+uint32_t Narrowphase::ClipPolygon(const glm::vec3* input, uint32_t inputCount, glm::vec3 planeNormal, float planeOffset, glm::vec3* output)
+{
+	uint32_t outputCount = 0;
+
+	for (uint32_t i = 0; i < inputCount; i++) {
+		glm::vec3 current = input[i];
+		glm::vec3 next = input[(i + 1) % inputCount];
+		float currentDistance = glm::dot(current, planeNormal) - planeOffset;
+		float nextDistance = glm::dot(next, planeNormal) - planeOffset;
+
+		if (currentDistance <= 0.0f) {
+			output[outputCount++] = current;
+		}
+
+		//The edge crosses the plane, add the point where it crosses
+		if ((currentDistance <= 0.0f) != (nextDistance <= 0.0f)) {
+			output[outputCount++] = current + (next - current) * (currentDistance / (currentDistance - nextDistance));
+		}
+	}
+
+	return outputCount;
+}
+
+void Narrowphase::GetVertices(const ColliderShape& box, glm::vec3* vertices)
+{
+	for (uint32_t i = 0; i < 8; i++) {
+		vertices[i] = box.center
+			+ box.axes[0] * ((i & 1) ? box.halfExtents.x : -box.halfExtents.x)
+			+ box.axes[1] * ((i & 2) ? box.halfExtents.y : -box.halfExtents.y)
+			+ box.axes[2] * ((i & 4) ? box.halfExtents.z : -box.halfExtents.z);
+	}
+}
+
+#pragma endregion
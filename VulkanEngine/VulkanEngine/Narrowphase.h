@@ -0,0 +1,172 @@
+#pragma once
+#include "pch.h"
+
+#include "AABB.h"
+#include "Collider.h"
+#include "ColliderShape.h"
+#include "ContactManifold.h"
+
+class Narrowphase
+{
+private:
+#pragma region Helper Methods
+
+	/// <summary>
+	/// Returns the point on a line segment closest to the specified point
+	/// </summary>
+	static glm::vec3 ClosestPointOnSegment(glm::vec3 point, glm::vec3 start, glm::vec3 end);
+
+	/// <summary>
+	/// Finds the closest pair of points between two line segments
+	/// </summary>
+	static void ClosestPointsBetweenSegments(glm::vec3 start1, glm::vec3 end1, glm::vec3 start2, glm::vec3 end2, glm::vec3& point1, glm::vec3& point2);
+
+	/// <summary>
+	/// Returns the point on or inside a box closest to the specified point
+	/// </summary>
+	static glm::vec3 ClosestPointOnBox(glm::vec3 point, const ColliderShape& box);
+
+	/// <summary>
+	/// Returns the vertex of a box furthest along a direction
+	/// </summary>
+	static glm::vec3 SupportPoint(const ColliderShape& box, glm::vec3 direction);
+
+	/// <summary>
+	/// Finds the edge of a box parallel to one of its axes that is furthest along a direction
+	/// </summary>
+	static void GetSupportEdge(const ColliderShape& box, glm::vec3 direction, uint32_t axis, glm::vec3& start, glm::vec3& end);
+
+	/// <summary>
+	/// Clips a convex polygon to the inside of a plane, the output needs room for one more point than the input
+	/// </summary>
+	/// <returns>The number of points in the clipped polygon</returns>
+	static uint32_t ClipPolygon(const glm::vec3* input, uint32_t inputCount, glm::vec3 planeNormal, float planeOffset, glm::vec3* output);
+
+	/// <summary>
+	/// Fills vertices with the 8 corners of a box
+	/// </summary>
+	static void GetVertices(const ColliderShape& box, glm::vec3* vertices);
+
+#pragma endregion
+
+#pragma region Shape Tests
+
+	/// <summary>
+	/// Tests two spheres, also used for capsules once the closest points on their center lines are known, the normal points from the first sphere to the second
+	/// </summary>
+	static bool SphereSphere(glm::vec3 center1, float radius1, glm::vec3 center2, float radius2, ContactManifold& manifold);
+
+	/// <summary>
+	/// Tests a sphere against an AABB or OBB, the normal points from the sphere to the box
+	/// </summary>
+	static bool SphereBox(glm::vec3 center, float radius, const ColliderShape& box, ContactManifold& manifold);
+
+	/// <summary>
+	/// Tests two capsules
+	/// </summary>
+	static bool CapsuleCapsule(const ColliderShape& capsule1, const ColliderShape& capsule2, ContactManifold& manifold);
+
+	/// <summary>
+	/// Tests a capsule against an AABB or OBB, the normal points from the capsule to the box
+	/// </summary>
+	static bool CapsuleBox(const ColliderShape& capsule, const ColliderShape& box, ContactManifold& manifold);
+
+	/// <summary>
+	/// Tests two AABBs or OBBs with the separating axis test, the normal points from the first box to the second
+	/// </summary>
+	static bool BoxBox(const ColliderShape& box1, const ColliderShape& box2, ContactManifold& manifold);
+
+#pragma endregion
+
+#pragma region Ray Tests
+
+	/// <summary>
+	/// Casts a ray against a sphere, the direction must be normalized
+	/// </summary>
+	static bool RaySphere(glm::vec3 origin, glm::vec3 direction, glm::vec3 center, float radius, float maxDistance, float& distance, glm::vec3& normal);
+
+	/// <summary>
+	/// Casts a ray against an AABB or OBB grown by a margin on every side, keeping its corners sharp
+	/// </summary>
+	static bool RayBox(glm::vec3 origin, glm::vec3 direction, const ColliderShape& box, float margin, float maxDistance, float& distance, glm::vec3& normal);
+
+	/// <summary>
+	/// Casts a ray against a capsule given by the end points of its center line
+	/// </summary>
+	static bool RayCapsule(glm::vec3 origin, glm::vec3 direction, glm::vec3 start, glm::vec3 end, float radius, float maxDistance, float& distance, glm::vec3& normal);
+
+	/// <summary>
+	/// Casts a ray against an AABB or OBB grown by a radius with rounded edges and corners, the space a sphere of that radius can't enter
+	/// </summary>
+	static bool RayRoundedBox(glm::vec3 origin, glm::vec3 direction, const ColliderShape& box, float radius, float maxDistance, float& distance, glm::vec3& normal);
+
+#pragma endregion
+
+public:
+#pragma region Shapes
+
+	/// <summary>
+	/// Places a collider in world space
+	/// </summary>
+	/// <param name="collider">The collider to place</param>
+	/// <param name="position">The position of the body</param>
+	/// <param name="orientation">The orientation of the body, ignored by AABBs</param>
+	/// <param name="scale">The scale of the body</param>
+	/// <returns>The collider's shape in world space</returns>
+	static ColliderShape ComputeShape(const Collider& collider, glm::vec3 position, glm::quat orientation, glm::vec3 scale);
+
+	/// <summary>
+	/// Returns the world space box that contains the shape
+	/// </summary>
+	/// <param name="shape">The shape to bound</param>
+	/// <returns>The shape's bounds</returns>
+	static AABB ComputeBounds(const ColliderShape& shape);
+
+	/// <summary>
+	/// Returns the radius of the smallest sphere around the shape's center that contains the shape
+	/// </summary>
+	/// <param name="shape">The shape to bound</param>
+	/// <returns>The shape's bounding radius</returns>
+	static float ComputeBoundingRadius(const ColliderShape& shape);
+
+	/// <summary>
+	/// Draws the outline of a shape with the debug manager
+	/// </summary>
+	/// <param name="shape">The shape to draw</param>
+	/// <param name="color">The color to draw the shape in</param>
+	static void DrawShape(const ColliderShape& shape, glm::vec3 color);
+
+#pragma endregion
+
+#pragma region Collision Tests
+
+	/// <summary>
+	/// Tests two shapes for overlap and fills the manifold with the contact normal, points and depths.
+	/// The manifold's body indices are left for the caller to set
+	/// </summary>
+	/// <param name="shape1">The first shape</param>
+	/// <param name="shape2">The second shape</param>
+	/// <param name="manifold">Filled with the contact, its normal points from the first shape to the second</param>
+	/// <returns>True if the shapes overlap</returns>
+	static bool Collide(const ColliderShape& shape1, const ColliderShape& shape2, ContactManifold& manifold);
+
+#pragma endregion
+
+#pragma region Ray Tests
+
+	/// <summary>
+	/// Casts a ray, or a sphere swept along the ray, against a shape.
+	/// Starting inside the shape counts as a hit at distance zero
+	/// </summary>
+	/// <param name="shape">The shape to cast against</param>
+	/// <param name="origin">The start of the ray</param>
+	/// <param name="direction">The normalized direction of the ray</param>
+	/// <param name="radius">The radius of the swept sphere, zero for a thin ray</param>
+	/// <param name="maxDistance">How far the ray reaches</param>
+	/// <param name="distance">Set to how far along the ray the hit is</param>
+	/// <param name="normal">Set to the surface normal at the hit, or the reverse of the direction when starting inside the shape</param>
+	/// <returns>True if the ray hits the shape</returns>
+	static bool Raycast(const ColliderShape& shape, glm::vec3 origin, glm::vec3 direction, float radius, float maxDistance, float& distance, glm::vec3& normal);
+
+#pragma endregion
+};
@@ -0,0 +1,136 @@
+#pragma once
+#include "pch.h"
+
+#include "GameObject.h"
+#include "ObjectPrefab.h"
+
+template<typename T = GameObject>
+class ObjectPool
+{
+private:
+	ObjectPrefab prefab;
+
+	//Every object is created up front with its transform and physics body, spawning only hands out one that is free
+	std::vector<std::shared_ptr<T>> objects;
+	std::vector<uint32_t> freeObjects;
+
+	//Pool slot of each object by its entity's index, lets objects be returned without searching
+	std::vector<uint32_t> slots;
+
+public:
+#pragma region Constructor
+
+	/// <summary>
+	/// Creates every object the pool can hand out, along with their transforms and physics bodies, and reserves their mesh instances
+	/// </summary>
+	/// <param name="prefab">What every object is made from</param>
+	/// <param name="capacity">The number of objects to create</param>
+	ObjectPool(const ObjectPrefab& prefab, uint32_t capacity)
+	{
+		this->prefab = prefab;
+
+		objects.reserve(capacity);
+		freeObjects.reserve(capacity);
+		prefab.mesh->ReserveInstances(prefab.mesh->GetActiveInstanceCount() + capacity);
+
+		for (uint32_t i = 0; i < capacity; i++) {
+			std::shared_ptr<Transform> transform = std::make_shared<Transform>();
+			transform->SetScale(prefab.scale);
+
+			std::shared_ptr<PhysicsObject> physicsObject = std::make_shared<PhysicsObject>(transform, prefab.physicsLayer, prefab.mass, prefab.affectedByGravity, false);
+			physicsObject->SetCollider(prefab.collider);
+
+			std::shared_ptr<T> object = std::make_shared<T>(prefab.mesh, transform, physicsObject);
+			object->SetTag(prefab.tag);
+
+			Entity entity = object->GetEntity();
+			if (entity.index >= slots.size()) {
+				slots.resize(static_cast<size_t>(entity.index) + 1, UINT32_MAX);
+			}
+			slots[entity.index] = i;
+
+			objects.push_back(object);
+		}
+
+		//Hand out the first objects first
+		for (uint32_t i = capacity; i > 0; i--) {
+			freeObjects.push_back(i - 1);
+		}
+	}
+
+	/// <summary>
+	/// Copying would leave two pools handing out the same objects
+	/// </summary>
+	ObjectPool(const ObjectPool&) = delete;
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the number of objects the pool created
+	/// </summary>
+	/// <returns>The pool's capacity</returns>
+	uint32_t GetCapacity()
+	{
+		return static_cast<uint32_t>(objects.size());
+	}
+
+	/// <summary>
+	/// Returns the number of objects that are currently spawned
+	/// </summary>
+	/// <returns>The active object count</returns>
+	uint32_t GetActiveCount()
+	{
+		return static_cast<uint32_t>(objects.size() - freeObjects.size());
+	}
+
+#pragma endregion
+
+#pragma region Spawning
+
+	/// <summary>
+	/// Spawns a free object at a position, nothing is allocated
+	/// </summary>
+	/// <param name="position">Where to place the object</param>
+	/// <param name="velocity">The velocity to start the object's body with</param>
+	/// <returns>The spawned object, nullptr if every object is already spawned</returns>
+	std::shared_ptr<T> Spawn(glm::vec3 position, glm::vec3 velocity = glm::vec3(0.0f, 0.0f, 0.0f))
+	{
+		if (freeObjects.empty()) {
+			return nullptr;
+		}
+
+		const std::shared_ptr<T>& object = objects[freeObjects.back()];
+		freeObjects.pop_back();
+
+		//Also moves the transform, and clears the previous position so the body doesn't appear to have flown from where it was despawned
+		std::shared_ptr<PhysicsObject> physicsObject = object->GetPhysicsObject();
+		physicsObject->SetPosition(position);
+		physicsObject->SetVelocity(velocity);
+		object->Spawn();
+
+		return object;
+	}
+
+	/// <summary>
+	/// Despawns an object and returns it to the pool, nothing is freed
+	/// </summary>
+	/// <param name="object">An object spawned from this pool</param>
+	void Despawn(const std::shared_ptr<T>& object)
+	{
+		Entity entity = object->GetEntity();
+		if (entity.index >= slots.size() || slots[entity.index] == UINT32_MAX || objects[slots[entity.index]] != object) {
+			throw std::runtime_error("Failed to despawn object, it doesn't belong to this pool!");
+		}
+
+		if (!object->GetActive()) {
+			return;
+		}
+
+		object->Despawn();
+		freeObjects.push_back(slots[entity.index]);
+	}
+
+#pragma endregion
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include "pch.h"
+
+#include "Mesh.h"
+#include "Collider.h"
+
+struct ObjectPrefab {
+public:
+	std::shared_ptr<Mesh> mesh;
+
+	//Given to every object so the live ones can be found with GameManager::GetObjectsWithTag
+	std::string tag;
+
+	glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
+
+	PhysicsLayers physicsLayer = PhysicsLayers::Dynamic;
+	float mass = 1.0f;
+	bool affectedByGravity = true;
+	Collider collider;
+};
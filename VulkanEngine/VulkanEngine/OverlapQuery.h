@@ -0,0 +1,16 @@
+#pragma once
+#include "pch.h"
+
+#include "Collider.h"
+
+struct OverlapQuery {
+public:
+	//Shape to test, placed in the world the same way a body's collider is
+	Collider collider;
+	glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f);
+	glm::quat orientation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+	glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
+
+	//Bits of the collision layers the query can find
+	uint32_t layerMask = UINT32_MAX;
+};
@@ -0,0 +1,14 @@
+#pragma once
+#include "pch.h"
+
+#include "PhysicsObject.h"
+#include "PhysicsHandle.h"
+
+struct PhysicsComponent {
+public:
+	//Keeps the body alive, the body is destroyed along with the last reference
+	std::shared_ptr<PhysicsObject> physicsObject;
+
+	//Copy of the body's handle so systems can look bodies up in the physics world without going through the object
+	PhysicsHandle handle;
+};
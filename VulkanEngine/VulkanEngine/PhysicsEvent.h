@@ -0,0 +1,14 @@
+#pragma once
+#include "pch.h"
+
+#include "PhysicsEventTypes.h"
+#include "PhysicsHandle.h"
+
+struct PhysicsEvent {
+public:
+	PhysicsEventTypes type = PhysicsEventTypes::CollisionEnter;
+
+	//The body the event is delivered to and the body it touched, every pair sends one event to each of its bodies
+	PhysicsHandle self;
+	PhysicsHandle other;
+};
@@ -0,0 +1,10 @@
+#pragma once
+
+enum PhysicsEventTypes {
+	TriggerEnter,
+	TriggerStay,
+	TriggerExit,
+	CollisionEnter,
+	CollisionExit,
+	PhysicsEventTypeCount
+};
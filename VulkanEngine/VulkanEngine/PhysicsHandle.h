@@ -0,0 +1,15 @@
+#pragma once
+#include "pch.h"
+
+struct PhysicsHandle {
+public:
+	//Slot in the physics world's handle table, stays the same while bodies around it are added and removed
+	uint32_t index = UINT32_MAX;
+
+	//Must match the slot's generation, a slot that has been freed and reused will not accept old handles
+	uint32_t generation = 0;
+
+	bool operator==(const PhysicsHandle& other) const {
+		return index == other.index && generation == other.generation;
+	}
+};
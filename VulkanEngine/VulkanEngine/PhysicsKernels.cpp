@@ -0,0 +1,322 @@
+#include "pch.h"
+#include "PhysicsKernels.h"
+
+#include <immintrin.h>
+
+//MSVC lets any function use AVX2 intrinsics, GCC and Clang need the function to be marked
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+SimdLevels PhysicsKernels::supportedLevel = PhysicsKernels::DetectSupportedLevel();
+SimdLevels PhysicsKernels::level = PhysicsKernels::supportedLevel;
+
+#pragma region Accessors
+
+SimdLevels PhysicsKernels::GetSupportedLevel()
+{
+	return supportedLevel;
+}
+
+SimdLevels PhysicsKernels::GetLevel()
+{
+	return level;
+}
+
+void PhysicsKernels::SetLevel(SimdLevels value)
+{
+	level = std::min(value, supportedLevel);
+}
+
+SimdLevels PhysicsKernels::DetectSupportedLevel()
+{
+#if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse = (info[3] & (1 << 25)) != 0;
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+	bool avx = (info[2] & (1 << 28)) != 0;
+
+	//AVX2 needs both the CPU flag and the operating system saving the YMM registers on context switches
+	if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+		__cpuidex(info, 7, 0);
+		if ((info[1] & (1 << 5)) != 0) {
+			return SimdLevels::AVX2;
+		}
+	}
+
+	return sse ? SimdLevels::SSE : SimdLevels::Scalar;
+#else
+	if (__builtin_cpu_supports("avx2")) {
+		return SimdLevels::AVX2;
+	}
+
+	return __builtin_cpu_supports("sse") ? SimdLevels::SSE : SimdLevels::Scalar;
+#endif
+}
+
+#pragma endregion
+
+#pragma region Integration
+
+void PhysicsKernels::IntegrateVelocities(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime, glm::vec3 gravity)
+{
+	switch (level) {
+	case SimdLevels::AVX2:
+		IntegrateVelocitiesAVX2(bodies, begin, end, deltaTime, gravity);
+		break;
+	case SimdLevels::SSE:
+		IntegrateVelocitiesSSE(bodies, begin, end, deltaTime, gravity);
+		break;
+	default:
+		IntegrateVelocitiesScalar(bodies, begin, end, deltaTime, gravity);
+		break;
+	}
+}
+
+void PhysicsKernels::IntegratePositions(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime)
+{
+	switch (level) {
+	case SimdLevels::AVX2:
+		IntegratePositionsAVX2(bodies, begin, end, deltaTime);
+		break;
+	case SimdLevels::SSE:
+		IntegratePositionsSSE(bodies, begin, end, deltaTime);
+		break;
+	default:
+		IntegratePositionsScalar(bodies, begin, end, deltaTime);
+		break;
+	}
+}
+
+void PhysicsKernels::IntegrateVelocitiesScalar(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime, glm::vec3 gravity)
+{
+	//Bodies that are not simulated have simulated and gravityScale set to 0 so every body goes through the same branch free math
+	for (uint32_t i = begin; i < end; i++) {
+		float s = bodies.simulated[i];
+		float g = bodies.gravityScale[i];
+
+		float accelerationX = bodies.accelerationX[i] + gravity.x * g;
+		float accelerationY = bodies.accelerationY[i] + gravity.y * g;
+		float accelerationZ = bodies.accelerationZ[i] + gravity.z * g;
+
+		bodies.velocityX[i] += accelerationX * deltaTime * s;
+		bodies.velocityY[i] += accelerationY * deltaTime * s;
+		bodies.velocityZ[i] += accelerationZ * deltaTime * s;
+
+		//Forces only last one step, bodies that are not simulated keep theirs until they are
+		bodies.accelerationX[i] = accelerationX * (1.0f - s);
+		bodies.accelerationY[i] = accelerationY * (1.0f - s);
+		bodies.accelerationZ[i] = accelerationZ * (1.0f - s);
+	}
+}
+
+void PhysicsKernels::IntegratePositionsScalar(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime)
+{
+	for (uint32_t i = begin; i < end; i++) {
+		float s = bodies.simulated[i];
+
+		bodies.positionX[i] += bodies.velocityX[i] * deltaTime * s;
+		bodies.positionY[i] += bodies.velocityY[i] * deltaTime * s;
+		bodies.positionZ[i] += bodies.velocityZ[i] * deltaTime * s;
+	}
+}
+
+void PhysicsKernels::IntegrateVelocitiesSSE(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime, glm::vec3 gravity)
+{
+	const __m128 dt = _mm_set1_ps(deltaTime);
+	const __m128 gravityX = _mm_set1_ps(gravity.x);
+	const __m128 gravityY = _mm_set1_ps(gravity.y);
+	const __m128 gravityZ = _mm_set1_ps(gravity.z);
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	//Same operations in the same order as the scalar kernel so the results match exactly
+	uint32_t i = begin;
+	for (; i + 4 <= end; i += 4) {
+		__m128 s = _mm_loadu_ps(bodies.simulated + i);
+		__m128 g = _mm_loadu_ps(bodies.gravityScale + i);
+
+		__m128 accelerationX = _mm_add_ps(_mm_loadu_ps(bodies.accelerationX + i), _mm_mul_ps(gravityX, g));
+		__m128 accelerationY = _mm_add_ps(_mm_loadu_ps(bodies.accelerationY + i), _mm_mul_ps(gravityY, g));
+		__m128 accelerationZ = _mm_add_ps(_mm_loadu_ps(bodies.accelerationZ + i), _mm_mul_ps(gravityZ, g));
+
+		_mm_storeu_ps(bodies.velocityX + i, _mm_add_ps(_mm_loadu_ps(bodies.velocityX + i), _mm_mul_ps(_mm_mul_ps(accelerationX, dt), s)));
+		_mm_storeu_ps(bodies.velocityY + i, _mm_add_ps(_mm_loadu_ps(bodies.velocityY + i), _mm_mul_ps(_mm_mul_ps(accelerationY, dt), s)));
+		_mm_storeu_ps(bodies.velocityZ + i, _mm_add_ps(_mm_loadu_ps(bodies.velocityZ + i), _mm_mul_ps(_mm_mul_ps(accelerationZ, dt), s)));
+
+		__m128 remaining = _mm_sub_ps(one, s);
+		_mm_storeu_ps(bodies.accelerationX + i, _mm_mul_ps(accelerationX, remaining));
+		_mm_storeu_ps(bodies.accelerationY + i, _mm_mul_ps(accelerationY, remaining));
+		_mm_storeu_ps(bodies.accelerationZ + i, _mm_mul_ps(accelerationZ, remaining));
+	}
+
+	IntegrateVelocitiesScalar(bodies, i, end, deltaTime, gravity);
+}
+
+void PhysicsKernels::IntegratePositionsSSE(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime)
+{
+	const __m128 dt = _mm_set1_ps(deltaTime);
+
+	uint32_t i = begin;
+	for (; i + 4 <= end; i += 4) {
+		__m128 s = _mm_loadu_ps(bodies.simulated + i);
+
+		_mm_storeu_ps(bodies.positionX + i, _mm_add_ps(_mm_loadu_ps(bodies.positionX + i), _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(bodies.velocityX + i), dt), s)));
+		_mm_storeu_ps(bodies.positionY + i, _mm_add_ps(_mm_loadu_ps(bodies.positionY + i), _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(bodies.velocityY + i), dt), s)));
+		_mm_storeu_ps(bodies.positionZ + i, _mm_add_ps(_mm_loadu_ps(bodies.positionZ + i), _mm_mul_ps(_mm_mul_ps(_mm_loadu_ps(bodies.velocityZ + i), dt), s)));
+	}
+
+	IntegratePositionsScalar(bodies, i, end, deltaTime);
+}
+
+TARGET_AVX2 void PhysicsKernels::IntegrateVelocitiesAVX2(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime, glm::vec3 gravity)
+{
+	const __m256 dt = _mm256_set1_ps(deltaTime);
+	const __m256 gravityX = _mm256_set1_ps(gravity.x);
+	const __m256 gravityY = _mm256_set1_ps(gravity.y);
+	const __m256 gravityZ = _mm256_set1_ps(gravity.z);
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	//Same operations in the same order as the scalar kernel so the results match exactly, no fused multiply-adds for the same reason
+	uint32_t i = begin;
+	for (; i + 8 <= end; i += 8) {
+		__m256 s = _mm256_loadu_ps(bodies.simulated + i);
+		__m256 g = _mm256_loadu_ps(bodies.gravityScale + i);
+
+		__m256 accelerationX = _mm256_add_ps(_mm256_loadu_ps(bodies.accelerationX + i), _mm256_mul_ps(gravityX, g));
+		__m256 accelerationY = _mm256_add_ps(_mm256_loadu_ps(bodies.accelerationY + i), _mm256_mul_ps(gravityY, g));
+		__m256 accelerationZ = _mm256_add_ps(_mm256_loadu_ps(bodies.accelerationZ + i), _mm256_mul_ps(gravityZ, g));
+
+		_mm256_storeu_ps(bodies.velocityX + i, _mm256_add_ps(_mm256_loadu_ps(bodies.velocityX + i), _mm256_mul_ps(_mm256_mul_ps(accelerationX, dt), s)));
+		_mm256_storeu_ps(bodies.velocityY + i, _mm256_add_ps(_mm256_loadu_ps(bodies.velocityY + i), _mm256_mul_ps(_mm256_mul_ps(accelerationY, dt), s)));
+		_mm256_storeu_ps(bodies.velocityZ + i, _mm256_add_ps(_mm256_loadu_ps(bodies.velocityZ + i), _mm256_mul_ps(_mm256_mul_ps(accelerationZ, dt), s)));
+
+		__m256 remaining = _mm256_sub_ps(one, s);
+		_mm256_storeu_ps(bodies.accelerationX + i, _mm256_mul_ps(accelerationX, remaining));
+		_mm256_storeu_ps(bodies.accelerationY + i, _mm256_mul_ps(accelerationY, remaining));
+		_mm256_storeu_ps(bodies.accelerationZ + i, _mm256_mul_ps(accelerationZ, remaining));
+	}
+
+	IntegrateVelocitiesScalar(bodies, i, end, deltaTime, gravity);
+}
+
+TARGET_AVX2 void PhysicsKernels::IntegratePositionsAVX2(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime)
+{
+	const __m256 dt = _mm256_set1_ps(deltaTime);
+
+	uint32_t i = begin;
+	for (; i + 8 <= end; i += 8) {
+		__m256 s = _mm256_loadu_ps(bodies.simulated + i);
+
+		_mm256_storeu_ps(bodies.positionX + i, _mm256_add_ps(_mm256_loadu_ps(bodies.positionX + i), _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(bodies.velocityX + i), dt), s)));
+		_mm256_storeu_ps(bodies.positionY + i, _mm256_add_ps(_mm256_loadu_ps(bodies.positionY + i), _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(bodies.velocityY + i), dt), s)));
+		_mm256_storeu_ps(bodies.positionZ + i, _mm256_add_ps(_mm256_loadu_ps(bodies.positionZ + i), _mm256_mul_ps(_mm256_mul_ps(_mm256_loadu_ps(bodies.velocityZ + i), dt), s)));
+	}
+
+	IntegratePositionsScalar(bodies, i, end, deltaTime);
+}
+
+#pragma endregion
+
+#pragma region Narrowphase
+
+void PhysicsKernels::CheckPairs(const BodyArrays& bodies, const CollisionPair* pairs, uint32_t count, uint8_t* results)
+{
+	switch (level) {
+	case SimdLevels::AVX2:
+		CheckPairsAVX2(bodies, pairs, count, results);
+		break;
+	case SimdLevels::SSE:
+		CheckPairsSSE(bodies, pairs, count, results);
+		break;
+	default:
+		CheckPairsScalar(bodies, pairs, count, results);
+		break;
+	}
+}
+
+void PhysicsKernels::CheckPairsScalar(const BodyArrays& bodies, const CollisionPair* pairs, uint32_t count, uint8_t* results)
+{
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t a = pairs[i].a;
+		uint32_t b = pairs[i].b;
+
+		float directionX = bodies.positionX[a] - bodies.positionX[b];
+		float directionY = bodies.positionY[a] - bodies.positionY[b];
+		float directionZ = bodies.positionZ[a] - bodies.positionZ[b];
+		float distanceSquared = directionX * directionX + directionY * directionY + directionZ * directionZ;
+		float radius = bodies.boundingRadius[a] + bodies.boundingRadius[b];
+
+		results[i] = distanceSquared < radius * radius ? 1 : 0;
+	}
+}
+
+void PhysicsKernels::CheckPairsSSE(const BodyArrays& bodies, const CollisionPair* pairs, uint32_t count, uint8_t* results)
+{
+	//SSE has no gather so the positions are loaded one lane at a time, the math is still done 4 pairs at a time
+	uint32_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const CollisionPair* p = pairs + i;
+
+		__m128 directionX = _mm_sub_ps(
+			_mm_setr_ps(bodies.positionX[p[0].a], bodies.positionX[p[1].a], bodies.positionX[p[2].a], bodies.positionX[p[3].a]),
+			_mm_setr_ps(bodies.positionX[p[0].b], bodies.positionX[p[1].b], bodies.positionX[p[2].b], bodies.positionX[p[3].b]));
+		__m128 directionY = _mm_sub_ps(
+			_mm_setr_ps(bodies.positionY[p[0].a], bodies.positionY[p[1].a], bodies.positionY[p[2].a], bodies.positionY[p[3].a]),
+			_mm_setr_ps(bodies.positionY[p[0].b], bodies.positionY[p[1].b], bodies.positionY[p[2].b], bodies.positionY[p[3].b]));
+		__m128 directionZ = _mm_sub_ps(
+			_mm_setr_ps(bodies.positionZ[p[0].a], bodies.positionZ[p[1].a], bodies.positionZ[p[2].a], bodies.positionZ[p[3].a]),
+			_mm_setr_ps(bodies.positionZ[p[0].b], bodies.positionZ[p[1].b], bodies.positionZ[p[2].b], bodies.positionZ[p[3].b]));
+
+		__m128 radius = _mm_add_ps(
+			_mm_setr_ps(bodies.boundingRadius[p[0].a], bodies.boundingRadius[p[1].a], bodies.boundingRadius[p[2].a], bodies.boundingRadius[p[3].a]),
+			_mm_setr_ps(bodies.boundingRadius[p[0].b], bodies.boundingRadius[p[1].b], bodies.boundingRadius[p[2].b], bodies.boundingRadius[p[3].b]));
+
+		__m128 distanceSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, directionX), _mm_mul_ps(directionY, directionY)), _mm_mul_ps(directionZ, directionZ));
+		int mask = _mm_movemask_ps(_mm_cmplt_ps(distanceSquared, _mm_mul_ps(radius, radius)));
+
+		for (uint32_t lane = 0; lane < 4; lane++) {
+			results[i + lane] = (mask >> lane) & 1;
+		}
+	}
+
+	CheckPairsScalar(bodies, pairs + i, count - i, results + i);
+}
+
+TARGET_AVX2 void PhysicsKernels::CheckPairsAVX2(const BodyArrays& bodies, const CollisionPair* pairs, uint32_t count, uint8_t* results)
+{
+	//Pairs are stored as a, b, a, b... so each half is shuffled into a0 a1 a2 a3 b0 b1 b2 b3 before the halves are combined
+	const __m256i deinterleave = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+
+	uint32_t i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256i* p = reinterpret_cast<const __m256i*>(pairs + i);
+		__m256i low = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(p), deinterleave);
+		__m256i high = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(p + 1), deinterleave);
+		__m256i a = _mm256_permute2x128_si256(low, high, 0x20);
+		__m256i b = _mm256_permute2x128_si256(low, high, 0x31);
+
+		__m256 directionX = _mm256_sub_ps(_mm256_i32gather_ps(bodies.positionX, a, 4), _mm256_i32gather_ps(bodies.positionX, b, 4));
+		__m256 directionY = _mm256_sub_ps(_mm256_i32gather_ps(bodies.positionY, a, 4), _mm256_i32gather_ps(bodies.positionY, b, 4));
+		__m256 directionZ = _mm256_sub_ps(_mm256_i32gather_ps(bodies.positionZ, a, 4), _mm256_i32gather_ps(bodies.positionZ, b, 4));
+
+		__m256 radius = _mm256_add_ps(_mm256_i32gather_ps(bodies.boundingRadius, a, 4), _mm256_i32gather_ps(bodies.boundingRadius, b, 4));
+
+		__m256 distanceSquared = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(directionX, directionX), _mm256_mul_ps(directionY, directionY)), _mm256_mul_ps(directionZ, directionZ));
+		int mask = _mm256_movemask_ps(_mm256_cmp_ps(distanceSquared, _mm256_mul_ps(radius, radius), _CMP_LT_OQ));
+
+		for (uint32_t lane = 0; lane < 8; lane++) {
+			results[i + lane] = (mask >> lane) & 1;
+		}
+	}
+
+	CheckPairsScalar(bodies, pairs + i, count - i, results + i);
+}
+
+#pragma endregion
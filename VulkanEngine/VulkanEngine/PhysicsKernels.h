@@ -0,0 +1,124 @@
+#pragma once
+#include "pch.h"
+
+#include "BodyArrays.h"
+#include "CollisionPair.h"
+#include "SimdLevels.h"
+
+class PhysicsKernels
+{
+private:
+	static SimdLevels supportedLevel;
+	static SimdLevels level;
+
+	/// <summary>
+	/// Queries the CPU and operating system for the widest instruction set that can be used
+	/// </summary>
+	/// <returns>The best supported SIMD level</returns>
+	static SimdLevels DetectSupportedLevel();
+
+#pragma region Kernels
+
+	/// <summary>
+	/// Applies forces to bodies one at a time, used for the remainder of a range and on CPUs without SSE
+	/// </summary>
+	static void IntegrateVelocitiesScalar(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime, glm::vec3 gravity);
+
+	/// <summary>
+	/// Moves bodies one at a time, used for the remainder of a range and on CPUs without SSE
+	/// </summary>
+	static void IntegratePositionsScalar(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime);
+
+	/// <summary>
+	/// Applies forces to bodies 4 at a time with SSE
+	/// </summary>
+	static void IntegrateVelocitiesSSE(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime, glm::vec3 gravity);
+
+	/// <summary>
+	/// Moves bodies 4 at a time with SSE
+	/// </summary>
+	static void IntegratePositionsSSE(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime);
+
+	/// <summary>
+	/// Applies forces to bodies 8 at a time with AVX2
+	/// </summary>
+	static void IntegrateVelocitiesAVX2(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime, glm::vec3 gravity);
+
+	/// <summary>
+	/// Moves bodies 8 at a time with AVX2
+	/// </summary>
+	static void IntegratePositionsAVX2(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime);
+
+	/// <summary>
+	/// Checks pairs one at a time, used for the remainder of a range and on CPUs without SSE
+	/// </summary>
+	static void CheckPairsScalar(const BodyArrays& bodies, const CollisionPair* pairs, uint32_t count, uint8_t* results);
+
+	/// <summary>
+	/// Checks pairs 4 at a time with SSE
+	/// </summary>
+	static void CheckPairsSSE(const BodyArrays& bodies, const CollisionPair* pairs, uint32_t count, uint8_t* results);
+
+	/// <summary>
+	/// Checks pairs 8 at a time with AVX2, using gathers to load the positions
+	/// </summary>
+	static void CheckPairsAVX2(const BodyArrays& bodies, const CollisionPair* pairs, uint32_t count, uint8_t* results);
+
+#pragma endregion
+
+public:
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the widest SIMD level that this CPU supports
+	/// </summary>
+	/// <returns>The supported SIMD level</returns>
+	static SimdLevels GetSupportedLevel();
+
+	/// <summary>
+	/// Returns the SIMD level the kernels are currently running at
+	/// </summary>
+	/// <returns>The SIMD level in use</returns>
+	static SimdLevels GetLevel();
+
+	/// <summary>
+	/// Sets the SIMD level the kernels run at, levels the CPU does not support fall back to the supported level
+	/// </summary>
+	/// <param name="value">The SIMD level to use</param>
+	static void SetLevel(SimdLevels value);
+
+#pragma endregion
+
+#pragma region Kernels
+
+	/// <summary>
+	/// Applies gravity and acceleration to the velocity of a range of bodies, 4 or 8 bodies at a time depending on the SIMD level
+	/// </summary>
+	/// <param name="bodies">The physics world's state arrays</param>
+	/// <param name="begin">The first dense index to integrate</param>
+	/// <param name="end">One past the last dense index to integrate</param>
+	/// <param name="deltaTime">The time step</param>
+	/// <param name="gravity">The gravity force applied to bodies that are affected by gravity</param>
+	static void IntegrateVelocities(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime, glm::vec3 gravity);
+
+	/// <summary>
+	/// Moves a range of bodies by their velocity, 4 or 8 bodies at a time depending on the SIMD level
+	/// </summary>
+	/// <param name="bodies">The physics world's state arrays</param>
+	/// <param name="begin">The first dense index to integrate</param>
+	/// <param name="end">One past the last dense index to integrate</param>
+	/// <param name="deltaTime">The time step</param>
+	static void IntegratePositions(const BodyArrays& bodies, uint32_t begin, uint32_t end, float deltaTime);
+
+	/// <summary>
+	/// Checks which pairs of bodies have overlapping bounding spheres, 4 or 8 pairs at a time depending on the SIMD level.
+	/// Used to skip the exact shape tests for pairs that are clearly apart
+	/// </summary>
+	/// <param name="bodies">The physics world's state arrays</param>
+	/// <param name="pairs">The pairs of dense indices to check</param>
+	/// <param name="count">The number of pairs</param>
+	/// <param name="results">Filled with 1 for each pair whose bounding spheres overlap and 0 otherwise</param>
+	static void CheckPairs(const BodyArrays& bodies, const CollisionPair* pairs, uint32_t count, uint8_t* results);
+
+#pragma endregion
+};
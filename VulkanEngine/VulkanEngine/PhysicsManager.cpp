@@ -1,6 +1,17 @@
 #include "pch.h"
 #include "PhysicsManager.h"
 
+#include "JobSystem.h"
+#include "FileManager.h"
+#include "DebugManager.h"
+#include "PhysicsKernels.h"
+#include "Narrowphase.h"
+#include "BruteForceBroadphase.h"
+#include "SweepAndPrune.h"
+#include "UniformGrid.h"
+
+#include <cfloat>
+
 #pragma region Singleton
 
 PhysicsManager* PhysicsManager::instance = nullptr;
@@ -9,11 +20,12 @@ PhysicsManager* PhysicsManager::GetInstance()
 {
     if (instance == nullptr) {
         instance = new PhysicsManager();
-        instance->physicsObjects.resize(PhysicsLayers::PhysicsLayerCount);
+        instance->world = std::make_shared<PhysicsWorld>();
 
-        for (size_t i = 0; i < instance->physicsObjects.size(); i++) {
-            instance->physicsObjects[i] = std::vector<std::shared_ptr<PhysicsObject>>();
-        }
+        instance->broadphases.resize(BroadphaseTypes::BroadphaseTypeCount);
+        instance->broadphases[BroadphaseTypes::AllPairs] = std::make_shared<BruteForceBroadphase>();
+        instance->broadphases[BroadphaseTypes::Sweep] = std::make_shared<SweepAndPrune>();
+        instance->broadphases[BroadphaseTypes::Grid] = std::make_shared<UniformGrid>();
     }
 
     return instance;
@@ -21,6 +33,15 @@ PhysicsManager* PhysicsManager::GetInstance()
 
 #pragma endregion
 
+#pragma region Memory Management
+
+void PhysicsManager::Cleanup()
+{
+    SetThreaded(false);
+}
+
+#pragma endregion
+
 #pragma region Accessors
 
 float PhysicsManager::GetGravity()
@@ -30,7 +51,14 @@ float PhysicsManager::GetGravity()
 
 void PhysicsManager::SetGravity(float value)
 {
+    std::lock_guard<std::mutex> lock(world->GetMutex());
     gravity = value;
+
+    if (recording != nullptr) {
+        recording->Write(static_cast<uint8_t>(RecordTypes::RecordSetGravity));
+        recording->Write(gravity);
+        recording->Write(gravityDirection);
+    }
 }
 
 glm::vec3 PhysicsManager::GetGravityDirection()
@@ -40,12 +68,167 @@ glm::vec3 PhysicsManager::GetGravityDirection()
 
 void PhysicsManager::SetGravityDirection(glm::vec3 value)
 {
+    std::lock_guard<std::mutex> lock(world->GetMutex());
     gravityDirection = value;
+
+    if (recording != nullptr) {
+        recording->Write(static_cast<uint8_t>(RecordTypes::RecordSetGravity));
+        recording->Write(gravity);
+        recording->Write(gravityDirection);
+    }
+}
+
+std::shared_ptr<PhysicsWorld> PhysicsManager::GetWorld()
+{
+    return world;
+}
+
+BroadphaseTypes PhysicsManager::GetBroadphaseType()
+{
+    return broadphaseType;
+}
+
+void PhysicsManager::SetBroadphaseType(BroadphaseTypes value)
+{
+    broadphaseType = value;
+}
+
+uint32_t PhysicsManager::GetCandidatePairCount()
+{
+    return candidatePairCount;
+}
+
+uint32_t PhysicsManager::GetContactCount()
+{
+    return contactCount;
+}
+
+float PhysicsManager::GetBroadphaseTime()
+{
+    return broadphaseTime;
+}
+
+float PhysicsManager::GetIntegrationTime()
+{
+    return integrationTime;
+}
+
+float PhysicsManager::GetNarrowphaseTime()
+{
+    return narrowphaseTime;
+}
+
+float PhysicsManager::GetSolverTime()
+{
+    return solverTime;
+}
+
+uint32_t PhysicsManager::GetRaycastCount()
+{
+    return raycastCount;
+}
+
+float PhysicsManager::GetRaycastTime()
+{
+    return raycastTime;
+}
+
+uint32_t PhysicsManager::GetSolverIterations()
+{
+    return solver.GetIterations();
+}
+
+void PhysicsManager::SetSolverIterations(uint32_t value)
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+    solver.SetIterations(value);
+
+    if (recording != nullptr) {
+        recording->Write(static_cast<uint8_t>(RecordTypes::RecordSetSolverIterations));
+        recording->Write(value);
+    }
+}
+
+uint32_t PhysicsManager::GetSleepingBodyCount()
+{
+    return sleepingBodyCount;
+}
+
+bool PhysicsManager::GetSleepingEnabled()
+{
+    return sleepingEnabled;
+}
+
+void PhysicsManager::SetSleepingEnabled(bool value)
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+    sleepingEnabled = value;
+
+    if (recording != nullptr) {
+        recording->Write(static_cast<uint8_t>(RecordTypes::RecordSetSleepingEnabled));
+        recording->Write(static_cast<uint8_t>(value));
+    }
+}
+
+uint32_t PhysicsManager::GetBodyCount()
+{
+    return bodyCount;
+}
+
+uint32_t PhysicsManager::GetStepCount()
+{
+    return stepCount;
+}
+
+float PhysicsManager::GetFixedTimeStep()
+{
+    return fixedTimeStep;
 }
 
-void PhysicsManager::AddPhysicsObject(std::shared_ptr<PhysicsObject> object)
+void PhysicsManager::SetFixedTimeStep(float value)
 {
-    physicsObjects[object->GetPhysicsLayer()].push_back(object);
+    fixedTimeStep = value;
+}
+
+uint32_t PhysicsManager::GetMaxSubsteps()
+{
+    return maxSubsteps;
+}
+
+void PhysicsManager::SetMaxSubsteps(uint32_t value)
+{
+    maxSubsteps = value;
+}
+
+bool PhysicsManager::GetThreaded()
+{
+    return threaded;
+}
+
+void PhysicsManager::SetThreaded(bool value)
+{
+    if (value == threaded) {
+        return;
+    }
+
+    if (value) {
+        {
+            std::lock_guard<std::mutex> lock(world->GetMutex());
+            lastStepTime = std::chrono::steady_clock::now();
+        }
+
+        threadRunning = true;
+        physicsThread = std::thread(&PhysicsManager::PhysicsThreadLoop, this);
+    }
+    else {
+        threadRunning = false;
+        physicsThread.join();
+
+        std::lock_guard<std::mutex> lock(world->GetMutex());
+        accumulator = 0.0f;
+    }
+
+    threaded = value;
 }
 
 #pragma endregion
@@ -54,13 +237,113 @@ void PhysicsManager::AddPhysicsObject(std::shared_ptr<PhysicsObject> object)
 
 void PhysicsManager::Update()
 {
-    //Update dynamic objects
-    for (size_t i = 0; i < physicsObjects[PhysicsLayers::Dynamic].size(); i++) {
-        physicsObjects[PhysicsLayers::Dynamic][i]->Update();
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+
+    float step = fixedTimeStep;
+    float alpha = 0.0f;
+
+    if (threaded) {
+        //The physics thread steps on its own, only work out how far past its latest step we are
+        alpha = std::chrono::duration<float>(std::chrono::steady_clock::now() - lastStepTime).count() / step;
+    }
+    else {
+        accumulator += Time::GetDeltaTime();
+
+        uint32_t substeps = 0;
+        while (accumulator >= step && substeps < maxSubsteps) {
+            Step(step);
+            accumulator -= step;
+            substeps++;
+        }
+
+        //Drop the time that could not be simulated so one long frame doesn't leave physics permanently behind
+        if (accumulator >= step) {
+            accumulator = std::fmod(accumulator, step);
+        }
+
+        alpha = accumulator / step;
+    }
+
+    //Rendering reads positions from the transforms so copy the results over, blended between the last two steps
+    world->SyncTransforms(glm::clamp(alpha, 0.0f, 1.0f));
+
+    if (DebugManager::GetInstance()->GetDrawHandles()) {
+        for (uint32_t i = 0; i < world->GetBodyCount(); i++) {
+            if (world->layers[i] == PhysicsLayers::Dynamic) {
+                world->DrawBodyHandles(i);
+            }
+        }
+    }
+}
+
+void PhysicsManager::StepFixed(uint32_t count)
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+
+    for (uint32_t i = 0; i < count; i++) {
+        Step(fixedTimeStep);
     }
 
-    //Check for collisions
+    world->SyncTransforms(1.0f);
+}
+
+void PhysicsManager::Step(float deltaTime)
+{
+    world->SavePreviousPositions();
+
+    //Find contacts at the current positions
     DetectCollisions();
+
+    //Apply forces, then fix the velocities so touching bodies don't move into each other before moving anything
+    std::chrono::steady_clock::time_point integrationStart = std::chrono::steady_clock::now();
+    world->IntegrateVelocities(deltaTime, gravity * gravityDirection);
+    float velocityTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - integrationStart).count();
+
+    SolveContacts(deltaTime);
+
+    integrationStart = std::chrono::steady_clock::now();
+    world->IntegratePositions(deltaTime);
+    integrationTime = velocityTime + std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - integrationStart).count();
+
+    UpdateSleeping(deltaTime);
+
+    bodyCount = world->GetBodyCount();
+    stepCount++;
+
+    //The hash lets a replay find the exact step it stopped matching on
+    if (recording != nullptr) {
+        recording->Write(static_cast<uint8_t>(RecordTypes::RecordStep));
+        recording->Write(deltaTime);
+        recording->Write(world->ComputeHash());
+    }
+}
+
+void PhysicsManager::PhysicsThreadLoop()
+{
+    std::chrono::steady_clock::time_point nextStep = std::chrono::steady_clock::now();
+
+    //Steps hold the world's mutex through their parallel loops, so this thread must not pick up frame jobs that lock it too
+    JobSystem::GetInstance()->BeginIsolation();
+
+    while (threadRunning) {
+        std::chrono::duration<float> step(fixedTimeStep);
+
+        {
+            std::lock_guard<std::mutex> lock(world->GetMutex());
+            Step(step.count());
+            lastStepTime = std::chrono::steady_clock::now();
+        }
+
+        //Skip ahead rather than trying to catch up once more than maxSubsteps steps behind
+        nextStep += std::chrono::duration_cast<std::chrono::steady_clock::duration>(step);
+        if (std::chrono::steady_clock::now() - nextStep > step * static_cast<float>(maxSubsteps)) {
+            nextStep = std::chrono::steady_clock::now();
+        }
+
+        std::this_thread::sleep_until(nextStep);
+    }
+
+    JobSystem::GetInstance()->EndIsolation();
 }
 
 #pragma endregion
@@ -69,82 +352,664 @@ void PhysicsManager::Update()
 
 void PhysicsManager::DetectCollisions()
 {
-    //Check Dynamic objects against all objects
-    for (size_t i = 0; i < physicsObjects[PhysicsLayers::Dynamic].size(); i++) {
-        for (size_t j = i + 1; j < physicsObjects[PhysicsLayers::Dynamic].size(); j++) {
-            if (CheckCollision(physicsObjects[PhysicsLayers::Dynamic][i], physicsObjects[PhysicsLayers::Dynamic][j])) {
-                ResolveCollision(physicsObjects[PhysicsLayers::Dynamic][i], physicsObjects[PhysicsLayers::Dynamic][j]);
-            }
+    GatherProxies();
+
+    std::chrono::steady_clock::time_point broadphaseStart = std::chrono::steady_clock::now();
+    queryBroadphaseType = broadphaseType;
+    broadphases[queryBroadphaseType]->FindPairs(proxyBounds, proxyFilters, candidatePairs);
+
+    //Each broadphase reports pairs in a different order, sort them so collisions resolve the same way whichever is used
+    std::sort(candidatePairs.begin(), candidatePairs.end());
+    candidatePairCount = static_cast<uint32_t>(candidatePairs.size());
+    broadphaseTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - broadphaseStart).count();
+
+    //Narrowphase, every pair is checked against the positions from the start of the step
+    CheckCollisions();
+
+    //Events are only queued here, they are sent out in a batch once the game asks for them
+    UpdateTouchingPairs();
+}
+
+void PhysicsManager::GatherProxies()
+{
+    uint32_t count = world->GetBodyCount();
+    shapes.resize(count);
+    proxyBounds.resize(count);
+    proxyHandles.resize(count);
+    proxyFilters.resize(count);
+
+    JobSystem::GetInstance()->ParallelFor(count, [this](uint32_t i) {
+        proxyHandles[i] = { world->handleSlots[i], world->generations[world->handleSlots[i]] };
+        proxyFilters[i] = world->filters[i];
+
+        glm::vec3 position = glm::vec3(world->positionX[i], world->positionY[i], world->positionZ[i]);
+        shapes[i] = Narrowphase::ComputeShape(world->colliders[i], position, world->orientations[i], world->scales[i]);
+        proxyBounds[i] = Narrowphase::ComputeBounds(shapes[i]);
+
+        //Measured from the body's position since that is what the bounding sphere check reads
+        world->boundingRadius[i] = glm::distance(position, shapes[i].center) + Narrowphase::ComputeBoundingRadius(shapes[i]);
+    }, 256);
+}
+
+void PhysicsManager::CheckCollisions()
+{
+    std::chrono::steady_clock::time_point narrowphaseStart = std::chrono::steady_clock::now();
+
+    uint32_t pairCount = static_cast<uint32_t>(candidatePairs.size());
+    collisionResults.resize(pairCount);
+    if (manifolds.size() < pairCount) {
+        manifolds.resize(pairCount);
+    }
+
+    //Cheap bounding sphere check first so the exact shape tests only run on pairs that are close
+    PhysicsKernels::CheckPairs(world->GetBodyArrays(), candidatePairs.data(), pairCount, collisionResults.data());
+
+    JobSystem::GetInstance()->ParallelFor(pairCount, [this](uint32_t i) {
+        const CollisionPair& pair = candidatePairs[i];
+
+        //Nothing changes between two bodies that can't move, so sleeping and static bodies are only tested against awake bodies and triggers
+        if (collisionResults[i] && !IsPairActive(pair.a, pair.b)) {
+            collisionResults[i] = 0;
         }
+        else if (collisionResults[i]) {
+            manifolds[i].a = pair.a;
+            manifolds[i].b = pair.b;
+            collisionResults[i] = Narrowphase::Collide(shapes[pair.a], shapes[pair.b], manifolds[i]) ? 1 : 0;
+        }
+    }, 64);
 
-        for (size_t j = 0; j < physicsObjects[PhysicsLayers::Static].size(); j++) {
-            if (CheckCollision(physicsObjects[PhysicsLayers::Dynamic][i], physicsObjects[PhysicsLayers::Static][j])) {
-                ResolveCollision(physicsObjects[PhysicsLayers::Dynamic][i], physicsObjects[PhysicsLayers::Static][j]);
-            }
+    contactCount = static_cast<uint32_t>(std::count(collisionResults.begin(), collisionResults.end(), 1));
+    narrowphaseTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - narrowphaseStart).count();
+}
+
+#pragma endregion
+
+#pragma region Queries
+
+void PhysicsManager::Raycast(const std::vector<RayQuery>& queries, std::vector<std::vector<RaycastHit>>& results)
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+
+    std::chrono::steady_clock::time_point raycastStart = std::chrono::steady_clock::now();
+
+    uint32_t count = static_cast<uint32_t>(queries.size());
+    results.resize(count);
+
+    JobSystem::GetInstance()->ParallelFor(count, [this, &queries, &results](uint32_t i) {
+        CastRay(queries[i], results[i]);
+    }, 16);
+
+    raycastCount = count;
+    raycastTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - raycastStart).count();
+}
+
+bool PhysicsManager::Raycast(glm::vec3 origin, glm::vec3 direction, float maxDistance, RaycastHit& hit, uint32_t layerMask)
+{
+    return SphereCast(origin, 0.0f, direction, maxDistance, hit, layerMask);
+}
+
+bool PhysicsManager::SphereCast(glm::vec3 origin, float radius, glm::vec3 direction, float maxDistance, RaycastHit& hit, uint32_t layerMask)
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+
+    RayQuery query;
+    query.origin = origin;
+    query.direction = direction;
+    query.maxDistance = maxDistance;
+    query.radius = radius;
+    query.layerMask = layerMask;
+    query.maxHits = 1;
+
+    static thread_local std::vector<RaycastHit> hits;
+    CastRay(query, hits);
+
+    if (hits.empty()) {
+        return false;
+    }
+
+    hit = hits[0];
+    return true;
+}
+
+void PhysicsManager::Overlap(const std::vector<OverlapQuery>& queries, std::vector<std::vector<PhysicsHandle>>& results)
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+
+    uint32_t count = static_cast<uint32_t>(queries.size());
+    results.resize(count);
+
+    JobSystem::GetInstance()->ParallelFor(count, [this, &queries, &results](uint32_t i) {
+        TestOverlap(queries[i], results[i]);
+    }, 16);
+}
+
+void PhysicsManager::OverlapSphere(glm::vec3 center, float radius, std::vector<PhysicsHandle>& handles, uint32_t layerMask)
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+
+    OverlapQuery query;
+    query.collider.type = ColliderTypes::SphereCollider;
+    query.collider.radius = radius;
+    query.position = center;
+    query.layerMask = layerMask;
+
+    TestOverlap(query, handles);
+}
+
+bool PhysicsManager::IsProxyQueryable(uint32_t proxy, uint32_t layerMask)
+{
+    PhysicsHandle handle = proxyHandles[proxy];
+
+    return (proxyFilters[proxy].category & layerMask) != 0 &&
+        world->IsCurrent(handle) &&
+        (world->flags[world->GetIndex(handle)] & PhysicsWorld::BodyFlags::Alive);
+}
+
+void PhysicsManager::CastRay(const RayQuery& query, std::vector<RaycastHit>& hits)
+{
+    hits.clear();
+
+    float length = glm::length(query.direction);
+    if (length < 0.000001f || query.maxHits == 0) {
+        return;
+    }
+
+    glm::vec3 direction = query.direction / length;
+
+    float maxDistance = query.maxDistance;
+
+    broadphases[queryBroadphaseType]->QueryRay(proxyBounds, query.origin, direction, query.maxDistance, query.radius, [&](uint32_t proxy) {
+        RaycastHit hit;
+        if (!IsProxyQueryable(proxy, query.layerMask) ||
+            !Narrowphase::Raycast(shapes[proxy], query.origin, direction, query.radius, maxDistance, hit.distance, hit.normal)) {
+            return maxDistance;
         }
 
-        for (size_t j = 0; j < physicsObjects[PhysicsLayers::Trigger].size(); j++) {
-            if (CheckCollision(physicsObjects[PhysicsLayers::Dynamic][i], physicsObjects[PhysicsLayers::Trigger][j])) {
-                //TODO: Call the trigger's on collide function
-            }
+        hit.handle = proxyHandles[proxy];
+
+        //A swept sphere touches the surface one radius behind its center along the normal
+        hit.point = hit.distance > 0.0f ? query.origin + direction * hit.distance - hit.normal * query.radius : query.origin;
+        hits.push_back(hit);
+
+        //Once there are enough hits only closer ones matter, so the ray can stop at the furthest hit being kept
+        if (hits.size() >= query.maxHits) {
+            std::sort(hits.begin(), hits.end());
+            hits.resize(query.maxHits);
+            maxDistance = hits.back().distance;
+        }
+
+        return maxDistance;
+    });
+
+    std::sort(hits.begin(), hits.end());
+}
+
+void PhysicsManager::TestOverlap(const OverlapQuery& query, std::vector<PhysicsHandle>& handles)
+{
+    handles.clear();
+
+    ColliderShape shape = Narrowphase::ComputeShape(query.collider, query.position, query.orientation, query.scale);
+
+    static thread_local std::vector<uint32_t> candidates;
+    broadphases[queryBroadphaseType]->QueryBounds(proxyBounds, Narrowphase::ComputeBounds(shape), candidates);
+
+    for (uint32_t proxy : candidates) {
+        ContactManifold manifold;
+        if (IsProxyQueryable(proxy, query.layerMask) && Narrowphase::Collide(shape, shapes[proxy], manifold)) {
+            handles.push_back(proxyHandles[proxy]);
+        }
+    }
+
+    //The broadphase lists proxies in no particular order, sort them so the same query always gives the same answer
+    std::sort(handles.begin(), handles.end(), [](const PhysicsHandle& a, const PhysicsHandle& b) { return a.index < b.index; });
+}
+
+#pragma endregion
+
+#pragma region Recording
+
+void PhysicsManager::SaveSnapshot(BinaryStream& stream)
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+    WriteSnapshot(stream);
+}
+
+void PhysicsManager::LoadSnapshot(BinaryStream& stream)
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+    ReadSnapshot(stream);
+}
+
+void PhysicsManager::StartRecording()
+{
+    std::lock_guard<std::mutex> lock(world->GetMutex());
+
+    recording = std::make_shared<BinaryStream>();
+    recording->Write(RECORDING_MAGIC);
+    recording->Write(RECORDING_VERSION);
+    WriteSnapshot(*recording);
+
+    world->recording = recording.get();
+}
+
+bool PhysicsManager::GetRecording()
+{
+    return recording != nullptr;
+}
+
+void PhysicsManager::StopRecording(const std::string& filePath)
+{
+    std::shared_ptr<BinaryStream> finished;
+
+    {
+        std::lock_guard<std::mutex> lock(world->GetMutex());
+        std::swap(finished, recording);
+        world->recording = nullptr;
+    }
+
+    if (finished != nullptr) {
+        FileManager::WriteFile(filePath, finished->data);
+    }
+}
+
+ReplayStats PhysicsManager::Replay(const std::string& filePath)
+{
+    SetThreaded(false);
+
+    BinaryStream stream;
+    stream.data = FileManager::ReadFile(filePath);
+
+    if (stream.Read<uint32_t>() != RECORDING_MAGIC || stream.Read<uint32_t>() != RECORDING_VERSION) {
+        throw std::runtime_error("File is not a physics recording from this version!");
+    }
+
+    //Start from an empty world so nothing that existed before the replay can affect it
+    world = std::make_shared<PhysicsWorld>();
+    recording = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(world->GetMutex());
+        ReadSnapshot(stream);
+    }
+
+    ReplayStats stats;
+    while (!stream.AtEnd()) {
+        RecordTypes type = static_cast<RecordTypes>(stream.Read<uint8_t>());
+        if (type != RecordTypes::RecordStep) {
+            ReplayCommand(type, stream);
+            continue;
+        }
+
+        float deltaTime = stream.Read<float>();
+        stats.expectedHash = stream.Read<uint64_t>();
+
+        std::lock_guard<std::mutex> lock(world->GetMutex());
+
+        std::chrono::steady_clock::time_point stepStart = std::chrono::steady_clock::now();
+        Step(deltaTime);
+        float stepTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - stepStart).count();
+
+        stats.totalStepTime += stepTime;
+        stats.maxStepTime = std::max(stats.maxStepTime, stepTime);
+
+        stats.finalHash = world->ComputeHash();
+        if (stats.finalHash != stats.expectedHash && stats.firstDivergentStep == UINT32_MAX) {
+            stats.firstDivergentStep = stats.stepCount;
         }
+        stats.stepCount++;
+
+        //Nothing is listening during a replay, the events recorded with the session already caused whatever changes they led to
+        pendingEvents.clear();
     }
 
-    //Check Static objects against triggers
-    for (size_t i = 0; i < physicsObjects[PhysicsLayers::Static].size(); i++) {
-        for (size_t j = 0; j < physicsObjects[PhysicsLayers::Trigger].size(); j++) {
-            if (CheckCollision(physicsObjects[PhysicsLayers::Static][i], physicsObjects[PhysicsLayers::Trigger][j])) {
-                //TODO: Call the trigger's on collide function
+    stats.bodyCount = world->GetBodyCount();
+    return stats;
+}
+
+void PhysicsManager::WriteSnapshot(BinaryStream& stream)
+{
+    stream.Write(gravity);
+    stream.Write(gravityDirection);
+    stream.Write(solver.GetIterations());
+    stream.Write(static_cast<uint8_t>(solver.GetWarmStarting()));
+    stream.Write(static_cast<uint8_t>(sleepingEnabled));
+    stream.Write(stepCount.load());
+
+    world->SaveSnapshot(stream);
+    solver.SaveImpulses(stream);
+}
+
+void PhysicsManager::ReadSnapshot(BinaryStream& stream)
+{
+    gravity = stream.Read<float>();
+    gravityDirection = stream.Read<glm::vec3>();
+    solver.SetIterations(stream.Read<uint32_t>());
+    solver.SetWarmStarting(stream.Read<uint8_t>() != 0);
+    sleepingEnabled = stream.Read<uint8_t>() != 0;
+    stepCount = stream.Read<uint32_t>();
+
+    world->LoadSnapshot(stream);
+    solver.LoadImpulses(stream);
+
+    //Touching pairs aren't part of a snapshot, keeping the current ones would fire enter and exit events for pairs the snapshot never had
+    touchingPairs.clear();
+    previousTouchingPairs.clear();
+    pendingEvents.clear();
+
+    bodyCount = world->GetBodyCount();
+}
+
+void PhysicsManager::ReplayCommand(RecordTypes type, BinaryStream& stream)
+{
+    //Changes to the manager's settings and the collision matrix don't belong to a body
+    switch (type) {
+    case RecordTypes::RecordSetGravity: {
+        float value = stream.Read<float>();
+        glm::vec3 direction = stream.Read<glm::vec3>();
+        SetGravity(value);
+        SetGravityDirection(direction);
+        return;
+    }
+    case RecordTypes::RecordSetSolverIterations:
+        SetSolverIterations(stream.Read<uint32_t>());
+        return;
+    case RecordTypes::RecordSetSleepingEnabled:
+        SetSleepingEnabled(stream.Read<uint8_t>() != 0);
+        return;
+    case RecordTypes::RecordSetLayersCollide: {
+        uint32_t layer1 = stream.Read<uint32_t>();
+        uint32_t layer2 = stream.Read<uint32_t>();
+        world->SetLayersCollide(layer1, layer2, stream.Read<uint8_t>() != 0);
+        return;
+    }
+    default:
+        break;
+    }
+
+    PhysicsHandle handle = stream.Read<PhysicsHandle>();
+
+    switch (type) {
+    case RecordTypes::RecordCreateBody: {
+        glm::vec3 position = stream.Read<glm::vec3>();
+        glm::quat orientation = stream.Read<glm::quat>();
+        glm::vec3 scale = stream.Read<glm::vec3>();
+        PhysicsLayers layer = stream.Read<PhysicsLayers>();
+        float mass = stream.Read<float>();
+        bool affectedByGravity = stream.Read<uint8_t>() != 0;
+        bool alive = stream.Read<uint8_t>() != 0;
+
+        //Free slots are reused in the same order as when recording, so the body gets the same handle as long as nothing has diverged
+        PhysicsHandle created = world->CreateBody(std::make_shared<Transform>(position, orientation, scale), layer, mass, affectedByGravity, alive);
+        if (!(created == handle)) {
+            throw std::runtime_error("Replayed body was given a different handle than when recorded!");
+        }
+        break;
+    }
+    case RecordTypes::RecordDestroyBody:
+        world->DestroyBody(handle);
+        break;
+    case RecordTypes::RecordSetPosition:
+        world->SetPosition(handle, stream.Read<glm::vec3>());
+        break;
+    case RecordTypes::RecordSetVelocity:
+        world->SetVelocity(handle, stream.Read<glm::vec3>());
+        break;
+    case RecordTypes::RecordSetMass:
+        world->SetMass(handle, stream.Read<float>());
+        break;
+    case RecordTypes::RecordSetAlive:
+        world->SetAlive(handle, stream.Read<uint8_t>() != 0);
+        break;
+    case RecordTypes::RecordSetCollisionLayer:
+        world->SetCollisionLayer(handle, stream.Read<uint32_t>());
+        break;
+    case RecordTypes::RecordSetCollisionFilter:
+        world->SetCollisionFilter(handle, stream.Read<CollisionFilter>());
+        break;
+    case RecordTypes::RecordWake:
+        world->Wake(handle);
+        break;
+    case RecordTypes::RecordSetTransform: {
+        glm::vec3 position = stream.Read<glm::vec3>();
+        glm::quat orientation = stream.Read<glm::quat>();
+        glm::vec3 scale = stream.Read<glm::vec3>();
+        world->SetTransform(handle, std::make_shared<Transform>(position, orientation, scale));
+        break;
+    }
+    case RecordTypes::RecordSetCollider:
+        world->SetCollider(handle, stream.Read<Collider>());
+        break;
+    case RecordTypes::RecordApplyForce: {
+        glm::vec3 force = stream.Read<glm::vec3>();
+        world->ApplyForce(handle, force, stream.Read<uint8_t>() != 0);
+        break;
+    }
+    case RecordTypes::RecordSetOrientation: {
+        //Recorded when the game rotated or scaled a transform, applied the same way SyncTransforms picks it up
+        glm::quat orientation = stream.Read<glm::quat>();
+        glm::vec3 scale = stream.Read<glm::vec3>();
+
+        std::lock_guard<std::mutex> lock(world->GetMutex());
+        uint32_t index = world->GetIndex(handle);
+        world->transforms[index]->SetOrientation(orientation);
+        world->transforms[index]->SetScale(scale);
+        world->orientations[index] = orientation;
+        world->scales[index] = scale;
+        break;
+    }
+    default:
+        throw std::runtime_error("Unknown physics recording entry " + std::to_string(type) + "!");
+    }
+}
+
+#pragma endregion
+
+#pragma region Collision Events
+
+bool PhysicsManager::IsPairActive(uint32_t a, uint32_t b)
+{
+    return world->simulated[a] > 0.0f || world->simulated[b] > 0.0f ||
+        world->layers[a] == PhysicsLayers::Trigger || world->layers[b] == PhysicsLayers::Trigger;
+}
+
+void PhysicsManager::UpdateTouchingPairs()
+{
+    std::swap(touchingPairs, previousTouchingPairs);
+    touchingPairs.clear();
+
+    for (size_t i = 0; i < candidatePairs.size(); i++) {
+        uint32_t a = candidatePairs[i].a;
+        uint32_t b = candidatePairs[i].b;
+
+        //Order the bodies by handle slot so the key stays the same when their dense indices swap around
+        TouchingPair pair;
+        pair.a.index = world->handleSlots[a];
+        pair.a.generation = world->generations[pair.a.index];
+        pair.b.index = world->handleSlots[b];
+        pair.b.generation = world->generations[pair.b.index];
+        if (pair.a.index > pair.b.index) {
+            std::swap(pair.a, pair.b);
+        }
+
+        pair.key = (static_cast<uint64_t>(pair.a.index) << 32) | pair.b.index;
+        pair.trigger = world->layers[a] == PhysicsLayers::Trigger || world->layers[b] == PhysicsLayers::Trigger;
+
+        bool touching = collisionResults[i] != 0;
+
+        //Pairs that were skipped because neither body can move are still touching if they were last step, otherwise sleeping bodies would send exit events
+        if (!touching && !IsPairActive(a, b)) {
+            std::vector<TouchingPair>::iterator previous = std::lower_bound(previousTouchingPairs.begin(), previousTouchingPairs.end(), pair);
+            touching = previous != previousTouchingPairs.end() && previous->key == pair.key && previous->a == pair.a && previous->b == pair.b;
+        }
+
+        if (touching) {
+            touchingPairs.push_back(pair);
+        }
+    }
+
+    std::sort(touchingPairs.begin(), touchingPairs.end());
+
+    //Walk both sorted lists together, pairs only in the new list started touching and pairs only in the old list stopped
+    size_t current = 0;
+    size_t previous = 0;
+    while (current < touchingPairs.size() || previous < previousTouchingPairs.size()) {
+        if (previous == previousTouchingPairs.size() || (current < touchingPairs.size() && touchingPairs[current].key < previousTouchingPairs[previous].key)) {
+            QueueEvents(PhysicsEventTypes::CollisionEnter, touchingPairs[current]);
+            current++;
+        }
+        else if (current == touchingPairs.size() || previousTouchingPairs[previous].key < touchingPairs[current].key) {
+            QueueEvents(PhysicsEventTypes::CollisionExit, previousTouchingPairs[previous]);
+            previous++;
+        }
+        else {
+            //Same slots but a different generation means a body was destroyed and its slot reused by a new one
+            if (touchingPairs[current].a == previousTouchingPairs[previous].a && touchingPairs[current].b == previousTouchingPairs[previous].b) {
+                if (touchingPairs[current].trigger) {
+                    QueueEvents(PhysicsEventTypes::TriggerStay, touchingPairs[current]);
+                }
+            }
+            else {
+                QueueEvents(PhysicsEventTypes::CollisionExit, previousTouchingPairs[previous]);
+                QueueEvents(PhysicsEventTypes::CollisionEnter, touchingPairs[current]);
             }
+
+            current++;
+            previous++;
         }
     }
 }
 
-bool PhysicsManager::CheckCollision(std::shared_ptr<PhysicsObject> physicsObject1, std::shared_ptr<PhysicsObject> physicsObject2)
+void PhysicsManager::QueueEvents(PhysicsEventTypes type, const TouchingPair& pair)
 {
-    // if (!physicsObject1->GetAlive() || !physicsObject2->GetAlive()) return false;
-    //TODO: Change this to use colliders rather than a radius check
-    glm::vec3 direction = physicsObject1->GetTransform()->GetPosition() - physicsObject2->GetTransform()->GetPosition();
-    float distance = direction.x * direction.x + direction.y * direction.y + direction.z * direction.z;
+    if (pair.trigger) {
+        if (type == PhysicsEventTypes::CollisionEnter) {
+            type = PhysicsEventTypes::TriggerEnter;
+        }
+        else if (type == PhysicsEventTypes::CollisionExit) {
+            type = PhysicsEventTypes::TriggerExit;
+        }
+    }
+
+    PhysicsEvent event;
+    event.type = type;
+    event.self = pair.a;
+    event.other = pair.b;
+    pendingEvents.push_back(event);
 
-    return distance < 1.0f;
+    event.self = pair.b;
+    event.other = pair.a;
+    pendingEvents.push_back(event);
+}
+
+void PhysicsManager::DispatchEvents()
+{
+    {
+        std::lock_guard<std::mutex> lock(world->GetMutex());
+        std::swap(pendingEvents, dispatchedEvents);
+    }
+
+    //The mutex is released so callbacks can use physics objects, each callback is looked up again in case an earlier one destroyed its body
+    for (size_t i = 0; i < dispatchedEvents.size(); i++) {
+        std::function<void(const PhysicsEvent&)> callback = world->GetEventCallback(dispatchedEvents[i].self);
+        if (callback) {
+            callback(dispatchedEvents[i]);
+        }
+    }
+
+    dispatchedEvents.clear();
 }
 
 #pragma endregion
 
 #pragma region Collision Resolution
 
-void PhysicsManager::ResolveCollision(std::shared_ptr<PhysicsObject> physicsObject1, std::shared_ptr<PhysicsObject> physicsObject2)
+void PhysicsManager::SolveContacts(float deltaTime)
 {
-    //TODO: Change this to use colliders rather than a radius check
-    //Double Dynamic
-    if (physicsObject1->GetPhysicsLayer() == PhysicsLayers::Dynamic && physicsObject2->GetPhysicsLayer() == PhysicsLayers::Dynamic) {
-        glm::vec3 center = (physicsObject1->GetTransform()->GetPosition() + physicsObject2->GetTransform()->GetPosition()) / 2.0f;
-        glm::vec3 collisionDirection = glm::normalize(physicsObject2->GetTransform()->GetPosition() - physicsObject1->GetTransform()->GetPosition());
+    std::chrono::steady_clock::time_point solverStart = std::chrono::steady_clock::now();
+
+    solver.Prepare(*world, manifolds.data(), collisionResults.data(), static_cast<uint32_t>(candidatePairs.size()), deltaTime);
+    solver.Solve(*world);
+    solver.StoreImpulses();
+
+    solverTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - solverStart).count();
+}
 
-        physicsObject1->GetTransform()->SetPosition(center + collisionDirection * -0.5f);
-        physicsObject2->GetTransform()->SetPosition(center + collisionDirection * 0.5f);
+#pragma endregion
+
+#pragma region Sleeping
+
+uint32_t PhysicsManager::FindIsland(uint32_t index)
+{
+    while (islandParents[index] != index) {
+        //Point every other body at its grandparent so later searches are shorter
+        islandParents[index] = islandParents[islandParents[index]];
+        index = islandParents[index];
     }
-    else { //One Dynamic and One Static
-        //Figure out which object is static and which is dynamic
-        std::shared_ptr<PhysicsObject> staticObject;
-        std::shared_ptr<PhysicsObject> dynamicObject;
 
-        if (physicsObject1->GetPhysicsLayer() == PhysicsLayers::Dynamic) {
-            dynamicObject = physicsObject1;
-            staticObject = physicsObject2;
+    return index;
+}
+
+void PhysicsManager::UpdateSleeping(float deltaTime)
+{
+    uint32_t count = world->GetBodyCount();
+    islandParents.resize(count);
+    islandSleepTimes.resize(count);
+
+    for (uint32_t i = 0; i < count; i++) {
+        islandParents[i] = i;
+        islandSleepTimes[i] = FLT_MAX;
+    }
+
+    //Touching dynamic bodies share an island, static bodies and triggers don't join islands or they would link everything resting on the same floor
+    for (size_t i = 0; i < candidatePairs.size(); i++) {
+        uint32_t a = candidatePairs[i].a;
+        uint32_t b = candidatePairs[i].b;
+
+        if (collisionResults[i] && world->layers[a] == PhysicsLayers::Dynamic && world->layers[b] == PhysicsLayers::Dynamic) {
+            islandParents[FindIsland(a)] = FindIsland(b);
         }
-        else {
-            dynamicObject = physicsObject2;
-            staticObject = physicsObject1;
+    }
+
+    //An island can only sleep once every body in it has been resting long enough, sleeping bodies are always ready
+    for (uint32_t i = 0; i < count; i++) {
+        if (world->layers[i] != PhysicsLayers::Dynamic || !(world->flags[i] & PhysicsWorld::BodyFlags::Alive)) {
+            continue;
+        }
+
+        float sleepTime = SLEEP_TIME;
+        if (!(world->flags[i] & PhysicsWorld::BodyFlags::Asleep)) {
+            glm::vec3 velocity = glm::vec3(world->velocityX[i], world->velocityY[i], world->velocityZ[i]);
+            world->sleepTimers[i] = glm::dot(velocity, velocity) < SLEEP_SPEED * SLEEP_SPEED ? world->sleepTimers[i] + deltaTime : 0.0f;
+            sleepTime = world->sleepTimers[i];
+        }
+
+        uint32_t island = FindIsland(i);
+        islandSleepTimes[island] = std::min(islandSleepTimes[island], sleepTime);
+    }
+
+    //Sleeping bodies touched by an awake body wake up, the bodies they rest on are woken in turn on the following steps
+    uint32_t sleeping = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (world->layers[i] != PhysicsLayers::Dynamic || !(world->flags[i] & PhysicsWorld::BodyFlags::Alive)) {
+            continue;
         }
 
-        //Move dynamic object out of the static object
-        glm::vec3 collisionDirection = glm::normalize(dynamicObject->GetTransform()->GetPosition() - staticObject->GetTransform()->GetPosition());
-        dynamicObject->GetTransform()->SetPosition(staticObject->GetTransform()->GetPosition() + collisionDirection);
+        bool asleep = (world->flags[i] & PhysicsWorld::BodyFlags::Asleep) != 0;
+        bool canSleep = sleepingEnabled && islandSleepTimes[FindIsland(i)] >= SLEEP_TIME;
+
+        if (canSleep && !asleep) {
+            world->SleepBody(i);
+        }
+        else if (!canSleep && asleep) {
+            world->WakeBody(i);
+        }
+
+        if (canSleep) {
+            sleeping++;
+        }
     }
 
-    //TODO: Call both object's on collision methods
+    sleepingBodyCount = sleeping;
 }
 
 #pragma endregion
\ No newline at end of file
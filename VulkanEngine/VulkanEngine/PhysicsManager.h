@@ -2,16 +2,193 @@
 #include "pch.h"
 
 #include "PhysicsObject.h"
+#include "PhysicsWorld.h"
+#include "Broadphase.h"
+#include "BroadphaseTypes.h"
+#include "ColliderShape.h"
+#include "ContactManifold.h"
+#include "ContactSolver.h"
+#include "PhysicsEvent.h"
+#include "RayQuery.h"
+#include "RaycastHit.h"
+#include "OverlapQuery.h"
+#include "BinaryStream.h"
+#include "ReplayStats.h"
+
+#include <atomic>
+#include <thread>
 
 class PhysicsManager
 {
 private:
+	//Two bodies that were touching at the end of a step, keyed by their handle slots so the key survives bodies moving around in the world's arrays
+	struct TouchingPair {
+		uint64_t key;
+		PhysicsHandle a;
+		PhysicsHandle b;
+		bool trigger;
+
+		bool operator<(const TouchingPair& other) const {
+			return key < other.key;
+		}
+	};
+
 	static PhysicsManager* instance;
 
 	float gravity = 9.8f;
 	glm::vec3 gravityDirection = glm::vec3(0.0f, -1.0f, 0.0f);
 
-	std::vector<std::vector<std::shared_ptr<PhysicsObject>>> physicsObjects;
+	//Owns the state of every physics object
+	std::shared_ptr<PhysicsWorld> world;
+
+	//Physics always advances in steps of fixedTimeStep, time that has passed but not been simulated yet builds up in the accumulator
+	std::atomic<float> fixedTimeStep{ 1.0f / 60.0f };
+	std::atomic<uint32_t> maxSubsteps{ 4 };
+	float accumulator = 0.0f;
+
+	//When threaded the physics thread steps the world at its own rate and Update only interpolates the transforms
+	std::atomic<bool> threaded{ false };
+	std::atomic<bool> threadRunning{ false };
+	std::thread physicsThread;
+	std::chrono::steady_clock::time_point lastStepTime;
+
+	//Bodies slower than SLEEP_SPEED for SLEEP_TIME seconds, along with everything they touch, stop being simulated
+	static constexpr float SLEEP_SPEED = 0.1f;
+	static constexpr float SLEEP_TIME = 0.5f;
+	bool sleepingEnabled = true;
+
+	//One instance of each broadphase so they can be switched between at runtime, the GUI picks one while the physics thread may be stepping
+	std::vector<std::shared_ptr<Broadphase>> broadphases;
+	std::atomic<BroadphaseTypes> broadphaseType{ BroadphaseTypes::Grid };
+
+	//Broadphase that was built during the latest step, queries use it even if another one has been picked since
+	BroadphaseTypes queryBroadphaseType = BroadphaseTypes::Grid;
+
+	//World space collider and bounds of every body in the world's order, rebuilt every update
+	std::vector<ColliderShape> shapes;
+	std::vector<AABB> proxyBounds;
+	std::vector<CollisionPair> candidatePairs;
+
+	//Handle and collision filter of every proxy, kept with the shapes so queries can still map proxies to bodies after bodies are added or removed
+	std::vector<PhysicsHandle> proxyHandles;
+	std::vector<CollisionFilter> proxyFilters;
+
+	//One entry per candidate pair, 1 once the bounding spheres overlap and kept only if the exact shape test finds contact, filling in the pair's manifold
+	std::vector<uint8_t> collisionResults;
+	std::vector<ContactManifold> manifolds;
+
+	ContactSolver solver;
+
+	//Union find over the touching bodies of the latest step and the shortest time any body of each island has been resting
+	std::vector<uint32_t> islandParents;
+	std::vector<float> islandSleepTimes;
+
+	//Pairs touching after the latest and the previous step, both sorted by key so they can be compared in one pass
+	std::vector<TouchingPair> touchingPairs;
+	std::vector<TouchingPair> previousTouchingPairs;
+
+	//Events wait in pendingEvents until the game asks for them, then are swapped into dispatchedEvents and sent out
+	std::vector<PhysicsEvent> pendingEvents;
+	std::vector<PhysicsEvent> dispatchedEvents;
+
+	//Stats from the latest step, atomic since the GUI reads them while the physics thread may be stepping
+	std::atomic<uint32_t> bodyCount{ 0 };
+	std::atomic<uint32_t> candidatePairCount{ 0 };
+	std::atomic<uint32_t> contactCount{ 0 };
+	std::atomic<uint32_t> sleepingBodyCount{ 0 };
+	std::atomic<uint32_t> stepCount{ 0 };
+	std::atomic<float> broadphaseTime{ 0.0f };
+	std::atomic<float> integrationTime{ 0.0f };
+	std::atomic<float> narrowphaseTime{ 0.0f };
+	std::atomic<float> solverTime{ 0.0f };
+	std::atomic<uint32_t> raycastCount{ 0 };
+	std::atomic<float> raycastTime{ 0.0f };
+
+	//Every recording starts with these so other files and recordings from older versions are rejected
+	static constexpr uint32_t RECORDING_MAGIC = 0x43455250;
+	static constexpr uint32_t RECORDING_VERSION = 1;
+
+	//Snapshot of the world followed by every change and step since recording started, null when not recording
+	std::shared_ptr<BinaryStream> recording;
+
+	/// <summary>
+	/// Places every body's collider in world space and calculates its bounds
+	/// </summary>
+	void GatherProxies();
+
+	/// <summary>
+	/// Advances the simulation by one fixed step, the caller must hold the world's mutex
+	/// </summary>
+	/// <param name="deltaTime">The length of the step</param>
+	void Step(float deltaTime);
+
+	/// <summary>
+	/// Steps the world at the fixed rate until threading is turned off
+	/// </summary>
+	void PhysicsThreadLoop();
+
+	/// <summary>
+	/// Returns the root of the island a body belongs to
+	/// </summary>
+	/// <param name="index">The dense index of the body</param>
+	/// <returns>The dense index of the island's root body</returns>
+	uint32_t FindIsland(uint32_t index);
+
+	/// <summary>
+	/// Returns whether a pair needs testing this step, pairs where neither body can move keep whatever state they had
+	/// </summary>
+	/// <param name="a">The dense index of the first body</param>
+	/// <param name="b">The dense index of the second body</param>
+	/// <returns>True if either body is awake and dynamic or a trigger</returns>
+	bool IsPairActive(uint32_t a, uint32_t b);
+
+	/// <summary>
+	/// Queues an event for each body of a pair
+	/// </summary>
+	/// <param name="type">The type of event to send, switched to the trigger version if the pair involves a trigger</param>
+	/// <param name="pair">The bodies the event is about</param>
+	void QueueEvents(PhysicsEventTypes type, const TouchingPair& pair);
+
+	/// <summary>
+	/// Returns whether a query can find a proxy, its body must still exist, be alive and be on one of the query's layers
+	/// </summary>
+	/// <param name="proxy">The index of the proxy</param>
+	/// <param name="layerMask">The collision layers the query looks at</param>
+	/// <returns>True if the proxy should be tested</returns>
+	bool IsProxyQueryable(uint32_t proxy, uint32_t layerMask);
+
+	/// <summary>
+	/// Casts a single ray against the proxies, the caller must hold the world's mutex
+	/// </summary>
+	/// <param name="query">The ray to cast</param>
+	/// <param name="hits">Filled with the hits sorted from nearest to furthest</param>
+	void CastRay(const RayQuery& query, std::vector<RaycastHit>& hits);
+
+	/// <summary>
+	/// Tests a single shape against the proxies, the caller must hold the world's mutex
+	/// </summary>
+	/// <param name="query">The shape to test</param>
+	/// <param name="handles">Filled with the handles of the overlapping bodies</param>
+	void TestOverlap(const OverlapQuery& query, std::vector<PhysicsHandle>& handles);
+
+	/// <summary>
+	/// Writes the settings, the world and the solver's carried over impulses to a stream, the caller must hold the world's mutex
+	/// </summary>
+	/// <param name="stream">The stream to write to</param>
+	void WriteSnapshot(BinaryStream& stream);
+
+	/// <summary>
+	/// Reads back everything written by WriteSnapshot, the caller must hold the world's mutex
+	/// </summary>
+	/// <param name="stream">The stream to read from</param>
+	void ReadSnapshot(BinaryStream& stream);
+
+	/// <summary>
+	/// Applies one recorded change that is not a step
+	/// </summary>
+	/// <param name="type">The type of change, already read from the stream</param>
+	/// <param name="stream">The stream the rest of the change is read from</param>
+	void ReplayCommand(RecordTypes type, BinaryStream& stream);
 
 public:
 
@@ -21,6 +198,15 @@ public:
 
 #pragma endregion
 
+#pragma region Memory Management
+
+	/// <summary>
+	/// Stops the physics thread if it is running
+	/// </summary>
+	void Cleanup();
+
+#pragma endregion
+
 #pragma region Accessors
 
 	/// <summary>
@@ -48,47 +234,309 @@ public:
 	void SetGravityDirection(glm::vec3 value);
 
 	/// <summary>
-	/// Adds a physics object to the list of physics objects
+	/// Returns the physics world that stores the state of every physics object
+	/// </summary>
+	/// <returns>The physics world</returns>
+	std::shared_ptr<PhysicsWorld> GetWorld();
+
+	/// <summary>
+	/// Returns the broadphase used to find collision candidates
+	/// </summary>
+	/// <returns>The type of broadphase in use</returns>
+	BroadphaseTypes GetBroadphaseType();
+
+	/// <summary>
+	/// Sets the broadphase used to find collision candidates
+	/// </summary>
+	/// <param name="value">The type of broadphase to use</param>
+	void SetBroadphaseType(BroadphaseTypes value);
+
+	/// <summary>
+	/// Returns the number of candidate pairs the broadphase found during the last update
 	/// </summary>
-	/// <param name="object">The object to add</param>
-	void AddPhysicsObject(std::shared_ptr<PhysicsObject> object);
+	/// <returns>The candidate pair count</returns>
+	uint32_t GetCandidatePairCount();
+
+	/// <summary>
+	/// Returns the number of candidate pairs that were found to be touching during the last update
+	/// </summary>
+	/// <returns>The contact count</returns>
+	uint32_t GetContactCount();
+
+	/// <summary>
+	/// Returns how long the broadphase took during the last update
+	/// </summary>
+	/// <returns>The broadphase time in milliseconds</returns>
+	float GetBroadphaseTime();
+
+	/// <summary>
+	/// Returns how long integrating the physics world took during the last update
+	/// </summary>
+	/// <returns>The integration time in milliseconds</returns>
+	float GetIntegrationTime();
+
+	/// <summary>
+	/// Returns how long checking the candidate pairs took during the last update
+	/// </summary>
+	/// <returns>The narrowphase time in milliseconds</returns>
+	float GetNarrowphaseTime();
+
+	/// <summary>
+	/// Returns how long solving the contacts took during the last update
+	/// </summary>
+	/// <returns>The solver time in milliseconds</returns>
+	float GetSolverTime();
+
+	/// <summary>
+	/// Returns the number of rays cast by the latest batched raycast
+	/// </summary>
+	/// <returns>The raycast count</returns>
+	uint32_t GetRaycastCount();
+
+	/// <summary>
+	/// Returns how long the latest batched raycast took
+	/// </summary>
+	/// <returns>The raycast time in milliseconds</returns>
+	float GetRaycastTime();
+
+	/// <summary>
+	/// Returns the number of times every contact is solved each step
+	/// </summary>
+	/// <returns>The number of solver iterations</returns>
+	uint32_t GetSolverIterations();
+
+	/// <summary>
+	/// Sets the number of times every contact is solved each step
+	/// </summary>
+	/// <param name="value">The number of solver iterations</param>
+	void SetSolverIterations(uint32_t value);
+
+	/// <summary>
+	/// Returns the number of bodies that were asleep after the latest step
+	/// </summary>
+	/// <returns>The sleeping body count</returns>
+	uint32_t GetSleepingBodyCount();
+
+	/// <summary>
+	/// Returns whether resting bodies are put to sleep
+	/// </summary>
+	/// <returns>True if sleeping is enabled</returns>
+	bool GetSleepingEnabled();
+
+	/// <summary>
+	/// Sets whether resting bodies are put to sleep, turning it off wakes every body on the next step
+	/// </summary>
+	/// <param name="value">Whether to let bodies sleep</param>
+	void SetSleepingEnabled(bool value);
+
+	/// <summary>
+	/// Returns the number of bodies in the physics world as of the latest step
+	/// </summary>
+	/// <returns>The body count</returns>
+	uint32_t GetBodyCount();
+
+	/// <summary>
+	/// Returns the number of fixed steps taken since the application started
+	/// </summary>
+	/// <returns>The step count</returns>
+	uint32_t GetStepCount();
+
+	/// <summary>
+	/// Returns the length of each physics step
+	/// </summary>
+	/// <returns>The fixed time step in seconds</returns>
+	float GetFixedTimeStep();
+
+	/// <summary>
+	/// Sets the length of each physics step
+	/// </summary>
+	/// <param name="value">The fixed time step in seconds</param>
+	void SetFixedTimeStep(float value);
+
+	/// <summary>
+	/// Returns the most steps that will be taken in one update before the remaining time is dropped
+	/// </summary>
+	/// <returns>The maximum number of substeps</returns>
+	uint32_t GetMaxSubsteps();
+
+	/// <summary>
+	/// Sets the most steps that will be taken in one update before the remaining time is dropped
+	/// </summary>
+	/// <param name="value">The maximum number of substeps</param>
+	void SetMaxSubsteps(uint32_t value);
+
+	/// <summary>
+	/// Returns whether physics is being stepped on its own thread
+	/// </summary>
+	/// <returns>True if the physics thread is running</returns>
+	bool GetThreaded();
+
+	/// <summary>
+	/// Starts or stops stepping physics on its own thread, decoupled from the frame rate
+	/// </summary>
+	/// <param name="value">Whether to run physics on its own thread</param>
+	void SetThreaded(bool value);
 
 #pragma endregion
 
 #pragma region Update
 
 	/// <summary>
-	/// Updates dynamic physics objects and checks for collisions
+	/// Runs as many fixed steps as the elapsed time allows, then places the transforms between the last two steps
 	/// </summary>
 	void Update();
 
+	/// <summary>
+	/// Runs fixed steps regardless of the elapsed time and places the transforms at the latest step,
+	/// so headless runs take the same steps every time. The physics thread must not be running
+	/// </summary>
+	/// <param name="count">The number of steps to run</param>
+	void StepFixed(uint32_t count);
+
 #pragma endregion
 
 #pragma region Collision Detection
 
 	/// <summary>
-	/// Detects collisions between all of the physics objects
+	/// Finds candidate pairs with the broadphase then checks them for collisions
 	/// </summary>
 	void DetectCollisions();
 
 	/// <summary>
-	/// Checks for a collision between two physics objects
+	/// Checks every candidate pair's colliders for a collision, storing the results in collisionResults and the contacts in manifolds
 	/// </summary>
-	/// <param name="physicsObject1">The first object to check</param>
-	/// <param name="physicsObject2">The second object to check</param>
-	/// <returns>True if the objects are colliding</returns>
-	bool CheckCollision(std::shared_ptr<PhysicsObject> physicsObject1, std::shared_ptr<PhysicsObject> physicsObject2);
+	void CheckCollisions();
+
+#pragma endregion
+
+#pragma region Queries
+
+	//Queries look through the proxies gathered for the latest step, so they see bodies where they were when that step started.
+	//Bodies created since then are not found until the next step and bodies destroyed since then are skipped
+
+	/// <summary>
+	/// Casts a batch of rays or swept spheres in parallel, fast enough for thousands of line of sight checks per frame
+	/// </summary>
+	/// <param name="queries">The rays to cast</param>
+	/// <param name="results">Resized to one list per ray, each filled with that ray's hits sorted from nearest to furthest.
+	/// Reusing the same results every frame avoids allocating</param>
+	void Raycast(const std::vector<RayQuery>& queries, std::vector<std::vector<RaycastHit>>& results);
+
+	/// <summary>
+	/// Casts a single ray and finds the closest body it hits
+	/// </summary>
+	/// <param name="origin">The start of the ray</param>
+	/// <param name="direction">The direction of the ray</param>
+	/// <param name="maxDistance">How far the ray reaches</param>
+	/// <param name="hit">Set to the closest hit</param>
+	/// <param name="layerMask">Bits of the collision layers the ray can hit</param>
+	/// <returns>True if the ray hit anything</returns>
+	bool Raycast(glm::vec3 origin, glm::vec3 direction, float maxDistance, RaycastHit& hit, uint32_t layerMask = UINT32_MAX);
+
+	/// <summary>
+	/// Sweeps a sphere along a ray and finds the first body it touches
+	/// </summary>
+	/// <param name="origin">The center of the sphere at the start</param>
+	/// <param name="radius">The radius of the sphere</param>
+	/// <param name="direction">The direction to sweep in</param>
+	/// <param name="maxDistance">How far to sweep</param>
+	/// <param name="hit">Set to the closest hit</param>
+	/// <param name="layerMask">Bits of the collision layers the sphere can hit</param>
+	/// <returns>True if the sphere hit anything</returns>
+	bool SphereCast(glm::vec3 origin, float radius, glm::vec3 direction, float maxDistance, RaycastHit& hit, uint32_t layerMask = UINT32_MAX);
+
+	/// <summary>
+	/// Finds the bodies overlapping each of a batch of shapes in parallel
+	/// </summary>
+	/// <param name="queries">The shapes to test</param>
+	/// <param name="results">Resized to one list per shape, each filled with the handles of the bodies overlapping it</param>
+	void Overlap(const std::vector<OverlapQuery>& queries, std::vector<std::vector<PhysicsHandle>>& results);
+
+	/// <summary>
+	/// Finds the bodies overlapping a sphere
+	/// </summary>
+	/// <param name="center">The center of the sphere</param>
+	/// <param name="radius">The radius of the sphere</param>
+	/// <param name="handles">Filled with the handles of the overlapping bodies</param>
+	/// <param name="layerMask">Bits of the collision layers to look at</param>
+	void OverlapSphere(glm::vec3 center, float radius, std::vector<PhysicsHandle>& handles, uint32_t layerMask = UINT32_MAX);
+
+#pragma endregion
+
+#pragma region Recording
+
+	/// <summary>
+	/// Writes a compact copy of the whole simulation state that LoadSnapshot can later return to
+	/// </summary>
+	/// <param name="stream">The stream to write to</param>
+	void SaveSnapshot(BinaryStream& stream);
+
+	/// <summary>
+	/// Returns the simulation to a snapshot. Bodies that still exist keep their transforms and event callbacks,
+	/// and touching pairs and undispatched events are dropped so no events fire for pairs from before the snapshot
+	/// </summary>
+	/// <param name="stream">The stream to read from</param>
+	void LoadSnapshot(BinaryStream& stream);
+
+	/// <summary>
+	/// Takes a snapshot and starts recording every change made through the physics world and every step taken, so the session can be replayed exactly
+	/// </summary>
+	void StartRecording();
+
+	/// <summary>
+	/// Returns whether a recording is in progress
+	/// </summary>
+	/// <returns>True if recording</returns>
+	bool GetRecording();
+
+	/// <summary>
+	/// Stops recording and saves the recording to a file
+	/// </summary>
+	/// <param name="filePath">The file to save to</param>
+	void StopRecording(const std::string& filePath);
+
+	/// <summary>
+	/// Replays a recording without a window or GPU, comparing every step with the hash it was recorded with.
+	/// Replaces the physics world and stops the physics thread, so only meant for headless runs
+	/// </summary>
+	/// <param name="filePath">The recording to replay</param>
+	/// <returns>How long the steps took and whether the replay matched the recording</returns>
+	ReplayStats Replay(const std::string& filePath);
+
+#pragma endregion
+
+#pragma region Collision Events
+
+	/// <summary>
+	/// Records which pairs are touching after this step and compares them with the previous step to queue enter, stay and exit events
+	/// </summary>
+	void UpdateTouchingPairs();
+
+	/// <summary>
+	/// Sends every event queued since the last call to the event callbacks of the bodies involved.
+	/// Call this from the main thread without holding the world's mutex, callbacks are free to use physics objects
+	/// </summary>
+	void DispatchEvents();
 
 #pragma endregion
 
 #pragma region Collision Resolution
 
 	/// <summary>
-	/// Resolves a collision between two physics objects
+	/// Applies impulses to every pair of colliding bodies so they stop moving into each other, called between integrating velocities and positions
+	/// </summary>
+	/// <param name="deltaTime">The length of the step</param>
+	void SolveContacts(float deltaTime);
+
+#pragma endregion
+
+#pragma region Sleeping
+
+	/// <summary>
+	/// Groups touching bodies into islands, puts islands that have rested long enough to sleep and wakes sleeping bodies that something moving touched
 	/// </summary>
-	/// <param name="physicsObject1">The first object in the collision</param>
-	/// <param name="physicsObject2">The second object in the collision</param>
-	void ResolveCollision(std::shared_ptr<PhysicsObject> physicsObject1, std::shared_ptr<PhysicsObject> physicsObject2);
+	/// <param name="deltaTime">The length of the step</param>
+	void UpdateSleeping(float deltaTime);
 
 #pragma endregion
 };
\ No newline at end of file
@@ -1,133 +1,141 @@
 #include "pch.h"
 #include "PhysicsObject.h"
 
-#include "DebugManager.h"
 #include "PhysicsManager.h"
 
-#define DebugInstance DebugManager::GetInstance()
-
 #pragma region Constructor
 
-PhysicsObject::PhysicsObject(std::shared_ptr<Transform> transform, PhysicsLayers physicsLayer, float mass, bool affectedByGravity, bool alive)
+PhysicsObject::PhysicsObject(const std::shared_ptr<Transform>& transform, PhysicsLayers physicsLayer, float mass, bool affectedByGravity, bool alive)
 {
-	this->transform = transform;
-	this->mass = mass;
-	this->affectedByGravity = affectedByGravity;
-	this->physicsLayer = physicsLayer;
-	this->alive = alive;
+	world = PhysicsManager::GetInstance()->GetWorld();
+	handle = world->CreateBody(transform, physicsLayer, mass, affectedByGravity, alive);
+}
 
-	velocity = glm::vec3(0.0f, 0.0f, 0.0f);
-	acceleration = glm::vec3(0.0f, 0.0f, 0.0f);
+PhysicsObject::~PhysicsObject()
+{
+	world->DestroyBody(handle);
 }
 
 #pragma endregion
 
 #pragma region Accessors
 
+PhysicsHandle PhysicsObject::GetHandle()
+{
+	return handle;
+}
+
+glm::vec3 PhysicsObject::GetPosition()
+{
+	return world->GetPosition(handle);
+}
+
+void PhysicsObject::SetPosition(glm::vec3 value)
+{
+	world->SetPosition(handle, value);
+}
+
 float PhysicsObject::GetMass()
 {
-	return mass;
+	return world->GetMass(handle);
 }
 
 void PhysicsObject::SetMass(float value)
 {
-	mass = value;
+	world->SetMass(handle, value);
 }
 
 glm::vec3 PhysicsObject::GetAcceleration()
 {
-	return acceleration;
+	return world->GetAcceleration(handle);
 }
 
 glm::vec3 PhysicsObject::GetVelocity()
 {
-	return velocity;
+	return world->GetVelocity(handle);
 }
 
 void PhysicsObject::SetVelocity(glm::vec3 value)
 {
-	velocity = value;
+	world->SetVelocity(handle, value);
 }
 
 PhysicsLayers PhysicsObject::GetPhysicsLayer()
 {
-	return physicsLayer;
+	return world->GetLayer(handle);
+}
+
+uint32_t PhysicsObject::GetCollisionLayer()
+{
+	return world->GetCollisionLayer(handle);
+}
+
+void PhysicsObject::SetCollisionLayer(uint32_t value)
+{
+	world->SetCollisionLayer(handle, value);
+}
+
+CollisionFilter PhysicsObject::GetCollisionFilter()
+{
+	return world->GetCollisionFilter(handle);
+}
+
+void PhysicsObject::SetCollisionFilter(CollisionFilter value)
+{
+	world->SetCollisionFilter(handle, value);
 }
 
 std::shared_ptr<Transform> PhysicsObject::GetTransform()
 {
-	return transform;
+	return world->GetTransform(handle);
 }
 
-void PhysicsObject::SetTransform(std::shared_ptr<Transform> value)
+void PhysicsObject::SetTransform(const std::shared_ptr<Transform>& value)
 {
-	transform = value;
+	world->SetTransform(handle, value);
 }
 
 bool PhysicsObject::GetAlive()
 {
-	return alive;
+	return world->GetAlive(handle);
 }
 
 void PhysicsObject::SetAlive(bool value)
 {
-	alive = value;
+	world->SetAlive(handle, value);
 }
 
-#pragma endregion
-
-#pragma Physics
-
-void PhysicsObject::ApplyForce(glm::vec3 force, bool applyMass)
+Collider PhysicsObject::GetCollider()
 {
-	if (applyMass) {
-		force /= mass;
-	}
+	return world->GetCollider(handle);
+}
 
-	acceleration += force;
+void PhysicsObject::SetCollider(Collider value)
+{
+	world->SetCollider(handle, value);
 }
 
 #pragma endregion
 
-#pragma region Update
+#pragma region Physics
 
-void PhysicsObject::Update()
+void PhysicsObject::ApplyForce(glm::vec3 force, bool applyMass)
 {
-	if (alive) {
-		if (affectedByGravity) {
-			ApplyForce(PhysicsManager::GetInstance()->GetGravity() * PhysicsManager::GetInstance()->GetGravityDirection());
-		}
-
-		//Apply acceleration
-		velocity += acceleration * Time::GetDeltaTime();
-		acceleration = glm::vec3(0.0f, 0.0f, 0.0f);
+	world->ApplyForce(handle, force, applyMass);
+}
 
-		//Apply velocity
-		transform->Translate(velocity * Time::GetDeltaTime());
+void PhysicsObject::SetEventCallback(std::function<void(const PhysicsEvent&)> value)
+{
+	world->SetEventCallback(handle, value);
+}
 
-		//TODO: remove this once actual collisions are working
-		glm::vec3 position = transform->GetPosition();
-		if (position.y <= 0.5f) {
-			velocity = glm::vec3(velocity.x, velocity.y * -0.8f, velocity.z);
-			transform->SetPosition(glm::vec3(position.x, 0.5f, position.z));
-		}
-	}
+#pragma endregion
 
-	if (DebugInstance->GetDrawHandles()) {
-		DrawHandles();
-	}
-}
+#pragma region Update
 
 void PhysicsObject::DrawHandles()
 {
-	//Draw velocity
-	DebugInstance->DrawLine(transform->GetPosition(), transform->GetPosition() + velocity, glm::vec3(1.0f, 1.0f, 0.0f), 0.0f);
-	//Draw acceleration
-	DebugInstance->DrawLine(transform->GetPosition() + velocity, transform->GetPosition() + velocity + acceleration, glm::vec3(1.0f, 0.0f, 0.0f), 0.0f);
-
-	//TODO: Draw collider when this is merged with Physics Branch
-
-	transform->DrawHandles();
+	world->DrawHandles(handle);
 }
 
-#pragma endregion
\ No newline at end of file
+#pragma endregion
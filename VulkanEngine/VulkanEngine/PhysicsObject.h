@@ -2,29 +2,52 @@
 #include "pch.h"
 
 #include "Transform.h"
+#include "PhysicsWorld.h"
+#include "PhysicsHandle.h"
 
 class PhysicsObject
 {
 private:
-	std::shared_ptr<Transform> transform;
+	//The object's state lives in the physics world, this is only a handle to it
+	std::shared_ptr<PhysicsWorld> world;
+	PhysicsHandle handle;
 
-	float mass;
-	glm::vec3 velocity;
-	glm::vec3 acceleration;
-
-	bool affectedByGravity;
-	bool alive;
-	PhysicsLayers physicsLayer;
 public:
 
 #pragma region Constructor
 
-	PhysicsObject(std::shared_ptr<Transform> transform, PhysicsLayers physicsLayer = PhysicsLayers::Dynamic, float mass = 1.0f, bool affectedByGravity = true, bool alive = false);
+	PhysicsObject(const std::shared_ptr<Transform>& transform, PhysicsLayers physicsLayer = PhysicsLayers::Dynamic, float mass = 1.0f, bool affectedByGravity = true, bool alive = false);
+
+	PhysicsObject(const PhysicsObject&) = delete;
+	PhysicsObject& operator=(const PhysicsObject&) = delete;
+
+	/// <summary>
+	/// Removes the object's body from the physics world
+	/// </summary>
+	~PhysicsObject();
 
 #pragma endregion
 
 #pragma region Accessors
 
+	/// <summary>
+	/// Returns the handle of the object's body in the physics world
+	/// </summary>
+	/// <returns>The object's physics handle</returns>
+	PhysicsHandle GetHandle();
+
+	/// <summary>
+	/// Returns the position of the object, the physics world owns it and copies it to the transform after every update
+	/// </summary>
+	/// <returns>The object's position</returns>
+	glm::vec3 GetPosition();
+
+	/// <summary>
+	/// Moves the object and its transform to the specified position
+	/// </summary>
+	/// <param name="value">The position to move to</param>
+	void SetPosition(glm::vec3 value);
+
 	/// <summary>
 	/// Returns the mass of the object
 	/// </summary>
@@ -61,6 +84,30 @@ public:
 	/// <returns>The object's physics layer</returns>
 	PhysicsLayers GetPhysicsLayer();
 
+	/// <summary>
+	/// Returns the collision layer the object is filtered by, defaults to its physics layer
+	/// </summary>
+	/// <returns>The object's collision layer</returns>
+	uint32_t GetCollisionLayer();
+
+	/// <summary>
+	/// Moves the object to a collision layer, which objects it collides with is set by the world's collision matrix
+	/// </summary>
+	/// <param name="value">The collision layer to move to</param>
+	void SetCollisionLayer(uint32_t value);
+
+	/// <summary>
+	/// Returns the category and mask bits the object's collisions are filtered by
+	/// </summary>
+	/// <returns>The object's collision filter</returns>
+	CollisionFilter GetCollisionFilter();
+
+	/// <summary>
+	/// Overrides the category and mask bits of the object until its collision layer or the collision matrix changes
+	/// </summary>
+	/// <param name="value">The filter to use</param>
+	void SetCollisionFilter(CollisionFilter value);
+
 	/// <summary>
 	/// Returns the transform used by this physics object
 	/// </summary>
@@ -71,7 +118,7 @@ public:
 	/// Sets the object's transform to the specified value
 	/// </summary>
 	/// <param name="value">The transform to set to</param>
-	void SetTransform(std::shared_ptr<Transform> value);
+	void SetTransform(const std::shared_ptr<Transform>& value);
 
 	/// <summary>
 	/// Returns whether or not the object is alive (currently part of the physics system)
@@ -85,6 +132,18 @@ public:
 	/// <param name="value">The value to set to</param>
 	void SetAlive(bool value);
 
+	/// <summary>
+	/// Returns the collider used by this physics object
+	/// </summary>
+	/// <returns>The object's collider</returns>
+	Collider GetCollider();
+
+	/// <summary>
+	/// Sets the collider used by this physics object
+	/// </summary>
+	/// <param name="value">The collider to use</param>
+	void SetCollider(Collider value);
+
 #pragma endregion
 
 #pragma region Physics
@@ -96,15 +155,16 @@ public:
 	/// <param namme="applyMass">Whether or not the force is affected by the mass of the object</param>
 	void ApplyForce(glm::vec3 force, bool applyMass = true);
 
+	/// <summary>
+	/// Sets the function this object's trigger and collision events are sent to, they are delivered in a batch after physics has updated
+	/// </summary>
+	/// <param name="value">The function to call, or an empty function to stop receiving events</param>
+	void SetEventCallback(std::function<void(const PhysicsEvent&)> value);
+
 #pragma endregion
 
 #pragma region Update
 
-	/// <summary>
-	/// Updates the velocity and position of the object
-	/// </summary>
-	void Update();
-
 	/// <summary>
 	/// Draws the physics object's handles
 	/// </summary>
@@ -0,0 +1,838 @@
+#include "pch.h"
+#include "PhysicsWorld.h"
+
+#include "DebugManager.h"
+#include "JobSystem.h"
+#include "Narrowphase.h"
+#include "PhysicsKernels.h"
+
+//Number of bodies a job integrates at a time, large enough that each job spends most of its time in the SIMD loop
+static const uint32_t INTEGRATION_CHUNK_SIZE = 4096;
+
+#pragma region Constructor
+
+PhysicsWorld::PhysicsWorld()
+{
+	for (uint32_t i = 0; i < MAX_COLLISION_LAYERS; i++) {
+		collisionMatrix[i] = UINT32_MAX;
+	}
+
+	//Static bodies and triggers never move on their own so they only need testing against each other and dynamic bodies
+	collisionMatrix[PhysicsLayers::Static] &= ~(1u << PhysicsLayers::Static);
+	collisionMatrix[PhysicsLayers::Trigger] &= ~(1u << PhysicsLayers::Trigger);
+}
+
+#pragma endregion
+
+#pragma region Collision Layers
+
+bool PhysicsWorld::GetLayersCollide(uint32_t layer1, uint32_t layer2)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	CheckCollisionLayer(layer1);
+	CheckCollisionLayer(layer2);
+
+	return (collisionMatrix[layer1] & (1u << layer2)) != 0;
+}
+
+void PhysicsWorld::SetLayersCollide(uint32_t layer1, uint32_t layer2, bool value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	CheckCollisionLayer(layer1);
+	CheckCollisionLayer(layer2);
+
+	if (recording != nullptr) {
+		recording->Write(static_cast<uint8_t>(RecordTypes::RecordSetLayersCollide));
+		recording->Write(layer1);
+		recording->Write(layer2);
+		recording->Write(static_cast<uint8_t>(value));
+	}
+
+	if (value) {
+		collisionMatrix[layer1] |= 1u << layer2;
+		collisionMatrix[layer2] |= 1u << layer1;
+	}
+	else {
+		collisionMatrix[layer1] &= ~(1u << layer2);
+		collisionMatrix[layer2] &= ~(1u << layer1);
+	}
+
+	for (uint32_t i = 0; i < GetBodyCount(); i++) {
+		RefreshFilter(i);
+	}
+}
+
+void PhysicsWorld::CheckCollisionLayer(uint32_t layer)
+{
+	if (layer >= MAX_COLLISION_LAYERS) {
+		throw std::runtime_error("Collision layer " + std::to_string(layer) + " is out of range!");
+	}
+}
+
+#pragma endregion
+
+#pragma region Body Management
+
+PhysicsHandle PhysicsWorld::CreateBody(const std::shared_ptr<Transform>& transform, PhysicsLayers layer, float mass, bool affectedByGravity, bool alive)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	uint32_t index = static_cast<uint32_t>(transforms.size());
+
+	glm::vec3 position = transform->GetPosition();
+	positionX.push_back(position.x);
+	positionY.push_back(position.y);
+	positionZ.push_back(position.z);
+	previousPositionX.push_back(position.x);
+	previousPositionY.push_back(position.y);
+	previousPositionZ.push_back(position.z);
+	velocityX.push_back(0.0f);
+	velocityY.push_back(0.0f);
+	velocityZ.push_back(0.0f);
+	accelerationX.push_back(0.0f);
+	accelerationY.push_back(0.0f);
+	accelerationZ.push_back(0.0f);
+	this->mass.push_back(mass);
+	flags.push_back((alive ? BodyFlags::Alive : 0) | (affectedByGravity ? BodyFlags::AffectedByGravity : 0));
+	layers.push_back(layer);
+	transforms.push_back(transform);
+	collisionLayers.push_back(static_cast<uint8_t>(layer));
+	filters.push_back(CollisionFilter());
+	RefreshFilter(index);
+	colliders.push_back(Collider());
+	orientations.push_back(transform->GetOrientation());
+	scales.push_back(transform->GetScale());
+	sleepTimers.push_back(0.0f);
+	boundingRadius.push_back(0.0f);
+	simulated.push_back(0.0f);
+	gravityScale.push_back(0.0f);
+	RefreshBody(index);
+
+	//Reuse a freed handle slot if there is one
+	PhysicsHandle handle;
+	if (freeSlots.size() > 0) {
+		handle.index = freeSlots.back();
+		freeSlots.pop_back();
+		denseIndices[handle.index] = index;
+	}
+	else {
+		handle.index = static_cast<uint32_t>(denseIndices.size());
+		denseIndices.push_back(index);
+		generations.push_back(0);
+		eventCallbacks.push_back(nullptr);
+	}
+
+	handle.generation = generations[handle.index];
+	handleSlots.push_back(handle.index);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordCreateBody, handle);
+		recording->Write(position);
+		recording->Write(orientations[index]);
+		recording->Write(scales[index]);
+		recording->Write(layer);
+		recording->Write(mass);
+		recording->Write(static_cast<uint8_t>(affectedByGravity));
+		recording->Write(static_cast<uint8_t>(alive));
+	}
+
+	return handle;
+}
+
+void PhysicsWorld::DestroyBody(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!IsCurrent(handle)) {
+		return;
+	}
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordDestroyBody, handle);
+	}
+
+	uint32_t index = denseIndices[handle.index];
+	uint32_t last = static_cast<uint32_t>(transforms.size()) - 1;
+
+	//Move the last body into the removed body's place and point its handle at the new index
+	if (index != last) {
+		positionX[index] = positionX[last];
+		positionY[index] = positionY[last];
+		positionZ[index] = positionZ[last];
+		previousPositionX[index] = previousPositionX[last];
+		previousPositionY[index] = previousPositionY[last];
+		previousPositionZ[index] = previousPositionZ[last];
+		velocityX[index] = velocityX[last];
+		velocityY[index] = velocityY[last];
+		velocityZ[index] = velocityZ[last];
+		accelerationX[index] = accelerationX[last];
+		accelerationY[index] = accelerationY[last];
+		accelerationZ[index] = accelerationZ[last];
+		mass[index] = mass[last];
+		flags[index] = flags[last];
+		layers[index] = layers[last];
+		transforms[index] = transforms[last];
+		collisionLayers[index] = collisionLayers[last];
+		filters[index] = filters[last];
+		colliders[index] = colliders[last];
+		orientations[index] = orientations[last];
+		scales[index] = scales[last];
+		sleepTimers[index] = sleepTimers[last];
+		boundingRadius[index] = boundingRadius[last];
+		simulated[index] = simulated[last];
+		gravityScale[index] = gravityScale[last];
+		handleSlots[index] = handleSlots[last];
+		denseIndices[handleSlots[index]] = index;
+	}
+
+	positionX.pop_back();
+	positionY.pop_back();
+	positionZ.pop_back();
+	previousPositionX.pop_back();
+	previousPositionY.pop_back();
+	previousPositionZ.pop_back();
+	velocityX.pop_back();
+	velocityY.pop_back();
+	velocityZ.pop_back();
+	accelerationX.pop_back();
+	accelerationY.pop_back();
+	accelerationZ.pop_back();
+	mass.pop_back();
+	flags.pop_back();
+	layers.pop_back();
+	transforms.pop_back();
+	collisionLayers.pop_back();
+	filters.pop_back();
+	colliders.pop_back();
+	orientations.pop_back();
+	scales.pop_back();
+	sleepTimers.pop_back();
+	boundingRadius.pop_back();
+	simulated.pop_back();
+	gravityScale.pop_back();
+	handleSlots.pop_back();
+
+	//Invalidate any remaining copies of the handle before the slot is reused
+	eventCallbacks[handle.index] = nullptr;
+	generations[handle.index]++;
+	freeSlots.push_back(handle.index);
+}
+
+bool PhysicsWorld::IsValid(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return IsCurrent(handle);
+}
+
+bool PhysicsWorld::IsCurrent(PhysicsHandle handle)
+{
+	//A free slot can still hold a matching generation after a snapshot is loaded, so the slot must also be in use
+	return handle.index < generations.size() && generations[handle.index] == handle.generation &&
+		denseIndices[handle.index] < handleSlots.size() && handleSlots[denseIndices[handle.index]] == handle.index;
+}
+
+uint32_t PhysicsWorld::GetIndex(PhysicsHandle handle)
+{
+	//A destroyed body's slot may already point at another body, so a kept handle must not be followed
+	if (!IsCurrent(handle)) {
+		throw std::runtime_error("Physics handle does not refer to a live body, it was destroyed or never created!");
+	}
+
+	return denseIndices[handle.index];
+}
+
+uint32_t PhysicsWorld::GetBodyCount()
+{
+	return static_cast<uint32_t>(transforms.size());
+}
+
+std::mutex& PhysicsWorld::GetMutex()
+{
+	return mutex;
+}
+
+BodyArrays PhysicsWorld::GetBodyArrays()
+{
+	BodyArrays bodies;
+	bodies.positionX = positionX.data();
+	bodies.positionY = positionY.data();
+	bodies.positionZ = positionZ.data();
+	bodies.velocityX = velocityX.data();
+	bodies.velocityY = velocityY.data();
+	bodies.velocityZ = velocityZ.data();
+	bodies.accelerationX = accelerationX.data();
+	bodies.accelerationY = accelerationY.data();
+	bodies.accelerationZ = accelerationZ.data();
+	bodies.simulated = simulated.data();
+	bodies.gravityScale = gravityScale.data();
+	bodies.boundingRadius = boundingRadius.data();
+
+	return bodies;
+}
+
+void PhysicsWorld::RefreshBody(uint32_t index)
+{
+	//Only awake dynamic bodies are integrated, static bodies and triggers stay where they are placed
+	bool isSimulated = (flags[index] & BodyFlags::Alive) && !(flags[index] & BodyFlags::Asleep) && layers[index] == PhysicsLayers::Dynamic;
+	simulated[index] = isSimulated ? 1.0f : 0.0f;
+	gravityScale[index] = (isSimulated && (flags[index] & BodyFlags::AffectedByGravity)) ? 1.0f / mass[index] : 0.0f;
+}
+
+void PhysicsWorld::RefreshFilter(uint32_t index)
+{
+	filters[index].category = 1u << collisionLayers[index];
+	filters[index].mask = collisionMatrix[collisionLayers[index]];
+}
+
+void PhysicsWorld::Record(RecordTypes type, PhysicsHandle handle)
+{
+	recording->Write(static_cast<uint8_t>(type));
+	recording->Write(handle);
+}
+
+void PhysicsWorld::SleepBody(uint32_t index)
+{
+	flags[index] |= BodyFlags::Asleep;
+	flags[index] &= ~BodyFlags::TransformSynced;
+
+	velocityX[index] = 0.0f;
+	velocityY[index] = 0.0f;
+	velocityZ[index] = 0.0f;
+
+	//Interpolation lands exactly on the resting position so the transform can be left alone after the next sync
+	previousPositionX[index] = positionX[index];
+	previousPositionY[index] = positionY[index];
+	previousPositionZ[index] = positionZ[index];
+
+	RefreshBody(index);
+}
+
+void PhysicsWorld::WakeBody(uint32_t index)
+{
+	sleepTimers[index] = 0.0f;
+
+	if (flags[index] & BodyFlags::Asleep) {
+		flags[index] &= ~(BodyFlags::Asleep | BodyFlags::TransformSynced);
+		RefreshBody(index);
+	}
+}
+
+#pragma endregion
+
+#pragma region Body Accessors
+
+glm::vec3 PhysicsWorld::GetPosition(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	uint32_t index = GetIndex(handle);
+	return glm::vec3(positionX[index], positionY[index], positionZ[index]);
+}
+
+void PhysicsWorld::SetPosition(PhysicsHandle handle, glm::vec3 value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordSetPosition, handle);
+		recording->Write(value);
+	}
+
+	uint32_t index = GetIndex(handle);
+	positionX[index] = value.x;
+	positionY[index] = value.y;
+	positionZ[index] = value.z;
+	transforms[index]->SetPosition(value);
+	WakeBody(index);
+
+	//Moving a body directly should not be smoothed over
+	previousPositionX[index] = value.x;
+	previousPositionY[index] = value.y;
+	previousPositionZ[index] = value.z;
+}
+
+glm::vec3 PhysicsWorld::GetVelocity(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	uint32_t index = GetIndex(handle);
+	return glm::vec3(velocityX[index], velocityY[index], velocityZ[index]);
+}
+
+void PhysicsWorld::SetVelocity(PhysicsHandle handle, glm::vec3 value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordSetVelocity, handle);
+		recording->Write(value);
+	}
+
+	uint32_t index = GetIndex(handle);
+	velocityX[index] = value.x;
+	velocityY[index] = value.y;
+	velocityZ[index] = value.z;
+	WakeBody(index);
+}
+
+glm::vec3 PhysicsWorld::GetAcceleration(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	uint32_t index = GetIndex(handle);
+	return glm::vec3(accelerationX[index], accelerationY[index], accelerationZ[index]);
+}
+
+float PhysicsWorld::GetMass(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return mass[GetIndex(handle)];
+}
+
+void PhysicsWorld::SetMass(PhysicsHandle handle, float value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordSetMass, handle);
+		recording->Write(value);
+	}
+
+	uint32_t index = GetIndex(handle);
+	mass[index] = value;
+	WakeBody(index);
+	RefreshBody(index);
+}
+
+PhysicsLayers PhysicsWorld::GetLayer(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return layers[GetIndex(handle)];
+}
+
+bool PhysicsWorld::GetAlive(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return (flags[GetIndex(handle)] & BodyFlags::Alive) != 0;
+}
+
+void PhysicsWorld::GetAlive(const PhysicsHandle* handles, uint32_t count, uint8_t* output)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (uint32_t i = 0; i < count; i++) {
+		output[i] = (flags[GetIndex(handles[i])] & BodyFlags::Alive) != 0;
+	}
+}
+
+void PhysicsWorld::SetAlive(PhysicsHandle handle, bool value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordSetAlive, handle);
+		recording->Write(static_cast<uint8_t>(value));
+	}
+
+	uint32_t index = GetIndex(handle);
+
+	if (value) {
+		flags[index] |= BodyFlags::Alive;
+	}
+	else {
+		flags[index] &= ~BodyFlags::Alive;
+	}
+
+	WakeBody(index);
+	RefreshBody(index);
+}
+
+uint32_t PhysicsWorld::GetCollisionLayer(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return collisionLayers[GetIndex(handle)];
+}
+
+void PhysicsWorld::SetCollisionLayer(PhysicsHandle handle, uint32_t value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	CheckCollisionLayer(value);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordSetCollisionLayer, handle);
+		recording->Write(value);
+	}
+
+	uint32_t index = GetIndex(handle);
+	collisionLayers[index] = static_cast<uint8_t>(value);
+	RefreshFilter(index);
+	WakeBody(index);
+}
+
+CollisionFilter PhysicsWorld::GetCollisionFilter(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return filters[GetIndex(handle)];
+}
+
+void PhysicsWorld::SetCollisionFilter(PhysicsHandle handle, CollisionFilter value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordSetCollisionFilter, handle);
+		recording->Write(value);
+	}
+
+	uint32_t index = GetIndex(handle);
+	filters[index] = value;
+	WakeBody(index);
+}
+
+bool PhysicsWorld::GetAsleep(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return (flags[GetIndex(handle)] & BodyFlags::Asleep) != 0;
+}
+
+void PhysicsWorld::Wake(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordWake, handle);
+	}
+
+	WakeBody(GetIndex(handle));
+}
+
+std::shared_ptr<Transform> PhysicsWorld::GetTransform(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return transforms[GetIndex(handle)];
+}
+
+void PhysicsWorld::SetTransform(PhysicsHandle handle, const std::shared_ptr<Transform>& value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordSetTransform, handle);
+		recording->Write(value->GetPosition());
+		recording->Write(value->GetOrientation());
+		recording->Write(value->GetScale());
+	}
+
+	uint32_t index = GetIndex(handle);
+	transforms[index] = value;
+	orientations[index] = value->GetOrientation();
+	scales[index] = value->GetScale();
+
+	glm::vec3 position = value->GetPosition();
+	positionX[index] = position.x;
+	positionY[index] = position.y;
+	positionZ[index] = position.z;
+	previousPositionX[index] = position.x;
+	previousPositionY[index] = position.y;
+	previousPositionZ[index] = position.z;
+	WakeBody(index);
+}
+
+Collider PhysicsWorld::GetCollider(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	return colliders[GetIndex(handle)];
+}
+
+void PhysicsWorld::SetCollider(PhysicsHandle handle, Collider value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordSetCollider, handle);
+		recording->Write(value);
+	}
+
+	uint32_t index = GetIndex(handle);
+	colliders[index] = value;
+	WakeBody(index);
+}
+
+std::function<void(const PhysicsEvent&)> PhysicsWorld::GetEventCallback(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (!IsCurrent(handle)) {
+		return nullptr;
+	}
+
+	return eventCallbacks[handle.index];
+}
+
+void PhysicsWorld::SetEventCallback(PhysicsHandle handle, std::function<void(const PhysicsEvent&)> value)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	eventCallbacks[handle.index] = value;
+}
+
+void PhysicsWorld::ApplyForce(PhysicsHandle handle, glm::vec3 force, bool applyMass)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (recording != nullptr) {
+		Record(RecordTypes::RecordApplyForce, handle);
+		recording->Write(force);
+		recording->Write(static_cast<uint8_t>(applyMass));
+	}
+
+	uint32_t index = GetIndex(handle);
+
+	if (applyMass) {
+		force /= mass[index];
+	}
+
+	accelerationX[index] += force.x;
+	accelerationY[index] += force.y;
+	accelerationZ[index] += force.z;
+	WakeBody(index);
+}
+
+#pragma endregion
+
+#pragma region Snapshots
+
+void PhysicsWorld::SaveSnapshot(BinaryStream& stream)
+{
+	stream.WriteVector(positionX);
+	stream.WriteVector(positionY);
+	stream.WriteVector(positionZ);
+	stream.WriteVector(velocityX);
+	stream.WriteVector(velocityY);
+	stream.WriteVector(velocityZ);
+	stream.WriteVector(accelerationX);
+	stream.WriteVector(accelerationY);
+	stream.WriteVector(accelerationZ);
+	stream.WriteVector(mass);
+	stream.WriteVector(flags);
+	stream.WriteVector(layers);
+	stream.WriteVector(collisionLayers);
+	stream.WriteVector(filters);
+	stream.WriteVector(colliders);
+	stream.WriteVector(orientations);
+	stream.WriteVector(scales);
+	stream.WriteVector(sleepTimers);
+	stream.WriteVector(previousPositionX);
+	stream.WriteVector(previousPositionY);
+	stream.WriteVector(previousPositionZ);
+	stream.WriteVector(simulated);
+	stream.WriteVector(gravityScale);
+	stream.WriteVector(denseIndices);
+	stream.WriteVector(handleSlots);
+	stream.WriteVector(generations);
+	stream.WriteVector(freeSlots);
+
+	for (uint32_t i = 0; i < MAX_COLLISION_LAYERS; i++) {
+		stream.Write(collisionMatrix[i]);
+	}
+}
+
+void PhysicsWorld::LoadSnapshot(BinaryStream& stream)
+{
+	//Bodies that exist both now and in the snapshot keep their transform and event callback, so whatever follows them keeps doing so.
+	//Generations only grow, so the same slot with the same generation is the same body
+	std::vector<std::shared_ptr<Transform>> slotTransforms(generations.size());
+	for (uint32_t i = 0; i < GetBodyCount(); i++) {
+		slotTransforms[handleSlots[i]] = transforms[i];
+	}
+	std::vector<uint32_t> previousGenerations = std::move(generations);
+	std::vector<std::function<void(const PhysicsEvent&)>> previousCallbacks = std::move(eventCallbacks);
+
+	stream.ReadVector(positionX);
+	stream.ReadVector(positionY);
+	stream.ReadVector(positionZ);
+	stream.ReadVector(velocityX);
+	stream.ReadVector(velocityY);
+	stream.ReadVector(velocityZ);
+	stream.ReadVector(accelerationX);
+	stream.ReadVector(accelerationY);
+	stream.ReadVector(accelerationZ);
+	stream.ReadVector(mass);
+	stream.ReadVector(flags);
+	stream.ReadVector(layers);
+	stream.ReadVector(collisionLayers);
+	stream.ReadVector(filters);
+	stream.ReadVector(colliders);
+	stream.ReadVector(orientations);
+	stream.ReadVector(scales);
+	stream.ReadVector(sleepTimers);
+	stream.ReadVector(previousPositionX);
+	stream.ReadVector(previousPositionY);
+	stream.ReadVector(previousPositionZ);
+	stream.ReadVector(simulated);
+	stream.ReadVector(gravityScale);
+	stream.ReadVector(denseIndices);
+	stream.ReadVector(handleSlots);
+	stream.ReadVector(generations);
+	stream.ReadVector(freeSlots);
+
+	for (uint32_t i = 0; i < MAX_COLLISION_LAYERS; i++) {
+		collisionMatrix[i] = stream.Read<uint32_t>();
+	}
+
+	uint32_t count = static_cast<uint32_t>(positionX.size());
+	transforms.resize(count);
+	boundingRadius.assign(count, 0.0f);
+	eventCallbacks.assign(generations.size(), nullptr);
+	for (uint32_t i = 0; i < count; i++) {
+		glm::vec3 position = glm::vec3(positionX[i], positionY[i], positionZ[i]);
+		uint32_t slot = handleSlots[i];
+
+		if (slot < slotTransforms.size() && slotTransforms[slot] != nullptr && previousGenerations[slot] == generations[slot]) {
+			transforms[i] = slotTransforms[slot];
+			transforms[i]->SetPosition(position);
+			transforms[i]->SetOrientation(orientations[i]);
+			transforms[i]->SetScale(scales[i]);
+			eventCallbacks[slot] = previousCallbacks[slot];
+		}
+		else {
+			transforms[i] = std::make_shared<Transform>(position, orientations[i], scales[i]);
+		}
+	}
+}
+
+uint64_t PhysicsWorld::ComputeHash()
+{
+	//FNV-1a over the raw bytes, any difference at all in the simulated state changes the hash
+	uint64_t hash = 14695981039346656037ull;
+	auto hashBytes = [&hash](const void* data, size_t size) {
+		const uint8_t* bytes = static_cast<const uint8_t*>(data);
+		for (size_t i = 0; i < size; i++) {
+			hash = (hash ^ bytes[i]) * 1099511628211ull;
+		}
+	};
+
+	uint32_t count = GetBodyCount();
+	hashBytes(handleSlots.data(), count * sizeof(uint32_t));
+	hashBytes(positionX.data(), count * sizeof(float));
+	hashBytes(positionY.data(), count * sizeof(float));
+	hashBytes(positionZ.data(), count * sizeof(float));
+	hashBytes(velocityX.data(), count * sizeof(float));
+	hashBytes(velocityY.data(), count * sizeof(float));
+	hashBytes(velocityZ.data(), count * sizeof(float));
+
+	//Only whether a body has been written to its transform depends on how often the game renders, leave it out
+	for (uint32_t i = 0; i < count; i++) {
+		uint8_t simulatedFlags = flags[i] & ~BodyFlags::TransformSynced;
+		hashBytes(&simulatedFlags, 1);
+	}
+
+	return hash;
+}
+
+#pragma endregion
+
+#pragma region Update
+
+void PhysicsWorld::IntegrateVelocities(float deltaTime, glm::vec3 gravity)
+{
+	uint32_t count = GetBodyCount();
+	uint32_t chunkCount = (count + INTEGRATION_CHUNK_SIZE - 1) / INTEGRATION_CHUNK_SIZE;
+
+	BodyArrays bodies = GetBodyArrays();
+
+	JobSystem::GetInstance()->ParallelFor(chunkCount, [&bodies, count, deltaTime, gravity](uint32_t chunk) {
+		uint32_t begin = chunk * INTEGRATION_CHUNK_SIZE;
+		PhysicsKernels::IntegrateVelocities(bodies, begin, std::min(begin + INTEGRATION_CHUNK_SIZE, count), deltaTime, gravity);
+	});
+}
+
+void PhysicsWorld::IntegratePositions(float deltaTime)
+{
+	uint32_t count = GetBodyCount();
+	uint32_t chunkCount = (count + INTEGRATION_CHUNK_SIZE - 1) / INTEGRATION_CHUNK_SIZE;
+
+	BodyArrays bodies = GetBodyArrays();
+
+	JobSystem::GetInstance()->ParallelFor(chunkCount, [&bodies, count, deltaTime](uint32_t chunk) {
+		uint32_t begin = chunk * INTEGRATION_CHUNK_SIZE;
+		PhysicsKernels::IntegratePositions(bodies, begin, std::min(begin + INTEGRATION_CHUNK_SIZE, count), deltaTime);
+	});
+}
+
+void PhysicsWorld::SavePreviousPositions()
+{
+	previousPositionX = positionX;
+	previousPositionY = positionY;
+	previousPositionZ = positionZ;
+}
+
+void PhysicsWorld::SyncTransforms(float alpha)
+{
+	uint32_t count = GetBodyCount();
+
+	//Rotating or scaling a transform changes the body's collider, so a recording has to see it happen before the next step
+	if (recording != nullptr) {
+		for (uint32_t i = 0; i < count; i++) {
+			if (transforms[i]->GetOrientation() != orientations[i] || transforms[i]->GetScale() != scales[i]) {
+				Record(RecordTypes::RecordSetOrientation, { handleSlots[i], generations[handleSlots[i]] });
+				recording->Write(transforms[i]->GetOrientation());
+				recording->Write(transforms[i]->GetScale());
+			}
+		}
+	}
+
+	JobSystem::GetInstance()->ParallelFor(count, [this, alpha](uint32_t i) {
+		//Physics does not rotate or scale bodies yet so the transform is the source of truth for both
+		orientations[i] = transforms[i]->GetOrientation();
+		scales[i] = transforms[i]->GetScale();
+
+		//Sleeping bodies don't move, their transform only needs writing once after they fall asleep
+		if (layers[i] == PhysicsLayers::Dynamic && !(flags[i] & BodyFlags::TransformSynced)) {
+			if (flags[i] & BodyFlags::Asleep) {
+				flags[i] |= BodyFlags::TransformSynced;
+			}
+
+			glm::vec3 previous = glm::vec3(previousPositionX[i], previousPositionY[i], previousPositionZ[i]);
+			glm::vec3 current = glm::vec3(positionX[i], positionY[i], positionZ[i]);
+			transforms[i]->SetPosition(glm::mix(previous, current, alpha));
+		}
+	}, 256);
+}
+
+void PhysicsWorld::DrawHandles(PhysicsHandle handle)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	DrawBodyHandles(GetIndex(handle));
+}
+
+void PhysicsWorld::DrawBodyHandles(uint32_t index)
+{
+	glm::vec3 position = glm::vec3(positionX[index], positionY[index], positionZ[index]);
+	glm::vec3 velocity = glm::vec3(velocityX[index], velocityY[index], velocityZ[index]);
+	glm::vec3 acceleration = glm::vec3(accelerationX[index], accelerationY[index], accelerationZ[index]);
+
+	//Draw velocity
+	DebugManager::GetInstance()->DrawLine(position, position + velocity, glm::vec3(1.0f, 1.0f, 0.0f), 0.0f);
+	//Draw acceleration
+	DebugManager::GetInstance()->DrawLine(position + velocity, position + velocity + acceleration, glm::vec3(1.0f, 0.0f, 0.0f), 0.0f);
+	//Draw collider
+	Narrowphase::DrawShape(Narrowphase::ComputeShape(colliders[index], position, orientations[index], scales[index]), glm::vec3(0.0f, 1.0f, 0.0f));
+
+	transforms[index]->DrawHandles();
+}
+
+#pragma endregion
@@ -0,0 +1,459 @@
+#pragma once
+#include "pch.h"
+
+#include "PhysicsHandle.h"
+#include "BodyArrays.h"
+#include "Collider.h"
+#include "CollisionFilter.h"
+#include "PhysicsEvent.h"
+#include "BinaryStream.h"
+#include "RecordTypes.h"
+#include "Transform.h"
+
+#include <mutex>
+
+class PhysicsWorld
+{
+	friend class PhysicsManager;
+	friend class ContactSolver;
+
+private:
+	enum BodyFlags : uint8_t {
+		Alive = 1,
+		AffectedByGravity = 2,
+		Asleep = 4,
+		//Set once a sleeping body's final position has been written to its transform so it can be skipped afterwards
+		TransformSynced = 8
+	};
+
+	//Body state, each array is indexed by a body's dense index and kept tightly packed so updates stream through memory
+	std::vector<float> positionX;
+	std::vector<float> positionY;
+	std::vector<float> positionZ;
+	std::vector<float> velocityX;
+	std::vector<float> velocityY;
+	std::vector<float> velocityZ;
+	std::vector<float> accelerationX;
+	std::vector<float> accelerationY;
+	std::vector<float> accelerationZ;
+	std::vector<float> mass;
+	std::vector<uint8_t> flags;
+	std::vector<PhysicsLayers> layers;
+	std::vector<std::shared_ptr<Transform>> transforms;
+
+	//Collision layer of each body and the category and mask bits the broadphase filters pairs with
+	std::vector<uint8_t> collisionLayers;
+	std::vector<CollisionFilter> filters;
+
+	//Collision shape of each body along with the orientation and scale it is placed with, copied from the transforms
+	std::vector<Collider> colliders;
+	std::vector<glm::quat> orientations;
+	std::vector<glm::vec3> scales;
+
+	//How long each body has been moving slowly enough to fall asleep
+	std::vector<float> sleepTimers;
+
+	//Radius around each body's position that contains its collider, rebuilt by the physics manager every step
+	std::vector<float> boundingRadius;
+
+	//Positions at the start of the latest step so rendering can interpolate between the last two steps
+	std::vector<float> previousPositionX;
+	std::vector<float> previousPositionY;
+	std::vector<float> previousPositionZ;
+
+	//Derived from the flags and mass so integration does not need to branch, 1 or 0 and gravity divided by mass or 0
+	std::vector<float> simulated;
+	std::vector<float> gravityScale;
+
+	//Handle slot -> dense index, dense index -> handle slot and the generation of each slot
+	std::vector<uint32_t> denseIndices;
+	std::vector<uint32_t> handleSlots;
+	std::vector<uint32_t> generations;
+	std::vector<uint32_t> freeSlots;
+
+	//Called with every trigger and collision event a body is part of, indexed by handle slot since the physics manager looks them up by handle
+	std::vector<std::function<void(const PhysicsEvent&)>> eventCallbacks;
+
+	//Row i has bit j set if bodies on collision layer i are tested against bodies on layer j, always kept symmetric
+	uint32_t collisionMatrix[32];
+
+	//Guards the body state when physics is stepped on its own thread
+	std::mutex mutex;
+
+	//While set, every change made through the public methods is written here so the session can be replayed, owned by the physics manager
+	BinaryStream* recording = nullptr;
+
+	/// <summary>
+	/// Returns the dense index of the body, only valid until the next body is destroyed. Throws if the handle's body has been destroyed
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's index in the state arrays</returns>
+	uint32_t GetIndex(PhysicsHandle handle);
+
+	/// <summary>
+	/// Returns whether the handle refers to a body that still exists without locking the mutex, the caller must hold it
+	/// </summary>
+	/// <param name="handle">The handle to check</param>
+	/// <returns>True if the handle is valid</returns>
+	bool IsCurrent(PhysicsHandle handle);
+
+	/// <summary>
+	/// Draws the velocity, acceleration, collider and transform handles of a body
+	/// </summary>
+	/// <param name="index">The dense index of the body</param>
+	void DrawBodyHandles(uint32_t index);
+
+	/// <summary>
+	/// Recalculates the simulated and gravityScale values of a body after its flags, layer or mass change
+	/// </summary>
+	/// <param name="index">The dense index of the body</param>
+	void RefreshBody(uint32_t index);
+
+	/// <summary>
+	/// Stops simulating a body until something touches or moves it, its velocity is cleared and its previous position matches its current one
+	/// </summary>
+	/// <param name="index">The dense index of the body</param>
+	void SleepBody(uint32_t index);
+
+	/// <summary>
+	/// Starts simulating a sleeping body again and restarts its sleep timer
+	/// </summary>
+	/// <param name="index">The dense index of the body</param>
+	void WakeBody(uint32_t index);
+
+	/// <summary>
+	/// Rebuilds a body's collision filter from its collision layer and the collision matrix
+	/// </summary>
+	/// <param name="index">The dense index of the body</param>
+	void RefreshFilter(uint32_t index);
+
+	/// <summary>
+	/// Throws if the layer is not one of the available collision layers
+	/// </summary>
+	/// <param name="layer">The layer to check</param>
+	static void CheckCollisionLayer(uint32_t layer);
+
+	/// <summary>
+	/// Starts a recording entry for a change to a body, the caller writes the values of the change after it
+	/// </summary>
+	/// <param name="type">The type of change</param>
+	/// <param name="handle">The body being changed</param>
+	void Record(RecordTypes type, PhysicsHandle handle);
+
+public:
+	static const uint32_t MAX_COLLISION_LAYERS = 32;
+
+#pragma region Constructor
+
+	/// <summary>
+	/// Creates an empty world where every collision layer collides with every other,
+	/// except that static bodies are not tested against each other and neither are triggers
+	/// </summary>
+	PhysicsWorld();
+
+#pragma endregion
+
+#pragma region Collision Layers
+
+	/// <summary>
+	/// Returns whether bodies on the two collision layers are tested for collisions
+	/// </summary>
+	/// <param name="layer1">The first collision layer</param>
+	/// <param name="layer2">The second collision layer</param>
+	/// <returns>True if the layers collide</returns>
+	bool GetLayersCollide(uint32_t layer1, uint32_t layer2);
+
+	/// <summary>
+	/// Sets whether bodies on the two collision layers are tested for collisions and rebuilds the filter of every body,
+	/// replacing any filters set directly on a body
+	/// </summary>
+	/// <param name="layer1">The first collision layer</param>
+	/// <param name="layer2">The second collision layer</param>
+	/// <param name="value">Whether the layers collide</param>
+	void SetLayersCollide(uint32_t layer1, uint32_t layer2, bool value);
+
+#pragma endregion
+
+#pragma region Body Management
+
+	/// <summary>
+	/// Adds a body to the world, its starting position is read from the transform
+	/// </summary>
+	/// <param name="transform">The transform that the body's position is written back to</param>
+	/// <param name="layer">The physics layer the body belongs to</param>
+	/// <param name="mass">The body's mass</param>
+	/// <param name="affectedByGravity">Whether gravity is applied to the body</param>
+	/// <param name="alive">Whether the body is currently being simulated</param>
+	/// <returns>A handle that stays valid until the body is destroyed</returns>
+	PhysicsHandle CreateBody(const std::shared_ptr<Transform>& transform, PhysicsLayers layer, float mass, bool affectedByGravity, bool alive);
+
+	/// <summary>
+	/// Removes a body from the world, the last body is moved into its place to keep the arrays packed
+	/// </summary>
+	/// <param name="handle">The handle of the body to remove</param>
+	void DestroyBody(PhysicsHandle handle);
+
+	/// <summary>
+	/// Returns whether the handle refers to a body that still exists
+	/// </summary>
+	/// <param name="handle">The handle to check</param>
+	/// <returns>True if the handle is valid</returns>
+	bool IsValid(PhysicsHandle handle);
+
+	/// <summary>
+	/// Returns the number of bodies in the world, the caller must hold the world's mutex
+	/// </summary>
+	/// <returns>The body count</returns>
+	uint32_t GetBodyCount();
+
+	/// <summary>
+	/// Returns pointers to the state arrays for kernels that process many bodies at once, only valid until a body is created or destroyed.
+	/// The caller must hold the world's mutex
+	/// </summary>
+	/// <returns>The state arrays</returns>
+	BodyArrays GetBodyArrays();
+
+	/// <summary>
+	/// Returns the mutex that guards the body state, the handle based methods lock it themselves
+	/// </summary>
+	/// <returns>The world's mutex</returns>
+	std::mutex& GetMutex();
+
+#pragma endregion
+
+#pragma region Body Accessors
+
+	/// <summary>
+	/// Returns the position of the body
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's position</returns>
+	glm::vec3 GetPosition(PhysicsHandle handle);
+
+	/// <summary>
+	/// Sets the position of the body and its transform
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="value">The position to set to</param>
+	void SetPosition(PhysicsHandle handle, glm::vec3 value);
+
+	/// <summary>
+	/// Returns the velocity of the body
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's velocity</returns>
+	glm::vec3 GetVelocity(PhysicsHandle handle);
+
+	/// <summary>
+	/// Sets the velocity of the body
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="value">The velocity to set to</param>
+	void SetVelocity(PhysicsHandle handle, glm::vec3 value);
+
+	/// <summary>
+	/// Returns the acceleration accumulated on the body since the last update
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's acceleration</returns>
+	glm::vec3 GetAcceleration(PhysicsHandle handle);
+
+	/// <summary>
+	/// Returns the mass of the body
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's mass</returns>
+	float GetMass(PhysicsHandle handle);
+
+	/// <summary>
+	/// Sets the mass of the body
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="value">The mass to set to</param>
+	void SetMass(PhysicsHandle handle, float value);
+
+	/// <summary>
+	/// Returns the physics layer of the body
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's physics layer</returns>
+	PhysicsLayers GetLayer(PhysicsHandle handle);
+
+	/// <summary>
+	/// Returns whether the body is currently being simulated
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>Whether the body is alive</returns>
+	bool GetAlive(PhysicsHandle handle);
+
+	/// <summary>
+	/// Returns whether each of several bodies is currently being simulated, locking the world once for all of them
+	/// </summary>
+	/// <param name="handles">The handles of the bodies</param>
+	/// <param name="count">The number of bodies</param>
+	/// <param name="output">Receives 1 for every body that is alive and 0 for the rest</param>
+	void GetAlive(const PhysicsHandle* handles, uint32_t count, uint8_t* output);
+
+	/// <summary>
+	/// Sets whether the body is currently being simulated
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="value">The value to set to</param>
+	void SetAlive(PhysicsHandle handle, bool value);
+
+	/// <summary>
+	/// Returns the collision layer of the body, a new body's collision layer is the value of its physics layer
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's collision layer</returns>
+	uint32_t GetCollisionLayer(PhysicsHandle handle);
+
+	/// <summary>
+	/// Moves the body to a collision layer, its filter is rebuilt from the collision matrix
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="value">The collision layer, less than MAX_COLLISION_LAYERS</param>
+	void SetCollisionLayer(PhysicsHandle handle, uint32_t value);
+
+	/// <summary>
+	/// Returns the category and mask bits the body's pairs are filtered with
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's collision filter</returns>
+	CollisionFilter GetCollisionFilter(PhysicsHandle handle);
+
+	/// <summary>
+	/// Sets the category and mask bits directly, for bodies that need different rules than the rest of their layer.
+	/// Replaced when the body's collision layer or the collision matrix changes
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="value">The filter to use</param>
+	void SetCollisionFilter(PhysicsHandle handle, CollisionFilter value);
+
+	/// <summary>
+	/// Returns whether the body has come to rest and is no longer being simulated
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>True if the body is asleep</returns>
+	bool GetAsleep(PhysicsHandle handle);
+
+	/// <summary>
+	/// Wakes the body if it is asleep and restarts the time it needs to rest before sleeping again
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	void Wake(PhysicsHandle handle);
+
+	/// <summary>
+	/// Returns the transform the body's position is written to
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's transform</returns>
+	std::shared_ptr<Transform> GetTransform(PhysicsHandle handle);
+
+	/// <summary>
+	/// Sets the transform the body's position is written to and moves the body to the transform's position
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="value">The transform to use</param>
+	void SetTransform(PhysicsHandle handle, const std::shared_ptr<Transform>& value);
+
+	/// <summary>
+	/// Returns the collider of the body
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's collider</returns>
+	Collider GetCollider(PhysicsHandle handle);
+
+	/// <summary>
+	/// Sets the collider of the body
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="value">The collider to use</param>
+	void SetCollider(PhysicsHandle handle, Collider value);
+
+	/// <summary>
+	/// Returns the function the body's trigger and collision events are delivered to
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <returns>The body's event callback or an empty function if it has none or the handle is no longer valid</returns>
+	std::function<void(const PhysicsEvent&)> GetEventCallback(PhysicsHandle handle);
+
+	/// <summary>
+	/// Sets the function the body's trigger and collision events are delivered to, events are delivered on the main thread after physics has updated
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="value">The function to call, or an empty function to stop receiving events</param>
+	void SetEventCallback(PhysicsHandle handle, std::function<void(const PhysicsEvent&)> value);
+
+	/// <summary>
+	/// Adds a force to the body's acceleration
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	/// <param name="force">The force to apply</param>
+	/// <param name="applyMass">Whether or not the force is affected by the mass of the body</param>
+	void ApplyForce(PhysicsHandle handle, glm::vec3 force, bool applyMass = true);
+
+#pragma endregion
+
+#pragma region Snapshots
+
+	/// <summary>
+	/// Writes the state of every body to a stream, the caller must hold the world's mutex
+	/// </summary>
+	/// <param name="stream">The stream to write to</param>
+	void SaveSnapshot(BinaryStream& stream);
+
+	/// <summary>
+	/// Replaces every body with the ones in a snapshot. Handles stay the same as when the snapshot was taken.
+	/// Bodies that still exist keep their transform and event callback with the snapshot's state written into the transform,
+	/// bodies only in the snapshot get a new transform and no callback. The caller must hold the world's mutex
+	/// </summary>
+	/// <param name="stream">The stream to read from</param>
+	void LoadSnapshot(BinaryStream& stream);
+
+	/// <summary>
+	/// Returns a hash of the simulated state of every body, identical across runs as long as the simulation is deterministic.
+	/// The caller must hold the world's mutex
+	/// </summary>
+	/// <returns>The hash of the world</returns>
+	uint64_t ComputeHash();
+
+#pragma endregion
+
+#pragma region Update
+
+	/// <summary>
+	/// Applies gravity and acceleration to the velocity of every simulated dynamic body, split across the job system and run with the physics kernels.
+	/// The caller must hold the world's mutex
+	/// </summary>
+	/// <param name="deltaTime">The time step</param>
+	/// <param name="gravity">The gravity force applied to bodies that are affected by gravity</param>
+	void IntegrateVelocities(float deltaTime, glm::vec3 gravity);
+
+	/// <summary>
+	/// Moves every simulated dynamic body by its velocity, split across the job system and run with the physics kernels.
+	/// The caller must hold the world's mutex
+	/// </summary>
+	/// <param name="deltaTime">The time step</param>
+	void IntegratePositions(float deltaTime);
+
+	/// <summary>
+	/// Stores the current positions as the start of the next step, the caller must hold the world's mutex
+	/// </summary>
+	void SavePreviousPositions();
+
+	/// <summary>
+	/// Copies the position of every awake dynamic body into its transform, blended between the last two steps,
+	/// and reads back the orientation and scale that colliders are placed with. The caller must hold the world's mutex
+	/// </summary>
+	/// <param name="alpha">How far between the previous and current step to place the transforms, from 0 to 1</param>
+	void SyncTransforms(float alpha);
+
+	/// <summary>
+	/// Draws the velocity, acceleration, collider and transform handles of a body
+	/// </summary>
+	/// <param name="handle">The handle of the body</param>
+	void DrawHandles(PhysicsHandle handle);
+
+#pragma endregion
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include "pch.h"
+
+#include <cfloat>
+
+struct RayQuery {
+public:
+	glm::vec3 origin = glm::vec3(0.0f, 0.0f, 0.0f);
+
+	//Does not need to be normalized, hit distances are measured in world units either way
+	glm::vec3 direction = glm::vec3(0.0f, 0.0f, -1.0f);
+
+	float maxDistance = FLT_MAX;
+
+	//Radius of the sphere swept along the ray, zero casts a thin ray
+	float radius = 0.0f;
+
+	//Bits of the collision layers the ray can hit
+	uint32_t layerMask = UINT32_MAX;
+
+	//Only the closest hits are kept, one is enough for line of sight checks
+	uint32_t maxHits = UINT32_MAX;
+};
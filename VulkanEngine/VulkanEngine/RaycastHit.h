@@ -0,0 +1,22 @@
+#pragma once
+#include "pch.h"
+
+#include "PhysicsHandle.h"
+
+struct RaycastHit {
+public:
+	PhysicsHandle handle;
+
+	//How far along the ray the hit is, zero if the ray started inside the body
+	float distance = 0.0f;
+
+	//Where the ray or swept sphere touches the body's surface
+	glm::vec3 point = glm::vec3(0.0f, 0.0f, 0.0f);
+
+	//Surface normal at the hit, faces back along the ray if the ray started inside the body
+	glm::vec3 normal = glm::vec3(0.0f, 1.0f, 0.0f);
+
+	bool operator<(const RaycastHit& other) const {
+		return distance < other.distance || (distance == other.distance && handle.index < other.handle.index);
+	}
+};
@@ -0,0 +1,24 @@
+#pragma once
+
+//Every entry in a physics recording starts with one of these, followed by the handle of the body it affects if it affects one
+enum RecordTypes {
+	RecordStep,
+	RecordCreateBody,
+	RecordDestroyBody,
+	RecordSetPosition,
+	RecordSetVelocity,
+	RecordSetMass,
+	RecordSetAlive,
+	RecordSetCollisionLayer,
+	RecordSetCollisionFilter,
+	RecordWake,
+	RecordSetTransform,
+	RecordSetCollider,
+	RecordApplyForce,
+	RecordSetLayersCollide,
+	RecordSetOrientation,
+	RecordSetGravity,
+	RecordSetSolverIterations,
+	RecordSetSleepingEnabled,
+	RecordTypeCount
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include "pch.h"
+
+struct ReplayStats {
+public:
+	uint32_t stepCount = 0;
+	uint32_t bodyCount = 0;
+
+	//Milliseconds spent inside physics steps, not counting applying the recorded inputs
+	float totalStepTime = 0.0f;
+	float maxStepTime = 0.0f;
+
+	//First step whose world hash did not match the recording, UINT32_MAX if every step matched
+	uint32_t firstDivergentStep = UINT32_MAX;
+
+	//Hash of the world after the last step when recorded and when replayed
+	uint64_t expectedHash = 0;
+	uint64_t finalHash = 0;
+};
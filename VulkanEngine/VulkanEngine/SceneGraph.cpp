@@ -0,0 +1,265 @@
+#include "pch.h"
+#include "SceneGraph.h"
+
+#include "JobSystem.h"
+
+//Number of roots each thread claims at a time, most roots only have a few descendants
+static const uint32_t ROOT_GRAIN_SIZE = 16;
+
+#pragma region Singleton
+
+SceneGraph* SceneGraph::instance = nullptr;
+
+SceneGraph* SceneGraph::GetInstance()
+{
+	if (instance == nullptr) {
+		instance = new SceneGraph();
+	}
+
+	return instance;
+}
+
+#pragma endregion
+
+#pragma region Accessors
+
+uint32_t SceneGraph::GetNodeCount()
+{
+	return static_cast<uint32_t>(nodeTransforms.size() - freeNodes.size());
+}
+
+uint32_t SceneGraph::GetUpdatedNodeCount()
+{
+	return updatedNodeCount.load();
+}
+
+float SceneGraph::GetUpdateTime()
+{
+	return updateTime;
+}
+
+#pragma endregion
+
+#pragma region Hierarchy
+
+void SceneGraph::SetParent(std::shared_ptr<Transform> child, std::shared_ptr<Transform> parent)
+{
+	if (child == nullptr) {
+		throw std::runtime_error("Failed to set parent, the child transform was null!");
+	}
+
+	if (child == parent) {
+		throw std::runtime_error("Failed to set parent, a transform can't be its own parent!");
+	}
+
+	//Attaching a transform under one of its own descendants would make a loop
+	if (parent != nullptr && child->sceneNode != UINT32_MAX) {
+		for (uint32_t node = parent->sceneNode; node != UINT32_MAX; node = nodeParents[node]) {
+			if (node == child->sceneNode) {
+				throw std::runtime_error("Failed to set parent, the parent is a descendant of the child!");
+			}
+		}
+	}
+
+	if (GetParent(child) == parent) {
+		return;
+	}
+
+	uint32_t childNode = child->sceneNode != UINT32_MAX ? child->sceneNode : AddNode(child);
+
+	//Detach from the current parent
+	uint32_t oldParent = nodeParents[childNode];
+	if (oldParent != UINT32_MAX) {
+		std::vector<uint32_t>& siblings = nodeChildren[oldParent];
+		siblings.erase(std::find(siblings.begin(), siblings.end(), childNode));
+		nodeParents[childNode] = UINT32_MAX;
+	}
+
+	if (parent != nullptr) {
+		uint32_t parentNode = parent->sceneNode != UINT32_MAX ? parent->sceneNode : AddNode(parent);
+		nodeParents[childNode] = parentNode;
+		nodeChildren[parentNode].push_back(childNode);
+	}
+
+	//The world matrix changed even though the local transform didn't
+	child->hasParent = parent != nullptr;
+	child->version++;
+
+	if (oldParent != UINT32_MAX) {
+		RemoveNodeIfUnused(oldParent);
+	}
+	RemoveNodeIfUnused(childNode);
+	orderDirty = true;
+}
+
+std::shared_ptr<Transform> SceneGraph::GetParent(std::shared_ptr<Transform> child)
+{
+	if (child == nullptr || child->sceneNode == UINT32_MAX || nodeParents[child->sceneNode] == UINT32_MAX) {
+		return nullptr;
+	}
+
+	return nodeTransforms[nodeParents[child->sceneNode]];
+}
+
+void SceneGraph::Remove(std::shared_ptr<Transform> transform)
+{
+	if (transform == nullptr || transform->sceneNode == UINT32_MAX) {
+		return;
+	}
+
+	//Detaching the children first frees the node once it is detached from its parent as well
+	std::vector<uint32_t> children = nodeChildren[transform->sceneNode];
+	for (uint32_t child : children) {
+		SetParent(nodeTransforms[child], nullptr);
+	}
+
+	SetParent(transform, nullptr);
+}
+
+void SceneGraph::Clear()
+{
+	for (std::shared_ptr<Transform> transform : nodeTransforms) {
+		if (transform != nullptr) {
+			transform->sceneNode = UINT32_MAX;
+			if (transform->hasParent) {
+				transform->hasParent = false;
+				transform->version++;
+			}
+		}
+	}
+
+	nodeTransforms.clear();
+	nodeParents.clear();
+	nodeChildren.clear();
+	freeNodes.clear();
+	orderDirty = true;
+}
+
+uint32_t SceneGraph::AddNode(std::shared_ptr<Transform> transform)
+{
+	//Reuse a freed node if there is one
+	uint32_t node;
+	if (freeNodes.size() > 0) {
+		node = freeNodes.back();
+		freeNodes.pop_back();
+	}
+	else {
+		node = static_cast<uint32_t>(nodeTransforms.size());
+		nodeTransforms.push_back(nullptr);
+		nodeParents.push_back(UINT32_MAX);
+		nodeChildren.push_back(std::vector<uint32_t>());
+	}
+
+	nodeTransforms[node] = transform;
+	nodeParents[node] = UINT32_MAX;
+	transform->sceneNode = node;
+
+	return node;
+}
+
+void SceneGraph::RemoveNodeIfUnused(uint32_t node)
+{
+	if (nodeParents[node] != UINT32_MAX || nodeChildren[node].size() > 0) {
+		return;
+	}
+
+	nodeTransforms[node]->sceneNode = UINT32_MAX;
+	nodeTransforms[node] = nullptr;
+	freeNodes.push_back(node);
+}
+
+#pragma endregion
+
+#pragma region Update
+
+void SceneGraph::Update()
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if (orderDirty) {
+		Rebuild();
+	}
+
+	//Roots share nothing so each one can be walked on a different thread
+	updatedNodeCount = 0;
+	JobSystem::GetInstance()->ParallelFor(static_cast<uint32_t>(roots.size()), [this](uint32_t i) {
+		UpdateRoot(roots[i]);
+	}, ROOT_GRAIN_SIZE);
+
+	updateTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void SceneGraph::Rebuild()
+{
+	transforms.clear();
+	parents.clear();
+	subtreeSizes.clear();
+	roots.clear();
+
+	for (uint32_t node = 0; node < nodeTransforms.size(); node++) {
+		if (nodeTransforms[node] != nullptr && nodeParents[node] == UINT32_MAX) {
+			roots.push_back(static_cast<uint32_t>(transforms.size()));
+			AppendSubtree(node, UINT32_MAX);
+		}
+	}
+
+	//Every node starts out of date so the new shape is fully propagated
+	seenVersions.resize(transforms.size());
+	worldMatrices.resize(transforms.size());
+	for (size_t i = 0; i < transforms.size(); i++) {
+		seenVersions[i] = transforms[i]->version - 1;
+	}
+
+	orderDirty = false;
+}
+
+void SceneGraph::AppendSubtree(uint32_t node, uint32_t parent)
+{
+	uint32_t index = static_cast<uint32_t>(transforms.size());
+	transforms.push_back(nodeTransforms[node].get());
+	parents.push_back(parent);
+	subtreeSizes.push_back(1);
+
+	for (uint32_t child : nodeChildren[node]) {
+		AppendSubtree(child, index);
+	}
+
+	subtreeSizes[index] = static_cast<uint32_t>(transforms.size()) - index;
+}
+
+void SceneGraph::UpdateRoot(uint32_t root)
+{
+	uint32_t end = root + subtreeSizes[root];
+	uint32_t updated = 0;
+
+	uint32_t i = root;
+	while (i < end) {
+		//Clean nodes are stepped into since their descendants may still have changed
+		if (transforms[i]->version == seenVersions[i]) {
+			i++;
+			continue;
+		}
+
+		//Everything under a changed node moves with it, parents come first so their world matrices are always ready
+		uint32_t subtreeEnd = i + subtreeSizes[i];
+		for (uint32_t j = i; j < subtreeEnd; j++) {
+			Transform* transform = transforms[j];
+			glm::mat4 local = transform->GetModelMatrix();
+			worldMatrices[j] = parents[j] == UINT32_MAX ? local : worldMatrices[parents[j]] * local;
+			transform->world = worldMatrices[j];
+
+			//Descendants only moved because an ancestor did, their version tells the meshes to repack them
+			if (j != i) {
+				transform->version++;
+			}
+			seenVersions[j] = transform->version;
+		}
+
+		updated += subtreeEnd - i;
+		i = subtreeEnd;
+	}
+
+	updatedNodeCount.fetch_add(updated);
+}
+
+#pragma endregion
@@ -0,0 +1,136 @@
+#pragma once
+#include "pch.h"
+
+#include <atomic>
+
+#include "Transform.h"
+
+class SceneGraph
+{
+private:
+	static SceneGraph* instance;
+
+	//Nodes indexed by their transform's scene node, they keep their index while the hierarchy changes shape
+	std::vector<std::shared_ptr<Transform>> nodeTransforms;
+	std::vector<uint32_t> nodeParents;
+	std::vector<std::vector<uint32_t>> nodeChildren;
+	std::vector<uint32_t> freeNodes;
+
+	//Flat copy of the hierarchy sorted so every parent comes before its children and every subtree is contiguous.
+	//Indexed by dense index and rebuilt whenever the hierarchy changes shape
+	std::vector<Transform*> transforms;
+	std::vector<uint32_t> parents;
+	std::vector<uint32_t> subtreeSizes;
+	std::vector<uint32_t> seenVersions;
+	std::vector<glm::mat4> worldMatrices;
+	std::vector<uint32_t> roots;
+	bool orderDirty = false;
+
+	//Statistics from the latest update
+	std::atomic<uint32_t> updatedNodeCount{ 0 };
+	float updateTime = 0.0f;
+
+	/// <summary>
+	/// Gives a transform a node with no parent or children
+	/// </summary>
+	/// <param name="transform">The transform to add</param>
+	/// <returns>The transform's scene node</returns>
+	uint32_t AddNode(std::shared_ptr<Transform> transform);
+
+	/// <summary>
+	/// Frees a node once it has neither a parent nor children, a lone transform doesn't need to be in the hierarchy
+	/// </summary>
+	/// <param name="node">The node to check</param>
+	void RemoveNodeIfUnused(uint32_t node);
+
+	/// <summary>
+	/// Rebuilds the flat arrays from the nodes, every world matrix is recomputed on the next update
+	/// </summary>
+	void Rebuild();
+
+	/// <summary>
+	/// Appends a node and all of its descendants to the flat arrays, parents first
+	/// </summary>
+	/// <param name="node">The node to append</param>
+	/// <param name="parent">The dense index of the node's parent, UINT32_MAX for roots</param>
+	void AppendSubtree(uint32_t node, uint32_t parent);
+
+	/// <summary>
+	/// Recomputes the world matrices of the subtrees under a root that changed, clean subtrees cost a version check per node
+	/// </summary>
+	/// <param name="root">The dense index of the root</param>
+	void UpdateRoot(uint32_t root);
+
+public:
+#pragma region Singleton
+
+	/// <summary>
+	/// Returns the singleton instance of the scene graph
+	/// </summary>
+	/// <returns>The singleton instance</returns>
+	static SceneGraph* GetInstance();
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the number of transforms that are a parent or child of another transform
+	/// </summary>
+	/// <returns>The node count</returns>
+	uint32_t GetNodeCount();
+
+	/// <summary>
+	/// Returns the number of world matrices recomputed by the latest update
+	/// </summary>
+	/// <returns>The updated node count</returns>
+	uint32_t GetUpdatedNodeCount();
+
+	/// <summary>
+	/// Returns how long the latest update took in milliseconds
+	/// </summary>
+	/// <returns>The update time</returns>
+	float GetUpdateTime();
+
+#pragma endregion
+
+#pragma region Hierarchy
+
+	/// <summary>
+	/// Attaches a transform to a parent, its position, orientation and scale become relative to the parent.
+	/// Physics keeps treating the transform's position as a world position, so attached transforms should not be simulated
+	/// </summary>
+	/// <param name="child">The transform to attach</param>
+	/// <param name="parent">The transform to attach it to, nullptr to detach it</param>
+	void SetParent(std::shared_ptr<Transform> child, std::shared_ptr<Transform> parent);
+
+	/// <summary>
+	/// Returns the parent a transform is attached to
+	/// </summary>
+	/// <param name="child">The transform to check</param>
+	/// <returns>The parent, nullptr if the transform has none</returns>
+	std::shared_ptr<Transform> GetParent(std::shared_ptr<Transform> child);
+
+	/// <summary>
+	/// Removes a transform from the hierarchy, its children are detached and keep their local position, orientation and scale
+	/// </summary>
+	/// <param name="transform">The transform to remove</param>
+	void Remove(std::shared_ptr<Transform> transform);
+
+	/// <summary>
+	/// Detaches every transform from the hierarchy
+	/// </summary>
+	void Clear();
+
+#pragma endregion
+
+#pragma region Update
+
+	/// <summary>
+	/// Recomputes the world matrices of every transform whose position, orientation or scale changed along with everything under it.
+	/// Roots are updated in parallel, the transforms may not be changed until the update finishes
+	/// </summary>
+	void Update();
+
+#pragma endregion
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+enum SimdLevels {
+	Scalar,
+	SSE,
+	AVX2,
+	SimdLevelCount
+};
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#include "pch.h"
+
+struct StringId {
+public:
+	//FNV-1a hash of the string, zero is reserved for no string
+	uint32_t value = 0;
+
+	constexpr StringId() = default;
+
+	/// <summary>
+	/// Hashes a string, literals assigned to a constexpr StringId are hashed at compile time
+	/// </summary>
+	/// <param name="string">The null terminated string to hash</param>
+	constexpr StringId(const char* string) {
+		if (string[0] == '\0') {
+			return;
+		}
+
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; string[i] != '\0'; i++) {
+			hash = (hash ^ static_cast<uint8_t>(string[i])) * 16777619u;
+		}
+		value = hash;
+	}
+
+	constexpr bool operator==(const StringId& other) const {
+		return value == other.value;
+	}
+
+	constexpr bool operator!=(const StringId& other) const {
+		return value != other.value;
+	}
+};
+
+namespace std {
+	template<> struct hash<StringId> {
+		size_t operator()(StringId const& id) const {
+			//Already a hash, no need to hash it again
+			return id.value;
+		}
+	};
+}
@@ -0,0 +1,51 @@
+#include "pch.h"
+#include "StringTable.h"
+
+#pragma region Singleton
+
+StringTable* StringTable::instance = nullptr;
+
+StringTable* StringTable::GetInstance()
+{
+	if (instance == nullptr) {
+		instance = new StringTable();
+	}
+
+	return instance;
+}
+
+#pragma endregion
+
+#pragma region Interning
+
+StringId StringTable::Intern(const std::string& string)
+{
+	StringId id = StringId(string.c_str());
+	if (id == StringId()) {
+		return id;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::unordered_map<StringId, std::string>::iterator existing = strings.find(id);
+	if (existing == strings.end()) {
+		strings.emplace(id, string);
+	}
+	else if (existing->second != string) {
+		throw std::runtime_error("Failed to intern " + string + ", its ID is already used by " + existing->second + "!");
+	}
+
+	return id;
+}
+
+const std::string& StringTable::GetString(StringId id)
+{
+	static const std::string empty;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	std::unordered_map<StringId, std::string>::iterator existing = strings.find(id);
+	return existing != strings.end() ? existing->second : empty;
+}
+
+#pragma endregion
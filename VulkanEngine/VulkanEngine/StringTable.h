@@ -0,0 +1,47 @@
+#pragma once
+#include "pch.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "StringId.h"
+
+class StringTable
+{
+private:
+	static StringTable* instance;
+
+	//The string behind every interned ID, references to the strings stay valid as more are added
+	std::unordered_map<StringId, std::string> strings;
+	std::mutex mutex;
+
+public:
+#pragma region Singleton
+
+	/// <summary>
+	/// Returns the singleton instance of the string table
+	/// </summary>
+	/// <returns>The singleton instance</returns>
+	static StringTable* GetInstance();
+
+#pragma endregion
+
+#pragma region Interning
+
+	/// <summary>
+	/// Returns the ID of a string and remembers the string so it can be looked up from the ID.
+	/// Throws if a different string was interned with the same ID
+	/// </summary>
+	/// <param name="string">The string to intern</param>
+	/// <returns>The string's ID</returns>
+	StringId Intern(const std::string& string);
+
+	/// <summary>
+	/// Returns the string an ID was interned from
+	/// </summary>
+	/// <param name="id">The ID to look up</param>
+	/// <returns>The string, empty if the ID was never interned</returns>
+	const std::string& GetString(StringId id);
+
+#pragma endregion
+};
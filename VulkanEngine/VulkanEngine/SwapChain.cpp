@@ -4,10 +4,11 @@
 #include "VulkanManager.h"
 #include "DebugManager.h"
 #include "EntityManager.h"
-#include "GameManager.h"
+#include "EntityRegistry.h"
 #include "WindowManager.h"
 #include "Camera.h"
 #include "GuiManager.h"
+#include "UploadManager.h"
 
 #define logicalDevice VulkanManager::GetInstance()->GetLogicalDevice()
 #define physicalDevice VulkanManager::GetInstance()->GetPhysicalDevice()
@@ -39,7 +40,7 @@ VkRenderPass SwapChain::GetRenderPass()
 	return renderPass;
 }
 
-std::vector<Buffer> SwapChain::GetUniformBuffers()
+const std::vector<Buffer>& SwapChain::GetUniformBuffers()
 {
 	return uniformBuffers;
 }
@@ -49,17 +50,17 @@ Image SwapChain::GetDepthImage()
 	return depthImage;
 }
 
-std::vector<VkImage> SwapChain::GetImages()
+const std::vector<VkImage>& SwapChain::GetImages()
 {
 	return images;
 }
 
-std::vector<VkImageView> SwapChain::GetImageViews()
+const std::vector<VkImageView>& SwapChain::GetImageViews()
 {
 	return imageViews;
 }
 
-std::vector<VkFramebuffer> SwapChain::GetFrameBuffers()
+const std::vector<VkFramebuffer>& SwapChain::GetFrameBuffers()
 {
 	return frameBuffers;
 }
@@ -84,7 +85,7 @@ VkCommandPool SwapChain::GetCommandPool()
 	return commandPool;
 }
 
-std::vector<VkCommandBuffer> SwapChain::GetCommandBuffers()
+const std::vector<VkCommandBuffer>& SwapChain::GetCommandBuffers()
 {
 	return commandBuffers;
 }
@@ -94,6 +95,10 @@ VkCommandBuffer* SwapChain::GetCommandBuffer(uint32_t index)
 	return &commandBuffers[index];
 }
 
+uint32_t SwapChain::GetCurrentFrame()
+{
+	return static_cast<uint32_t>(currentFrame);
+}
 
 #pragma endregion
 
@@ -134,6 +139,9 @@ void SwapChain::CreateSwapChainResources()
 	//Setup Meshes and Materials
 	EntityManager::GetInstance()->CreateMeshResources();
 
+	//Every texture and mesh upload was recorded into one batch, submit it without waiting on it
+	UploadManager::GetInstance()->Submit();
+
 	//Create the Command Buffers
 	CreateCommandBuffers();
 
@@ -212,8 +220,9 @@ void SwapChain::RecreateSwapChain()
 		glfwWaitEvents();
 	}
 
-	//Wait for the device to finish any current processes
-	vkDeviceWaitIdle(logicalDevice);
+	//Wait for the device to finish any current processes, including uploads that are still recording
+	UploadManager::GetInstance()->Submit();
+	VulkanManager::GetInstance()->WaitIdle();
 
 	//Cleanup resources
 	Cleanup();
@@ -233,6 +242,7 @@ void SwapChain::RecreateSwapChain()
 
 	//Re-create materials
 	EntityManager::GetInstance()->CreateMaterialResources();
+	UploadManager::GetInstance()->Submit();
 
 	CreateCommandBuffers();
 }
@@ -247,6 +257,8 @@ void SwapChain::Cleanup()
 
 	//Free Command Buffers
 	vkFreeCommandBuffers(logicalDevice, commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+	EntityManager::GetInstance()->FreeDrawCommands();
+
 	//Cleanup Materials
 	EntityManager::GetInstance()->CleanupMaterials();
 
@@ -505,26 +517,28 @@ void SwapChain::UpdateUniformBuffer(uint32_t imageIndex)
 	ubo.projection = Camera::GetMainCamera()->GetProjection();
 	ubo.cameraPosition = Camera::GetMainCamera()->GetTransform()->GetPosition();
 
-	std::vector<std::shared_ptr<Light>> lights = GameManager::GetInstance()->GetLights();
+	std::vector<Light>& lights = EntityRegistry::GetInstance()->GetPool<Light>().GetComponents();
 	for (int i = 0; i < lights.size(); i++) {
 		if (i >= 5) {
 			break;
 		}
 
-		ubo.lights[i] = *lights[i];
+		ubo.lights[i] = lights[i];
 	}
 
 
-	void* data;
-	vkMapMemory(logicalDevice, uniformBuffers[imageIndex].GetBufferMemory(), 0, sizeof(ubo), 0, &data);
-	memcpy(data, &ubo, sizeof(ubo));
-	vkUnmapMemory(logicalDevice, uniformBuffers[imageIndex].GetBufferMemory());
+	memcpy(uniformBuffers[imageIndex].GetMappedData(), &ubo, sizeof(ubo));
 }
 
-uint32_t SwapChain::BeginDraw()
+void SwapChain::WaitForFrame()
 {
-	//Wait for the fence to finish
 	vkWaitForFences(logicalDevice, 1, &inFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
+}
+
+uint32_t SwapChain::BeginDraw()
+{
+	//Wait for the fence to finish, returns immediately if WaitForFrame was already called this frame
+	WaitForFrame();
 
 	//Find the index of the next image
 	uint32_t imageIndex;
@@ -538,6 +552,11 @@ uint32_t SwapChain::BeginDraw()
 		throw std::runtime_error("Failed to aquire next swap chain image!");
 	}
 
+	//Make sure the image is not already in use before its uniform buffer and command buffer are overwritten
+	if (imagesInFlight[imageIndex] != VK_NULL_HANDLE) {
+		vkWaitForFences(logicalDevice, 1, &imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
+	}
+
 	//Update uniform buffers
 	UpdateUniformBuffer(imageIndex);
 
@@ -575,11 +594,6 @@ void SwapChain::EndDraw(uint32_t imageIndex)
 	submitInfo.signalSemaphoreCount = 1;
 	submitInfo.pSignalSemaphores = signalSemaphores;
 
-	//Make sure the image is not already in use before submitting it
-	if (imagesInFlight[imageIndex] != VK_NULL_HANDLE) {
-		vkWaitForFences(logicalDevice, 1, &imagesInFlight[imageIndex], VK_TRUE, UINT64_MAX);
-	}
-
 	//Reset fence
 	vkResetFences(logicalDevice, 1, &inFlightFences[currentFrame]);
 	if (vkQueueSubmit(VulkanManager::GetInstance()->GetGraphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) { //stops here VK_DEVICE_LOST
@@ -7,8 +7,6 @@
 class SwapChain
 {
 private:
-	const int MAX_FRAMES_IN_FLIGHT = 2;
-
 	static SwapChain* instance;
 
 	std::vector<VkSemaphore> imageAvailableSemaphores;
@@ -36,6 +34,7 @@ private:
 	Image depthImage;
 
 public:
+	static const int MAX_FRAMES_IN_FLIGHT = 2;
 
 #pragma region Singleton
 
@@ -65,7 +64,7 @@ public:
 	/// Returns the list of uniform buffers storing current camera position
 	/// </summary>
 	/// <returns>Buffer vector of the uniform buffers</returns>
-	std::vector<Buffer> GetUniformBuffers();
+	const std::vector<Buffer>& GetUniformBuffers();
 
 	/// <summary>
 	/// Returns the depth image
@@ -77,19 +76,19 @@ public:
 	/// Returns the list of swap chain images
 	/// </summary>
 	/// <returns>VkImage vector of the images used by the swap chain</returns>
-	std::vector<VkImage> GetImages();
+	const std::vector<VkImage>& GetImages();
 
 	/// <summary>
 	/// Returns the vector of swap chain image views
 	/// </summary>
 	/// <returns>VkImageView vector of the image views used by the swap chain</returns>
-	std::vector<VkImageView> GetImageViews();
+	const std::vector<VkImageView>& GetImageViews();
 
 	/// <summary>
 	/// Returns the frame buffers used by the swap chain
 	/// </summary>
 	/// <returns>VkFrameBuffer vector of the frame buffers used by the swap chain</returns>
-	std::vector<VkFramebuffer> GetFrameBuffers();
+	const std::vector<VkFramebuffer>& GetFrameBuffers();
 
 	/// <summary>
 	/// Returns the image format used by the swap chain
@@ -119,7 +118,7 @@ public:
 	/// Returns the list of command buffers used by the swap chain
 	/// </summary>
 	/// <returns>The list of command buffers</returns>
-	std::vector<VkCommandBuffer> GetCommandBuffers();
+	const std::vector<VkCommandBuffer>& GetCommandBuffers();
 
 	/// <summary>
 	/// Returns the command buffer at the specified index
@@ -130,6 +129,12 @@ public:
 
 	VkCommandBuffer* GetGuiCommandBuffer(uint32_t index);
 
+	/// <summary>
+	/// Returns the index of the frame in flight that is currently being prepared
+	/// </summary>
+	/// <returns>The current frame index, less than MAX_FRAMES_IN_FLIGHT</returns>
+	uint32_t GetCurrentFrame();
+
 #pragma endregion
 
 #pragma region Memory Management
@@ -210,6 +215,11 @@ public:
 	/// <param name="imageIndex">The index of the next image in the swap chain</param>
 	void UpdateUniformBuffer(uint32_t imageIndex);
 
+	/// <summary>
+	/// Waits until the GPU has finished with the resources of the current frame in flight so they can be written to
+	/// </summary>
+	void WaitForFrame();
+
 	/// <summary>
 	/// Begins drawing the current frame
 	/// </summary>
@@ -0,0 +1,135 @@
+#include "pch.h"
+#include "SweepAndPrune.h"
+
+#include <numeric>
+
+#pragma region Pair Finding
+
+void SweepAndPrune::FindPairs(const std::vector<AABB>& bounds, const std::vector<CollisionFilter>& filters, std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+
+	//Changing axis or proxy count invalidates last update's order
+	int newAxis = ChooseAxis(bounds);
+	bool fullSort = newAxis != axis || order.size() != bounds.size();
+	axis = newAxis;
+	SortProxies(bounds, fullSort);
+
+	uint32_t count = static_cast<uint32_t>(order.size());
+	sortedBounds.resize(count);
+	sortedFilters.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		sortedBounds[i] = bounds[order[i]];
+		sortedFilters[i] = filters[order[i]];
+	}
+
+	//Only proxies that start before this one ends can overlap it on the sweep axis
+	for (uint32_t i = 0; i < count; i++) {
+		const AABB& boundsA = sortedBounds[i];
+		float end = boundsA.max[axis];
+
+		for (uint32_t j = i + 1; j < count && sortedBounds[j].min[axis] <= end; j++) {
+			if (sortedFilters[i].CanCollide(sortedFilters[j]) && boundsA.Overlaps(sortedBounds[j])) {
+				uint32_t a = order[i];
+				uint32_t b = order[j];
+				pairs.push_back({ std::min(a, b), std::max(a, b) });
+			}
+		}
+	}
+}
+
+int SweepAndPrune::ChooseAxis(const std::vector<AABB>& bounds)
+{
+	if (bounds.empty()) {
+		return axis;
+	}
+
+	glm::vec3 sum = glm::vec3(0.0f);
+	glm::vec3 sumSquared = glm::vec3(0.0f);
+	for (const AABB& box : bounds) {
+		glm::vec3 center = (box.min + box.max) * 0.5f;
+		sum += center;
+		sumSquared += center * center;
+	}
+
+	glm::vec3 variance = sumSquared / static_cast<float>(bounds.size()) - (sum * sum) / static_cast<float>(bounds.size() * bounds.size());
+
+	//Only switch when another axis is clearly better so the sort order stays coherent between updates
+	int bestAxis = axis;
+	for (int i = 0; i < 3; i++) {
+		if (variance[i] > variance[bestAxis] * 1.5f) {
+			bestAxis = i;
+		}
+	}
+
+	return bestAxis;
+}
+
+void SweepAndPrune::SortProxies(const std::vector<AABB>& bounds, bool fullSort)
+{
+	uint32_t count = static_cast<uint32_t>(bounds.size());
+	int sortAxis = axis;
+	auto compare = [&bounds, sortAxis](uint32_t a, uint32_t b) { return bounds[a].min[sortAxis] < bounds[b].min[sortAxis]; };
+
+	if (fullSort) {
+		order.resize(count);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), compare);
+		return;
+	}
+
+	//Insertion sort is close to linear on last update's order, but give up if things moved too much since then
+	size_t shiftBudget = static_cast<size_t>(count) * 4;
+	size_t shifts = 0;
+	for (uint32_t i = 1; i < count; i++) {
+		uint32_t proxy = order[i];
+
+		uint32_t j = i;
+		while (j > 0 && compare(proxy, order[j - 1])) {
+			order[j] = order[j - 1];
+			j--;
+			shifts++;
+		}
+		order[j] = proxy;
+
+		if (shifts > shiftBudget) {
+			std::sort(order.begin(), order.end(), compare);
+			return;
+		}
+	}
+}
+
+#pragma endregion
+
+#pragma region Queries
+
+void SweepAndPrune::QueryBounds(const std::vector<AABB>& bounds, const AABB& query, std::vector<uint32_t>& proxies) const
+{
+	proxies.clear();
+
+	uint32_t count = static_cast<uint32_t>(sortedBounds.size());
+	for (uint32_t i = 0; i < count && sortedBounds[i].min[axis] <= query.max[axis]; i++) {
+		if (sortedBounds[i].Overlaps(query)) {
+			proxies.push_back(order[i]);
+		}
+	}
+}
+
+void SweepAndPrune::QueryRay(const std::vector<AABB>& bounds, glm::vec3 origin, glm::vec3 direction, float maxDistance, float radius, const std::function<float(uint32_t)>& visit) const
+{
+	glm::vec3 inverseDirection = 1.0f / direction;
+	uint32_t count = static_cast<uint32_t>(sortedBounds.size());
+
+	//Nothing that starts past the furthest point the ray or swept sphere gets to on the sweep axis can be hit
+	for (uint32_t i = 0; i < count && sortedBounds[i].min[axis] <= origin[axis] + std::max(direction[axis], 0.0f) * maxDistance + radius; i++) {
+		AABB grown = { sortedBounds[i].min - radius, sortedBounds[i].max + radius };
+		float start = 0.0f;
+		float end = maxDistance;
+
+		if (grown.ClipRay(origin, inverseDirection, start, end)) {
+			maxDistance = std::min(maxDistance, visit(order[i]));
+		}
+	}
+}
+
+#pragma endregion
\ No newline at end of file
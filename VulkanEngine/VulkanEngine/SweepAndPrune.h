@@ -0,0 +1,68 @@
+#pragma once
+
+#include "pch.h"
+#include "Broadphase.h"
+
+class SweepAndPrune : public Broadphase
+{
+private:
+	//The axis proxies are sorted along, picked each update as the axis the proxies are most spread out on
+	int axis = 0;
+
+	//Proxy indices sorted by the minimum of their bounds on the sweep axis, kept between updates since objects barely move from one frame to the next
+	std::vector<uint32_t> order;
+
+	//Bounds and filters in sorted order so the sweep reads memory linearly
+	std::vector<AABB> sortedBounds;
+	std::vector<CollisionFilter> sortedFilters;
+
+	/// <summary>
+	/// Returns the axis with the largest variance in proxy centers
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <returns>The index of the axis to sweep along</returns>
+	int ChooseAxis(const std::vector<AABB>& bounds);
+
+	/// <summary>
+	/// Re-sorts the proxy order by the minimum of each proxy's bounds on the sweep axis
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="fullSort">Whether to sort from scratch rather than starting from the previous order</param>
+	void SortProxies(const std::vector<AABB>& bounds, bool fullSort);
+
+public:
+#pragma region Pair Finding
+
+	/// <summary>
+	/// Sorts the proxies along one axis and only tests proxies whose ranges on that axis overlap
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="filters">The collision filter of each proxy</param>
+	/// <param name="pairs">Filled with the candidate pairs</param>
+	void FindPairs(const std::vector<AABB>& bounds, const std::vector<CollisionFilter>& filters, std::vector<CollisionPair>& pairs) override;
+
+#pragma endregion
+
+#pragma region Queries
+
+	/// <summary>
+	/// Scans the sorted proxies until they start past the end of the box on the sweep axis
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="query">The box to look in</param>
+	/// <param name="proxies">Filled with the overlapping proxies</param>
+	void QueryBounds(const std::vector<AABB>& bounds, const AABB& query, std::vector<uint32_t>& proxies) const override;
+
+	/// <summary>
+	/// Scans the sorted proxies until they start past the furthest point the ray reaches on the sweep axis
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="origin">The start of the ray</param>
+	/// <param name="direction">The normalized direction of the ray</param>
+	/// <param name="maxDistance">How far the ray reaches</param>
+	/// <param name="radius">The radius of the swept sphere, zero for a thin ray</param>
+	/// <param name="visit">Called for each proxy the ray passes through, returns how far the ray should reach from then on</param>
+	void QueryRay(const std::vector<AABB>& bounds, glm::vec3 origin, glm::vec3 direction, float maxDistance, float radius, const std::function<float(uint32_t)>& visit) const override;
+
+#pragma endregion
+};
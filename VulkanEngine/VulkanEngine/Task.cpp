@@ -0,0 +1,20 @@
+#include "pch.h"
+#include "Task.h"
+
+#pragma region Constructor
+
+Task::Task(std::function<void()> work)
+{
+	this->work = work;
+}
+
+#pragma endregion
+
+#pragma region Accessors
+
+bool Task::IsFinished()
+{
+	return finished.load();
+}
+
+#pragma endregion
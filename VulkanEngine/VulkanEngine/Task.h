@@ -0,0 +1,37 @@
+#pragma once
+#include "pch.h"
+
+#include <atomic>
+#include <mutex>
+
+class Task
+{
+	friend class JobSystem;
+
+private:
+	std::function<void()> work;
+
+	//Starts at one so the task can't run before it is scheduled, each unfinished dependency adds one more
+	std::atomic<uint32_t> dependencyCount{ 1 };
+	std::atomic<bool> finished{ false };
+
+	std::mutex continuationMutex;
+	std::vector<std::shared_ptr<Task>> continuations;
+
+public:
+#pragma region Constructor
+
+	Task(std::function<void()> work);
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns whether or not the task has finished running
+	/// </summary>
+	/// <returns>True if the task's work has completed</returns>
+	bool IsFinished();
+
+#pragma endregion
+};
@@ -9,6 +9,8 @@
 #include "stb/stb_image.h"
 
 #include "Buffer.h"
+#include "MemoryAllocator.h"
+#include "UploadManager.h"
 
 void TextureImages::LoadAll() {
 	LoadTexture("textures/room.jpg");
@@ -28,24 +30,16 @@ void TextureImages::LoadTexture(const std::string texturePath) {
 
 	if (!pixels) { throw std::runtime_error("failed to load texture image!"); }
 
-	Buffer stagingBuffer;
-
-	Buffer::CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer);
-
-	void* data;
-	vkMapMemory(VulkanManager::GetInstance()->GetLogicalDevice(), stagingBuffer.GetBufferMemory(), 0, imageSize, 0, &data);
-	memcpy(data, pixels, static_cast<size_t>(imageSize));
-	vkUnmapMemory(VulkanManager::GetInstance()->GetLogicalDevice(), stagingBuffer.GetBufferMemory());
+	//Stage before recording anything since running out of staging space can submit the current batch
+	VkDeviceSize stagingOffset;
+	VkBuffer stagingBuffer = UploadManager::GetInstance()->StageData(pixels, imageSize, stagingOffset);
 	stbi_image_free(pixels);
 
 
 	Image::CreateImage(mipLevels, texWidth, texHeight, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage); 		//transitionImageLayout(textureImage, VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 	Image::TransitionImageLayout(textureImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels);
 
-	Image::CopyBufferToImage(stagingBuffer.GetBuffer(), textureImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight));
-	textureImageMemory = *textureImage.GetMemory();
-	vkDestroyBuffer(VulkanManager::GetInstance()->GetLogicalDevice(), stagingBuffer.GetBuffer(), nullptr);
-	vkFreeMemory(VulkanManager::GetInstance()->GetLogicalDevice(), stagingBuffer.GetBufferMemory(), nullptr);
+	Image::CopyBufferToImage(stagingBuffer, textureImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, stagingOffset);
 	GenerateMipmaps(*textureImage.GetImage(), VK_FORMAT_R8G8B8A8_SRGB, texWidth, texHeight, mipLevels);
 
 }
@@ -82,20 +76,16 @@ void TextureImages::LoadCubeMap(const std::string texturePath)
 		if (!pixels[i]) { throw std::runtime_error("failed to load texture image! hhhh"); }
 	}
 
-	Buffer stagingBuffer;
-
-	Buffer::CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer);
-
-	void *data;
+	//Stage before recording anything since running out of staging space can submit the current batch
+	VkBuffer stagingBuffer;
+	VkDeviceSize stagingOffset;
+	void *data = UploadManager::GetInstance()->AllocateStaging(imageSize, stagingBuffer, stagingOffset);
 	// void* dataOffset = &data + layerSize;
-	//VkResult res = 
-	vkMapMemory(VulkanManager::GetInstance()->GetLogicalDevice(), stagingBuffer.GetBufferMemory(), 0, imageSize, 0, &data);
 	for (uint8_t i = 0; i < 6; ++i) {
 		// since an int is 32-bit, we need to divide layerSize by 4 to get the number of bytes as our offset
 		memcpy(static_cast<int*>(data) + (layerSize / 4) * i, pixels[i], static_cast<size_t>(layerSize));
 		// break;
 	}
-	vkUnmapMemory(VulkanManager::GetInstance()->GetLogicalDevice(), stagingBuffer.GetBufferMemory());
 	stbi_image_free(pixel);
 	for (size_t i = 0; i < 6; ++i) {
 		stbi_image_free(pixels[i]);
@@ -104,10 +94,7 @@ void TextureImages::LoadCubeMap(const std::string texturePath)
 
 	Image::CreateImage(mipLevels, texWidth, texHeight, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, 6);  
 	Image::TransitionImageLayout(textureImage, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, mipLevels, 6);
-	Image::CopyBufferToImage(stagingBuffer.GetBuffer(), textureImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), 6);
-	textureImageMemory = *textureImage.GetMemory();
-	vkDestroyBuffer(VulkanManager::GetInstance()->GetLogicalDevice(), stagingBuffer.GetBuffer(), nullptr);
-	vkFreeMemory(VulkanManager::GetInstance()->GetLogicalDevice(), stagingBuffer.GetBufferMemory(), nullptr);
+	Image::CopyBufferToImage(stagingBuffer, textureImage, static_cast<uint32_t>(texWidth), static_cast<uint32_t>(texHeight), 6, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, stagingOffset);
 	GenerateMipmaps(*textureImage.GetImage(), VK_FORMAT_R8G8B8A8_SRGB, texWidth, texHeight, mipLevels, 6);
 
 }
@@ -121,7 +108,7 @@ void TextureImages::GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t
 		throw std::runtime_error("texture image format does not support linear blitting!");
 	}
 
-	VkCommandBuffer commandBuffer = CommandBuffer::BeginSingleTimeCommand();
+	VkCommandBuffer commandBuffer = UploadManager::GetInstance()->GetCommandBuffer();
 
 	VkImageMemoryBarrier barrier{};
 	barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -196,8 +183,6 @@ void TextureImages::GenerateMipmaps(VkImage image, VkFormat imageFormat, int32_t
 		0, nullptr,
 		1, &barrier);
 
-	CommandBuffer::EndSingleTimeCommand(commandBuffer);
-
 }
 void TextureImages::CreateTextureSampler() {
 	VkSamplerCreateInfo samplerInfo{};
@@ -230,7 +215,7 @@ void TextureImages::Cleanup() {
 
 	vkDestroyImage(VulkanManager::GetInstance()->GetLogicalDevice(), *textureImage.GetImage(), nullptr);
 	vkDestroyImageView(VulkanManager::GetInstance()->GetLogicalDevice(), textureImageView, nullptr);
-	vkFreeMemory(VulkanManager::GetInstance()->GetLogicalDevice(), textureImageMemory, nullptr);
+	MemoryAllocator::GetInstance()->Free(*textureImage.GetAllocation());
 }
 
 void TextureImages::CreateTextureImageView() {
@@ -255,7 +240,7 @@ VkImage TextureImages::TextureImageImage() {
 
 VkDeviceMemory TextureImages::TextureImageMemory() {
 	
-	return textureImageMemory;
+	return textureImage.GetAllocation()->memory;
 }
 VkSampler TextureImages::GetSampler() {
 	return textureSampler;
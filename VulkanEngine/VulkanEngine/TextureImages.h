@@ -10,7 +10,6 @@ private:
 	VkDeviceMemory memory;
 	VkImageView textureImageView;
 	Image textureImage;
-	VkDeviceMemory textureImageMemory;
 
 	uint32_t mipLevels;
 	VkSampler textureSampler;
@@ -16,7 +16,12 @@ Transform::Transform(glm::vec3 postition, glm::quat orientation, glm::vec3 scale
 	//Generate model matrix
 	model = {};
 	isDirty = true;
+	version = 0;
 	GenerateModelMatrix();
+
+	world = model;
+	hasParent = false;
+	sceneNode = UINT32_MAX;
 }
 
 #pragma endregion
@@ -34,6 +39,7 @@ void Transform::SetPosition(glm::vec3 value)
 
 	//Mark model matrix for regeneration
 	isDirty = true;
+	version++;
 }
 
 glm::quat Transform::GetOrientation()
@@ -47,6 +53,7 @@ void Transform::SetOrientation(glm::quat value)
 
 	//Mark the model matrix for regeneration
 	isDirty = true;
+	version++;
 }
 
 void Transform::SetOrientation(glm::vec3 value, bool degrees)
@@ -59,6 +66,7 @@ void Transform::SetOrientation(glm::vec3 value, bool degrees)
 
 	//Mark the model matrix for regeneration
 	isDirty = true;
+	version++;
 }
 
 glm::vec3 Transform::GetScale()
@@ -72,6 +80,7 @@ void Transform::SetScale(glm::vec3 value)
 
 	//Mark the model matrix for regeneration
 	isDirty = true;
+	version++;
 }
 
 glm::mat4 Transform::GetModelMatrix()
@@ -84,6 +93,26 @@ glm::mat4 Transform::GetModelMatrix()
 	return model;
 }
 
+glm::mat4 Transform::GetWorldMatrix()
+{
+	//Transforms without a parent are already in world space
+	if (!hasParent) {
+		return GetModelMatrix();
+	}
+
+	return world;
+}
+
+bool Transform::HasParent()
+{
+	return hasParent;
+}
+
+uint32_t Transform::GetVersion()
+{
+	return version;
+}
+
 #pragma endregion
 
 #pragma region Transformations
@@ -100,6 +129,7 @@ void Transform::Translate(glm::vec3 translation, bool localSpace)
 
 	//Mark the model matrix for regeneration
 	isDirty = true;
+	version++;
 }
 
 void Transform::Rotate(glm::quat rotation)
@@ -108,6 +138,7 @@ void Transform::Rotate(glm::quat rotation)
 
 	//Mark the model matrix for regeneration
 	isDirty = true;
+	version++;
 }
 
 void Transform::Rotate(glm::vec3 eulerRotation, bool degrees)
@@ -127,6 +158,10 @@ void Transform::LookAt(glm::vec3 target, glm::vec3 up)
 	glm::vec3 direction = glm::normalize(position - target);
 
 	orientation = glm::quatLookAt(direction, up);
+
+	//Mark the model matrix for regeneration
+	isDirty = true;
+	version++;
 }
 
 #pragma endregion
@@ -135,9 +170,13 @@ void Transform::LookAt(glm::vec3 target, glm::vec3 up)
 
 void Transform::DrawHandles()
 {
-	DebugManager::GetInstance()->DrawLine(position, position + orientation * glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), 0.0f);
-	DebugManager::GetInstance()->DrawLine(position, position + orientation * glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 0.0f);
-	DebugManager::GetInstance()->DrawLine(position, position + orientation * glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, 1.0f), 0.0f);
+	//Drawn in world space so children show where they are after their parents move them
+	glm::mat4 matrix = GetWorldMatrix();
+	glm::vec3 origin = glm::vec3(matrix[3]);
+
+	DebugManager::GetInstance()->DrawLine(origin, origin + glm::normalize(glm::vec3(matrix[0])), glm::vec3(1.0f, 0.0f, 0.0f), 0.0f);
+	DebugManager::GetInstance()->DrawLine(origin, origin + glm::normalize(glm::vec3(matrix[1])), glm::vec3(0.0f, 1.0f, 0.0f), 0.0f);
+	DebugManager::GetInstance()->DrawLine(origin, origin + glm::normalize(glm::vec3(matrix[2])), glm::vec3(0.0f, 0.0f, 1.0f), 0.0f);
 }
 
 #pragma endregion
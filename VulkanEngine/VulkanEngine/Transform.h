@@ -12,6 +12,14 @@ private:
 
 	glm::mat4 model;
 	bool isDirty; //Keeps track of whether position rotation or scale have changed to know when to regenerate the model matrix
+	uint32_t version; //Incremented whenever the transform changes so other systems can tell if it changed since they last looked
+
+	//World matrix cached by the scene graph for transforms with a parent, and the transform's node in the scene graph
+	glm::mat4 world;
+	bool hasParent;
+	uint32_t sceneNode;
+
+	friend class SceneGraph;
 
 #pragma region Model Matrix
 
@@ -84,6 +92,24 @@ public:
 	/// <returns>The updated mat4 model matrix</returns>
 	glm::mat4 GetModelMatrix();
 
+	/// <summary>
+	/// Returns the transform's matrix in world space, the model matrix combined with every parent's as of the latest scene graph update
+	/// </summary>
+	/// <returns>The world matrix</returns>
+	glm::mat4 GetWorldMatrix();
+
+	/// <summary>
+	/// Returns whether the transform is attached to a parent in the scene graph, its position, orientation and scale are then relative to the parent
+	/// </summary>
+	/// <returns>True if the transform has a parent</returns>
+	bool HasParent();
+
+	/// <summary>
+	/// Returns a counter that changes every time the position, orientation or scale changes, or the world matrix changes because a parent moved
+	/// </summary>
+	/// <returns>The transform's version</returns>
+	uint32_t GetVersion();
+
 #pragma endregion
 
 #pragma region Transformations
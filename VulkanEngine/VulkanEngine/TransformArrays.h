@@ -0,0 +1,17 @@
+#pragma once
+#include "pch.h"
+
+struct TransformArrays {
+public:
+	//Pointers to the position, orientation and scale of a batch of transforms stored one component per array
+	const float* positionX = nullptr;
+	const float* positionY = nullptr;
+	const float* positionZ = nullptr;
+	const float* orientationX = nullptr;
+	const float* orientationY = nullptr;
+	const float* orientationZ = nullptr;
+	const float* orientationW = nullptr;
+	const float* scaleX = nullptr;
+	const float* scaleY = nullptr;
+	const float* scaleZ = nullptr;
+};
@@ -0,0 +1,10 @@
+#pragma once
+#include "pch.h"
+
+#include "Transform.h"
+
+struct TransformComponent {
+public:
+	//Shared with the meshes, physics world and scene graph, which all keep the transform itself
+	std::shared_ptr<Transform> transform;
+};
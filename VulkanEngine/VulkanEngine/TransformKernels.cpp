@@ -0,0 +1,398 @@
+#include "pch.h"
+#include "TransformKernels.h"
+
+#include "JobSystem.h"
+#include "PhysicsKernels.h"
+
+#include <immintrin.h>
+
+//MSVC lets any function use AVX2 intrinsics, GCC and Clang need the function to be marked
+#if defined(_MSC_VER)
+#define TARGET_AVX2
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+//Number of transforms each thread claims at a time when a batch is split across threads
+static const uint32_t TRANSFORM_BATCH_SIZE = 2048;
+
+#pragma region Helper Methods
+
+/// <summary>
+/// Computes the first three columns of a transform's model matrix, the rotation scaled along each axis.
+/// Uses the same operations in the same order as glm::toMat4 so the results match Transform::GetModelMatrix exactly
+/// </summary>
+/// <param name="transforms">The transforms' component arrays</param>
+/// <param name="i">The index of the transform</param>
+/// <param name="columns">Filled with the x, y and z of each column in turn</param>
+static void ComputeColumns(const TransformArrays& transforms, uint32_t i, float* columns)
+{
+	float x = transforms.orientationX[i];
+	float y = transforms.orientationY[i];
+	float z = transforms.orientationZ[i];
+	float w = transforms.orientationW[i];
+
+	float xx = x * x;
+	float yy = y * y;
+	float zz = z * z;
+	float xz = x * z;
+	float xy = x * y;
+	float yz = y * z;
+	float wx = w * x;
+	float wy = w * y;
+	float wz = w * z;
+
+	float scaleX = transforms.scaleX[i];
+	float scaleY = transforms.scaleY[i];
+	float scaleZ = transforms.scaleZ[i];
+
+	columns[0] = (1.0f - 2.0f * (yy + zz)) * scaleX;
+	columns[1] = (2.0f * (xy + wz)) * scaleX;
+	columns[2] = (2.0f * (xz - wy)) * scaleX;
+	columns[3] = (2.0f * (xy - wz)) * scaleY;
+	columns[4] = (1.0f - 2.0f * (xx + zz)) * scaleY;
+	columns[5] = (2.0f * (yz + wx)) * scaleY;
+	columns[6] = (2.0f * (xz + wy)) * scaleZ;
+	columns[7] = (2.0f * (yz - wx)) * scaleZ;
+	columns[8] = (1.0f - 2.0f * (xx + yy)) * scaleZ;
+}
+
+/// <summary>
+/// Computes the first three columns of 4 transforms' model matrices with SSE, same layout as ComputeColumns with one transform per lane
+/// </summary>
+static void ComputeColumnsSSE(const TransformArrays& transforms, uint32_t i, __m128* columns)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+
+	__m128 x = _mm_loadu_ps(transforms.orientationX + i);
+	__m128 y = _mm_loadu_ps(transforms.orientationY + i);
+	__m128 z = _mm_loadu_ps(transforms.orientationZ + i);
+	__m128 w = _mm_loadu_ps(transforms.orientationW + i);
+
+	__m128 xx = _mm_mul_ps(x, x);
+	__m128 yy = _mm_mul_ps(y, y);
+	__m128 zz = _mm_mul_ps(z, z);
+	__m128 xz = _mm_mul_ps(x, z);
+	__m128 xy = _mm_mul_ps(x, y);
+	__m128 yz = _mm_mul_ps(y, z);
+	__m128 wx = _mm_mul_ps(w, x);
+	__m128 wy = _mm_mul_ps(w, y);
+	__m128 wz = _mm_mul_ps(w, z);
+
+	__m128 scaleX = _mm_loadu_ps(transforms.scaleX + i);
+	__m128 scaleY = _mm_loadu_ps(transforms.scaleY + i);
+	__m128 scaleZ = _mm_loadu_ps(transforms.scaleZ + i);
+
+	columns[0] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), scaleX);
+	columns[1] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), scaleX);
+	columns[2] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), scaleX);
+	columns[3] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), scaleY);
+	columns[4] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), scaleY);
+	columns[5] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), scaleY);
+	columns[6] = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), scaleZ);
+	columns[7] = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), scaleZ);
+	columns[8] = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), scaleZ);
+}
+
+/// <summary>
+/// Computes the first three columns of 8 transforms' model matrices with AVX2, same layout as ComputeColumns with one transform per lane
+/// </summary>
+TARGET_AVX2 static void ComputeColumnsAVX2(const TransformArrays& transforms, uint32_t i, __m256* columns)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 two = _mm256_set1_ps(2.0f);
+
+	__m256 x = _mm256_loadu_ps(transforms.orientationX + i);
+	__m256 y = _mm256_loadu_ps(transforms.orientationY + i);
+	__m256 z = _mm256_loadu_ps(transforms.orientationZ + i);
+	__m256 w = _mm256_loadu_ps(transforms.orientationW + i);
+
+	__m256 xx = _mm256_mul_ps(x, x);
+	__m256 yy = _mm256_mul_ps(y, y);
+	__m256 zz = _mm256_mul_ps(z, z);
+	__m256 xz = _mm256_mul_ps(x, z);
+	__m256 xy = _mm256_mul_ps(x, y);
+	__m256 yz = _mm256_mul_ps(y, z);
+	__m256 wx = _mm256_mul_ps(w, x);
+	__m256 wy = _mm256_mul_ps(w, y);
+	__m256 wz = _mm256_mul_ps(w, z);
+
+	__m256 scaleX = _mm256_loadu_ps(transforms.scaleX + i);
+	__m256 scaleY = _mm256_loadu_ps(transforms.scaleY + i);
+	__m256 scaleZ = _mm256_loadu_ps(transforms.scaleZ + i);
+
+	//No fused multiply-adds so the results match the scalar kernel exactly
+	columns[0] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(yy, zz))), scaleX);
+	columns[1] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), scaleX);
+	columns[2] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), scaleX);
+	columns[3] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), scaleY);
+	columns[4] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, zz))), scaleY);
+	columns[5] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), scaleY);
+	columns[6] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), scaleZ);
+	columns[7] = _mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), scaleZ);
+	columns[8] = _mm256_mul_ps(_mm256_sub_ps(one, _mm256_mul_ps(two, _mm256_add_ps(xx, yy))), scaleZ);
+}
+
+/// <summary>
+/// Transposes 4 transforms' columns from one transform per lane to one transform per register and stores their model matrices
+/// </summary>
+static void StoreModelMatricesSSE(const __m128* columns, __m128 positionX, __m128 positionY, __m128 positionZ, TransformData* output)
+{
+	__m128 vectors[4][4];
+	for (uint32_t column = 0; column < 3; column++) {
+		vectors[column][0] = columns[column * 3];
+		vectors[column][1] = columns[column * 3 + 1];
+		vectors[column][2] = columns[column * 3 + 2];
+		vectors[column][3] = _mm_setzero_ps();
+		_MM_TRANSPOSE4_PS(vectors[column][0], vectors[column][1], vectors[column][2], vectors[column][3]);
+	}
+
+	vectors[3][0] = positionX;
+	vectors[3][1] = positionY;
+	vectors[3][2] = positionZ;
+	vectors[3][3] = _mm_set1_ps(1.0f);
+	_MM_TRANSPOSE4_PS(vectors[3][0], vectors[3][1], vectors[3][2], vectors[3][3]);
+
+	//TransformData holds the matrix a column at a time
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		_mm_storeu_ps(&output[lane].row1.x, vectors[0][lane]);
+		_mm_storeu_ps(&output[lane].row2.x, vectors[1][lane]);
+		_mm_storeu_ps(&output[lane].row3.x, vectors[2][lane]);
+		_mm_storeu_ps(&output[lane].row4.x, vectors[3][lane]);
+	}
+}
+
+/// <summary>
+/// Transposes 4 transforms' columns from one transform per lane to one transform per register and stores the top three rows of their model matrices
+/// </summary>
+static void StoreAffineMatricesSSE(const __m128* columns, __m128 positionX, __m128 positionY, __m128 positionZ, AffineTransformData* output)
+{
+	//Row i of the matrix is component i of every column followed by the position
+	__m128 positions[3] = { positionX, positionY, positionZ };
+	__m128 vectors[3][4];
+	for (uint32_t row = 0; row < 3; row++) {
+		vectors[row][0] = columns[row];
+		vectors[row][1] = columns[3 + row];
+		vectors[row][2] = columns[6 + row];
+		vectors[row][3] = positions[row];
+		_MM_TRANSPOSE4_PS(vectors[row][0], vectors[row][1], vectors[row][2], vectors[row][3]);
+	}
+
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		_mm_storeu_ps(&output[lane].row1.x, vectors[0][lane]);
+		_mm_storeu_ps(&output[lane].row2.x, vectors[1][lane]);
+		_mm_storeu_ps(&output[lane].row3.x, vectors[2][lane]);
+	}
+}
+
+/// <summary>
+/// Transposes the 4x4 block in each 128 bit half of 4 AVX registers, the AVX2 counterpart of _MM_TRANSPOSE4_PS
+/// </summary>
+TARGET_AVX2 static void Transpose4AVX2(__m256& row0, __m256& row1, __m256& row2, __m256& row3)
+{
+	__m256 low01 = _mm256_unpacklo_ps(row0, row1);
+	__m256 high01 = _mm256_unpackhi_ps(row0, row1);
+	__m256 low23 = _mm256_unpacklo_ps(row2, row3);
+	__m256 high23 = _mm256_unpackhi_ps(row2, row3);
+
+	row0 = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(1, 0, 1, 0));
+	row1 = _mm256_shuffle_ps(low01, low23, _MM_SHUFFLE(3, 2, 3, 2));
+	row2 = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(1, 0, 1, 0));
+	row3 = _mm256_shuffle_ps(high01, high23, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+/// <summary>
+/// Transposes 8 transforms' columns from one transform per lane to one transform per 128 bit half and stores their model matrices.
+/// Kept in AVX instructions throughout, mixing in the SSE helpers costs more than the wider math saves
+/// </summary>
+TARGET_AVX2 static void StoreModelMatricesAVX2(const __m256* columns, __m256 positionX, __m256 positionY, __m256 positionZ, TransformData* output)
+{
+	__m256 vectors[4][4];
+	for (uint32_t column = 0; column < 3; column++) {
+		vectors[column][0] = columns[column * 3];
+		vectors[column][1] = columns[column * 3 + 1];
+		vectors[column][2] = columns[column * 3 + 2];
+		vectors[column][3] = _mm256_setzero_ps();
+		Transpose4AVX2(vectors[column][0], vectors[column][1], vectors[column][2], vectors[column][3]);
+	}
+
+	vectors[3][0] = positionX;
+	vectors[3][1] = positionY;
+	vectors[3][2] = positionZ;
+	vectors[3][3] = _mm256_set1_ps(1.0f);
+	Transpose4AVX2(vectors[3][0], vectors[3][1], vectors[3][2], vectors[3][3]);
+
+	//The low half holds the first 4 transforms and the high half the last 4
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		_mm_storeu_ps(&output[lane].row1.x, _mm256_castps256_ps128(vectors[0][lane]));
+		_mm_storeu_ps(&output[lane].row2.x, _mm256_castps256_ps128(vectors[1][lane]));
+		_mm_storeu_ps(&output[lane].row3.x, _mm256_castps256_ps128(vectors[2][lane]));
+		_mm_storeu_ps(&output[lane].row4.x, _mm256_castps256_ps128(vectors[3][lane]));
+		_mm_storeu_ps(&output[lane + 4].row1.x, _mm256_extractf128_ps(vectors[0][lane], 1));
+		_mm_storeu_ps(&output[lane + 4].row2.x, _mm256_extractf128_ps(vectors[1][lane], 1));
+		_mm_storeu_ps(&output[lane + 4].row3.x, _mm256_extractf128_ps(vectors[2][lane], 1));
+		_mm_storeu_ps(&output[lane + 4].row4.x, _mm256_extractf128_ps(vectors[3][lane], 1));
+	}
+}
+
+/// <summary>
+/// Transposes 8 transforms' columns from one transform per lane to one transform per 128 bit half and stores the top three rows of their model matrices
+/// </summary>
+TARGET_AVX2 static void StoreAffineMatricesAVX2(const __m256* columns, __m256 positionX, __m256 positionY, __m256 positionZ, AffineTransformData* output)
+{
+	__m256 positions[3] = { positionX, positionY, positionZ };
+	__m256 vectors[3][4];
+	for (uint32_t row = 0; row < 3; row++) {
+		vectors[row][0] = columns[row];
+		vectors[row][1] = columns[3 + row];
+		vectors[row][2] = columns[6 + row];
+		vectors[row][3] = positions[row];
+		Transpose4AVX2(vectors[row][0], vectors[row][1], vectors[row][2], vectors[row][3]);
+	}
+
+	for (uint32_t lane = 0; lane < 4; lane++) {
+		_mm_storeu_ps(&output[lane].row1.x, _mm256_castps256_ps128(vectors[0][lane]));
+		_mm_storeu_ps(&output[lane].row2.x, _mm256_castps256_ps128(vectors[1][lane]));
+		_mm_storeu_ps(&output[lane].row3.x, _mm256_castps256_ps128(vectors[2][lane]));
+		_mm_storeu_ps(&output[lane + 4].row1.x, _mm256_extractf128_ps(vectors[0][lane], 1));
+		_mm_storeu_ps(&output[lane + 4].row2.x, _mm256_extractf128_ps(vectors[1][lane], 1));
+		_mm_storeu_ps(&output[lane + 4].row3.x, _mm256_extractf128_ps(vectors[2][lane], 1));
+	}
+}
+
+#pragma endregion
+
+#pragma region Model Matrices
+
+void TransformKernels::GenerateModelMatrices(const TransformArrays& transforms, uint32_t begin, uint32_t end, TransformData* output)
+{
+	switch (PhysicsKernels::GetLevel()) {
+	case SimdLevels::AVX2:
+		GenerateModelMatricesAVX2(transforms, begin, end, output);
+		break;
+	case SimdLevels::SSE:
+		GenerateModelMatricesSSE(transforms, begin, end, output);
+		break;
+	default:
+		GenerateModelMatricesScalar(transforms, begin, end, output);
+		break;
+	}
+}
+
+void TransformKernels::GenerateModelMatricesParallel(const TransformArrays& transforms, uint32_t count, TransformData* output)
+{
+	//Small batches run on the calling thread, ParallelFor doesn't queue helpers for a single range
+	uint32_t rangeCount = (count + TRANSFORM_BATCH_SIZE - 1) / TRANSFORM_BATCH_SIZE;
+	JobSystem::GetInstance()->ParallelFor(rangeCount, [&transforms, count, output](uint32_t range) {
+		uint32_t begin = range * TRANSFORM_BATCH_SIZE;
+		GenerateModelMatrices(transforms, begin, std::min(begin + TRANSFORM_BATCH_SIZE, count), output);
+	});
+}
+
+void TransformKernels::GenerateModelMatricesScalar(const TransformArrays& transforms, uint32_t begin, uint32_t end, TransformData* output)
+{
+	float columns[9];
+	for (uint32_t i = begin; i < end; i++) {
+		ComputeColumns(transforms, i, columns);
+
+		output[i].row1 = glm::vec4(columns[0], columns[1], columns[2], 0.0f);
+		output[i].row2 = glm::vec4(columns[3], columns[4], columns[5], 0.0f);
+		output[i].row3 = glm::vec4(columns[6], columns[7], columns[8], 0.0f);
+		output[i].row4 = glm::vec4(transforms.positionX[i], transforms.positionY[i], transforms.positionZ[i], 1.0f);
+	}
+}
+
+void TransformKernels::GenerateModelMatricesSSE(const TransformArrays& transforms, uint32_t begin, uint32_t end, TransformData* output)
+{
+	__m128 columns[9];
+
+	uint32_t i = begin;
+	for (; i + 4 <= end; i += 4) {
+		ComputeColumnsSSE(transforms, i, columns);
+		StoreModelMatricesSSE(columns, _mm_loadu_ps(transforms.positionX + i), _mm_loadu_ps(transforms.positionY + i), _mm_loadu_ps(transforms.positionZ + i), output + i);
+	}
+
+	GenerateModelMatricesScalar(transforms, i, end, output);
+}
+
+TARGET_AVX2 void TransformKernels::GenerateModelMatricesAVX2(const TransformArrays& transforms, uint32_t begin, uint32_t end, TransformData* output)
+{
+	__m256 columns[9];
+
+	uint32_t i = begin;
+	for (; i + 8 <= end; i += 8) {
+		ComputeColumnsAVX2(transforms, i, columns);
+		StoreModelMatricesAVX2(columns, _mm256_loadu_ps(transforms.positionX + i), _mm256_loadu_ps(transforms.positionY + i), _mm256_loadu_ps(transforms.positionZ + i), output + i);
+	}
+
+	GenerateModelMatricesScalar(transforms, i, end, output);
+}
+
+#pragma endregion
+
+#pragma region Affine Matrices
+
+void TransformKernels::GenerateAffineMatrices(const TransformArrays& transforms, uint32_t begin, uint32_t end, AffineTransformData* output)
+{
+	switch (PhysicsKernels::GetLevel()) {
+	case SimdLevels::AVX2:
+		GenerateAffineMatricesAVX2(transforms, begin, end, output);
+		break;
+	case SimdLevels::SSE:
+		GenerateAffineMatricesSSE(transforms, begin, end, output);
+		break;
+	default:
+		GenerateAffineMatricesScalar(transforms, begin, end, output);
+		break;
+	}
+}
+
+void TransformKernels::GenerateAffineMatricesParallel(const TransformArrays& transforms, uint32_t count, AffineTransformData* output)
+{
+	uint32_t rangeCount = (count + TRANSFORM_BATCH_SIZE - 1) / TRANSFORM_BATCH_SIZE;
+	JobSystem::GetInstance()->ParallelFor(rangeCount, [&transforms, count, output](uint32_t range) {
+		uint32_t begin = range * TRANSFORM_BATCH_SIZE;
+		GenerateAffineMatrices(transforms, begin, std::min(begin + TRANSFORM_BATCH_SIZE, count), output);
+	});
+}
+
+void TransformKernels::GenerateAffineMatricesScalar(const TransformArrays& transforms, uint32_t begin, uint32_t end, AffineTransformData* output)
+{
+	float columns[9];
+	for (uint32_t i = begin; i < end; i++) {
+		ComputeColumns(transforms, i, columns);
+
+		output[i].row1 = glm::vec4(columns[0], columns[3], columns[6], transforms.positionX[i]);
+		output[i].row2 = glm::vec4(columns[1], columns[4], columns[7], transforms.positionY[i]);
+		output[i].row3 = glm::vec4(columns[2], columns[5], columns[8], transforms.positionZ[i]);
+	}
+}
+
+void TransformKernels::GenerateAffineMatricesSSE(const TransformArrays& transforms, uint32_t begin, uint32_t end, AffineTransformData* output)
+{
+	__m128 columns[9];
+
+	uint32_t i = begin;
+	for (; i + 4 <= end; i += 4) {
+		ComputeColumnsSSE(transforms, i, columns);
+		StoreAffineMatricesSSE(columns, _mm_loadu_ps(transforms.positionX + i), _mm_loadu_ps(transforms.positionY + i), _mm_loadu_ps(transforms.positionZ + i), output + i);
+	}
+
+	GenerateAffineMatricesScalar(transforms, i, end, output);
+}
+
+TARGET_AVX2 void TransformKernels::GenerateAffineMatricesAVX2(const TransformArrays& transforms, uint32_t begin, uint32_t end, AffineTransformData* output)
+{
+	__m256 columns[9];
+
+	uint32_t i = begin;
+	for (; i + 8 <= end; i += 8) {
+		ComputeColumnsAVX2(transforms, i, columns);
+		StoreAffineMatricesAVX2(columns, _mm256_loadu_ps(transforms.positionX + i), _mm256_loadu_ps(transforms.positionY + i), _mm256_loadu_ps(transforms.positionZ + i), output + i);
+	}
+
+	GenerateAffineMatricesScalar(transforms, i, end, output);
+}
+
+#pragma endregion
@@ -0,0 +1,83 @@
+#pragma once
+#include "pch.h"
+
+#include "TransformArrays.h"
+#include "SimdLevels.h"
+
+class TransformKernels
+{
+private:
+#pragma region Kernels
+
+	/// <summary>
+	/// Builds model matrices one at a time, used for the remainder of a range and on CPUs without SSE
+	/// </summary>
+	static void GenerateModelMatricesScalar(const TransformArrays& transforms, uint32_t begin, uint32_t end, TransformData* output);
+
+	/// <summary>
+	/// Builds model matrices 4 at a time with SSE
+	/// </summary>
+	static void GenerateModelMatricesSSE(const TransformArrays& transforms, uint32_t begin, uint32_t end, TransformData* output);
+
+	/// <summary>
+	/// Builds model matrices 8 at a time with AVX2
+	/// </summary>
+	static void GenerateModelMatricesAVX2(const TransformArrays& transforms, uint32_t begin, uint32_t end, TransformData* output);
+
+	/// <summary>
+	/// Builds affine matrices one at a time, used for the remainder of a range and on CPUs without SSE
+	/// </summary>
+	static void GenerateAffineMatricesScalar(const TransformArrays& transforms, uint32_t begin, uint32_t end, AffineTransformData* output);
+
+	/// <summary>
+	/// Builds affine matrices 4 at a time with SSE
+	/// </summary>
+	static void GenerateAffineMatricesSSE(const TransformArrays& transforms, uint32_t begin, uint32_t end, AffineTransformData* output);
+
+	/// <summary>
+	/// Builds affine matrices 8 at a time with AVX2
+	/// </summary>
+	static void GenerateAffineMatricesAVX2(const TransformArrays& transforms, uint32_t begin, uint32_t end, AffineTransformData* output);
+
+#pragma endregion
+
+public:
+#pragma region Kernels
+
+	/// <summary>
+	/// Builds the model matrix of a range of transforms, 4 or 8 at a time at the SIMD level set for the physics kernels.
+	/// Gives the same matrices as Transform::GetModelMatrix without building a separate matrix for each step
+	/// </summary>
+	/// <param name="transforms">The transforms' component arrays</param>
+	/// <param name="begin">The first index to build</param>
+	/// <param name="end">One past the last index to build</param>
+	/// <param name="output">Filled with the model matrices at the same indices, can point into a mapped buffer</param>
+	static void GenerateModelMatrices(const TransformArrays& transforms, uint32_t begin, uint32_t end, TransformData* output);
+
+	/// <summary>
+	/// Builds the top three rows of the model matrix of a range of transforms, 4 or 8 at a time at the SIMD level set for the physics kernels
+	/// </summary>
+	/// <param name="transforms">The transforms' component arrays</param>
+	/// <param name="begin">The first index to build</param>
+	/// <param name="end">One past the last index to build</param>
+	/// <param name="output">Filled with the affine matrices at the same indices, can point into a mapped buffer</param>
+	static void GenerateAffineMatrices(const TransformArrays& transforms, uint32_t begin, uint32_t end, AffineTransformData* output);
+
+	/// <summary>
+	/// Builds the model matrices of a batch of transforms, split across the job system's threads for large batches
+	/// </summary>
+	/// <param name="transforms">The transforms' component arrays</param>
+	/// <param name="count">The number of transforms</param>
+	/// <param name="output">Filled with the model matrices at the same indices</param>
+	static void GenerateModelMatricesParallel(const TransformArrays& transforms, uint32_t count, TransformData* output);
+
+	/// <summary>
+	/// Builds the affine matrices of a batch of transforms, split across the job system's threads for large batches
+	/// </summary>
+	/// <param name="transforms">The transforms' component arrays</param>
+	/// <param name="count">The number of transforms</param>
+	/// <param name="output">Filled with the affine matrices at the same indices</param>
+	static void GenerateAffineMatricesParallel(const TransformArrays& transforms, uint32_t count, AffineTransformData* output);
+
+#pragma endregion
+};
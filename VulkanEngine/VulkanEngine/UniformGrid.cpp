@@ -0,0 +1,255 @@
+#include "pch.h"
+#include "UniformGrid.h"
+
+#include <cfloat>
+
+#pragma region Constructor
+
+UniformGrid::UniformGrid(float cellSize)
+{
+	this->cellSize = cellSize;
+}
+
+#pragma endregion
+
+#pragma region Accessors
+
+float UniformGrid::GetCellSize()
+{
+	return cellSize;
+}
+
+void UniformGrid::SetCellSize(float value)
+{
+	cellSize = value;
+}
+
+#pragma endregion
+
+#pragma region Pair Finding
+
+void UniformGrid::FindPairs(const std::vector<AABB>& bounds, const std::vector<CollisionFilter>& filters, std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+	entries.clear();
+
+	if (!bounds.empty()) {
+		extent = bounds[0];
+	}
+
+	//Bucket every proxy into the cells it touches
+	for (uint32_t i = 0; i < bounds.size(); i++) {
+		extent.min = glm::min(extent.min, bounds[i].min);
+		extent.max = glm::max(extent.max, bounds[i].max);
+
+		glm::ivec3 minCell = GetCell(bounds[i].min);
+		glm::ivec3 maxCell = GetCell(bounds[i].max);
+
+		for (int32_t x = minCell.x; x <= maxCell.x; x++) {
+			for (int32_t y = minCell.y; y <= maxCell.y; y++) {
+				for (int32_t z = minCell.z; z <= maxCell.z; z++) {
+					entries.push_back({ GetCellKey(x, y, z), i });
+				}
+			}
+		}
+	}
+
+	//Sorting groups the entries of each cell together
+	std::sort(entries.begin(), entries.end());
+
+	size_t start = 0;
+	while (start < entries.size()) {
+		size_t end = start + 1;
+		while (end < entries.size() && entries[end].cell == entries[start].cell) {
+			end++;
+		}
+
+		for (size_t i = start; i < end; i++) {
+			for (size_t j = i + 1; j < end; j++) {
+				uint32_t a = entries[i].proxy;
+				uint32_t b = entries[j].proxy;
+
+				if (!filters[a].CanCollide(filters[b]) || !bounds[a].Overlaps(bounds[b])) {
+					continue;
+				}
+
+				//Two proxies can share several cells, only report the pair from the cell holding the min corner of their overlap
+				glm::ivec3 overlapCell = GetCell(glm::max(bounds[a].min, bounds[b].min));
+				if (GetCellKey(overlapCell.x, overlapCell.y, overlapCell.z) == entries[start].cell) {
+					pairs.push_back({ a, b });
+				}
+			}
+		}
+
+		start = end;
+	}
+}
+
+uint64_t UniformGrid::GetCellKey(int32_t x, int32_t y, int32_t z)
+{
+	//21 bits per axis, offset so negative coordinates stay positive
+	const int32_t offset = 1 << 20;
+	const uint64_t mask = (1 << 21) - 1;
+
+	return (static_cast<uint64_t>(x + offset) & mask) << 42 |
+		(static_cast<uint64_t>(y + offset) & mask) << 21 |
+		(static_cast<uint64_t>(z + offset) & mask);
+}
+
+glm::ivec3 UniformGrid::GetCell(glm::vec3 point) const
+{
+	return glm::ivec3(glm::floor(point / cellSize));
+}
+
+#pragma endregion
+
+#pragma region Queries
+
+void UniformGrid::QueryBounds(const std::vector<AABB>& bounds, const AABB& query, std::vector<uint32_t>& proxies) const
+{
+	proxies.clear();
+
+	if (entries.empty() || !extent.Overlaps(query)) {
+		return;
+	}
+
+	//Cells outside the extent are empty so only look at the part of the query inside it
+	glm::ivec3 minCell = GetCell(glm::max(query.min, extent.min));
+	glm::ivec3 maxCell = GetCell(glm::min(query.max, extent.max));
+	glm::ivec3 size = maxCell - minCell + 1;
+
+	//Looking up more cells than there are entries is slower than testing every proxy
+	if (static_cast<uint64_t>(size.x) * size.y * size.z > entries.size()) {
+		for (uint32_t i = 0; i < bounds.size(); i++) {
+			if (bounds[i].Overlaps(query)) {
+				proxies.push_back(i);
+			}
+		}
+
+		return;
+	}
+
+	for (int32_t x = minCell.x; x <= maxCell.x; x++) {
+		for (int32_t y = minCell.y; y <= maxCell.y; y++) {
+			for (int32_t z = minCell.z; z <= maxCell.z; z++) {
+				GatherCell(glm::ivec3(x, y, z), proxies);
+			}
+		}
+	}
+
+	//Proxies spanning several cells were found once per cell
+	std::sort(proxies.begin(), proxies.end());
+	proxies.erase(std::unique(proxies.begin(), proxies.end()), proxies.end());
+	proxies.erase(std::remove_if(proxies.begin(), proxies.end(), [&bounds, &query](uint32_t proxy) { return !bounds[proxy].Overlaps(query); }), proxies.end());
+}
+
+void UniformGrid::QueryRay(const std::vector<AABB>& bounds, glm::vec3 origin, glm::vec3 direction, float maxDistance, float radius, const std::function<float(uint32_t)>& visit) const
+{
+	if (entries.empty()) {
+		return;
+	}
+
+	glm::vec3 inverseDirection = 1.0f / direction;
+	AABB grownExtent = { extent.min - radius, extent.max + radius };
+	float start = 0.0f;
+	float end = maxDistance;
+	if (!grownExtent.ClipRay(origin, inverseDirection, start, end)) {
+		return;
+	}
+
+	//Proxies spanning several cells are only visited the first time they are found, marked with a number unique to this ray
+	static thread_local std::vector<uint32_t> visitedRay;
+	static thread_local uint32_t rayNumber = 0;
+	if (visitedRay.size() < bounds.size()) {
+		visitedRay.resize(bounds.size(), 0);
+	}
+
+	rayNumber++;
+	if (rayNumber == 0) {
+		std::fill(visitedRay.begin(), visitedRay.end(), 0);
+		rayNumber = 1;
+	}
+
+	static thread_local std::vector<uint32_t> cellProxies;
+
+	//Step from cell to cell along the ray, always crossing whichever cell boundary is closest.
+	//boundaryDistance is how far along the ray the next boundary on each axis is, stepDistance how far apart the boundaries on each axis are
+	glm::vec3 entry = origin + direction * start;
+	glm::ivec3 cell = GetCell(entry);
+	glm::ivec3 step = glm::ivec3(0);
+	glm::vec3 boundaryDistance = glm::vec3(FLT_MAX);
+	glm::vec3 stepDistance = glm::vec3(FLT_MAX);
+
+	for (int i = 0; i < 3; i++) {
+		if (direction[i] > 0.0f) {
+			step[i] = 1;
+			boundaryDistance[i] = start + ((cell[i] + 1) * cellSize - entry[i]) * inverseDirection[i];
+			stepDistance[i] = cellSize * inverseDirection[i];
+		}
+		else if (direction[i] < 0.0f) {
+			step[i] = -1;
+			boundaryDistance[i] = start + (cell[i] * cellSize - entry[i]) * inverseDirection[i];
+			stepDistance[i] = -cellSize * inverseDirection[i];
+		}
+	}
+
+	//A swept sphere also reaches into the neighbouring cells within its radius.
+	//The first cell looks at the whole block around it, after that each step only adds the layer of the block on the side it moved towards
+	int32_t reach = static_cast<int32_t>(std::ceil(radius / cellSize));
+	glm::ivec3 layerMin = cell - reach;
+	glm::ivec3 layerMax = cell + reach;
+
+	while (true) {
+		cellProxies.clear();
+		for (int32_t x = layerMin.x; x <= layerMax.x; x++) {
+			for (int32_t y = layerMin.y; y <= layerMax.y; y++) {
+				for (int32_t z = layerMin.z; z <= layerMax.z; z++) {
+					GatherCell(glm::ivec3(x, y, z), cellProxies);
+				}
+			}
+		}
+
+		for (uint32_t proxy : cellProxies) {
+			if (visitedRay[proxy] == rayNumber) {
+				continue;
+			}
+			visitedRay[proxy] = rayNumber;
+
+			AABB grown = { bounds[proxy].min - radius, bounds[proxy].max + radius };
+			float proxyStart = 0.0f;
+			float proxyEnd = end;
+			if (grown.ClipRay(origin, inverseDirection, proxyStart, proxyEnd)) {
+				end = std::min(end, visit(proxy));
+			}
+		}
+
+		int axis = boundaryDistance.x < boundaryDistance.y ?
+			(boundaryDistance.x < boundaryDistance.z ? 0 : 2) :
+			(boundaryDistance.y < boundaryDistance.z ? 1 : 2);
+
+		//Anything in the cells past here is further away than the ray reaches
+		if (boundaryDistance[axis] > end) {
+			break;
+		}
+
+		cell[axis] += step[axis];
+		boundaryDistance[axis] += stepDistance[axis];
+
+		layerMin = cell - reach;
+		layerMax = cell + reach;
+		layerMin[axis] = layerMax[axis] = cell[axis] + step[axis] * reach;
+	}
+}
+
+void UniformGrid::GatherCell(glm::ivec3 cell, std::vector<uint32_t>& proxies) const
+{
+	uint64_t key = GetCellKey(cell.x, cell.y, cell.z);
+
+	//Entries are sorted by cell then proxy, so a cell's entries start at the first entry not below the cell with proxy 0
+	std::vector<CellEntry>::const_iterator it = std::lower_bound(entries.begin(), entries.end(), CellEntry{ key, 0 });
+	for (; it != entries.end() && it->cell == key; it++) {
+		proxies.push_back(it->proxy);
+	}
+}
+
+#pragma endregion
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "pch.h"
+#include "Broadphase.h"
+
+class UniformGrid : public Broadphase
+{
+private:
+	//Each proxy is listed once for every cell its bounds touch
+	struct CellEntry {
+		uint64_t cell;
+		uint32_t proxy;
+
+		bool operator<(const CellEntry& other) const {
+			return cell < other.cell || (cell == other.cell && proxy < other.proxy);
+		}
+	};
+
+	float cellSize;
+	std::vector<CellEntry> entries;
+
+	//Bounds of every proxy together, rays are clipped to it so ones without a maximum distance still end
+	AABB extent;
+
+	/// <summary>
+	/// Packs the coordinates of a cell into a single key
+	/// </summary>
+	/// <param name="x">The x coordinate of the cell</param>
+	/// <param name="y">The y coordinate of the cell</param>
+	/// <param name="z">The z coordinate of the cell</param>
+	/// <returns>The cell key</returns>
+	static uint64_t GetCellKey(int32_t x, int32_t y, int32_t z);
+
+	/// <summary>
+	/// Returns the coordinates of the cell that contains the point
+	/// </summary>
+	/// <param name="point">The point to find the cell of</param>
+	/// <returns>The cell coordinates</returns>
+	glm::ivec3 GetCell(glm::vec3 point) const;
+
+	/// <summary>
+	/// Adds every proxy listed in a cell to the list
+	/// </summary>
+	/// <param name="cell">The coordinates of the cell</param>
+	/// <param name="proxies">The list to add the proxies to</param>
+	void GatherCell(glm::ivec3 cell, std::vector<uint32_t>& proxies) const;
+
+public:
+#pragma region Constructor
+
+	UniformGrid(float cellSize = 2.0f);
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the width of each grid cell
+	/// </summary>
+	/// <returns>The cell size</returns>
+	float GetCellSize();
+
+	/// <summary>
+	/// Sets the width of each grid cell, works best when cells are a little larger than most objects
+	/// </summary>
+	/// <param name="value">The value to set the cell size to</param>
+	void SetCellSize(float value);
+
+#pragma endregion
+
+#pragma region Pair Finding
+
+	/// <summary>
+	/// Buckets the proxies into grid cells and only tests proxies that share a cell
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="filters">The collision filter of each proxy</param>
+	/// <param name="pairs">Filled with the candidate pairs</param>
+	void FindPairs(const std::vector<AABB>& bounds, const std::vector<CollisionFilter>& filters, std::vector<CollisionPair>& pairs) override;
+
+#pragma endregion
+
+#pragma region Queries
+
+	/// <summary>
+	/// Looks up the cells the box touches
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="query">The box to look in</param>
+	/// <param name="proxies">Filled with the overlapping proxies</param>
+	void QueryBounds(const std::vector<AABB>& bounds, const AABB& query, std::vector<uint32_t>& proxies) const override;
+
+	/// <summary>
+	/// Walks the cells along the ray nearest first, along with any neighbours a swept sphere reaches into, and stops once the ray has been cut short
+	/// </summary>
+	/// <param name="bounds">The bounds of each proxy</param>
+	/// <param name="origin">The start of the ray</param>
+	/// <param name="direction">The normalized direction of the ray</param>
+	/// <param name="maxDistance">How far the ray reaches</param>
+	/// <param name="radius">The radius of the swept sphere, zero for a thin ray</param>
+	/// <param name="visit">Called for each proxy the ray passes through, returns how far the ray should reach from then on</param>
+	void QueryRay(const std::vector<AABB>& bounds, glm::vec3 origin, glm::vec3 direction, float maxDistance, float radius, const std::function<float(uint32_t)>& visit) const override;
+
+#pragma endregion
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include "pch.h"
+
+#include "Buffer.h"
+
+typedef uint64_t UploadTicket;
+
+struct UploadBatch {
+public:
+	UploadTicket ticket = 0;
+	VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+	VkFence fence = VK_NULL_HANDLE;
+
+	//Position of the staging ring head when the batch was submitted, the ring is free up to here once the batch completes
+	VkDeviceSize stagingEnd = 0;
+
+	//Staging buffers for uploads that were too large for the staging ring
+	std::vector<Buffer> overflowBuffers;
+
+	//Buffers that were replaced while earlier frames could still be reading them
+	std::vector<Buffer> retiredBuffers;
+};
@@ -0,0 +1,358 @@
+#include "pch.h"
+#include "UploadManager.h"
+
+#include "VulkanManager.h"
+
+#define logicalDevice VulkanManager::GetInstance()->GetLogicalDevice()
+
+#pragma region Singleton
+
+UploadManager* UploadManager::instance = nullptr;
+
+UploadManager* UploadManager::GetInstance()
+{
+	if (instance == nullptr) {
+		instance = new UploadManager();
+	}
+
+	return instance;
+}
+
+#pragma endregion
+
+#pragma region Memory Management
+
+void UploadManager::Init()
+{
+	QueueFamilyIndices queueFamilyIndices = VulkanManager::GetInstance()->FindQueueFamilies(VulkanManager::GetInstance()->GetPhysicalDevice());
+
+	//Command buffers are reused between batches so they need to be individually resettable
+	VkCommandPoolCreateInfo poolInfo = {};
+	poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
+	poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+	if (vkCreateCommandPool(logicalDevice, &poolInfo, nullptr, &commandPool) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to create upload command pool!");
+	}
+
+	Buffer::CreateBuffer(STAGING_RING_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingRing);
+	ringHead = 0;
+	ringTail = 0;
+}
+
+void UploadManager::Cleanup()
+{
+	Wait(Submit());
+
+	for (VkFence fence : freeFences) {
+		vkDestroyFence(logicalDevice, fence, nullptr);
+	}
+	freeFences.clear();
+
+	//Destroying the pool frees every command buffer allocated from it
+	vkDestroyCommandPool(logicalDevice, commandPool, nullptr);
+	freeCommandBuffers.clear();
+
+	stagingRing.Cleanup();
+}
+
+#pragma endregion
+
+#pragma region Recording
+
+VkCommandBuffer UploadManager::GetCommandBuffer()
+{
+	if (!batchOpen) {
+		BeginBatch();
+	}
+
+	return currentBatch.commandBuffer;
+}
+
+UploadTicket UploadManager::GetCurrentTicket()
+{
+	GetCommandBuffer();
+	return currentBatch.ticket;
+}
+
+void* UploadManager::AllocateStaging(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset, VkDeviceSize alignment)
+{
+	GetCommandBuffer();
+
+	//Uploads that could never fit in the ring get a dedicated buffer that lives until the batch completes
+	if (size > STAGING_RING_SIZE) {
+		Buffer overflowBuffer;
+		Buffer::CreateBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, overflowBuffer);
+		currentBatch.overflowBuffers.push_back(overflowBuffer);
+
+		buffer = overflowBuffer.GetBuffer();
+		offset = 0;
+		return overflowBuffer.GetMappedData();
+	}
+
+	while (!ReserveStaging(size, alignment, offset)) {
+		if (pendingBatches.empty()) {
+			//The recording batch is the only one using the ring, submit it so its space can be reclaimed
+			Wait(Submit());
+			GetCommandBuffer();
+		}
+		else {
+			//Free up space by waiting on the oldest batch
+			vkWaitForFences(logicalDevice, 1, &pendingBatches.front().fence, VK_TRUE, UINT64_MAX);
+			stallCount++;
+			RetireBatch(pendingBatches.front());
+			pendingBatches.pop_front();
+		}
+	}
+
+	buffer = stagingRing.GetBuffer();
+	return static_cast<char*>(stagingRing.GetMappedData()) + offset;
+}
+
+VkBuffer UploadManager::StageData(const void* data, VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize alignment)
+{
+	VkBuffer buffer;
+	void* mappedData = AllocateStaging(size, buffer, offset, alignment);
+	memcpy(mappedData, data, static_cast<size_t>(size));
+
+	return buffer;
+}
+
+UploadTicket UploadManager::UploadToBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset)
+{
+	VkDeviceSize stagingOffset;
+	VkBuffer stagingBuffer = StageData(data, size, stagingOffset);
+
+	//Staging can submit the batch so the command buffer is fetched afterwards
+	VkBufferCopy copyRegion = {};
+	copyRegion.srcOffset = stagingOffset;
+	copyRegion.dstOffset = dstOffset;
+	copyRegion.size = size;
+	vkCmdCopyBuffer(GetCommandBuffer(), stagingBuffer, dstBuffer, 1, &copyRegion);
+
+	return currentBatch.ticket;
+}
+
+UploadTicket UploadManager::DestroyAfterBatch(const Buffer& buffer)
+{
+	GetCommandBuffer();
+	currentBatch.retiredBuffers.push_back(buffer);
+
+	return currentBatch.ticket;
+}
+
+void UploadManager::BeginBatch()
+{
+	currentBatch = UploadBatch();
+	currentBatch.ticket = nextTicket++;
+
+	//Reuse a command buffer and fence from a retired batch when possible
+	if (freeCommandBuffers.empty()) {
+		VkCommandBufferAllocateInfo allocateInfo = {};
+		allocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+		allocateInfo.commandPool = commandPool;
+		allocateInfo.commandBufferCount = 1;
+
+		if (vkAllocateCommandBuffers(logicalDevice, &allocateInfo, &currentBatch.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to allocate upload command buffer!");
+		}
+	}
+	else {
+		currentBatch.commandBuffer = freeCommandBuffers.back();
+		freeCommandBuffers.pop_back();
+	}
+
+	if (freeFences.empty()) {
+		VkFenceCreateInfo fenceInfo = {};
+		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+
+		if (vkCreateFence(logicalDevice, &fenceInfo, nullptr, &currentBatch.fence) != VK_SUCCESS) {
+			throw std::runtime_error("Failed to create upload fence!");
+		}
+	}
+	else {
+		currentBatch.fence = freeFences.back();
+		freeFences.pop_back();
+	}
+
+	VkCommandBufferBeginInfo beginInfo = {};
+	beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+	if (vkBeginCommandBuffer(currentBatch.commandBuffer, &beginInfo) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to begin upload command buffer!");
+	}
+
+	//Make sure earlier frames have finished reading any resource this batch overwrites
+	vkCmdPipelineBarrier(
+		currentBatch.commandBuffer,
+		VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		0,
+		0, nullptr,
+		0, nullptr,
+		0, nullptr);
+
+	batchOpen = true;
+}
+
+bool UploadManager::ReserveStaging(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset)
+{
+	//The head only ever catches up to the tail when every batch has been retired, start from the beginning again
+	if (ringHead == ringTail) {
+		ringHead = 0;
+		ringTail = 0;
+	}
+
+	VkDeviceSize alignedHead = (ringHead + alignment - 1) / alignment * alignment;
+
+	if (ringHead >= ringTail) {
+		//Used region is contiguous, try the space after the head first then wrap around to the start
+		if (alignedHead + size <= STAGING_RING_SIZE) {
+			offset = alignedHead;
+			ringHead = alignedHead + size;
+			return true;
+		}
+
+		if (size < ringTail) {
+			offset = 0;
+			ringHead = size;
+			return true;
+		}
+
+		return false;
+	}
+
+	//Used region wraps around, the head must stay strictly behind the tail so a full ring isn't mistaken for an empty one
+	if (alignedHead + size < ringTail) {
+		offset = alignedHead;
+		ringHead = alignedHead + size;
+		return true;
+	}
+
+	return false;
+}
+
+#pragma endregion
+
+#pragma region Submission
+
+UploadTicket UploadManager::Submit()
+{
+	if (!batchOpen) {
+		return nextTicket - 1;
+	}
+
+	//Make the transferred data visible to every stage that reads uploaded resources
+	VkMemoryBarrier barrier = {};
+	barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+	vkCmdPipelineBarrier(
+		currentBatch.commandBuffer,
+		VK_PIPELINE_STAGE_TRANSFER_BIT,
+		VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+		0,
+		1, &barrier,
+		0, nullptr,
+		0, nullptr);
+
+	if (vkEndCommandBuffer(currentBatch.commandBuffer) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to record upload command buffer!");
+	}
+
+	VkSubmitInfo submitInfo = {};
+	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+	submitInfo.commandBufferCount = 1;
+	submitInfo.pCommandBuffers = &currentBatch.commandBuffer;
+
+	if (vkQueueSubmit(VulkanManager::GetInstance()->GetGraphicsQueue(), 1, &submitInfo, currentBatch.fence) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to submit upload batch!");
+	}
+
+	currentBatch.stagingEnd = ringHead;
+	pendingBatches.push_back(currentBatch);
+	batchOpen = false;
+	submitCount++;
+
+	return currentBatch.ticket;
+}
+
+bool UploadManager::IsComplete(UploadTicket ticket)
+{
+	RetireCompletedBatches();
+	return ticket <= completedTicket;
+}
+
+void UploadManager::Wait(UploadTicket ticket)
+{
+	if (batchOpen && ticket >= currentBatch.ticket) {
+		Submit();
+	}
+
+	//Batches are submitted to a single queue in order so waiting on one implies all earlier batches are done too
+	while (!pendingBatches.empty() && pendingBatches.front().ticket <= ticket) {
+		vkWaitForFences(logicalDevice, 1, &pendingBatches.front().fence, VK_TRUE, UINT64_MAX);
+		stallCount++;
+		RetireBatch(pendingBatches.front());
+		pendingBatches.pop_front();
+	}
+}
+
+void UploadManager::Update()
+{
+	Submit();
+	RetireCompletedBatches();
+}
+
+void UploadManager::RetireBatch(UploadBatch& batch)
+{
+	ringTail = batch.stagingEnd;
+	completedTicket = batch.ticket;
+
+	for (Buffer& overflowBuffer : batch.overflowBuffers) {
+		overflowBuffer.Cleanup();
+	}
+	batch.overflowBuffers.clear();
+
+	for (Buffer& retiredBuffer : batch.retiredBuffers) {
+		retiredBuffer.Cleanup();
+	}
+	batch.retiredBuffers.clear();
+
+	vkResetFences(logicalDevice, 1, &batch.fence);
+	freeFences.push_back(batch.fence);
+	freeCommandBuffers.push_back(batch.commandBuffer);
+}
+
+void UploadManager::RetireCompletedBatches()
+{
+	while (!pendingBatches.empty() && vkGetFenceStatus(logicalDevice, pendingBatches.front().fence) == VK_SUCCESS) {
+		RetireBatch(pendingBatches.front());
+		pendingBatches.pop_front();
+	}
+}
+
+#pragma endregion
+
+#pragma region Accessors
+
+uint32_t UploadManager::GetSubmitCount()
+{
+	return submitCount;
+}
+
+uint32_t UploadManager::GetPendingBatchCount()
+{
+	return static_cast<uint32_t>(pendingBatches.size());
+}
+
+uint32_t UploadManager::GetStallCount()
+{
+	return stallCount;
+}
+
+#pragma endregion
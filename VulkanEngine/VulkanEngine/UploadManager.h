@@ -0,0 +1,191 @@
+#pragma once
+#include "pch.h"
+
+#include <deque>
+
+#include "Buffer.h"
+#include "UploadBatch.h"
+
+class UploadManager
+{
+private:
+	static UploadManager* instance;
+
+	static constexpr VkDeviceSize STAGING_RING_SIZE = 32 * 1024 * 1024;
+
+	VkCommandPool commandPool = VK_NULL_HANDLE;
+
+	//Persistently mapped staging memory shared by every batch, the region between the tail and the head is in use
+	Buffer stagingRing;
+	VkDeviceSize ringHead = 0;
+	VkDeviceSize ringTail = 0;
+
+	bool batchOpen = false;
+	UploadBatch currentBatch;
+	std::deque<UploadBatch> pendingBatches;
+
+	std::vector<VkCommandBuffer> freeCommandBuffers;
+	std::vector<VkFence> freeFences;
+
+	UploadTicket nextTicket = 1;
+	UploadTicket completedTicket = 0;
+	uint32_t submitCount = 0;
+
+	//Every time the CPU blocked on an upload batch's fence
+	uint32_t stallCount = 0;
+
+	/// <summary>
+	/// Starts recording a new batch
+	/// </summary>
+	void BeginBatch();
+
+	/// <summary>
+	/// Releases the staging space, command buffer and fence of a batch that has finished executing
+	/// </summary>
+	/// <param name="batch">The completed batch</param>
+	void RetireBatch(UploadBatch& batch);
+
+	/// <summary>
+	/// Retires every pending batch whose fence has been signaled
+	/// </summary>
+	void RetireCompletedBatches();
+
+	/// <summary>
+	/// Reserves a contiguous range of the staging ring
+	/// </summary>
+	/// <param name="size">The size of the range in bytes</param>
+	/// <param name="alignment">The required alignment of the range</param>
+	/// <param name="offset">Set to the offset of the range within the staging ring</param>
+	/// <returns>True if the range was reserved, false if the ring is too full</returns>
+	bool ReserveStaging(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset);
+
+public:
+#pragma region Singleton
+
+	/// <summary>
+	/// Returns the singleton instance of the upload manager
+	/// </summary>
+	/// <returns>The upload manager instance</returns>
+	static UploadManager* GetInstance();
+
+#pragma endregion
+
+#pragma region Memory Management
+
+	/// <summary>
+	/// Creates the command pool and staging ring used for uploads
+	/// </summary>
+	void Init();
+
+	/// <summary>
+	/// Waits for all uploads to finish and destroys the upload resources
+	/// </summary>
+	void Cleanup();
+
+#pragma endregion
+
+#pragma region Recording
+
+	/// <summary>
+	/// Returns the command buffer of the batch that is currently recording, starting a new batch if necessary.
+	/// Staging data can submit the current batch so the command buffer should be fetched after staging
+	/// </summary>
+	/// <returns>The command buffer to record upload commands into</returns>
+	VkCommandBuffer GetCommandBuffer();
+
+	/// <summary>
+	/// Returns the ticket of the batch that is currently recording
+	/// </summary>
+	/// <returns>The ticket that work recorded now will complete with</returns>
+	UploadTicket GetCurrentTicket();
+
+	/// <summary>
+	/// Reserves staging memory for the current batch that the caller can write into
+	/// </summary>
+	/// <param name="size">The number of bytes to reserve</param>
+	/// <param name="buffer">Set to the staging buffer that holds the memory</param>
+	/// <param name="offset">Set to the offset of the memory within the staging buffer</param>
+	/// <param name="alignment">The required alignment of the offset</param>
+	/// <returns>Pointer to the mapped staging memory</returns>
+	void* AllocateStaging(VkDeviceSize size, VkBuffer& buffer, VkDeviceSize& offset, VkDeviceSize alignment = 16);
+
+	/// <summary>
+	/// Copies data into staging memory owned by the current batch
+	/// </summary>
+	/// <param name="data">The data to copy</param>
+	/// <param name="size">The size of the data in bytes</param>
+	/// <param name="offset">Set to the offset of the data within the returned buffer</param>
+	/// <param name="alignment">The required alignment of the offset</param>
+	/// <returns>The staging buffer that holds the data</returns>
+	VkBuffer StageData(const void* data, VkDeviceSize size, VkDeviceSize& offset, VkDeviceSize alignment = 16);
+
+	/// <summary>
+	/// Stages data and records a copy of it into the destination buffer
+	/// </summary>
+	/// <param name="data">The data to upload</param>
+	/// <param name="size">The size of the data in bytes</param>
+	/// <param name="dstBuffer">The buffer to copy the data to</param>
+	/// <param name="dstOffset">The offset in the destination buffer to copy to</param>
+	/// <returns>The ticket of the batch the copy was recorded into</returns>
+	UploadTicket UploadToBuffer(const void* data, VkDeviceSize size, VkBuffer dstBuffer, VkDeviceSize dstOffset = 0);
+
+	/// <summary>
+	/// Destroys a buffer once the current batch completes, without waiting for the device to go idle.
+	/// Every batch starts with a barrier on the stages that read uploaded resources, so by then anything submitted before the batch is done with the buffer
+	/// </summary>
+	/// <param name="buffer">The buffer to destroy, it must not be used by any work submitted after this batch</param>
+	/// <returns>The ticket of the batch the buffer will be destroyed with</returns>
+	UploadTicket DestroyAfterBatch(const Buffer& buffer);
+
+#pragma endregion
+
+#pragma region Submission
+
+	/// <summary>
+	/// Submits the current batch with a fence, does nothing if no batch is recording
+	/// </summary>
+	/// <returns>The ticket of the submitted batch, or of the last submitted batch if nothing was recorded</returns>
+	UploadTicket Submit();
+
+	/// <summary>
+	/// Returns whether or not the batch with the specified ticket has finished executing
+	/// </summary>
+	/// <param name="ticket">The ticket to check</param>
+	/// <returns>True if the batch and every batch before it have completed</returns>
+	bool IsComplete(UploadTicket ticket);
+
+	/// <summary>
+	/// Blocks until the batch with the specified ticket has finished executing, submitting it first if necessary
+	/// </summary>
+	/// <param name="ticket">The ticket to wait for</param>
+	void Wait(UploadTicket ticket);
+
+	/// <summary>
+	/// Submits any recorded uploads and retires completed batches, should be called once per frame
+	/// </summary>
+	void Update();
+
+#pragma endregion
+
+#pragma region Accessors
+
+	/// <summary>
+	/// Returns the number of batches that have been submitted since the application started
+	/// </summary>
+	/// <returns>The submit count</returns>
+	uint32_t GetSubmitCount();
+
+	/// <summary>
+	/// Returns the number of submitted batches that have not been retired yet
+	/// </summary>
+	/// <returns>The pending batch count</returns>
+	uint32_t GetPendingBatchCount();
+
+	/// <summary>
+	/// Returns the number of times the CPU has blocked waiting for a batch to finish executing since the application started
+	/// </summary>
+	/// <returns>The stall count</returns>
+	uint32_t GetStallCount();
+
+#pragma endregion
+};
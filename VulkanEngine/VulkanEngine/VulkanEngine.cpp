@@ -1,12 +1,26 @@
 #include "pch.h"
 
 #include "VulkanManager.h"
+#include "AllocationCounter.h"
+#include "BruteForceBroadphase.h"
 #include "DebugManager.h"
 #include "EntityManager.h"
+#include "EntityRegistry.h"
 #include "GameManager.h"
 #include "GuiManager.h"
+#include "HostMemoryBackend.h"
 #include "InputManager.h"
+#include "InstanceBuffer.h"
+#include "JobSystem.h"
+#include "MemoryAllocator.h"
+#include "ObjectPool.h"
 #include "PhysicsManager.h"
+#include "PhysicsKernels.h"
+#include "SceneGraph.h"
+#include "StringTable.h"
+#include "SweepAndPrune.h"
+#include "TransformKernels.h"
+#include "UniformGrid.h"
 #include "WindowManager.h"
 
 //Memory leak detection
@@ -14,8 +28,1666 @@
 #include <stdlib.h>
 #include <crtdbg.h>
 
-int main()
+/// <summary>
+/// Replays a physics recording without opening a window and prints how long the steps took and whether they matched the recording
+/// </summary>
+/// <param name="filePath">The recording to replay</param>
+/// <returns>True if every step matched the recording</returns>
+static bool ReplayPhysics(const std::string& filePath)
 {
+	JobSystem::GetInstance()->Init();
+	ReplayStats stats = PhysicsManager::GetInstance()->Replay(filePath);
+	JobSystem::GetInstance()->Cleanup();
+
+	std::cout << "Replayed " << stats.stepCount << " steps with " << stats.bodyCount << " bodies" << std::endl;
+	std::cout << "Step time: " << (stats.stepCount > 0 ? stats.totalStepTime / stats.stepCount : 0.0f) << " ms average, " << stats.maxStepTime << " ms max" << std::endl;
+
+	if (stats.firstDivergentStep != UINT32_MAX) {
+		std::cout << "Diverged from the recording at step " << stats.firstDivergentStep << std::endl;
+		return false;
+	}
+
+	std::cout << "Matched the recording, final hash " << std::hex << stats.finalHash << std::dec << std::endl;
+	return true;
+}
+
+/// <summary>
+/// Runs the memory allocator against a backend that hands out host memory and checks buddy splitting and merging, alignment,
+/// running out of room in a block, oversized blocks and handing empty blocks back, then a random mix of allocations and frees
+/// </summary>
+/// <returns>True if every check passed</returns>
+static bool CheckMemoryAllocator()
+{
+	std::shared_ptr<HostMemoryBackend> backend = std::make_shared<HostMemoryBackend>();
+	MemoryAllocator* allocator = MemoryAllocator::GetInstance();
+	allocator->Init(backend);
+
+	uint32_t failures = 0;
+	std::function<void(bool, const std::string&)> check = [&failures](bool passed, const std::string& description) {
+		std::cout << (passed ? " Passed: " : " Failed: ") << description << std::endl;
+		failures += passed ? 0 : 1;
+	};
+
+	VkMemoryRequirements requirements = {};
+	requirements.memoryTypeBits = UINT32_MAX;
+	requirements.alignment = 1;
+
+	//The smallest range comes from halving the block all the way down, so the next one is its buddy right after it
+	requirements.size = 1;
+	Allocation first = allocator->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true);
+	Allocation second = allocator->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true);
+	MemoryStats stats = allocator->GetStats();
+	VkDeviceSize blockSize = stats.bytesReserved;
+	VkDeviceSize minimumRange = stats.bytesAllocated / 2;
+	check(stats.blockCount == 1 && backend->GetBlockCount() == 1, "the first allocations share one block");
+	check(first.offset == 0 && second.offset == minimumRange, "splitting hands out buddies next to each other");
+
+	//Once both halves are free they merge all the way back up, so the whole block fits again
+	allocator->Free(first);
+	allocator->Free(second);
+	requirements.size = blockSize;
+	Allocation whole = allocator->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true);
+	check(whole.offset == 0 && allocator->GetStats().blockCount == 1, "freed buddies merge back into the whole block");
+	allocator->Free(whole);
+	check(first.block == nullptr && allocator->GetStats().allocationCount == 0, "freeing resets the allocation");
+
+	//Odd sized ranges in between so the aligned ones can't land on a large range by chance
+	std::vector<Allocation> allocations;
+	bool aligned = true;
+	for (VkDeviceSize alignment = 1; alignment <= 64 * 1024; alignment *= 4) {
+		requirements.size = 300;
+		requirements.alignment = 1;
+		allocations.push_back(allocator->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true));
+
+		requirements.size = 100;
+		requirements.alignment = alignment;
+		allocations.push_back(allocator->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true));
+		aligned = aligned && allocations.back().offset % alignment == 0;
+	}
+	check(aligned, "offsets meet the requested alignment");
+
+	for (Allocation& allocation : allocations) {
+		allocator->Free(allocation);
+	}
+	allocations.clear();
+
+	//Two halves fill a block, the third needs a new one and a resource larger than a block gets its own rounded up to a power of two
+	requirements.alignment = 1;
+	requirements.size = blockSize / 2;
+	for (uint32_t i = 0; i < 3; i++) {
+		allocations.push_back(allocator->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true));
+	}
+	check(allocator->GetStats().blockCount == 2 && allocations[2].memory != allocations[0].memory, "a full block makes the allocator create another");
+
+	requirements.size = blockSize * 3;
+	allocations.push_back(allocator->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true));
+	check(allocator->GetStats().bytesReserved == blockSize * 6, "an oversized resource gets a block of its own");
+
+	//Optimally tiled resources never share a block with linear ones
+	requirements.size = 1;
+	allocations.push_back(allocator->Allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, false));
+	check(allocator->GetStats().blockCount == 4, "linear and optimal resources use separate pools");
+
+	//Empty blocks are handed back to the backend except for the last one in each pool
+	for (Allocation& allocation : allocations) {
+		allocator->Free(allocation);
+	}
+	allocations.clear();
+	check(allocator->GetStats().blockCount == 2 && backend->GetBlockCount() == 2, "empty blocks are freed down to one per pool");
+
+	//Each host visible range is filled with its own byte, any overlap would overwrite another range's bytes
+	uint32_t badRanges = 0;
+	for (uint32_t i = 0; i < 256; i++) {
+		requirements.size = 1 + std::rand() % 32768;
+		requirements.alignment = static_cast<VkDeviceSize>(1) << (std::rand() % 13);
+		allocations.push_back(allocator->Allocate(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, true));
+		badRanges += allocations.back().mappedData == nullptr || allocations.back().offset % requirements.alignment != 0 ? 1 : 0;
+		if (allocations.back().mappedData != nullptr) {
+			memset(allocations.back().mappedData, i & 0xff, static_cast<size_t>(allocations.back().size));
+		}
+	}
+
+	//Free and replace ranges at random, checking each range that is freed
+	for (uint32_t i = 0; i < 20000; i++) {
+		uint32_t index = std::rand() % static_cast<uint32_t>(allocations.size());
+		const char* bytes = static_cast<const char*>(allocations[index].mappedData);
+		for (VkDeviceSize j = 0; bytes != nullptr && j < allocations[index].size; j++) {
+			if (bytes[j] != static_cast<char>(index & 0xff)) {
+				badRanges++;
+				break;
+			}
+		}
+		allocator->Free(allocations[index]);
+
+		//Now and then a large range so whole orders of the block get split and merged
+		requirements.size = std::rand() % 8 == 0 ? (1 + std::rand() % 1024) * 4096 : 1 + std::rand() % 32768;
+		requirements.alignment = static_cast<VkDeviceSize>(1) << (std::rand() % 13);
+		allocations[index] = allocator->Allocate(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, true);
+		badRanges += allocations[index].mappedData == nullptr || allocations[index].offset % requirements.alignment != 0 ? 1 : 0;
+		if (allocations[index].mappedData != nullptr) {
+			memset(allocations[index].mappedData, index & 0xff, static_cast<size_t>(allocations[index].size));
+		}
+	}
+	check(badRanges == 0, "random host visible ranges are aligned and never overlap");
+
+	for (Allocation& allocation : allocations) {
+		allocator->Free(allocation);
+	}
+	allocations.clear();
+	stats = allocator->GetStats();
+	check(stats.allocationCount == 0 && stats.bytesInUse == 0 && stats.bytesAllocated == 0, "every range is returned once everything is freed");
+
+	uint32_t allocateCount = backend->GetAllocateCount();
+	requirements.size = blockSize;
+	requirements.alignment = 1;
+	Allocation merged = allocator->Allocate(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, true);
+	check(merged.offset == 0 && backend->GetAllocateCount() == allocateCount, "the ranges merge back into a whole block");
+	allocator->Free(merged);
+
+	bool threw = false;
+	try {
+		requirements.memoryTypeBits = 1;
+		allocator->Allocate(requirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, true);
+	}
+	catch (const std::runtime_error&) {
+		threw = true;
+	}
+	check(threw, "asking for a memory type that doesn't exist throws");
+
+	allocator->Cleanup();
+	check(backend->GetBlockCount() == 0 && backend->GetMappedBlockCount() == 0, "cleaning up unmaps and frees every block");
+
+	std::cout << failures << " of the checks failed, " << backend->GetAllocateCount() << " blocks were allocated in total" << std::endl;
+	return failures == 0;
+}
+
+/// <summary>
+/// Times building model matrices one transform at a time against the batched transform kernels at every supported SIMD level and prints the results
+/// </summary>
+/// <param name="count">The number of transforms to build matrices for</param>
+static void BenchmarkTransforms(uint32_t count)
+{
+	const uint32_t iterations = 20;
+	const char* levelNames[SimdLevelCount] = { "Scalar", "SSE", "AVX2" };
+
+	JobSystem::GetInstance()->Init();
+
+	//The same random transforms as objects and one component per array
+	std::vector<std::shared_ptr<Transform>> objects(count);
+	std::vector<float> components(static_cast<size_t>(count) * 10);
+	TransformArrays transforms;
+	transforms.positionX = components.data();
+	transforms.positionY = components.data() + count;
+	transforms.positionZ = components.data() + count * 2;
+	transforms.orientationX = components.data() + count * 3;
+	transforms.orientationY = components.data() + count * 4;
+	transforms.orientationZ = components.data() + count * 5;
+	transforms.orientationW = components.data() + count * 6;
+	transforms.scaleX = components.data() + count * 7;
+	transforms.scaleY = components.data() + count * 8;
+	transforms.scaleZ = components.data() + count * 9;
+
+	for (uint32_t i = 0; i < count; i++) {
+		glm::vec3 position = glm::vec3(std::rand() % 200 - 100.0f, std::rand() % 200 - 100.0f, std::rand() % 200 - 100.0f);
+		glm::quat orientation = glm::quat(glm::radians(glm::vec3(std::rand() % 360, std::rand() % 360, std::rand() % 360)));
+		glm::vec3 scale = glm::vec3(0.5f + (std::rand() % 100) / 50.0f, 0.5f + (std::rand() % 100) / 50.0f, 0.5f + (std::rand() % 100) / 50.0f);
+		objects[i] = std::make_shared<Transform>(position, orientation, scale);
+
+		float values[10] = { position.x, position.y, position.z, orientation.x, orientation.y, orientation.z, orientation.w, scale.x, scale.y, scale.z };
+		for (uint32_t j = 0; j < 10; j++) {
+			components[static_cast<size_t>(count) * j + i] = values[j];
+		}
+	}
+
+	std::vector<TransformData> expected(count);
+	std::vector<TransformData> output(count);
+
+	//Every transform is marked changed before each pass so GetModelMatrix rebuilds its matrix
+	float objectTime = 0.0f;
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		for (uint32_t i = 0; i < count; i++) {
+			objects[i]->SetScale(objects[i]->GetScale());
+		}
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t i = 0; i < count; i++) {
+			expected[i] = TransformData::LoadMat4(objects[i]->GetModelMatrix());
+		}
+		objectTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	std::cout << "Building " << count << " model matrices, average of " << iterations << " runs" << std::endl;
+	std::cout << "Per object: " << objectTime / iterations << " ms" << std::endl;
+
+	SimdLevels previousLevel = PhysicsKernels::GetLevel();
+	for (uint32_t level = SimdLevels::Scalar; level <= PhysicsKernels::GetSupportedLevel(); level++) {
+		PhysicsKernels::SetLevel(static_cast<SimdLevels>(level));
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+			TransformKernels::GenerateModelMatrices(transforms, 0, count, output.data());
+		}
+		float batchTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+		bool matched = true;
+		for (uint32_t i = 0; i < count && matched; i++) {
+			matched = expected[i].row1 == output[i].row1 && expected[i].row2 == output[i].row2 && expected[i].row3 == output[i].row3 && expected[i].row4 == output[i].row4;
+		}
+		std::cout << "Batched " << levelNames[level] << ": " << batchTime / iterations << " ms, " << (objectTime / batchTime) << "x, " << (matched ? "matches" : "differs from") << " the per object matrices" << std::endl;
+	}
+
+	PhysicsKernels::SetLevel(PhysicsKernels::GetSupportedLevel());
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		TransformKernels::GenerateModelMatricesParallel(transforms, count, output.data());
+	}
+	float parallelTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "Batched " << levelNames[PhysicsKernels::GetSupportedLevel()] << " on " << JobSystem::GetInstance()->GetThreadCount() << " threads: " << parallelTime / iterations << " ms, " << (objectTime / parallelTime) << "x" << std::endl;
+
+	PhysicsKernels::SetLevel(previousLevel);
+	JobSystem::GetInstance()->Cleanup();
+}
+
+//The layout bodies had before physics state moved into PhysicsWorld's arrays, each one on the heap holding its own transform.
+//Kept as the reference the physics kernels are checked and timed against, the floor bounce it used to do is the contact solver's job now
+struct ReferenceBody {
+	std::shared_ptr<Transform> transform;
+	glm::vec3 velocity = glm::vec3(0.0f, 0.0f, 0.0f);
+	glm::vec3 acceleration = glm::vec3(0.0f, 0.0f, 0.0f);
+	float mass = 1.0f;
+	bool affectedByGravity = true;
+};
+
+/// <summary>
+/// Steps a reference body the way PhysicsObject::Update did before the kernels replaced it
+/// </summary>
+/// <param name="body">The body to step</param>
+/// <param name="gravity">The gravity force applied if the body is affected by gravity</param>
+/// <param name="deltaTime">The time step</param>
+static void UpdateReferenceBody(ReferenceBody& body, glm::vec3 gravity, float deltaTime)
+{
+	if (body.affectedByGravity) {
+		body.acceleration += gravity / body.mass;
+	}
+
+	body.velocity += body.acceleration * deltaTime;
+	body.acceleration = glm::vec3(0.0f, 0.0f, 0.0f);
+
+	body.transform->Translate(body.velocity * deltaTime);
+}
+
+/// <summary>
+/// Checks two reference bodies the way PhysicsManager::CheckCollision did before the kernels replaced it, with a radius of 0.5 for every body
+/// </summary>
+/// <returns>True if the bodies' spheres overlap</returns>
+static bool CheckReferenceCollision(const ReferenceBody& body1, const ReferenceBody& body2)
+{
+	glm::vec3 direction = body1.transform->GetPosition() - body2.transform->GetPosition();
+	float distance = direction.x * direction.x + direction.y * direction.y + direction.z * direction.z;
+
+	return distance < 1.0f;
+}
+
+/// <summary>
+/// Creates the same random bodies as reference bodies and in a physics world. They sit on a jittered grid so neighbouring bodies overlap about half the time,
+/// and every body is paired with its neighbours along x and y and with one random body
+/// </summary>
+/// <param name="count">The number of bodies to create</param>
+/// <param name="objects">Filled with the reference bodies</param>
+/// <param name="world">The world to create the bodies in, their dense indices match their index in objects</param>
+/// <param name="pairs">Filled with the pairs of dense indices to check</param>
+static void CreateReferenceBodies(uint32_t count, std::vector<std::shared_ptr<ReferenceBody>>& objects, PhysicsWorld& world, std::vector<CollisionPair>& pairs)
+{
+	const uint32_t side = 100;
+
+	objects.resize(count);
+	for (uint32_t i = 0; i < count; i++) {
+		glm::vec3 jitter = glm::vec3(std::rand() % 100, std::rand() % 100, std::rand() % 100) / 200.0f;
+		glm::vec3 position = glm::vec3(static_cast<float>(i % side), static_cast<float>(i / side % side), static_cast<float>(i / (side * side))) + jitter;
+
+		objects[i] = std::make_shared<ReferenceBody>();
+		objects[i]->transform = std::make_shared<Transform>(position);
+		objects[i]->velocity = glm::vec3(std::rand() % 100 - 50, std::rand() % 100 - 50, std::rand() % 100 - 50) / 10.0f;
+		objects[i]->mass = 0.5f + (std::rand() % 100) / 50.0f;
+		objects[i]->affectedByGravity = std::rand() % 4 != 0;
+
+		PhysicsHandle handle = world.CreateBody(std::make_shared<Transform>(position), PhysicsLayers::Dynamic, objects[i]->mass, objects[i]->affectedByGravity, true);
+		world.SetVelocity(handle, objects[i]->velocity);
+	}
+
+	pairs.clear();
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t neighbours[3] = { i + 1, i + side, static_cast<uint32_t>(std::rand() % count) };
+		for (uint32_t j = 0; j < 3; j++) {
+			if (neighbours[j] < count && neighbours[j] != i) {
+				CollisionPair pair;
+				pair.a = std::min(i, neighbours[j]);
+				pair.b = std::max(i, neighbours[j]);
+				pairs.push_back(pair);
+			}
+		}
+	}
+}
+
+/// <summary>
+/// Times stepping heap allocated bodies one at a time against the physics world's kernels at every supported SIMD level and on the job system,
+/// then times the sphere check on the same pairs both ways and prints the results
+/// </summary>
+/// <param name="count">The number of bodies to step</param>
+static void BenchmarkPhysics(uint32_t count)
+{
+	const uint32_t iterations = 20;
+	const float deltaTime = 1.0f / 60.0f;
+	const glm::vec3 gravity = glm::vec3(0.0f, -9.8f, 0.0f);
+	const char* levelNames[SimdLevelCount] = { "Scalar", "SSE", "AVX2" };
+
+	JobSystem::GetInstance()->Init();
+
+	std::vector<std::shared_ptr<ReferenceBody>> objects;
+	PhysicsWorld world;
+	std::vector<CollisionPair> pairs;
+	CreateReferenceBodies(count, objects, world, pairs);
+
+	BodyArrays bodies = world.GetBodyArrays();
+	std::vector<float> boundingRadius(count, 0.5f);
+	bodies.boundingRadius = boundingRadius.data();
+
+	//Pairs are checked first, integrating moves the bodies apart
+	std::vector<uint8_t> results(pairs.size());
+	uint32_t pairCount = static_cast<uint32_t>(pairs.size());
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		for (uint32_t i = 0; i < pairCount; i++) {
+			results[i] = CheckReferenceCollision(*objects[pairs[i].a], *objects[pairs[i].b]) ? 1 : 0;
+		}
+	}
+	float objectTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Checking " << pairCount << " pairs, average of " << iterations << " runs" << std::endl;
+	std::cout << "Per object: " << objectTime / iterations << " ms, " << pairCount * iterations / (objectTime * 1000.0f) << " million pairs/s" << std::endl;
+
+	SimdLevels previousLevel = PhysicsKernels::GetLevel();
+	for (uint32_t level = SimdLevels::Scalar; level <= PhysicsKernels::GetSupportedLevel(); level++) {
+		PhysicsKernels::SetLevel(static_cast<SimdLevels>(level));
+
+		start = std::chrono::steady_clock::now();
+		for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+			PhysicsKernels::CheckPairs(bodies, pairs.data(), pairCount, results.data());
+		}
+		float batchTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "Batched " << levelNames[level] << ": " << batchTime / iterations << " ms, " << pairCount * iterations / (batchTime * 1000.0f) << " million pairs/s" << std::endl;
+	}
+
+	start = std::chrono::steady_clock::now();
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		for (uint32_t i = 0; i < count; i++) {
+			UpdateReferenceBody(*objects[i], gravity, deltaTime);
+		}
+	}
+	objectTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "Integrating " << count << " bodies, average of " << iterations << " steps" << std::endl;
+	std::cout << "Per object: " << objectTime / iterations << " ms" << std::endl;
+
+	for (uint32_t level = SimdLevels::Scalar; level <= PhysicsKernels::GetSupportedLevel(); level++) {
+		PhysicsKernels::SetLevel(static_cast<SimdLevels>(level));
+
+		start = std::chrono::steady_clock::now();
+		for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+			PhysicsKernels::IntegrateVelocities(bodies, 0, count, deltaTime, gravity);
+			PhysicsKernels::IntegratePositions(bodies, 0, count, deltaTime);
+		}
+		float batchTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "Batched " << levelNames[level] << ": " << batchTime / iterations << " ms, " << (objectTime / batchTime) << "x" << std::endl;
+	}
+
+	PhysicsKernels::SetLevel(PhysicsKernels::GetSupportedLevel());
+	start = std::chrono::steady_clock::now();
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		std::lock_guard<std::mutex> lock(world.GetMutex());
+		world.IntegrateVelocities(deltaTime, gravity);
+		world.IntegratePositions(deltaTime);
+	}
+	float parallelTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "Batched " << levelNames[PhysicsKernels::GetSupportedLevel()] << " on " << JobSystem::GetInstance()->GetThreadCount() << " threads: " << parallelTime / iterations << " ms, " << (objectTime / parallelTime) << "x" << std::endl;
+
+	PhysicsKernels::SetLevel(previousLevel);
+	JobSystem::GetInstance()->Cleanup();
+}
+
+/// <summary>
+/// Checks the physics kernels against the per object path they replaced. Every SIMD level and the job system split must match the scalar kernels bit for bit,
+/// the scalar kernels must stay within rounding of the per object bodies since gravity is scaled by the inverse mass rather than divided by the mass,
+/// and every level's sphere check must give exactly the per object results
+/// </summary>
+/// <param name="count">The number of bodies to check</param>
+/// <param name="steps">The number of steps to integrate the bodies for</param>
+/// <returns>True if every check passed</returns>
+static bool CheckPhysicsKernels(uint32_t count, uint32_t steps)
+{
+	const float deltaTime = 1.0f / 60.0f;
+	const glm::vec3 gravity = glm::vec3(0.0f, -9.8f, 0.0f);
+	const float tolerance = 1e-4f;
+	const char* levelNames[SimdLevelCount] = { "Scalar", "SSE", "AVX2" };
+	uint32_t failures = 0;
+
+	JobSystem::GetInstance()->Init();
+
+	std::vector<std::shared_ptr<ReferenceBody>> objects;
+	PhysicsWorld world;
+	std::vector<CollisionPair> pairs;
+	CreateReferenceBodies(count, objects, world, pairs);
+
+	BodyArrays bodies = world.GetBodyArrays();
+	std::vector<float> boundingRadius(count, 0.5f);
+	bodies.boundingRadius = boundingRadius.data();
+
+	uint32_t pairCount = static_cast<uint32_t>(pairs.size());
+	std::vector<uint8_t> expectedPairs(pairCount);
+	std::vector<uint8_t> results(pairCount);
+	uint32_t overlapCount = 0;
+	for (uint32_t i = 0; i < pairCount; i++) {
+		expectedPairs[i] = CheckReferenceCollision(*objects[pairs[i].a], *objects[pairs[i].b]) ? 1 : 0;
+		overlapCount += expectedPairs[i];
+	}
+
+	std::cout << "Checking " << pairCount << " pairs, " << overlapCount << " overlap" << std::endl;
+
+	SimdLevels previousLevel = PhysicsKernels::GetLevel();
+	for (uint32_t level = SimdLevels::Scalar; level <= PhysicsKernels::GetSupportedLevel(); level++) {
+		PhysicsKernels::SetLevel(static_cast<SimdLevels>(level));
+		PhysicsKernels::CheckPairs(bodies, pairs.data(), pairCount, results.data());
+
+		bool matched = results == expectedPairs;
+		failures += matched ? 0 : 1;
+		std::cout << levelNames[level] << ": " << (matched ? "matches" : "differs from") << " the per object check" << std::endl;
+	}
+
+	//Every level starts from the same state, which is copied out of the world's arrays and back in
+	float* state[9] = { bodies.positionX, bodies.positionY, bodies.positionZ, bodies.velocityX, bodies.velocityY, bodies.velocityZ, bodies.accelerationX, bodies.accelerationY, bodies.accelerationZ };
+	std::vector<float> initialState(static_cast<size_t>(count) * 9);
+	std::vector<float> scalarState(initialState.size());
+	std::vector<float> finalState(initialState.size());
+	for (uint32_t j = 0; j < 9; j++) {
+		std::copy(state[j], state[j] + count, initialState.begin() + static_cast<size_t>(count) * j);
+	}
+
+	std::cout << "Integrating " << count << " bodies for " << steps << " steps" << std::endl;
+
+	for (uint32_t level = SimdLevels::Scalar; level <= PhysicsKernels::GetSupportedLevel() + 1; level++) {
+		for (uint32_t j = 0; j < 9; j++) {
+			std::copy(initialState.begin() + static_cast<size_t>(count) * j, initialState.begin() + static_cast<size_t>(count) * (j + 1), state[j]);
+		}
+
+		//The pass after the last level runs the supported level split across the job system the way the physics manager does
+		bool parallel = level > PhysicsKernels::GetSupportedLevel();
+		PhysicsKernels::SetLevel(parallel ? PhysicsKernels::GetSupportedLevel() : static_cast<SimdLevels>(level));
+		for (uint32_t step = 0; step < steps; step++) {
+			if (parallel) {
+				std::lock_guard<std::mutex> lock(world.GetMutex());
+				world.IntegrateVelocities(deltaTime, gravity);
+				world.IntegratePositions(deltaTime);
+			}
+			else {
+				PhysicsKernels::IntegrateVelocities(bodies, 0, count, deltaTime, gravity);
+				PhysicsKernels::IntegratePositions(bodies, 0, count, deltaTime);
+			}
+		}
+
+		for (uint32_t j = 0; j < 9; j++) {
+			std::copy(state[j], state[j] + count, finalState.begin() + static_cast<size_t>(count) * j);
+		}
+
+		if (level == SimdLevels::Scalar) {
+			scalarState = finalState;
+			continue;
+		}
+
+		bool matched = memcmp(finalState.data(), scalarState.data(), finalState.size() * sizeof(float)) == 0;
+		failures += matched ? 0 : 1;
+		std::cout << levelNames[PhysicsKernels::GetLevel()] << (parallel ? " on " + std::to_string(JobSystem::GetInstance()->GetThreadCount()) + " threads" : "")
+			<< ": " << (matched ? "matches the scalar kernels bit for bit" : "differs from the scalar kernels") << std::endl;
+	}
+
+	for (uint32_t step = 0; step < steps; step++) {
+		for (uint32_t i = 0; i < count; i++) {
+			UpdateReferenceBody(*objects[i], gravity, deltaTime);
+		}
+	}
+
+	//Differences are relative to the size of the value so large positions and velocities get the same slack as small ones
+	float maxDifference = 0.0f;
+	for (uint32_t i = 0; i < count; i++) {
+		glm::vec3 position = objects[i]->transform->GetPosition();
+		glm::vec3 velocity = objects[i]->velocity;
+		float expected[6] = { position.x, position.y, position.z, velocity.x, velocity.y, velocity.z };
+
+		for (uint32_t j = 0; j < 6; j++) {
+			float difference = std::abs(scalarState[static_cast<size_t>(count) * j + i] - expected[j]) / std::max(std::abs(expected[j]), 1.0f);
+			maxDifference = std::max(maxDifference, difference);
+		}
+	}
+
+	bool withinTolerance = maxDifference <= tolerance;
+	failures += withinTolerance ? 0 : 1;
+	std::cout << "Scalar: " << maxDifference << " largest relative difference from the per object path, " << (withinTolerance ? "within" : "outside") << " the tolerance of " << tolerance << std::endl;
+
+	PhysicsKernels::SetLevel(previousLevel);
+	JobSystem::GetInstance()->Cleanup();
+
+	std::cout << failures << " of the checks failed" << std::endl;
+	return failures == 0;
+}
+
+/// <summary>
+/// Runs a frame shaped like the engine's on 1 thread up to every core and prints how the frame time scales with the thread count.
+/// Collision detection runs alongside world matrix propagation, and instance packing follows the propagation as a continuation
+/// </summary>
+/// <param name="count">The number of physics bodies and of transforms in the hierarchy</param>
+static void BenchmarkJobScaling(uint32_t count)
+{
+	const uint32_t iterations = 50;
+	const uint32_t chainCount = 256;
+	SceneGraph* sceneGraph = SceneGraph::GetInstance();
+	PhysicsManager* physicsManager = PhysicsManager::GetInstance();
+
+	//Bodies sit on a jittered grid close enough that neighbours overlap, none of them move so every frame does the same work
+	std::vector<std::shared_ptr<PhysicsObject>> bodies(count);
+	uint32_t side = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<float>(count))));
+	for (uint32_t i = 0; i < count; i++) {
+		glm::vec3 jitter = glm::vec3(std::rand() % 100, std::rand() % 100, std::rand() % 100) / 200.0f;
+		glm::vec3 position = glm::vec3(static_cast<float>(i % side), static_cast<float>(i / side % side), static_cast<float>(i / (side * side))) * 0.9f + jitter;
+		bodies[i] = std::make_shared<PhysicsObject>(std::make_shared<Transform>(position), PhysicsLayers::Dynamic, 1.0f, false, true);
+	}
+
+	//Chains hanging off a few hundred roots, so propagation has roots to spread over the threads and depth to walk in each
+	std::vector<std::shared_ptr<Transform>> transforms(count);
+	for (uint32_t i = 0; i < count; i++) {
+		transforms[i] = std::make_shared<Transform>(glm::vec3(0.0f, 1.0f, 0.0f), glm::quat(glm::radians(glm::vec3(0.0f, 5.0f, 0.0f))));
+		if (i >= chainCount) {
+			sceneGraph->SetParent(transforms[i], transforms[i - chainCount]);
+		}
+	}
+	std::vector<TransformData> instances(count);
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	std::vector<uint32_t> threadCounts;
+	uint32_t coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+	for (uint32_t threadCount = 1; threadCount < coreCount; threadCount *= 2) {
+		threadCounts.push_back(threadCount);
+	}
+	threadCounts.push_back(coreCount);
+
+	std::cout << "Frame with " << count << " bodies and " << count << " transforms, average of " << iterations << " frames" << std::endl;
+
+	float singleThreadTime = 0.0f;
+	for (uint32_t threadCount : threadCounts) {
+		uint32_t stealStart = jobSystem->GetStealCount();
+		jobSystem->Init(threadCount);
+
+		//The first frame grows the scratch space and isn't timed
+		float frameTime = 0.0f;
+		for (uint32_t iteration = 0; iteration <= iterations; iteration++) {
+			for (uint32_t i = 0; i < chainCount; i++) {
+				transforms[i]->Rotate(glm::quat(glm::vec3(0.0f, 0.01f, 0.0f)));
+			}
+
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			std::shared_ptr<Task> physicsTask = jobSystem->CreateTask([physicsManager]() { physicsManager->DetectCollisions(); });
+			std::shared_ptr<Task> sceneTask = jobSystem->CreateTask([sceneGraph]() { sceneGraph->Update(); });
+			jobSystem->Schedule(physicsTask);
+			jobSystem->Schedule(sceneTask);
+
+			std::shared_ptr<Task> packTask = jobSystem->Then(sceneTask, [jobSystem, &transforms, &instances]() {
+				jobSystem->ParallelFor(static_cast<uint32_t>(transforms.size()), [&transforms, &instances](uint32_t i) {
+					instances[i] = TransformData::LoadMat4(transforms[i]->GetWorldMatrix());
+				}, 256);
+			});
+
+			jobSystem->Wait(physicsTask);
+			jobSystem->Wait(packTask);
+
+			if (iteration > 0) {
+				frameTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+			}
+		}
+
+		uint32_t stealCount = jobSystem->GetStealCount() - stealStart;
+		jobSystem->Cleanup();
+
+		frameTime /= iterations;
+		if (threadCount == 1) {
+			singleThreadTime = frameTime;
+		}
+
+		float speedup = singleThreadTime / frameTime;
+		std::cout << " " << threadCount << " threads: " << frameTime << " ms, " << speedup << "x, " << (speedup / threadCount) * 100.0f << "% efficiency, "
+			<< physicsManager->GetContactCount() << " contacts, " << stealCount << " steals" << std::endl;
+	}
+
+	bodies.clear();
+	sceneGraph->Clear();
+}
+
+/// <summary>
+/// Times recording draw commands the way EntityManager::Draw does on 1 thread up to every core, with every material changed, a tenth changed and nothing changed.
+/// The engine calls the Vulkan loader directly so there is no dispatch to swap for a null device, instead each command RecordMaterial issues
+/// is written to a stand in command buffer as an opcode and its arguments, and the stitched result is checked against a single thread's
+/// </summary>
+/// <param name="materialCount">The number of materials, each recorded into its own stand in secondary command buffer</param>
+/// <param name="meshesPerMaterial">The number of meshes drawn with each material</param>
+/// <returns>True if every thread count recorded the same commands as one thread</returns>
+static bool BenchmarkCommandRecording(uint32_t materialCount, uint32_t meshesPerMaterial)
+{
+	const uint32_t iterations = 20;
+
+	//What RecordMaterial and GetDrawSignature read from a mesh, the handles are made up since nothing is submitted
+	struct RecordedMesh {
+		uint64_t vertexBuffer;
+		uint64_t indexBuffer;
+		uint64_t instanceBuffer;
+		uint64_t colorBuffer;
+		uint64_t indexCount;
+		uint64_t instanceCount;
+	};
+
+	enum RecordedCommands {
+		BeginCommand,
+		BindPipelineCommand,
+		BindDescriptorSetsCommand,
+		BindVertexBuffersCommand,
+		BindIndexBufferCommand,
+		DrawIndexedCommand,
+		EndCommand
+	};
+
+	//Every tenth mesh has a debug color buffer like the debug shapes do
+	std::vector<std::vector<RecordedMesh>> scene(materialCount, std::vector<RecordedMesh>(meshesPerMaterial));
+	for (uint32_t material = 0; material < materialCount; material++) {
+		for (uint32_t i = 0; i < meshesPerMaterial; i++) {
+			uint64_t handle = (static_cast<uint64_t>(material) * meshesPerMaterial + i) * 4 + 1;
+			scene[material][i] = { handle, handle + 1, handle + 2, i % 10 == 0 ? handle + 3 : 0, 36 + (i % 4) * 1000, 0 };
+		}
+	}
+
+	std::function<void(uint32_t, uint32_t)> changeMaterial = [&scene](uint32_t material, uint32_t iteration) {
+		for (uint32_t i = 0; i < scene[material].size(); i++) {
+			uint32_t seed = material * 31 + i * 7 + iteration;
+			scene[material][i].instanceCount = seed % 17 == 0 ? 0 : 1 + seed % 100;
+		}
+	};
+
+	std::function<void(uint32_t, std::vector<uint64_t>&)> getSignature = [&scene](uint32_t material, std::vector<uint64_t>& signature) {
+		signature.clear();
+		for (const RecordedMesh& mesh : scene[material]) {
+			if (mesh.instanceCount > 0) {
+				signature.insert(signature.end(), { mesh.vertexBuffer, mesh.indexBuffer, mesh.instanceBuffer, 0, mesh.colorBuffer, 0, mesh.indexCount, mesh.instanceCount });
+			}
+		}
+
+		if (!signature.empty()) {
+			signature.insert(signature.end(), { material + 1ull, material + 2ull, 1, 1 });
+		}
+	};
+
+	std::function<void(uint32_t, std::vector<uint64_t>&)> recordMaterial = [&scene](uint32_t material, std::vector<uint64_t>& commandBuffer) {
+		commandBuffer.clear();
+		commandBuffer.insert(commandBuffer.end(), { BeginCommand, BindPipelineCommand, material + 1ull, BindDescriptorSetsCommand, material + 2ull });
+
+		for (const RecordedMesh& mesh : scene[material]) {
+			if (mesh.instanceCount > 0) {
+				commandBuffer.insert(commandBuffer.end(), { BindVertexBuffersCommand, 0, mesh.vertexBuffer, BindVertexBuffersCommand, 1, mesh.instanceBuffer });
+				if (mesh.colorBuffer != 0) {
+					commandBuffer.insert(commandBuffer.end(), { BindVertexBuffersCommand, 2, mesh.colorBuffer });
+				}
+				commandBuffer.insert(commandBuffer.end(), { BindIndexBufferCommand, mesh.indexBuffer, DrawIndexedCommand, mesh.indexCount, mesh.instanceCount });
+			}
+		}
+
+		commandBuffer.push_back(EndCommand);
+	};
+
+	JobSystem* jobSystem = JobSystem::GetInstance();
+	std::vector<uint32_t> threadCounts;
+	uint32_t coreCount = std::max(std::thread::hardware_concurrency(), 1u);
+	for (uint32_t threadCount = 1; threadCount < coreCount; threadCount *= 2) {
+		threadCounts.push_back(threadCount);
+	}
+	threadCounts.push_back(coreCount);
+
+	std::cout << materialCount << " materials with " << meshesPerMaterial << " meshes each, average of " << iterations << " frames" << std::endl;
+
+	std::vector<uint64_t> expectedHashes;
+	float singleThreadTime = 0.0f;
+	bool matched = true;
+	for (uint32_t threadCount : threadCounts) {
+		jobSystem->Init(threadCount);
+		uint32_t chunkCount = std::min(threadCount, materialCount);
+
+		std::vector<std::vector<uint64_t>> commandBuffers(materialCount);
+		std::vector<std::vector<uint64_t>> signatures(materialCount);
+		std::vector<std::vector<uint64_t>> chunkSignatures(chunkCount);
+		std::vector<uint32_t> executed;
+
+		//Materials are split between chunks the same way Draw splits them between command pools
+		std::function<float()> drawFrame = [&]() {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			jobSystem->ParallelFor(chunkCount, [&](uint32_t chunk) {
+				for (uint32_t i = chunk; i < materialCount; i += chunkCount) {
+					getSignature(i, chunkSignatures[chunk]);
+
+					if (chunkSignatures[chunk].empty()) {
+						signatures[i].clear();
+					}
+					else if (chunkSignatures[chunk] != signatures[i]) {
+						recordMaterial(i, commandBuffers[i]);
+						signatures[i] = chunkSignatures[chunk];
+					}
+				}
+			});
+
+			executed.clear();
+			for (uint32_t i = 0; i < materialCount; i++) {
+				if (!signatures[i].empty()) {
+					executed.push_back(i);
+				}
+			}
+
+			return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+		};
+
+		float fullTime = 0.0f;
+		float partialTime = 0.0f;
+		float unchangedTime = 0.0f;
+		std::vector<uint64_t> hashes;
+		for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+			for (uint32_t i = 0; i < materialCount; i++) {
+				changeMaterial(i, iteration);
+			}
+			fullTime += drawFrame();
+
+			for (uint32_t i = iteration % 10; i < materialCount; i += 10) {
+				changeMaterial(i, iteration + 1);
+			}
+			partialTime += drawFrame();
+			unchangedTime += drawFrame();
+
+			//The commands the primary buffer would execute in order
+			uint64_t hash = 14695981039346656037ull;
+			for (uint32_t material : executed) {
+				for (uint64_t word : commandBuffers[material]) {
+					hash = (hash ^ word) * 1099511628211ull;
+				}
+			}
+			hashes.push_back(hash);
+		}
+		jobSystem->Cleanup();
+
+		if (threadCount == 1) {
+			expectedHashes = hashes;
+			singleThreadTime = fullTime;
+		}
+		matched = matched && hashes == expectedHashes;
+
+		std::cout << " " << threadCount << " threads: " << fullTime / iterations << " ms every material, " << partialTime / iterations << " ms a tenth, "
+			<< unchangedTime / iterations << " ms unchanged, " << singleThreadTime / fullTime << "x, " << (hashes == expectedHashes ? "same" : "different") << " commands" << std::endl;
+	}
+
+	return matched;
+}
+
+/// <summary>
+/// Times every broadphase finding pairs on the same moving boxes and checks that each finds exactly the pairs all pairs testing does.
+/// A tenth of the boxes are in a layer that doesn't collide with itself and a few are large enough to span many grid cells
+/// </summary>
+/// <param name="count">The number of boxes</param>
+/// <returns>True if every broadphase found the same pairs as testing all pairs</returns>
+static bool BenchmarkBroadphases(uint32_t count)
+{
+	const uint32_t frameCount = 10;
+	const char* typeNames[BroadphaseTypeCount] = { "All pairs", "Sweep and prune", "Uniform grid" };
+
+	std::shared_ptr<Broadphase> broadphases[BroadphaseTypeCount];
+	broadphases[BroadphaseTypes::AllPairs] = std::make_shared<BruteForceBroadphase>();
+	broadphases[BroadphaseTypes::Sweep] = std::make_shared<SweepAndPrune>();
+	broadphases[BroadphaseTypes::Grid] = std::make_shared<UniformGrid>();
+
+	//Unit boxes at about one per eight units of space, moved a little each frame so the sweep's incremental sort is used
+	float extent = std::cbrt(static_cast<float>(count) * 8.0f) * 0.5f;
+	std::vector<std::vector<AABB>> frames(frameCount, std::vector<AABB>(count));
+	std::vector<CollisionFilter> filters(count);
+	std::vector<glm::vec3> positions(count);
+	std::vector<glm::vec3> sizes(count);
+	for (uint32_t i = 0; i < count; i++) {
+		positions[i] = (glm::vec3(std::rand() % 1000, std::rand() % 1000, std::rand() % 1000) / 500.0f - 1.0f) * extent;
+		sizes[i] = i % 1000 == 0 ? glm::vec3(8.0f, 1.0f, 8.0f) : glm::vec3(0.5f + (std::rand() % 100) / 100.0f);
+
+		if (i % 10 == 0) {
+			filters[i].category = 2;
+			filters[i].mask = ~2u;
+		}
+	}
+
+	for (uint32_t frame = 0; frame < frameCount; frame++) {
+		for (uint32_t i = 0; i < count; i++) {
+			positions[i] += (glm::vec3(std::rand() % 100, std::rand() % 100, std::rand() % 100) / 50.0f - 1.0f) * 0.1f;
+			frames[frame][i].min = positions[i] - sizes[i] * 0.5f;
+			frames[frame][i].max = positions[i] + sizes[i] * 0.5f;
+		}
+	}
+
+	//Testing every pair is the reference the others are checked against
+	std::vector<std::vector<CollisionPair>> expected(frameCount);
+	std::vector<CollisionPair> pairs;
+	float allPairsTime = 0.0f;
+	bool matched = true;
+
+	std::cout << count << " boxes, average of " << frameCount << " frames" << std::endl;
+	for (uint32_t type = BroadphaseTypes::AllPairs; type < BroadphaseTypeCount; type++) {
+		float time = 0.0f;
+		uint32_t mismatchedFrames = 0;
+
+		for (uint32_t frame = 0; frame < frameCount; frame++) {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			broadphases[type]->FindPairs(frames[frame], filters, pairs);
+			time += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+			std::sort(pairs.begin(), pairs.end());
+			if (type == BroadphaseTypes::AllPairs) {
+				expected[frame] = pairs;
+			}
+			else if (pairs != expected[frame]) {
+				mismatchedFrames++;
+			}
+		}
+
+		if (type == BroadphaseTypes::AllPairs) {
+			allPairsTime = time;
+		}
+		matched = matched && mismatchedFrames == 0;
+
+		std::cout << " " << typeNames[type] << ": " << time / frameCount << " ms, " << (allPairsTime / time) << "x, " << pairs.size() << " pairs, "
+			<< (mismatchedFrames == 0 ? "same pairs as all pairs" : std::to_string(mismatchedFrames) + " frames differ from all pairs") << std::endl;
+	}
+
+	return matched;
+}
+
+/// <summary>
+/// Stacks a pyramid of boxes on a floor the way the pyramid key does, without a window, and prints the solver time per step as the boxes settle and fall asleep.
+/// The pyramid is run again with sleeping turned off to show what sleeping saves
+/// </summary>
+/// <param name="baseWidth">The number of boxes in the bottom row</param>
+/// <param name="stepCount">The number of fixed steps to run</param>
+/// <returns>True if every box was asleep after the last step</returns>
+static bool BenchmarkSolver(uint32_t baseWidth, uint32_t stepCount)
+{
+	//Leave a small gap between neighbouring boxes so each one only rests on the boxes below it
+	const float spacing = 1.05f;
+	const uint32_t reportInterval = 30;
+	PhysicsManager* physicsManager = PhysicsManager::GetInstance();
+
+	JobSystem::GetInstance()->Init();
+
+	Collider floorCollider;
+	floorCollider.type = ColliderTypes::AABBCollider;
+
+	Collider boxCollider;
+	boxCollider.type = ColliderTypes::OBBCollider;
+
+	bool settled = false;
+	bool previousSleeping = physicsManager->GetSleepingEnabled();
+	for (bool sleeping : { true, false }) {
+		physicsManager->SetSleepingEnabled(sleeping);
+
+		std::shared_ptr<Transform> floorTransform = std::make_shared<Transform>(glm::vec3(0.0f, -0.5f, 0.0f));
+		floorTransform->SetScale(glm::vec3(baseWidth * spacing + 2.0f, 1.0f, 3.0f));
+		std::shared_ptr<PhysicsObject> floor = std::make_shared<PhysicsObject>(floorTransform, PhysicsLayers::Static, 1.0f, false, true);
+		floor->SetCollider(floorCollider);
+
+		std::vector<std::shared_ptr<PhysicsObject>> boxes;
+		for (uint32_t row = 0; row < baseWidth; row++) {
+			uint32_t rowWidth = baseWidth - row;
+
+			for (uint32_t column = 0; column < rowWidth; column++) {
+				glm::vec3 position = glm::vec3((column - (rowWidth - 1) * 0.5f) * spacing, 0.5f + row, 0.0f);
+				boxes.push_back(std::make_shared<PhysicsObject>(std::make_shared<Transform>(position), PhysicsLayers::Dynamic, 1.0f, true, true));
+				boxes.back()->SetCollider(boxCollider);
+			}
+		}
+
+		std::cout << "Pyramid of " << boxes.size() << " boxes with sleeping " << (sleeping ? "on" : "off") << ", " << stepCount << " steps of " << physicsManager->GetFixedTimeStep() * 1000.0f << " ms" << std::endl;
+
+		//The solver time is only kept for the latest step, so steps are taken one at a time and the time is summed over each report
+		float intervalTime = 0.0f;
+		float totalTime = 0.0f;
+		for (uint32_t step = 1; step <= stepCount; step++) {
+			physicsManager->StepFixed(1);
+			intervalTime += physicsManager->GetSolverTime();
+
+			if (step % reportInterval == 0 || step == stepCount) {
+				uint32_t intervalSteps = (step - 1) % reportInterval + 1;
+				std::cout << " Steps " << step - intervalSteps + 1 << "-" << step << ": " << intervalTime / intervalSteps << " ms solving per step, "
+					<< physicsManager->GetSleepingBodyCount() << "/" << boxes.size() << " boxes asleep" << std::endl;
+				totalTime += intervalTime;
+				intervalTime = 0.0f;
+			}
+		}
+
+		std::cout << " Average: " << totalTime / stepCount << " ms solving per step" << std::endl;
+
+		if (sleeping) {
+			settled = physicsManager->GetSleepingBodyCount() == boxes.size();
+		}
+	}
+
+	physicsManager->SetSleepingEnabled(previousSleeping);
+	JobSystem::GetInstance()->Cleanup();
+
+	return settled;
+}
+
+/// <summary>
+/// Fills a bare physics world with a fixed field of boxes and spheres and times batches of line of sight rays, swept spheres and sphere overlaps through each broadphase,
+/// the same kind of rays the F11 benchmark casts, without a window. Every broadphase's hits are checked against testing every body
+/// </summary>
+/// <param name="count">The number of bodies in the field</param>
+/// <param name="iterations">The number of times each batch is run</param>
+/// <returns>True if every broadphase found the same hits as testing every body</returns>
+static bool BenchmarkRaycasts(uint32_t count, uint32_t iterations)
+{
+	const uint32_t gridWidth = 100;
+	const char* typeNames[BroadphaseTypeCount] = { "All pairs", "Sweep and prune", "Uniform grid" };
+	PhysicsManager* physicsManager = PhysicsManager::GetInstance();
+
+	JobSystem::GetInstance()->Init();
+
+	Collider boxCollider;
+	boxCollider.type = ColliderTypes::OBBCollider;
+
+	Collider sphereCollider;
+	sphereCollider.type = ColliderTypes::SphereCollider;
+
+	//Bodies are laid out on a jittered grid from their index rather than std::rand so the field is the same on every platform
+	uint32_t fieldWidth = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(count))));
+	float area = fieldWidth * 2.0f;
+	std::vector<std::shared_ptr<PhysicsObject>> bodies(count);
+	for (uint32_t i = 0; i < count; i++) {
+		glm::vec3 position = glm::vec3((i % fieldWidth) * 2.0f - area * 0.5f + (i * 7 % 10) * 0.1f, (i * 13 % 20) * 0.1f, (i / fieldWidth) * 2.0f - area * 0.5f + (i * 3 % 10) * 0.1f);
+
+		std::shared_ptr<Transform> transform = std::make_shared<Transform>(position);
+		transform->SetScale(glm::vec3(0.5f + (i * 11 % 10) * 0.1f));
+		transform->SetOrientation(glm::vec3(0.0f, static_cast<float>(i * 17 % 90), 0.0f));
+
+		bodies[i] = std::make_shared<PhysicsObject>(transform, PhysicsLayers::Static, 1.0f, false, true);
+		bodies[i]->SetCollider(i % 2 == 0 ? boxCollider : sphereCollider);
+	}
+
+	//Line of sight rays at eye height through the middle of the field to the opposite point, as the F11 benchmark casts them
+	std::vector<RayQuery> rays(gridWidth * gridWidth);
+	std::vector<OverlapQuery> overlaps(gridWidth * gridWidth);
+	for (uint32_t x = 0; x < gridWidth; x++) {
+		for (uint32_t z = 0; z < gridWidth; z++) {
+			RayQuery& ray = rays[x * gridWidth + z];
+			ray.origin = glm::vec3((x / (gridWidth - 1.0f) - 0.5f) * area, 1.0f, (z / (gridWidth - 1.0f) - 0.5f) * area);
+
+			glm::vec3 target = glm::vec3(-ray.origin.x, ray.origin.y, -ray.origin.z);
+			ray.direction = target - ray.origin;
+			ray.maxDistance = glm::length(ray.direction);
+			ray.maxHits = 1;
+
+			OverlapQuery& overlap = overlaps[x * gridWidth + z];
+			overlap.collider.type = ColliderTypes::SphereCollider;
+			overlap.collider.radius = 2.0f;
+			overlap.position = ray.origin;
+		}
+	}
+
+	std::vector<RayQuery> sphereCasts = rays;
+	for (RayQuery& sphereCast : sphereCasts) {
+		sphereCast.radius = 0.5f;
+	}
+
+	std::vector<std::vector<RaycastHit>> rayHits;
+	std::vector<std::vector<RaycastHit>> sphereHits;
+	std::vector<std::vector<PhysicsHandle>> overlapHits;
+
+	//Testing every body is the reference the others are checked against
+	std::vector<std::vector<RaycastHit>> expectedRayHits;
+	std::vector<std::vector<RaycastHit>> expectedSphereHits;
+	std::vector<std::vector<PhysicsHandle>> expectedOverlapHits;
+	bool matched = true;
+
+	std::cout << count << " bodies, " << rays.size() << " queries per batch, " << iterations << " iterations" << std::endl;
+
+	BroadphaseTypes previousBroadphase = physicsManager->GetBroadphaseType();
+	for (uint32_t type = BroadphaseTypes::AllPairs; type < BroadphaseTypeCount; type++) {
+		//Queries use the broadphase built during the latest step, so step once to build this one
+		physicsManager->SetBroadphaseType(static_cast<BroadphaseTypes>(type));
+		physicsManager->StepFixed(1);
+
+		float rayTime = 0.0f;
+		float sphereTime = 0.0f;
+		float overlapTime = 0.0f;
+		for (uint32_t i = 0; i < iterations; i++) {
+			std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			physicsManager->Raycast(rays, rayHits);
+			rayTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+			start = std::chrono::steady_clock::now();
+			physicsManager->Raycast(sphereCasts, sphereHits);
+			sphereTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+
+			start = std::chrono::steady_clock::now();
+			physicsManager->Overlap(overlaps, overlapHits);
+			overlapTime += std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+		}
+
+		//Overlaps are found in whatever order the broadphase visits them
+		for (std::vector<PhysicsHandle>& handles : overlapHits) {
+			std::sort(handles.begin(), handles.end(), [](const PhysicsHandle& a, const PhysicsHandle& b) { return a.index < b.index; });
+		}
+
+		uint32_t rayHitCount = 0;
+		for (const std::vector<RaycastHit>& hits : rayHits) {
+			rayHitCount += static_cast<uint32_t>(hits.size());
+		}
+
+		uint32_t overlapHitCount = 0;
+		for (const std::vector<PhysicsHandle>& handles : overlapHits) {
+			overlapHitCount += static_cast<uint32_t>(handles.size());
+		}
+
+		bool same = true;
+		if (type == BroadphaseTypes::AllPairs) {
+			expectedRayHits = rayHits;
+			expectedSphereHits = sphereHits;
+			expectedOverlapHits = overlapHits;
+		}
+		else {
+			//The same shapes are tested whichever broadphase finds them, so the hit distances match exactly
+			auto sameHits = [](const std::vector<RaycastHit>& hits, const std::vector<RaycastHit>& expected) {
+				return std::equal(hits.begin(), hits.end(), expected.begin(), expected.end(), [](const RaycastHit& a, const RaycastHit& b) {
+					return a.handle == b.handle && a.distance == b.distance;
+				});
+			};
+
+			for (uint32_t i = 0; i < rays.size() && same; i++) {
+				same = sameHits(rayHits[i], expectedRayHits[i]) && sameHits(sphereHits[i], expectedSphereHits[i]) && overlapHits[i] == expectedOverlapHits[i];
+			}
+		}
+		matched = matched && same;
+
+		float queryCount = static_cast<float>(rays.size()) * iterations;
+		std::cout << " " << typeNames[type] << ": " << queryCount / rayTime << " rays/sec, " << queryCount / sphereTime << " sphere casts/sec, "
+			<< queryCount / overlapTime << " overlaps/sec, " << rayHitCount << " rays blocked, " << overlapHitCount << " overlapping bodies, "
+			<< (same ? "same hits as testing every body" : "hits differ from testing every body") << std::endl;
+	}
+
+	physicsManager->SetBroadphaseType(previousBroadphase);
+	JobSystem::GetInstance()->Cleanup();
+
+	return matched;
+}
+
+/// <summary>
+/// Builds a hierarchy in the scene graph and times propagating world matrices after moving every root, after moving a few nodes and after moving nothing,
+/// against recomputing every node's world matrix through its parents one node at a time
+/// </summary>
+/// <param name="name">The name printed with the results</param>
+/// <param name="rootCount">The number of transforms without a parent</param>
+/// <param name="depth">The number of levels including the roots</param>
+/// <param name="nodeCount">The total number of transforms</param>
+static void BenchmarkHierarchy(const std::string& name, uint32_t rootCount, uint32_t depth, uint32_t nodeCount)
+{
+	const uint32_t iterations = 20;
+	SceneGraph* sceneGraph = SceneGraph::GetInstance();
+
+	//Roots fill the first level and the other nodes are spread evenly over the rest, each attached to a node on the level above
+	std::vector<std::shared_ptr<Transform>> transforms;
+	std::vector<uint32_t> parents;
+	uint32_t levelStart = 0;
+	uint32_t levelSize = rootCount;
+	for (uint32_t level = 0; level < depth; level++) {
+		uint32_t size = rootCount;
+		if (level > 0) {
+			size = (nodeCount - rootCount) / (depth - 1) + (level <= (nodeCount - rootCount) % (depth - 1) ? 1 : 0);
+		}
+
+		uint32_t start = static_cast<uint32_t>(transforms.size());
+		for (uint32_t i = 0; i < size; i++) {
+			transforms.push_back(std::make_shared<Transform>(glm::vec3(1.0f, 0.5f, 0.0f), glm::quat(glm::radians(glm::vec3(0.0f, 10.0f, 0.0f)))));
+			parents.push_back(level > 0 ? levelStart + i % levelSize : UINT32_MAX);
+
+			if (level > 0) {
+				sceneGraph->SetParent(transforms.back(), transforms[parents.back()]);
+			}
+		}
+
+		levelStart = start;
+		levelSize = size;
+	}
+	sceneGraph->Update();
+
+	float fullTime = 0.0f;
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		for (uint32_t i = 0; i < rootCount; i++) {
+			transforms[i]->Translate(glm::vec3(0.01f, 0.0f, 0.0f));
+		}
+		sceneGraph->Update();
+		fullTime += sceneGraph->GetUpdateTime();
+	}
+	uint32_t fullCount = sceneGraph->GetUpdatedNodeCount();
+
+	float partialTime = 0.0f;
+	uint32_t partialCount = 0;
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		for (uint32_t i = 0; i < nodeCount / 100; i++) {
+			transforms[std::rand() % nodeCount]->Translate(glm::vec3(0.0f, 0.01f, 0.0f));
+		}
+		sceneGraph->Update();
+		partialTime += sceneGraph->GetUpdateTime();
+		partialCount += sceneGraph->GetUpdatedNodeCount();
+	}
+
+	float idleTime = 0.0f;
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		sceneGraph->Update();
+		idleTime += sceneGraph->GetUpdateTime();
+	}
+
+	//What gameplay code has to do without a hierarchy, every node multiplied up through all of its parents every frame
+	std::vector<glm::mat4> worldMatrices(nodeCount);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		for (uint32_t i = 0; i < nodeCount; i++) {
+			glm::mat4 world = transforms[i]->GetModelMatrix();
+			for (uint32_t parent = parents[i]; parent != UINT32_MAX; parent = parents[parent]) {
+				world = transforms[parent]->GetModelMatrix() * world;
+			}
+			worldMatrices[i] = world;
+		}
+	}
+	float naiveTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	//The two multiply in a different order so they only agree to rounding
+	float maxError = 0.0f;
+	for (uint32_t i = 0; i < nodeCount; i++) {
+		glm::mat4 difference = worldMatrices[i] - transforms[i]->GetWorldMatrix();
+		for (uint32_t column = 0; column < 4; column++) {
+			maxError = std::max(maxError, glm::length(difference[column]));
+		}
+	}
+
+	std::cout << name << ": " << nodeCount << " nodes, " << rootCount << " roots, depth " << depth << std::endl;
+	std::cout << " Every root moved: " << fullTime / iterations << " ms, " << fullCount << " nodes updated" << std::endl;
+	std::cout << " " << nodeCount / 100 << " nodes moved: " << partialTime / iterations << " ms, " << partialCount / iterations << " nodes updated" << std::endl;
+	std::cout << " Nothing moved: " << idleTime / iterations << " ms" << std::endl;
+	std::cout << " Every node through its parents: " << naiveTime / iterations << " ms, largest difference " << maxError << std::endl;
+
+	sceneGraph->Clear();
+}
+
+/// <summary>
+/// Times creating, querying and destroying objects held in a list of game objects against plain entities queried through the entity registry's pools.
+/// Game objects keep their components in the registry too, so they are destroyed before the entities are created
+/// </summary>
+/// <param name="count">The number of objects to create each way</param>
+static void BenchmarkEntities(uint32_t count)
+{
+	const uint32_t iterations = 20;
+
+	//A mesh that is never uploaded, only its instance bookkeeping is used
+	std::shared_ptr<Mesh> mesh = std::make_shared<Mesh>();
+	EntityRegistry* registry = EntityRegistry::GetInstance();
+
+	//Every hundredth body is left inactive so both ways find the same handles to draw
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<std::shared_ptr<GameObject>> objects(count);
+	for (uint32_t i = 0; i < count; i++) {
+		std::shared_ptr<Transform> transform = std::make_shared<Transform>(glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+		objects[i] = std::make_shared<GameObject>(mesh, transform, std::make_shared<PhysicsObject>(transform));
+		objects[i]->Spawn();
+		objects[i]->GetPhysicsObject()->SetAlive(i % 100 != 0);
+	}
+	float objectCreateTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	//Finding the bodies that need handles drawn one object and one lock at a time, the way game objects used to in their updates
+	std::vector<std::shared_ptr<GameObject>> inactiveObjects;
+	start = std::chrono::steady_clock::now();
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		inactiveObjects.clear();
+		for (size_t i = 0; i < objects.size(); i++) {
+			objects[i]->Update();
+			if (!objects[i]->GetPhysicsObject()->GetAlive()) {
+				inactiveObjects.push_back(objects[i]);
+			}
+		}
+	}
+	float objectInactiveTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	glm::vec3 objectSum = glm::vec3(0.0f);
+	start = std::chrono::steady_clock::now();
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		for (size_t i = 0; i < objects.size(); i++) {
+			objectSum += objects[i]->GetTransform()->GetPosition();
+		}
+	}
+	float objectQueryTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	inactiveObjects.clear();
+	objects.clear();
+	float objectDestroyTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	std::vector<Entity> entities(count);
+	for (uint32_t i = 0; i < count; i++) {
+		std::shared_ptr<Transform> transform = std::make_shared<Transform>(glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+		std::shared_ptr<PhysicsObject> physicsObject = std::make_shared<PhysicsObject>(transform);
+		physicsObject->SetAlive(i % 100 != 0);
+
+		MeshComponent meshComponent;
+		meshComponent.mesh = mesh;
+		meshComponent.instanceId = mesh->AddInstance(transform);
+
+		entities[i] = registry->Create();
+		registry->Add(entities[i], TransformComponent{ transform });
+		registry->Add(entities[i], PhysicsComponent{ physicsObject, physicsObject->GetHandle() });
+		registry->Add(entities[i], meshComponent);
+	}
+	float entityCreateTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	//One pass over the physics pool with the world locked once
+	std::vector<Entity> inactiveEntities;
+	start = std::chrono::steady_clock::now();
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		registry->FindInactiveEntities(inactiveEntities);
+	}
+	float entityInactiveTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	glm::vec3 entitySum = glm::vec3(0.0f);
+	start = std::chrono::steady_clock::now();
+	for (uint32_t iteration = 0; iteration < iterations; iteration++) {
+		registry->Each<TransformComponent>([&entitySum](Entity entity, TransformComponent& component) {
+			entitySum += component.transform->GetPosition();
+		});
+	}
+	float entityQueryTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < count; i++) {
+		registry->Destroy(entities[i]);
+	}
+	float entityDestroyTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << count << " objects, game objects against entities" << std::endl;
+	std::cout << " Create: " << objectCreateTime << " ms, " << entityCreateTime << " ms" << std::endl;
+	std::cout << " Find inactive bodies: " << objectInactiveTime / iterations << " ms, " << entityInactiveTime / iterations << " ms, "
+		<< (objectInactiveTime / entityInactiveTime) << "x, " << count / 100 << " expected and " << inactiveEntities.size() << " found" << std::endl;
+	std::cout << " Read every position: " << objectQueryTime / iterations << " ms, " << entityQueryTime / iterations << " ms, "
+		<< (objectQueryTime / entityQueryTime) << "x, " << (objectSum == entitySum ? "same" : "different") << " sums" << std::endl;
+	std::cout << " Destroy: " << objectDestroyTime << " ms, " << entityDestroyTime << " ms" << std::endl;
+}
+
+/// <summary>
+/// Fires projectiles at 10k per second in 60 Hz frames and despawns each one a second later, printing the time and heap allocations per frame once the first projectiles expire
+/// </summary>
+/// <param name="name">The name printed with the results</param>
+/// <param name="frameCount">The number of frames to simulate</param>
+/// <param name="spawn">Spawns a projectile at a position</param>
+/// <param name="despawn">Despawns a projectile, the last reference to it is dropped right after</param>
+static void ChurnProjectiles(const std::string& name, uint32_t frameCount, std::function<std::shared_ptr<GameObject>(glm::vec3)> spawn, std::function<void(const std::shared_ptr<GameObject>&)> despawn)
+{
+	const uint32_t lifetimeFrames = 60;
+	const float firedPerFrame = 10000.0f / 60.0f;
+
+	//Live projectiles in the order they were fired, which is also the order they expire in
+	std::vector<std::shared_ptr<GameObject>> projectiles(12000);
+	std::vector<uint32_t> spawnFrames(projectiles.size());
+	uint32_t first = 0;
+	uint32_t count = 0;
+	float owed = 0.0f;
+
+	uint64_t allocationStart = 0;
+	std::chrono::steady_clock::time_point start;
+
+	for (uint32_t frame = 0; frame < frameCount; frame++) {
+		//Only measure once projectiles are being despawned as fast as they are spawned
+		if (frame == lifetimeFrames) {
+			allocationStart = AllocationCounter::GetCount();
+			start = std::chrono::steady_clock::now();
+		}
+
+		while (count > 0 && frame - spawnFrames[first] >= lifetimeFrames) {
+			despawn(projectiles[first]);
+			projectiles[first] = nullptr;
+			first = (first + 1) % projectiles.size();
+			count--;
+		}
+
+		owed += firedPerFrame;
+		while (owed >= 1.0f) {
+			uint32_t last = (first + count) % projectiles.size();
+			projectiles[last] = spawn(glm::vec3(static_cast<float>(last), 1.0f, 30.0f));
+			spawnFrames[last] = frame;
+			count++;
+			owed -= 1.0f;
+		}
+	}
+
+	uint32_t measuredFrames = frameCount - lifetimeFrames;
+	float time = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+	uint64_t allocations = AllocationCounter::GetCount() - allocationStart;
+	std::cout << name << ": " << time / measuredFrames << " ms per frame, " << static_cast<float>(allocations) / measuredFrames << " allocations per frame" << std::endl;
+
+	for (uint32_t i = 0; i < count; i++) {
+		despawn(projectiles[(first + i) % projectiles.size()]);
+	}
+}
+
+/// <summary>
+/// Compares creating a game object, transform and physics object for every projectile against spawning them from an object pool
+/// </summary>
+/// <param name="seconds">How many seconds of 60 Hz frames to simulate, the first second only fills the scene</param>
+static void BenchmarkPooling(float seconds)
+{
+	uint32_t frameCount = std::max(static_cast<uint32_t>(seconds * 60.0f), 61u);
+
+	//A mesh that is never uploaded, only its instance bookkeeping is used
+	ObjectPrefab prefab;
+	prefab.mesh = std::make_shared<Mesh>();
+	prefab.tag = "Projectile";
+	prefab.scale = glm::vec3(0.1f, 0.1f, 0.1f);
+
+	ChurnProjectiles("Created per spawn", frameCount, [&prefab](glm::vec3 position) {
+		std::shared_ptr<Transform> transform = std::make_shared<Transform>(position, glm::quat(glm::vec3(0.0f, 0.0f, 0.0f)), prefab.scale);
+		std::shared_ptr<PhysicsObject> physicsObject = std::make_shared<PhysicsObject>(transform, prefab.physicsLayer, prefab.mass, prefab.affectedByGravity);
+		physicsObject->SetCollider(prefab.collider);
+
+		std::shared_ptr<GameObject> projectile = std::make_shared<GameObject>(prefab.mesh, transform, physicsObject);
+		projectile->SetTag(prefab.tag);
+		projectile->Spawn();
+		return projectile;
+	}, [](const std::shared_ptr<GameObject>& projectile) {
+		projectile->Despawn();
+	});
+
+	ObjectPool<GameObject> pool(prefab, 12000);
+	ChurnProjectiles("Pooled", frameCount, [&pool](glm::vec3 position) {
+		return pool.Spawn(position);
+	}, [&pool](const std::shared_ptr<GameObject>& projectile) {
+		pool.Despawn(projectile);
+	});
+}
+
+/// <summary>
+/// Counts the heap allocations made by the parts of a frame that don't need a window once the scene has warmed up.
+/// Pooled projectiles are fired at a floor and despawned, physics is stepped, a hierarchy is moved and the entity registry's systems run
+/// </summary>
+/// <param name="frameCount">The number of 60 Hz frames to count allocations over, after five seconds of warm up for the scene to fill up</param>
+/// <returns>True if none of the counted frames allocated</returns>
+static bool CheckFrameAllocations(uint32_t frameCount)
+{
+	const uint32_t warmUpFrames = 300;
+	const uint32_t lifetimeFrames = 60;
+	const uint32_t firedPerFrame = 20;
+	const std::chrono::steady_clock::duration frameTime = std::chrono::microseconds(16667);
+
+	PhysicsManager* physicsManager = PhysicsManager::GetInstance();
+	SceneGraph* sceneGraph = SceneGraph::GetInstance();
+	EntityRegistry* registry = EntityRegistry::GetInstance();
+
+	//A mesh that is never uploaded, only its instance bookkeeping is used
+	ObjectPrefab prefab;
+	prefab.mesh = std::make_shared<Mesh>();
+	prefab.tag = "Projectile";
+	prefab.scale = glm::vec3(0.1f, 0.1f, 0.1f);
+	ObjectPool<GameObject> pool(prefab, firedPerFrame * (lifetimeFrames + 1));
+
+	std::shared_ptr<GameObject> floor = std::make_shared<GameObject>(prefab.mesh, std::make_shared<Transform>(glm::vec3(0.0f, -0.5f, 0.0f)));
+	floor->GetTransform()->SetScale(glm::vec3(100.0f, 1.0f, 100.0f));
+	floor->SetPhysicsObject(std::make_shared<PhysicsObject>(floor->GetTransform(), PhysicsLayers::Static, 1.0f, false, true));
+
+	Collider floorCollider;
+	floorCollider.type = ColliderTypes::AABBCollider;
+	floor->GetPhysicsObject()->SetCollider(floorCollider);
+	floor->Spawn();
+
+	std::vector<std::shared_ptr<Transform>> hierarchy;
+	hierarchy.push_back(std::make_shared<Transform>());
+	for (uint32_t i = 1; i < 200; i++) {
+		hierarchy.push_back(std::make_shared<Transform>(glm::vec3(1.0f, 0.0f, 0.0f)));
+		sceneGraph->SetParent(hierarchy.back(), hierarchy[(i - 1) / 4]);
+	}
+
+	//Live projectiles in the order they were fired, which is also the order they expire in
+	std::vector<std::shared_ptr<GameObject>> projectiles(pool.GetCapacity());
+	std::vector<uint32_t> spawnFrames(projectiles.size());
+	std::vector<Entity> inactiveEntities;
+	uint32_t first = 0;
+	uint32_t count = 0;
+
+	uint32_t allocatingFrames = 0;
+	uint64_t totalAllocations = 0;
+
+	Time::Reset();
+	std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+	for (uint32_t frame = 0; frame < warmUpFrames + frameCount; frame++) {
+		//Physics steps on the time that has passed, so the frames are paced like the real loop
+		std::this_thread::sleep_until(frameStart += frameTime);
+		uint64_t allocationStart = AllocationCounter::GetCount();
+
+		Time::Update();
+
+		while (count > 0 && frame - spawnFrames[first] >= lifetimeFrames) {
+			pool.Despawn(projectiles[first]);
+			projectiles[first] = nullptr;
+			first = (first + 1) % projectiles.size();
+			count--;
+		}
+
+		for (uint32_t i = 0; i < firedPerFrame; i++) {
+			uint32_t last = (first + count) % projectiles.size();
+			projectiles[last] = pool.Spawn(glm::vec3(static_cast<float>(last % 40) - 20.0f, 1.0f, 0.0f), glm::vec3(0.0f, 0.0f, -2.0f));
+			spawnFrames[last] = frame;
+			count++;
+		}
+
+		//The game manager hands out the collision events each frame
+		physicsManager->Update();
+		physicsManager->DispatchEvents();
+
+		hierarchy[0]->Rotate(glm::quat(glm::vec3(0.0f, 0.01f, 0.0f)));
+		sceneGraph->Update();
+
+		registry->Update();
+		registry->FindInactiveEntities(inactiveEntities);
+
+		uint64_t allocations = AllocationCounter::GetCount() - allocationStart;
+		if (frame >= warmUpFrames && allocations > 0) {
+			allocatingFrames++;
+			totalAllocations += allocations;
+		}
+	}
+
+	std::cout << allocatingFrames << " of " << frameCount << " frames allocated, " << totalAllocations << " allocations in total" << std::endl;
+
+	for (uint32_t i = 0; i < count; i++) {
+		pool.Despawn(projectiles[(first + i) % projectiles.size()]);
+	}
+	sceneGraph->Clear();
+
+	return allocatingFrames == 0;
+}
+
+/// <summary>
+/// Reports the instance benchmark after the renderer has been run with it for a set number of frames.
+/// Device idles are only counted between churn frames, so the idle when the application closes isn't included
+/// </summary>
+/// <returns>True if the device was never idled while instances were churning</returns>
+static bool ReportInstanceChurn()
+{
+	GameManager* gameManager = GameManager::GetInstance();
+	uint32_t frameCount = gameManager->GetInstanceChurnFrames();
+	uint32_t idleCount = gameManager->GetInstanceChurnIdles();
+
+	std::cout << "Instance churn over " << frameCount << " frames: " << gameManager->GetInstanceChurnCount() << " instances removed and added in "
+		<< gameManager->GetInstanceChurnTime() << " ms on the last frame" << std::endl;
+	std::cout << " " << idleCount << " device idles, " << (frameCount > 0 ? static_cast<float>(idleCount) / frameCount : 0.0f) << " per frame" << std::endl;
+	std::cout << " " << gameManager->GetInstanceChurnStalls() << " upload stalls, " << InstanceBuffer::GetReallocationCount() << " instance buffer reallocations" << std::endl;
+
+	return frameCount > 0 && idleCount == 0;
+}
+
+int main(int argc, char* argv[])
+{
+	//Physics recordings can be replayed headless with --replay <file>, used to check the simulation is still deterministic and time it
+	if (argc == 3 && std::string(argv[1]) == "--replay") {
+		try {
+			bool matched = ReplayPhysics(argv[2]);
+			delete PhysicsManager::GetInstance();
+			return matched ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		catch (const std::exception& e) {
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	//The memory allocator can be checked without a device with --allocator-check, fails if any check did
+	if (argc == 2 && std::string(argv[1]) == "--allocator-check") {
+		try {
+			bool passed = CheckMemoryAllocator();
+			delete MemoryAllocator::GetInstance();
+			return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+		catch (const std::exception& e) {
+			std::cerr << e.what() << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	//Model matrix generation can be timed without opening a window with --transform-benchmark [count]
+	if ((argc == 2 || argc == 3) && std::string(argv[1]) == "--transform-benchmark") {
+		BenchmarkTransforms(argc == 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 100000);
+		return EXIT_SUCCESS;
+	}
+
+	//Physics integration and the sphere check can be timed against the per object path without opening a window with --physics-benchmark [count]
+	if ((argc == 2 || argc == 3) && std::string(argv[1]) == "--physics-benchmark") {
+		BenchmarkPhysics(argc == 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 100000);
+		return EXIT_SUCCESS;
+	}
+
+	//The physics kernels can be checked against the per object path without opening a window with --kernel-check [count] [steps], fails if any check did
+	if (argc >= 2 && argc <= 4 && std::string(argv[1]) == "--kernel-check") {
+		bool passed = CheckPhysicsKernels(argc >= 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 100000, argc == 4 ? static_cast<uint32_t>(std::stoul(argv[3])) : 200);
+		return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	//Frame time scaling with the number of job system threads can be measured without opening a window with --job-benchmark [count]
+	if ((argc == 2 || argc == 3) && std::string(argv[1]) == "--job-benchmark") {
+		BenchmarkJobScaling(argc == 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 20000);
+		delete PhysicsManager::GetInstance();
+		delete SceneGraph::GetInstance();
+		return EXIT_SUCCESS;
+	}
+
+	//Recording draw commands across threads can be timed and checked against one thread without opening a window with --record-benchmark [materials] [meshes]
+	if (argc >= 2 && argc <= 4 && std::string(argv[1]) == "--record-benchmark") {
+		bool matched = BenchmarkCommandRecording(argc >= 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 500, argc == 4 ? static_cast<uint32_t>(std::stoul(argv[3])) : 20);
+		return matched ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	//The broadphases can be timed and checked against testing all pairs without opening a window with --broadphase-benchmark [count], fails if any found different pairs
+	if ((argc == 2 || argc == 3) && std::string(argv[1]) == "--broadphase-benchmark") {
+		bool matched = BenchmarkBroadphases(argc == 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 10000);
+		return matched ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	//The contact solver can be timed as a pyramid settles without opening a window with --solver-benchmark [base width] [steps], fails if the pyramid never fell asleep
+	if (argc >= 2 && argc <= 4 && std::string(argv[1]) == "--solver-benchmark") {
+		bool settled = BenchmarkSolver(argc >= 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 20, argc == 4 ? static_cast<uint32_t>(std::stoul(argv[3])) : 300);
+		delete PhysicsManager::GetInstance();
+		return settled ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	//Batched rays, sphere casts and overlaps can be timed on a fixed field of bodies without opening a window with --raycast-benchmark [count] [iterations],
+	//fails if any broadphase found different hits than testing every body
+	if (argc >= 2 && argc <= 4 && std::string(argv[1]) == "--raycast-benchmark") {
+		bool matched = BenchmarkRaycasts(argc >= 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 10000, argc == 4 ? static_cast<uint32_t>(std::stoul(argv[3])) : 5);
+		delete PhysicsManager::GetInstance();
+		return matched ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	//World matrix propagation can be timed on deep and wide hierarchies with --scene-graph-benchmark
+	if (argc == 2 && std::string(argv[1]) == "--scene-graph-benchmark") {
+		JobSystem::GetInstance()->Init();
+		BenchmarkHierarchy("Deep", 1250, 8, 10000);
+		BenchmarkHierarchy("Wide", 10, 8, 10000);
+		JobSystem::GetInstance()->Cleanup();
+		delete SceneGraph::GetInstance();
+		return EXIT_SUCCESS;
+	}
+
+	//Game objects can be compared against plain entities without opening a window with --ecs-benchmark [count]
+	if ((argc == 2 || argc == 3) && std::string(argv[1]) == "--ecs-benchmark") {
+		BenchmarkEntities(argc == 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 100000);
+		delete GameManager::GetInstance();
+		delete EntityRegistry::GetInstance();
+		delete PhysicsManager::GetInstance();
+		return EXIT_SUCCESS;
+	}
+
+	//Spawning projectiles with and without an object pool can be compared without opening a window with --pool-benchmark [seconds]
+	if ((argc == 2 || argc == 3) && std::string(argv[1]) == "--pool-benchmark") {
+		BenchmarkPooling(argc == 3 ? std::stof(argv[2]) : 5.0f);
+		delete GameManager::GetInstance();
+		delete EntityRegistry::GetInstance();
+		delete PhysicsManager::GetInstance();
+		delete StringTable::GetInstance();
+		return EXIT_SUCCESS;
+	}
+
+	//Checks that a warmed up frame doesn't allocate without opening a window with --allocation-check [frames], fails if any frame did
+	if ((argc == 2 || argc == 3) && std::string(argv[1]) == "--allocation-check") {
+		JobSystem::GetInstance()->Init();
+		bool passed = CheckFrameAllocations(argc == 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 300);
+		JobSystem::GetInstance()->Cleanup();
+		delete GameManager::GetInstance();
+		delete EntityRegistry::GetInstance();
+		delete PhysicsManager::GetInstance();
+		delete SceneGraph::GetInstance();
+		delete StringTable::GetInstance();
+		return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	//Instances can be sent to the shaders in a smaller format with --instance-format <matrix|affine|compact>
+	if (argc == 3 && std::string(argv[1]) == "--instance-format") {
+		std::string format = argv[2];
+		if (format == "affine") {
+			EntityManager::GetInstance()->SetInstanceFormat(AffineInstanceFormat);
+		}
+		else if (format == "compact") {
+			EntityManager::GetInstance()->SetInstanceFormat(CompactInstanceFormat);
+		}
+		else if (format != "matrix") {
+			std::cerr << "Unknown instance format " << format << ", expected matrix, affine or compact" << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	//Instances can be churned for a set number of frames with --instance-churn [frames], fails if the device was idled while they churned.
+	//Idles only happen on a real device so this opens the window, but it closes on its own
+	bool instanceChurn = (argc == 2 || argc == 3) && std::string(argv[1]) == "--instance-churn";
+	if (instanceChurn) {
+		VulkanManager::GetInstance()->SetFrameLimit(argc == 3 ? static_cast<uint32_t>(std::stoul(argv[2])) : 600);
+		GameManager::GetInstance()->SetInstanceBenchmark(true);
+	}
+
 	try {
 		VulkanManager::GetInstance()->Run();
 	}
@@ -27,17 +1699,22 @@ int main()
 		return EXIT_FAILURE;
 	}
 
+	bool passed = !instanceChurn || ReportInstanceChurn();
+
 	//Cleanup singletons
 	delete VulkanManager::GetInstance();
 	delete DebugManager::GetInstance();
 	delete GuiManager::GetInstance();
 	delete EntityManager::GetInstance();
 	delete GameManager::GetInstance();
+	delete EntityRegistry::GetInstance();
 	delete InputManager::GetInstance();
 	delete PhysicsManager::GetInstance();
+	delete SceneGraph::GetInstance();
+	delete StringTable::GetInstance();
 	delete WindowManager::GetInstance();
 
 	//Check for memory leaks
 	_CrtDumpMemoryLeaks();
-	return EXIT_SUCCESS;
+	return passed ? EXIT_SUCCESS : EXIT_FAILURE;
 }
\ No newline at end of file
@@ -10,6 +10,10 @@
 #include "SwapChain.h"
 #include "Camera.h"
 #include "GuiManager.h"
+#include "MemoryAllocator.h"
+#include "VulkanMemoryBackend.h"
+#include "UploadManager.h"
+#include "JobSystem.h"
 
 #define mainCamera Camera::GetMainCamera()
 #define shouldInitGui true
@@ -61,6 +65,16 @@ VkQueue VulkanManager::GetPresentQueue()
     return presentQueue;
 }
 
+uint32_t VulkanManager::GetIdleCount()
+{
+    return idleCount;
+}
+
+void VulkanManager::SetFrameLimit(uint32_t value)
+{
+    frameLimit = value;
+}
+
 #pragma endregion
 
 #pragma region Helper Methods
@@ -117,6 +131,12 @@ QueueFamilyIndices VulkanManager::FindQueueFamilies(VkPhysicalDevice physicalDev
 	return indices;
 }
 
+void VulkanManager::WaitIdle()
+{
+	vkDeviceWaitIdle(logicalDevice);
+	idleCount++;
+}
+
 #pragma endregion
 
 
@@ -139,14 +159,23 @@ void VulkanManager::Run()
 	mainCamera->GetTransform()->SetPosition(glm::vec3(0.0f, 2.5f, 5.0f));
 	mainCamera->GetTransform()->LookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
 
+	//Start the worker threads before any work is handed to them
+	JobSystem::GetInstance()->Init();
+
 	InitVulkan();
 	
 	if (DebugManager::GetInstance()->GetEnableValidationLayers()) {
 		std::cout << "Finished Setup" << std::endl;
 	}
 	MainLoop();
+
+	//Stop the physics thread before anything it uses is destroyed
+	PhysicsManager::GetInstance()->Cleanup();
+
 	Cleanup();
 
+	JobSystem::GetInstance()->Cleanup();
+
 	delete mainCamera;
 }
 
@@ -171,6 +200,12 @@ void VulkanManager::InitVulkan()
 	//Create the logical device
 	CreateLogicalDevice();
 
+	//Sub-allocate buffer and image memory from large device memory blocks
+	MemoryAllocator::GetInstance()->Init(std::make_shared<VulkanMemoryBackend>());
+
+	//Batch resource uploads into a few fenced submissions instead of waiting on the queue for every copy
+	UploadManager::GetInstance()->Init();
+
 	initGui = shouldInitGui;
 	SwapChain::GetInstance()->CreateSwapChainResources();
 
@@ -252,7 +287,7 @@ void VulkanManager::CreateInstance()
 	createInfo.ppEnabledExtensionNames = requiredExtensions.data();
 	createInfo.enabledLayerCount = 0;
 
-	std::vector<const char*> validationLayers = DebugManager::GetInstance()->GetValidationLayers();
+	const std::vector<const char*>& validationLayers = DebugManager::GetInstance()->GetValidationLayers();
 
 	//Add validation layers if they are enabled
 	VkDebugUtilsMessengerCreateInfoEXT debugCreateInfo;
@@ -312,7 +347,7 @@ void VulkanManager::CreateLogicalDevice()
 	createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
 	createInfo.ppEnabledExtensionNames = deviceExtensions.data();
 
-	std::vector<const char*> enabledLayers = DebugManager::GetInstance()->GetValidationLayers();
+	const std::vector<const char*>& enabledLayers = DebugManager::GetInstance()->GetValidationLayers();
 
 	if (enabledLayers.size() > 0) {
 		createInfo.enabledLayerCount = static_cast<uint32_t>(DebugManager::GetInstance()->GetValidationLayers().size());
@@ -341,6 +376,9 @@ void VulkanManager::CreateSurface()
 
 void VulkanManager::Cleanup()
 {
+	//Finish any outstanding uploads before the resources they write to are destroyed
+	UploadManager::GetInstance()->Cleanup();
+
 	//Cleanup Swap Chain and associated resources
 	SwapChain::GetInstance()->FullCleanup();
 	delete SwapChain::GetInstance();
@@ -350,6 +388,9 @@ void VulkanManager::Cleanup()
 	//Cleanup Debug Manager
 	DebugManager::GetInstance()->Cleanup();
 
+	//Free the device memory blocks
+	MemoryAllocator::GetInstance()->Cleanup();
+
 	//Destroy Logical Device
 	vkDestroyDevice(logicalDevice, nullptr);
 
@@ -379,6 +420,7 @@ void VulkanManager::MainLoop()
 	Time::Reset();
 
 	//Loop until the window is closed
+	uint32_t frameCount = 0;
 	while (!glfwWindowShouldClose(WindowManager::GetInstance()->GetWindow())) {
 		glfwPollEvents();
 
@@ -388,9 +430,14 @@ void VulkanManager::MainLoop()
 		if (InputManager::GetInstance()->GetKeyPressed(Controls::Exit)) {
 			break;
 		}
+
+		frameCount++;
+		if (frameLimit > 0 && frameCount >= frameLimit) {
+			break;
+		}
 	}
 
-	vkDeviceWaitIdle(logicalDevice);
+	WaitIdle();
 }
 
 void VulkanManager::Draw()
@@ -400,7 +447,7 @@ void VulkanManager::Draw()
 
 
 	if (imageIndex != -1) {
-		//Re-record command buffer
+		//Record the primary command buffer, per material secondary buffers are only re-recorded when they changed
 		EntityManager::GetInstance()->Draw(imageIndex, SwapChain::GetInstance()->GetCommandBuffer(imageIndex));
 
 		if (shouldInitGui)
@@ -418,11 +465,22 @@ void VulkanManager::Update()
 
 	GameManager::GetInstance()->Update();
 
-	PhysicsManager::GetInstance()->Update();
+	JobSystem* jobSystem = JobSystem::GetInstance();
+
+	//Physics only touches CPU side state so it runs while this thread waits on the GPU
+	std::shared_ptr<Task> physicsTask = jobSystem->CreateTask([]() { PhysicsManager::GetInstance()->Update(); });
+	jobSystem->Schedule(physicsTask);
+
+	//Instance buffers are written in place so the GPU must be done with this frame's copies first
+	SwapChain::GetInstance()->WaitForFrame();
 
-	DebugManager::GetInstance()->Update();
+	//Debug shapes are added by physics handles and their instances are packed with the rest of the meshes
+	std::shared_ptr<Task> debugTask = jobSystem->Then(physicsTask, []() { DebugManager::GetInstance()->Update(); });
+	std::shared_ptr<Task> entityTask = jobSystem->Then(debugTask, []() { EntityManager::GetInstance()->Update(); });
+	jobSystem->Wait(entityTask);
 
-	EntityManager::GetInstance()->Update();
+	//Submit anything recorded this frame and recycle batches the GPU has finished with
+	UploadManager::GetInstance()->Update();
 	
 	
 }
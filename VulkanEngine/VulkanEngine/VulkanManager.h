@@ -2,7 +2,6 @@
 
 #include "pch.h"
 
-#include "CommandBuffer.h"
 #include "Image.h"
 
 class VulkanManager
@@ -27,6 +26,12 @@ private:
 		VK_KHR_SWAPCHAIN_EXTENSION_NAME
 	};
 
+	//Every time the device has been idled, nothing that runs per frame should ever add to it
+	uint32_t idleCount = 0;
+
+	//When set the main loop exits on its own after this many frames
+	uint32_t frameLimit = 0;
+
 #pragma region Memory Management
 
 	/// <summary>
@@ -165,6 +170,18 @@ public:
 	/// <returns>The VkQueue being used for present operations</returns>
 	VkQueue GetPresentQueue();
 
+	/// <summary>
+	/// Returns the number of times the device has been idled since the application started
+	/// </summary>
+	/// <returns>The idle count</returns>
+	uint32_t GetIdleCount();
+
+	/// <summary>
+	/// Makes the main loop exit after the specified number of frames so a run doesn't need anyone at the keyboard
+	/// </summary>
+	/// <param name="value">The number of frames to run, 0 runs until the window is closed</param>
+	void SetFrameLimit(uint32_t value);
+
 #pragma endregion
 
 #pragma region Helper Methods
@@ -184,6 +201,11 @@ public:
 	/// <returns>The indices of the queue families</returns>
 	QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice physicalDevice);
 
+	/// <summary>
+	/// Blocks until the device has finished all of its work and counts the idle
+	/// </summary>
+	void WaitIdle();
+
 #pragma endregion
 
 #pragma region Run
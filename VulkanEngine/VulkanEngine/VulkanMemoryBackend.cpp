@@ -0,0 +1,68 @@
+#include "pch.h"
+#include "VulkanMemoryBackend.h"
+
+#include "VulkanManager.h"
+
+#define logicalDevice VulkanManager::GetInstance()->GetLogicalDevice()
+
+#pragma region Constructor
+
+VulkanMemoryBackend::VulkanMemoryBackend()
+{
+	vkGetPhysicalDeviceMemoryProperties(VulkanManager::GetInstance()->GetPhysicalDevice(), &memoryProperties);
+}
+
+#pragma endregion
+
+#pragma region Memory Types
+
+uint32_t VulkanMemoryBackend::FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties)
+{
+	return VulkanManager::GetInstance()->FindMemoryType(typeFilter, properties);
+}
+
+bool VulkanMemoryBackend::IsHostVisible(uint32_t memoryTypeIndex)
+{
+	return (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+#pragma endregion
+
+#pragma region Memory Management
+
+VkDeviceMemory VulkanMemoryBackend::AllocateMemory(uint32_t memoryTypeIndex, VkDeviceSize size)
+{
+	VkMemoryAllocateInfo allocateInfo = {};
+	allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	allocateInfo.allocationSize = size;
+	allocateInfo.memoryTypeIndex = memoryTypeIndex;
+
+	VkDeviceMemory memory;
+	if (vkAllocateMemory(logicalDevice, &allocateInfo, nullptr, &memory) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to allocate device memory block!");
+	}
+
+	return memory;
+}
+
+void VulkanMemoryBackend::FreeMemory(VkDeviceMemory memory)
+{
+	vkFreeMemory(logicalDevice, memory, nullptr);
+}
+
+void* VulkanMemoryBackend::MapMemory(VkDeviceMemory memory, VkDeviceSize size)
+{
+	void* data;
+	if (vkMapMemory(logicalDevice, memory, 0, size, 0, &data) != VK_SUCCESS) {
+		throw std::runtime_error("Failed to map device memory block!");
+	}
+
+	return data;
+}
+
+void VulkanMemoryBackend::UnmapMemory(VkDeviceMemory memory)
+{
+	vkUnmapMemory(logicalDevice, memory);
+}
+
+#pragma endregion
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "pch.h"
+#include "MemoryBackend.h"
+
+class VulkanMemoryBackend : public MemoryBackend
+{
+private:
+	VkPhysicalDeviceMemoryProperties memoryProperties;
+
+public:
+#pragma region Constructor
+
+	VulkanMemoryBackend();
+
+#pragma endregion
+
+#pragma region Memory Types
+
+	/// <summary>
+	/// Finds a memory type on the physical device that matches the type filter and has the requested properties
+	/// </summary>
+	/// <param name="typeFilter">Bit mask of the acceptable memory types</param>
+	/// <param name="properties">The required memory properties</param>
+	/// <returns>The index of the memory type to use</returns>
+	uint32_t FindMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) override;
+
+	/// <summary>
+	/// Returns whether memory of the specified type can be mapped by the host
+	/// </summary>
+	/// <param name="memoryTypeIndex">The memory type to check</param>
+	/// <returns>True if the memory type is host visible</returns>
+	bool IsHostVisible(uint32_t memoryTypeIndex) override;
+
+#pragma endregion
+
+#pragma region Memory Management
+
+	/// <summary>
+	/// Allocates a block of memory on the logical device
+	/// </summary>
+	/// <param name="memoryTypeIndex">The memory type to allocate from</param>
+	/// <param name="size">The size of the block in bytes</param>
+	/// <returns>The allocated device memory</returns>
+	VkDeviceMemory AllocateMemory(uint32_t memoryTypeIndex, VkDeviceSize size) override;
+
+	/// <summary>
+	/// Frees a block of memory on the logical device
+	/// </summary>
+	/// <param name="memory">The memory to free</param>
+	void FreeMemory(VkDeviceMemory memory) override;
+
+	/// <summary>
+	/// Maps an entire block of device memory into host address space
+	/// </summary>
+	/// <param name="memory">The memory to map</param>
+	/// <param name="size">The size of the memory block</param>
+	/// <returns>Pointer to the start of the mapped memory</returns>
+	void* MapMemory(VkDeviceMemory memory, VkDeviceSize size) override;
+
+	/// <summary>
+	/// Unmaps a block of device memory that was mapped with MapMemory
+	/// </summary>
+	/// <param name="memory">The memory to unmap</param>
+	void UnmapMemory(VkDeviceMemory memory) override;
+
+#pragma endregion
+};
@@ -4,4 +4,10 @@ C:\VulkanSDK\1.2.135.0\Bin\glslc.exe shaders\DebugShader.vert -o shaders\DebugVe
 C:\VulkanSDK\1.2.135.0\Bin\glslc.exe shaders\DebugShader.frag -o shaders\DebugFrag.spv
 C:\VulkanSDK\1.2.135.0\Bin\glslc.exe shaders\SkyBox.vert -o shaders\SkyVert.spv
 C:\VulkanSDK\1.2.135.0\Bin\glslc.exe shaders\SkyBox.frag -o shaders\SkyFrag.spv
+C:\VulkanSDK\1.2.135.0\Bin\glslc.exe -DINSTANCE_AFFINE shaders\BasicShader.vert -o shaders\vertAffine.spv
+C:\VulkanSDK\1.2.135.0\Bin\glslc.exe -DINSTANCE_COMPACT shaders\BasicShader.vert -o shaders\vertCompact.spv
+C:\VulkanSDK\1.2.135.0\Bin\glslc.exe -DINSTANCE_AFFINE shaders\DebugShader.vert -o shaders\DebugVertAffine.spv
+C:\VulkanSDK\1.2.135.0\Bin\glslc.exe -DINSTANCE_COMPACT shaders\DebugShader.vert -o shaders\DebugVertCompact.spv
+C:\VulkanSDK\1.2.135.0\Bin\glslc.exe -DINSTANCE_AFFINE shaders\SkyBox.vert -o shaders\SkyVertAffine.spv
+C:\VulkanSDK\1.2.135.0\Bin\glslc.exe -DINSTANCE_COMPACT shaders\SkyBox.vert -o shaders\SkyVertCompact.spv
 pause
\ No newline at end of file
@@ -44,6 +44,8 @@
 #include "QueueFamilyIndices.h"
 #include "SwapChainSupportDetails.h"
 #include "TransformData.h"
+#include "AffineTransformData.h"
+#include "CompactTransformData.h"
 #include "UniformBufferObject.h"
 #include "Vertex.h"
 
@@ -52,5 +54,6 @@
 #include "Controls.h"
 #include "InputStates.h"
 #include "PhysicsLayers.h"
+#include "InstanceFormats.h"
 
 #endif //PCH_H
\ No newline at end of file
@@ -20,14 +20,48 @@ layout(location = 1) in vec3 inColor;
 layout(location = 2) in vec3 inNormal;
 layout(location = 3) in vec3 texCoord;
 
-//Instanced Data
+//Instanced Data, the layout depends on the instance format the shader was compiled for
+#if defined(INSTANCE_AFFINE)
+//Top three rows of the model matrix, the bottom row is always (0, 0, 0, 1)
+layout(location = 4) in vec4 modelRow1;
+layout(location = 5) in vec4 modelRow2;
+layout(location = 6) in vec4 modelRow3;
+
+mat4 getModelMatrix(){
+	return transpose(mat4(modelRow1, modelRow2, modelRow3, vec4(0.0f, 0.0f, 0.0f, 1.0f)));
+}
+#elif defined(INSTANCE_COMPACT)
+//Position with the x scale, quantized orientation quaternion and the y and z scale
+layout(location = 4) in vec4 positionScaleX;
+layout(location = 5) in vec4 orientation;
+layout(location = 6) in vec2 scaleYZ;
+
+vec3 rotate(vec4 q, vec3 v){
+	return v + 2.0f * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+mat4 getModelMatrix(){
+	vec4 q = normalize(orientation);
+	return mat4(
+		vec4(rotate(q, vec3(positionScaleX.w, 0.0f, 0.0f)), 0.0f),
+		vec4(rotate(q, vec3(0.0f, scaleYZ.x, 0.0f)), 0.0f),
+		vec4(rotate(q, vec3(0.0f, 0.0f, scaleYZ.y)), 0.0f),
+		vec4(positionScaleX.xyz, 1.0f));
+}
+#else
 layout(location = 4) in mat4 model;
+
+mat4 getModelMatrix(){
+	return model;
+}
+#endif
 layout(location = 8) in vec3 inWireColor;
 
 layout(location = 0) out vec3 color;
 
 void main(){
 	//Create model view projection matrix
+	mat4 model = getModelMatrix();
 	mat4 mvp = ubo.projection * ubo.view * model;
 
 	//calculate screen position of the fragment